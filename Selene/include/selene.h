@@ -5,4 +5,5 @@
 #endif
 
 #include "selene/State.h"
+#include "selene/Trampoline.h"
 #include "selene/Tuple.h"
@@ -16,13 +16,16 @@ struct BaseFun {
 
 namespace detail {
 
-inline int _lua_dispatcher(lua_State *l) {
-    BaseFun *fun = (BaseFun *)lua_touserdata(l, lua_upvalueindex(1));
+// Calls apply() and turns its C++ exceptions into Lua errors. The error is
+// raised after the exception has been destroyed, since lua_error() unwinds
+// with longjmp() in a Lua built as C.
+template <typename Apply>
+inline int _protected_call(lua_State *l, Apply &&apply) {
     _lua_check_get raiseParameterConversionError = nullptr;
     const char * wrong_meta_table = nullptr;
     int erroneousParameterIndex = 0;
     try {
-        return fun->Apply(l);
+        return apply();
     } catch (GetParameterFromLuaTypeError & e) {
         raiseParameterConversionError = e.checked_get;
         erroneousParameterIndex = e.index;
@@ -50,6 +53,11 @@ inline int _lua_dispatcher(lua_State *l) {
     return lua_error(l);
 }
 
+inline int _lua_dispatcher(lua_State *l) {
+    BaseFun *fun = (BaseFun *)lua_touserdata(l, lua_upvalueindex(1));
+    return _protected_call(l, [fun, l]() { return fun->Apply(l); });
+}
+
 template <typename Ret, typename... Args, std::size_t... N>
 inline Ret _lift(std::function<Ret(Args...)> fun,
                  std::tuple<Args...> args,
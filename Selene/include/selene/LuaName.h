@@ -2,9 +2,7 @@
 
 #include <string>
 
-extern "C" {
-#include <lua.h>
-}
+#include "compat.h"
 
 namespace sel {
 /*
@@ -4,10 +4,7 @@
 #include <typeinfo>
 #include <unordered_map>
 
-extern "C" {
-#include <lua.h>
-#include <lauxlib.h>
-}
+#include "compat.h"
 
 namespace sel {
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ExceptionHandler.h"
+#include "primitives.h"
+#include "ResourceHandler.h"
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "util.h"
+
+#include "compat.h"
+
+/* A Lua function resolved once into a registry reference, see
+ * Selector::Prepare(). Calling it does not traverse the tables again, an
+ * invocation only pushes the error handler, the function and the arguments,
+ * calls lua_pcall and leaves the results to the caller. */
+
+namespace sel {
+class PreparedCall {
+private:
+    lua_State *_state = nullptr;
+    int _ref = LUA_NOREF;
+    const void *_function = nullptr;
+    ExceptionHandler *_exception_handler = nullptr;
+
+public:
+    PreparedCall() = default;
+
+    // References the function at the index of the stack
+    PreparedCall(lua_State *l, int index, ExceptionHandler *eh = nullptr)
+        : _state(l), _function(lua_topointer(l, index)), _exception_handler(eh) {
+        lua_pushvalue(l, index);
+        _ref = luaL_ref(l, LUA_REGISTRYINDEX);
+    }
+
+    PreparedCall(const PreparedCall &) = delete;
+    PreparedCall &operator=(const PreparedCall &) = delete;
+
+    PreparedCall(PreparedCall &&other) noexcept
+        : _state(other._state), _ref(other._ref), _function(other._function),
+          _exception_handler(other._exception_handler) {
+        other._state = nullptr;
+        other._ref = LUA_NOREF;
+    }
+
+    PreparedCall &operator=(PreparedCall &&other) noexcept {
+        if (this != &other) {
+            _release();
+            _state = other._state;
+            _ref = other._ref;
+            _function = other._function;
+            _exception_handler = other._exception_handler;
+            other._state = nullptr;
+            other._ref = LUA_NOREF;
+        }
+        return *this;
+    }
+
+    // Has to be destroyed before the state is closed
+    ~PreparedCall() {
+        _release();
+    }
+
+    explicit operator bool() const {
+        return _state != nullptr && _ref != LUA_REFNIL;
+    }
+
+    // Checks if the value at the index of the stack is the prepared function,
+    // e.g. to notice a table entry replaced since. The reference keeps the
+    // function alive, so its address is not reused by another function.
+    bool Refers(int index) const {
+        return _state != nullptr && lua_topointer(_state, index) == _function;
+    }
+
+    // Calls the function in protected mode. On success, the num_ret results
+    // are left on top of the stack, otherwise the error message with the
+    // traceback. Returns the status of lua_pcall.
+    template <typename... Args>
+    int Invoke(int num_ret, Args&&... args) const {
+        const int handler_index = SetErrorHandler(_state);
+        lua_rawgeti(_state, LUA_REGISTRYINDEX, _ref);
+        detail::_push_n(_state, std::forward<Args>(args)...);
+        const int status = lua_pcall(_state, sizeof...(Args), num_ret, handler_index);
+        lua_remove(_state, handler_index);
+        return status;
+    }
+
+    // Calls the function and converts the result, errors are passed to the
+    // exception handler like with sel::function
+    template <typename R = void, typename... Args>
+    R Call(Args&&... args) const {
+        static_assert(!std::is_same<R, std::string_view>::value,
+                      "the result is popped, use Invoke() to read it in place");
+        ResetStackOnScopeExit save(_state);
+        const int status = Invoke(std::is_void<R>::value ? 0 : 1, std::forward<Args>(args)...);
+        if (status != LUA_OK && _exception_handler != nullptr) {
+            _exception_handler->Handle_top_of_stack(status, _state);
+        }
+        if constexpr (!std::is_void<R>::value) {
+            return detail::_get(detail::_id<R>{}, _state, -1);
+        }
+    }
+
+private:
+    void _release() {
+        if (_state != nullptr) {
+            luaL_unref(_state, LUA_REGISTRYINDEX, _ref);
+        }
+    }
+};
+}
@@ -4,10 +4,13 @@
 #include "function.h"
 #include <functional>
 #include "LuaRef.h"
+#include "PreparedCall.h"
 #include "references.h"
 #include "Registry.h"
 #include "ResourceHandler.h"
+#include "SelectorKey.h"
 #include <string>
+#include <string_view>
 #include <tuple>
 #include "util.h"
 #include <vector>
@@ -46,30 +49,44 @@ private:
     lua_State *_state;
     Registry *_registry;
     ExceptionHandler *_exception_handler;
-    std::string _name;
 
     // Traverses the structure up to this element
-    std::vector<LuaRef> _traversal;
+    detail::SelectorPath _traversal;
 
     // Key of the value to act upon.
-    LuaRef _key;
+    detail::SelectorKey _key;
 
     std::vector<LuaRef> _functor_arguments;
 
     // Functor is activated when the () operator is invoked.
     mutable  MovingFlag _functor_active;
 
-    Selector(lua_State *s, Registry &r, ExceptionHandler &eh, const std::string &name,
-             std::vector<LuaRef> traversal, LuaRef key)
-        : _state(s), _registry(&r), _exception_handler(&eh), _name(name), _traversal(traversal),
+    Selector(lua_State *s, Registry &r, ExceptionHandler &eh,
+             const detail::SelectorPath &traversal, const detail::SelectorKey &key)
+        : _state(s), _registry(&r), _exception_handler(&eh), _traversal(traversal),
           _key(key) {}
 
-    Selector(lua_State *s, Registry &r, ExceptionHandler &eh, const std::string& name)
-        : _state(s), _registry(&r), _exception_handler(&eh), _name(name),
-          _key(make_Ref(s, name)) {}
+    Selector(lua_State *s, Registry &r, ExceptionHandler &eh, std::string_view name)
+        : _state(s), _registry(&r), _exception_handler(&eh),
+          _key(name) {}
 
-    void _get(LuaRef r) const {
-        r.Push(_state);
+    // Anchors the strings of string_view conversions, which are not
+    // referenced otherwise, in the registry.
+    static inline const char _view_anchor = 0;
+
+    // Dotted name of the element (e.g. "a.b.1"), the name of classes
+    std::string _full_name() const {
+        std::string name;
+        for (std::size_t i = 0; i < _traversal.size(); ++i) {
+            _traversal[i].AppendTo(name);
+            name += '.';
+        }
+        _key.AppendTo(name);
+        return name;
+    }
+
+    void _get(const detail::SelectorKey &key) const {
+        key.Push(_state);
         lua_gettable(_state, -2);
         lua_remove(_state, lua_absindex(_state, -2));
     }
@@ -105,8 +122,8 @@ private:
 
     void _traverse() const {
         lua_pushglobaltable(_state);
-        for (auto &key : _traversal) {
-            _get(key);
+        for (std::size_t i = 0; i < _traversal.size(); ++i) {
+            _get(_traversal[i]);
         }
     }
 
@@ -129,7 +146,7 @@ private:
         // install handler, and swap(handler, function) on lua stack
         int handler_index = SetErrorHandler(_state);
         int func_index = handler_index - 1;
-#if LUA_VERSION_NUM >= 502
+#if LUA_VERSION_NUM >= 502 || defined(SELENE_LUAJIT)
         lua_pushvalue(_state, func_index);
         lua_copy(_state, handler_index, func_index);
         lua_replace(_state, handler_index);
@@ -256,12 +273,35 @@ public:
         });
     }
 
+    // Stores a plain C function, e.g. a sel::trampoline. Not const, so it is
+    // preferred to the function pointer overload above.
+    void operator=(lua_CFunction fun) {
+        _evaluate_store([this, fun]() {
+            lua_pushcfunction(_state, fun);
+        });
+    }
+
+    // Stores a C closure with the pointer as its upvalue, e.g. a
+    // sel::bound_trampoline. The pointee has to outlive the state.
+    void SetClosure(lua_CFunction fun, void *upvalue) const {
+        _evaluate_store([this, fun, upvalue]() {
+            lua_pushlightuserdata(_state, upvalue);
+            lua_pushcclosure(_state, fun, 1);
+        });
+    }
+
     void operator=(const char *s) const {
         _evaluate_store([this, s]() {
             detail::_push(_state, s);
         });
     }
 
+    void operator=(std::string_view s) const {
+        _evaluate_store([this, s]() {
+            detail::_push(_state, s);
+        });
+    }
+
     template <typename T, typename... Funs>
     void SetObj(T &t, Funs... funs) {
         auto fun_tuple = std::make_tuple(std::forward<Funs>(funs)...);
@@ -275,7 +315,7 @@ public:
         auto fun_tuple = std::make_tuple(std::forward<Funs>(funs)...);
         _evaluate_store([this, &fun_tuple]() {
             typename detail::_indices_builder<sizeof...(Funs)>::type d;
-            _registry->RegisterClass<T, Args...>(_name, fun_tuple, d);
+            _registry->RegisterClass<T, Args...>(_full_name(), fun_tuple, d);
         });
     }
 
@@ -349,6 +389,24 @@ public:
         return detail::_pop(detail::_id<std::string>{}, _state);
     }
 
+    // Non-owning view of the value, without copying the Lua string. The view
+    // stays valid as long as the string is referenced by the table, i.e.
+    // while the entry is not changed and no Lua code runs in between (the
+    // scope of a lock on the state). Results of function calls and numbers
+    // converted to strings are anchored in the registry until the next such
+    // conversion on the state.
+    operator std::string_view() const {
+        ResetStackOnScopeExit save(_state);
+        const bool call = _functor_active;
+        _evaluate_retrieve(1);
+        if (call || lua_type(_state, -1) != LUA_TSTRING) {
+            lua_tolstring(_state, -1, nullptr);
+            lua_pushvalue(_state, -1);
+            lua_rawsetp(_state, LUA_REGISTRYINDEX, &_view_anchor);
+        }
+        return detail::_pop(detail::_id<std::string_view>{}, _state);
+    }
+
     template <typename R, typename... Args>
     operator sel::function<R(Args...)>() {
         ResetStackOnScopeExit save(_state);
@@ -359,6 +417,18 @@ public:
         return ret;
     }
 
+    // Resolves the function once, so it can be called without traversing
+    // the tables again. Other values give an empty PreparedCall.
+    PreparedCall Prepare() const {
+        ResetStackOnScopeExit save(_state);
+        _traverse();
+        _get();
+        if (!lua_isfunction(_state, -1)) {
+            return PreparedCall{};
+        }
+        return PreparedCall{_state, -1, _exception_handler};
+    }
+
     // Vector of keys in the table
     std::vector<std::string> getKeys() const {
         ResetStackOnScopeExit save(_state);
@@ -391,43 +461,49 @@ public:
         return *this;
     }
 
+    std::string_view toStringView() const {
+        return *this;
+    }
+
     // Chaining operators. If the selector is an rvalue, modify in
     // place. Otherwise, create a new Selector and return it.
 #ifdef HAS_REF_QUALIFIERS
-    Selector&& operator[](const std::string& name) && {
-        _name += std::string(".") + name;
+    Selector&& operator[](std::string_view name) && {
         _check_create_table();
         _traversal.push_back(_key);
-        _key = make_Ref(_state, name);
+        _key = detail::SelectorKey{name};
         return std::move(*this);
     }
+    Selector&& operator[](const std::string& name) && {
+        return std::move(*this)[std::string_view{name}];
+    }
     Selector&& operator[](const char* name) && {
-        return std::move(*this)[std::string{name}];
+        return std::move(*this)[std::string_view{name}];
     }
     Selector&& operator[](const int index) && {
-        _name += std::string(".") + std::to_string(index);
         _check_create_table();
         _traversal.push_back(_key);
-        _key = make_Ref(_state, index);
+        _key = detail::SelectorKey{index};
         return std::move(*this);
     }
 #endif // HAS_REF_QUALIFIERS
-    Selector operator[](const std::string& name) const REF_QUAL_LVALUE {
-        auto n = _name + "." + name;
+    Selector operator[](std::string_view name) const REF_QUAL_LVALUE {
         _check_create_table();
         auto traversal = _traversal;
         traversal.push_back(_key);
-        return Selector{_state, *_registry, *_exception_handler, n, traversal, make_Ref(_state, name)};
+        return Selector{_state, *_registry, *_exception_handler, traversal, detail::SelectorKey{name}};
+    }
+    Selector operator[](const std::string& name) const REF_QUAL_LVALUE {
+        return (*this)[std::string_view{name}];
     }
     Selector operator[](const char* name) const REF_QUAL_LVALUE {
-        return (*this)[std::string{name}];
+        return (*this)[std::string_view{name}];
     }
     Selector operator[](const int index) const REF_QUAL_LVALUE {
-        auto name = _name + "." + std::to_string(index);
         _check_create_table();
         auto traversal = _traversal;
         traversal.push_back(_key);
-        return Selector{_state, *_registry, *_exception_handler, name, traversal, make_Ref(_state, index)};
+        return Selector{_state, *_registry, *_exception_handler, traversal, detail::SelectorKey{index}};
     }
 
     friend bool operator==(const Selector &, const char *);
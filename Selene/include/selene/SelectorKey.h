@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "compat.h"
+
+/* Keys of the table accesses of a Selector. Unlike LuaRef, which anchors
+ * every key in the registry behind a shared_ptr, the keys are kept by value
+ * and pushed when the selector is evaluated. Together with the inline
+ * storage of short names and shallow paths, chaining selectors does not
+ * allocate. */
+
+namespace sel {
+namespace detail {
+
+// A string or integer key. Names up to _inline_size characters are stored
+// in the key itself, longer names on the heap.
+class SelectorKey {
+public:
+    static constexpr std::size_t _inline_size = 39;
+
+private:
+    std::size_t _size = 0;
+    int _index = 0;
+    bool _is_index = false;
+    char _inline[_inline_size + 1] = {};
+    std::string _long;
+
+public:
+    SelectorKey() = default;
+
+    SelectorKey(int index) : _index(index), _is_index(true) {}
+
+    SelectorKey(std::string_view name) : _size(name.size()) {
+        if (_size <= _inline_size) {
+            std::memcpy(_inline, name.data(), _size);
+        } else {
+            _long.assign(name.data(), name.size());
+        }
+    }
+
+    std::string_view Name() const {
+        return (_size <= _inline_size) ? std::string_view{_inline, _size}
+                                       : std::string_view{_long};
+    }
+
+    void Push(lua_State *l) const {
+        if (_is_index) {
+            lua_pushinteger(l, _index);
+        } else {
+            const std::string_view name = Name();
+            lua_pushlstring(l, name.data(), name.size());
+        }
+    }
+
+    void AppendTo(std::string &out) const {
+        if (_is_index) {
+            out += std::to_string(_index);
+        } else {
+            out += Name();
+        }
+    }
+};
+
+// The keys from the global table down to the table a Selector acts upon.
+// The first _inline_depth keys are stored inline, deeper paths spill to the
+// heap.
+class SelectorPath {
+public:
+    static constexpr std::size_t _inline_depth = 4;
+
+private:
+    std::array<SelectorKey, _inline_depth> _inline;
+    std::vector<SelectorKey> _spill;
+    std::size_t _size = 0;
+
+public:
+    void push_back(const SelectorKey &key) {
+        if (_size < _inline_depth) {
+            _inline[_size] = key;
+        } else {
+            _spill.push_back(key);
+        }
+        ++_size;
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    const SelectorKey &operator[](std::size_t i) const {
+        return (i < _inline_depth) ? _inline[i] : _spill[i - _inline_depth];
+    }
+};
+}
+}
@@ -27,6 +27,22 @@ public:
         _registry.reset(new Registry(_l));
         HandleExceptionsPrintingToStdOut();
     }
+    State(lua_Alloc alloc, void *ud, bool should_open_libs) : _l(nullptr), _l_owner(true), _exception_handler(new ExceptionHandler) {
+        _l = lua_newstate(alloc, ud);
+#ifdef SELENE_LUAJIT
+        // 64 bit LuaJIT without GC64 only runs with its own allocator
+        if (_l == nullptr) _l = luaL_newstate();
+#endif
+        if (_l == nullptr) throw 0;
+        lua_atpanic(_l, [](lua_State *l) -> int {
+            std::cerr << "PANIC: unprotected error in call to Lua API ("
+                      << (lua_tostring(l, -1) ? lua_tostring(l, -1) : "?") << ")" << std::endl;
+            return 0;
+        });
+        if (should_open_libs) luaL_openlibs(_l);
+        _registry.reset(new Registry(_l));
+        HandleExceptionsPrintingToStdOut();
+    }
     State(lua_State *l) : _l(l), _l_owner(false), _exception_handler(new ExceptionHandler) {
         _registry.reset(new Registry(_l));
         HandleExceptionsPrintingToStdOut();
@@ -125,6 +141,10 @@ public:
         lua_gc(_l, LUA_GCCOLLECT, 0);
     }
 
+    lua_State *GetLuaState() const {
+        return _l;
+    }
+
     void InteractiveDebug() {
         luaL_dostring(_l, "debug.debug()");
     }
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "BaseFun.h"
+#include "primitives.h"
+#include <type_traits>
+#include <utility>
+
+/* Compile-time registration of functions: sel::trampoline<&f> is a plain
+ * lua_CFunction, which reads the arguments of f straight from the Lua stack
+ * and pushes its result. Unlike the functions registered through sel::Fun,
+ * there is no std::function, no argument tuple and no BaseFun object per
+ * function. With sel::bound_trampoline<&f>, the first parameter of f is a
+ * pointer taken from the first upvalue of the closure, see
+ * Selector::SetClosure(). */
+
+namespace sel {
+namespace detail {
+
+template <typename Ret, typename... Args, std::size_t... N, typename Fun>
+inline int _invoke_from_stack(lua_State *l, Fun &&fun, int first, _indices<N...>) {
+    if constexpr (std::is_void<Ret>::value) {
+        fun(_check_get(_id<decay_primitive<Args>>{}, l, first + int(N))...);
+        return 0;
+    } else {
+        _push(l, fun(_check_get(_id<decay_primitive<Args>>{}, l, first + int(N))...));
+        return 1;
+    }
+}
+
+template <auto F, typename Sig = decltype(F)>
+struct _trampoline;
+
+template <auto F, typename Ret, typename... Args, bool NoExcept>
+struct _trampoline<F, Ret (*)(Args...) noexcept(NoExcept)> {
+    static int call(lua_State *l) {
+        return _protected_call(l, [l]() {
+            return _invoke_from_stack<Ret, Args...>(
+                l, F, 1, typename _indices_builder<sizeof...(Args)>::type());
+        });
+    }
+};
+
+template <auto F, typename Sig = decltype(F)>
+struct _bound_trampoline;
+
+template <auto F, typename Ret, typename Ctx, typename... Args, bool NoExcept>
+struct _bound_trampoline<F, Ret (*)(Ctx *, Args...) noexcept(NoExcept)> {
+    static int call(lua_State *l) {
+        Ctx *ctx = static_cast<Ctx *>(lua_touserdata(l, lua_upvalueindex(1)));
+        return _protected_call(l, [l, ctx]() {
+            return _invoke_from_stack<Ret, Args...>(
+                l, [ctx](auto&&... args) { return F(ctx, std::forward<decltype(args)>(args)...); },
+                1, typename _indices_builder<sizeof...(Args)>::type());
+        });
+    }
+};
+}
+
+template <auto F>
+constexpr lua_CFunction trampoline = &detail::_trampoline<F>::call;
+
+template <auto F>
+constexpr lua_CFunction bound_trampoline = &detail::_bound_trampoline<F>::call;
+}
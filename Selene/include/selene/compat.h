@@ -0,0 +1,67 @@
+#pragma once
+
+/* Includes the C API of the Lua backend: Lua 5.2 and later, or LuaJIT 2.1
+ * (which reports LUA_VERSION_NUM 501). LuaJIT 2.1 already provides most of
+ * the Lua 5.2 API (luaL_setfuncs, luaL_testudata, lua_copy, lua_tointegerx,
+ * luaL_loadbufferx, ...), the remaining functions used by Selene and the
+ * simulator are filled in below. */
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#ifdef LUA_JITLIBNAME
+#include <luajit.h>
+#endif
+}
+
+#ifdef LUAJIT_VERSION
+#define SELENE_LUAJIT 1
+#endif
+
+#if LUA_VERSION_NUM < 502
+
+#ifndef LUA_OK
+#define LUA_OK 0
+#endif
+
+#ifndef luaL_newlib
+#define luaL_newlib(L, l) (lua_newtable(L), luaL_setfuncs(L, l, 0))
+#endif
+
+inline int lua_absindex(lua_State *l, int idx) {
+    return (idx > 0 || idx <= LUA_REGISTRYINDEX) ? idx : lua_gettop(l) + idx + 1;
+}
+
+inline void lua_pushglobaltable(lua_State *l) {
+    lua_pushvalue(l, LUA_GLOBALSINDEX);
+}
+
+inline void lua_rawgetp(lua_State *l, int idx, const void *p) {
+    idx = lua_absindex(l, idx);
+    lua_pushlightuserdata(l, const_cast<void *>(p));
+    lua_rawget(l, idx);
+}
+
+inline void lua_rawsetp(lua_State *l, int idx, const void *p) {
+    idx = lua_absindex(l, idx);
+    lua_pushlightuserdata(l, const_cast<void *>(p));
+    lua_insert(l, -2);
+    lua_rawset(l, idx);
+}
+
+inline void luaL_requiref(lua_State *l, const char *modname, lua_CFunction openf, int glb) {
+    lua_pushcfunction(l, openf);
+    lua_pushstring(l, modname);
+    lua_call(l, 1, 1);
+    luaL_findtable(l, LUA_REGISTRYINDEX, "_LOADED", 16);
+    lua_pushvalue(l, -2);
+    lua_setfield(l, -2, modname);
+    lua_pop(l, 1);
+    if (glb) {
+        lua_pushvalue(l, -1);
+        lua_setglobal(l, modname);
+    }
+}
+
+#endif
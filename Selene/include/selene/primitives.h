@@ -2,15 +2,12 @@
 
 #include "ExceptionTypes.h"
 #include <string>
+#include <string_view>
 #include "traits.h"
 #include <type_traits>
 #include "MetatableRegistry.h"
 
-extern "C" {
-#include <lua.h>
-#include <lauxlib.h>
-#include <lualib.h>
-}
+#include "compat.h"
 
 /* The purpose of this header is to handle pushing and retrieving
  * primitives from the stack
@@ -44,6 +41,10 @@ template <>
 struct is_primitive<std::string> {
     static constexpr bool value = true;
 };
+template <>
+struct is_primitive<std::string_view> {
+    static constexpr bool value = true;
+};
 
 template<typename T>
 using decay_primitive =
@@ -112,6 +113,15 @@ inline std::string _get(_id<std::string>, lua_State *l, const int index) {
     return std::string{buff, size};
 }
 
+// The view points into the Lua string, it is only valid as long as the
+// string is referenced, e.g. from a table or the stack. Numbers are converted
+// in place, the resulting string is referenced by the stack slot only.
+inline std::string_view _get(_id<std::string_view>, lua_State *l, const int index) {
+    size_t size = 0;
+    const char *buff = lua_tolstring(l, index, &size);
+    return std::string_view{buff, buff == nullptr ? 0 : size};
+}
+
 using _lua_check_get = void (*)(lua_State *l, int index);
 // Throw this on conversion errors to prevent long jumps caused in Lua from
 // bypassing destructors. The outermost function can then call checkd_get(index)
@@ -161,7 +171,7 @@ inline T _check_get(_id<T&&>, lua_State *l, const int index) {
 
 
 inline int _check_get(_id<int>, lua_State *l, const int index) {
-#if LUA_VERSION_NUM >= 502
+#if LUA_VERSION_NUM >= 502 || defined(SELENE_LUAJIT)
     int isNum = 0;
     auto res = static_cast<int>(lua_tointegerx(l, index, &isNum));
     if(!isNum){
@@ -182,7 +192,7 @@ inline int _check_get(_id<int>, lua_State *l, const int index) {
 
 inline unsigned int _check_get(_id<unsigned int>, lua_State *l, const int index) {
     int isNum = 0;
-#if LUA_VERSION_NUM >= 503
+#if LUA_VERSION_NUM >= 503 || defined(SELENE_LUAJIT)
     auto res = static_cast<unsigned>(lua_tointegerx(l, index, &isNum));
     if(!isNum) {
         throw GetParameterFromLuaTypeError{
@@ -232,6 +242,18 @@ inline std::string _check_get(_id<std::string>, lua_State *l, const int index) {
     return std::string{buff, size};
 }
 
+inline std::string_view _check_get(_id<std::string_view>, lua_State *l, const int index) {
+    size_t size = 0;
+    char const * buff = lua_tolstring(l, index, &size);
+    if(buff == nullptr) {
+        throw GetParameterFromLuaTypeError{
+            [](lua_State *l, int index){luaL_checkstring(l, index);},
+            index
+        };
+    }
+    return std::string_view{buff, size};
+}
+
 // Worker type-trait struct to _get_n
 // Getting multiple elements returns a tuple
 template <typename... Ts>
@@ -326,7 +348,7 @@ inline void _push(lua_State *l, int i) {
 }
 
 inline void _push(lua_State *l, unsigned int u) {
-#if LUA_VERSION_NUM >= 503
+#if LUA_VERSION_NUM >= 503 || defined(SELENE_LUAJIT)
   lua_pushinteger(l, (lua_Integer)u);
 #elif LUA_VERSION_NUM >= 502
     lua_pushunsigned(l, u);
@@ -343,6 +365,10 @@ inline void _push(lua_State *l, const std::string &s) {
     lua_pushlstring(l, s.c_str(), s.size());
 }
 
+inline void _push(lua_State *l, std::string_view s) {
+    lua_pushlstring(l, s.data(), s.size());
+}
+
 inline void _push(lua_State *l, const char *s) {
     lua_pushstring(l, s);
 }
@@ -4,11 +4,7 @@
 #include <iostream>
 #include <utility>
 
-extern "C" {
-#include <lua.h>
-#include <lauxlib.h>
-#include <lualib.h>
-}
+#include "compat.h"
 
 namespace sel {
 inline std::ostream &operator<<(std::ostream &os, lua_State *l) {
@@ -85,8 +81,23 @@ inline int ErrorHandler(lua_State *L) {
     return Traceback(L);
 }
 
+// Registry key of the error handler under Lua 5.1 and LuaJIT, where every
+// lua_pushcfunction creates a new closure. Since Lua 5.2 the handler is a
+// light C function, pushing it does not allocate.
+inline const char _error_handler_key = 0;
+
 inline int SetErrorHandler(lua_State *L) {
+#if LUA_VERSION_NUM >= 502
     lua_pushcfunction(L, &ErrorHandler);
+#else
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &_error_handler_key);
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        lua_pushcfunction(L, &ErrorHandler);
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, LUA_REGISTRYINDEX, &_error_handler_key);
+    }
+#endif
     return lua_gettop(L);
 }
 
@@ -118,6 +118,15 @@ static TestMap tests = {
     {"test_selector_get_wrong_ref_to_table", test_selector_get_wrong_ref_to_table},
     {"test_selector_get_wrong_ref_to_unregistered", test_selector_get_wrong_ref_to_unregistered},
     {"test_selector_get_wrong_ptr", test_selector_get_wrong_ptr},
+    {"test_selector_get_string_view", test_selector_get_string_view},
+    {"test_selector_get_string_view_from_call", test_selector_get_string_view_from_call},
+    {"test_selector_get_string_view_from_number", test_selector_get_string_view_from_number},
+    {"test_selector_deep_traversal", test_selector_deep_traversal},
+    {"test_selector_long_key", test_selector_long_key},
+    {"test_prepared_call", test_prepared_call},
+    {"test_prepared_call_of_non_function", test_prepared_call_of_non_function},
+    {"test_prepared_call_refers", test_prepared_call_refers},
+    {"test_prepared_call_error", test_prepared_call_error},
 
     {"test_register_class", test_register_class},
     {"test_get_member_variable", test_get_member_variable},
@@ -307,3 +307,70 @@ bool test_selector_get_wrong_ptr(sel::State &state) {
     SelectorFoo * foo = state["bar"];
     return foo == nullptr;
 }
+
+bool test_selector_get_string_view(sel::State &state) {
+    state.Load("../test/test.lua");
+    std::string_view answer = state["my_table"]["nested"]["foo"];
+    return answer == "bar";
+}
+
+bool test_selector_get_string_view_from_call(sel::State &state) {
+    state("function concat(a, b) return a .. b end");
+    std::string_view answer = state["concat"]("ba", "r");
+    state("collectgarbage()");
+    return answer == "bar";
+}
+
+bool test_selector_get_string_view_from_number(sel::State &state) {
+    state.Load("../test/test.lua");
+    std::string_view answer = state["my_global"];
+    state("collectgarbage()");
+    return answer == "4";
+}
+
+bool test_selector_deep_traversal(sel::State &state) {
+    state["a"]["b"]["c"]["d"]["e"]["f"] = "deep";
+    state("x = a.b.c.d.e.f");
+    return state["x"] == "deep" && state["a"]["b"]["c"]["d"]["e"]["f"] == "deep";
+}
+
+bool test_selector_long_key(sel::State &state) {
+    const std::string key(100, 'k');
+    state["t"][key] = 7;
+    state(("n = t['" + key + "']").c_str());
+    return state["n"] == 7;
+}
+
+bool test_prepared_call(sel::State &state) {
+    state.Load("../test/test.lua");
+    sel::PreparedCall add = state["add"].Prepare();
+    return add && add.Call<int>(5, 2) == 7 && add.Call<int>(1, 1) == 2;
+}
+
+bool test_prepared_call_of_non_function(sel::State &state) {
+    state.Load("../test/test.lua");
+    return !state["my_global"].Prepare();
+}
+
+bool test_prepared_call_refers(sel::State &state) {
+    state("function f() end function g() end");
+    sel::PreparedCall f = state["f"].Prepare();
+    lua_State *l = state.GetLuaState();
+    const int top = lua_gettop(l);
+    lua_getglobal(l, "f");
+    lua_getglobal(l, "g");
+    const bool refers = f.Refers(-2) && !f.Refers(-1);
+    lua_settop(l, top);
+    return refers;
+}
+
+bool test_prepared_call_error(sel::State &state) {
+    state("function fail() error('failed') end");
+    sel::PreparedCall fail = state["fail"].Prepare();
+    const int top = lua_gettop(state.GetLuaState());
+    const bool failed = fail.Invoke(1) != LUA_OK;
+    const std::string message = lua_tostring(state.GetLuaState(), -1);
+    lua_settop(state.GetLuaState(), top);
+    return failed && message.find("failed") != std::string::npos
+        && message.find("traceback") != std::string::npos;
+}
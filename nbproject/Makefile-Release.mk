@@ -45,7 +45,29 @@ OBJECTFILES= \
 	${OBJECTDIR}/src/session_controller.o \
 	${OBJECTDIR}/src/uds_receiver.o \
 	${OBJECTDIR}/src/utilities.o \
-	${OBJECTDIR}/src/j1939_simulator.o
+	${OBJECTDIR}/src/j1939_simulator.o \
+	${OBJECTDIR}/src/dtc_store.o \
+	${OBJECTDIR}/src/did_store.o \
+	${OBJECTDIR}/src/timer_service.o \
+	${OBJECTDIR}/src/metrics.o \
+	${OBJECTDIR}/src/worker_pool.o \
+	${OBJECTDIR}/src/routine_controller.o \
+	${OBJECTDIR}/src/security_algorithm.o \
+	${OBJECTDIR}/src/security_manager.o \
+	${OBJECTDIR}/src/communication_control.o \
+	${OBJECTDIR}/src/lua_snapshot.o \
+	${OBJECTDIR}/src/uds_request.o \
+	${OBJECTDIR}/src/request_arena.o \
+	${OBJECTDIR}/src/lua_bytes.o \
+	${OBJECTDIR}/src/script_slot.o \
+	${OBJECTDIR}/src/config_watcher.o \
+	${OBJECTDIR}/src/lua_chunk_cache.o \
+	${OBJECTDIR}/src/lua_allocator.o \
+	${OBJECTDIR}/src/lua_libraries.o \
+	${OBJECTDIR}/src/lua_collector.o \
+	${OBJECTDIR}/src/lua_budget.o \
+	${OBJECTDIR}/src/static_entries.o \
+	${OBJECTDIR}/src/static_tables.o
 
 
 # Test Directory
@@ -57,7 +79,23 @@ TESTFILES= \
 	${TESTDIR}/TestFiles/f4 \
 	${TESTDIR}/TestFiles/f5 \
 	${TESTDIR}/TestFiles/f6 \
-	${TESTDIR}/TestFiles/f1
+	${TESTDIR}/TestFiles/f1 \
+	${TESTDIR}/TestFiles/f7 \
+	${TESTDIR}/TestFiles/f8 \
+	${TESTDIR}/TestFiles/f9 \
+	${TESTDIR}/TestFiles/f10 \
+	${TESTDIR}/TestFiles/f11 \
+	${TESTDIR}/TestFiles/f12 \
+	${TESTDIR}/TestFiles/f13 \
+	${TESTDIR}/TestFiles/f14 \
+	${TESTDIR}/TestFiles/f15 \
+	${TESTDIR}/TestFiles/f16 \
+	${TESTDIR}/TestFiles/f17 \
+	${TESTDIR}/TestFiles/f18 \
+	${TESTDIR}/TestFiles/f19 \
+	${TESTDIR}/TestFiles/f20 \
+	${TESTDIR}/TestFiles/f21 \
+	${TESTDIR}/TestFiles/f22
 
 # Test Object Files
 TESTOBJECTFILES= \
@@ -70,7 +108,39 @@ TESTOBJECTFILES= \
 	${TESTDIR}/tests/uds_receiver_test.o \
 	${TESTDIR}/tests/uds_receiver_test_runner.o \
 	${TESTDIR}/tests/utils_test.o \
-	${TESTDIR}/tests/utils_test_runner.o
+	${TESTDIR}/tests/utils_test_runner.o \
+	${TESTDIR}/tests/dtc_store_test.o \
+	${TESTDIR}/tests/dtc_store_test_runner.o \
+	${TESTDIR}/tests/did_store_test.o \
+	${TESTDIR}/tests/did_store_test_runner.o \
+	${TESTDIR}/tests/timer_service_test.o \
+	${TESTDIR}/tests/timer_service_test_runner.o \
+	${TESTDIR}/tests/routine_controller_test.o \
+	${TESTDIR}/tests/routine_controller_test_runner.o \
+	${TESTDIR}/tests/security_manager_test.o \
+	${TESTDIR}/tests/security_manager_test_runner.o \
+	${TESTDIR}/tests/communication_control_test.o \
+	${TESTDIR}/tests/communication_control_test_runner.o \
+	${TESTDIR}/tests/uds_request_test.o \
+	${TESTDIR}/tests/uds_request_test_runner.o \
+	${TESTDIR}/tests/request_arena_test.o \
+	${TESTDIR}/tests/request_arena_test_runner.o \
+	${TESTDIR}/tests/script_slot_test.o \
+	${TESTDIR}/tests/script_slot_test_runner.o \
+	${TESTDIR}/tests/lua_chunk_cache_test.o \
+	${TESTDIR}/tests/lua_chunk_cache_test_runner.o \
+	${TESTDIR}/tests/lua_allocator_test.o \
+	${TESTDIR}/tests/lua_allocator_test_runner.o \
+	${TESTDIR}/tests/lua_libraries_test.o \
+	${TESTDIR}/tests/lua_libraries_test_runner.o \
+	${TESTDIR}/tests/lua_collector_test.o \
+	${TESTDIR}/tests/lua_collector_test_runner.o \
+	${TESTDIR}/tests/lua_budget_test.o \
+	${TESTDIR}/tests/lua_budget_test_runner.o \
+	${TESTDIR}/tests/handler_benchmark_test.o \
+	${TESTDIR}/tests/handler_benchmark_test_runner.o \
+	${TESTDIR}/tests/static_entries_test.o \
+	${TESTDIR}/tests/static_entries_test_runner.o
 
 # C Compiler Flags
 CFLAGS=
@@ -85,8 +155,11 @@ FFLAGS=
 # Assembler Flags
 ASFLAGS=
 
+# Lua backend (pkg-config package), e.g. `make LUA_PKG=luajit` for LuaJIT
+LUA_PKG?=lua5.2
+
 # Link Libraries and Options
-LDLIBSOPTIONS=`pkg-config --libs lua-5.2`  `pkg-config --libs libsocketcan` -lstdc++fs 
+LDLIBSOPTIONS=`pkg-config --libs ${LUA_PKG}`  `pkg-config --libs libsocketcan` -lstdc++fs -ldl 
 
 # Build Targets
 .build-conf: ${BUILD_SUBPROJECTS}
@@ -99,57 +172,167 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/amos-ss17-proj4: ${OBJECTFILES}
 ${OBJECTDIR}/src/broadcast_receiver.o: src/broadcast_receiver.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/broadcast_receiver.o src/broadcast_receiver.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/broadcast_receiver.o src/broadcast_receiver.cpp
 
 ${OBJECTDIR}/src/ecu_lua_script.o: src/ecu_lua_script.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_lua_script.o src/ecu_lua_script.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_lua_script.o src/ecu_lua_script.cpp
 
 ${OBJECTDIR}/src/ecu_timer.o: src/ecu_timer.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_timer.o src/ecu_timer.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_timer.o src/ecu_timer.cpp
 
 ${OBJECTDIR}/src/electronic_control_unit.o: src/electronic_control_unit.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/electronic_control_unit.o src/electronic_control_unit.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/electronic_control_unit.o src/electronic_control_unit.cpp
 
 ${OBJECTDIR}/src/isotp_receiver.o: src/isotp_receiver.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_receiver.o src/isotp_receiver.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_receiver.o src/isotp_receiver.cpp
 
 ${OBJECTDIR}/src/isotp_sender.o: src/isotp_sender.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_sender.o src/isotp_sender.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_sender.o src/isotp_sender.cpp
 
 ${OBJECTDIR}/src/main.o: src/main.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/main.o src/main.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/main.o src/main.cpp
 
 ${OBJECTDIR}/src/session_controller.o: src/session_controller.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/session_controller.o src/session_controller.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/session_controller.o src/session_controller.cpp
 
 ${OBJECTDIR}/src/uds_receiver.o: src/uds_receiver.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/uds_receiver.o src/uds_receiver.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/uds_receiver.o src/uds_receiver.cpp
 
 ${OBJECTDIR}/src/utilities.o: src/utilities.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utilities.o src/utilities.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utilities.o src/utilities.cpp
 
 ${OBJECTDIR}/src/j1939_simulator.o: src/j1939_simulator.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/j1939_simulator.o src/j1939_simulator.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/j1939_simulator.o src/j1939_simulator.cpp
+
+${OBJECTDIR}/src/dtc_store.o: src/dtc_store.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/dtc_store.o src/dtc_store.cpp
+
+${OBJECTDIR}/src/did_store.o: src/did_store.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/did_store.o src/did_store.cpp
+
+${OBJECTDIR}/src/timer_service.o: src/timer_service.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/timer_service.o src/timer_service.cpp
+
+${OBJECTDIR}/src/metrics.o: src/metrics.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/metrics.o src/metrics.cpp
+
+${OBJECTDIR}/src/worker_pool.o: src/worker_pool.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/worker_pool.o src/worker_pool.cpp
+
+${OBJECTDIR}/src/routine_controller.o: src/routine_controller.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/routine_controller.o src/routine_controller.cpp
+
+${OBJECTDIR}/src/security_algorithm.o: src/security_algorithm.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/security_algorithm.o src/security_algorithm.cpp
+
+${OBJECTDIR}/src/security_manager.o: src/security_manager.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/security_manager.o src/security_manager.cpp
+
+${OBJECTDIR}/src/communication_control.o: src/communication_control.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/communication_control.o src/communication_control.cpp
+
+${OBJECTDIR}/src/lua_snapshot.o: src/lua_snapshot.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_snapshot.o src/lua_snapshot.cpp
+
+${OBJECTDIR}/src/uds_request.o: src/uds_request.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/uds_request.o src/uds_request.cpp
+
+${OBJECTDIR}/src/request_arena.o: src/request_arena.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/request_arena.o src/request_arena.cpp
+
+${OBJECTDIR}/src/lua_bytes.o: src/lua_bytes.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_bytes.o src/lua_bytes.cpp
+
+${OBJECTDIR}/src/script_slot.o: src/script_slot.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/script_slot.o src/script_slot.cpp
+
+${OBJECTDIR}/src/config_watcher.o: src/config_watcher.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/config_watcher.o src/config_watcher.cpp
+
+${OBJECTDIR}/src/lua_chunk_cache.o: src/lua_chunk_cache.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_chunk_cache.o src/lua_chunk_cache.cpp
+
+${OBJECTDIR}/src/lua_allocator.o: src/lua_allocator.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_allocator.o src/lua_allocator.cpp
+
+${OBJECTDIR}/src/lua_libraries.o: src/lua_libraries.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_libraries.o src/lua_libraries.cpp
+
+${OBJECTDIR}/src/lua_collector.o: src/lua_collector.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_collector.o src/lua_collector.cpp
+
+${OBJECTDIR}/src/lua_budget.o: src/lua_budget.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_budget.o src/lua_budget.cpp
+
+${OBJECTDIR}/src/static_entries.o: src/static_entries.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/static_entries.o src/static_entries.cpp
+
+${OBJECTDIR}/src/static_tables.o: src/static_tables.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/static_tables.o src/static_tables.cpp
 
 
 # Subprojects
@@ -179,65 +362,321 @@ ${TESTDIR}/TestFiles/f1: ${TESTDIR}/tests/utils_test.o ${TESTDIR}/tests/utils_te
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f1 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
 
+${TESTDIR}/TestFiles/f7: ${TESTDIR}/tests/dtc_store_test.o ${TESTDIR}/tests/dtc_store_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f7 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f8: ${TESTDIR}/tests/did_store_test.o ${TESTDIR}/tests/did_store_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f8 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f9: ${TESTDIR}/tests/timer_service_test.o ${TESTDIR}/tests/timer_service_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f9 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f10: ${TESTDIR}/tests/routine_controller_test.o ${TESTDIR}/tests/routine_controller_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f10 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f11: ${TESTDIR}/tests/security_manager_test.o ${TESTDIR}/tests/security_manager_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f11 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f12: ${TESTDIR}/tests/communication_control_test.o ${TESTDIR}/tests/communication_control_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f12 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f13: ${TESTDIR}/tests/uds_request_test.o ${TESTDIR}/tests/uds_request_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f13 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f14: ${TESTDIR}/tests/request_arena_test.o ${TESTDIR}/tests/request_arena_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f14 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f15: ${TESTDIR}/tests/script_slot_test.o ${TESTDIR}/tests/script_slot_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f15 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f16: ${TESTDIR}/tests/lua_chunk_cache_test.o ${TESTDIR}/tests/lua_chunk_cache_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f16 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f17: ${TESTDIR}/tests/lua_allocator_test.o ${TESTDIR}/tests/lua_allocator_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f17 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f18: ${TESTDIR}/tests/lua_libraries_test.o ${TESTDIR}/tests/lua_libraries_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f18 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f19: ${TESTDIR}/tests/lua_collector_test.o ${TESTDIR}/tests/lua_collector_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f19 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f20: ${TESTDIR}/tests/lua_budget_test.o ${TESTDIR}/tests/lua_budget_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f20 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f21: ${TESTDIR}/tests/handler_benchmark_test.o ${TESTDIR}/tests/handler_benchmark_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f21 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
+${TESTDIR}/TestFiles/f22: ${TESTDIR}/tests/static_entries_test.o ${TESTDIR}/tests/static_entries_test_runner.o ${OBJECTFILES:%.o=%_nomain.o}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/f22 $^ ${LDLIBSOPTIONS}   `cppunit-config --libs`   
+
 
 ${TESTDIR}/tests/ecu_lua_script_test.o: tests/ecu_lua_script_test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/ecu_lua_script_test.o tests/ecu_lua_script_test.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/ecu_lua_script_test.o tests/ecu_lua_script_test.cpp
 
 
 ${TESTDIR}/tests/ecu_lua_script_test_runner.o: tests/ecu_lua_script_test_runner.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/ecu_lua_script_test_runner.o tests/ecu_lua_script_test_runner.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/ecu_lua_script_test_runner.o tests/ecu_lua_script_test_runner.cpp
 
 
 ${TESTDIR}/tests/electronic_control_unit_test.o: tests/electronic_control_unit_test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/electronic_control_unit_test.o tests/electronic_control_unit_test.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/electronic_control_unit_test.o tests/electronic_control_unit_test.cpp
 
 
 ${TESTDIR}/tests/electronic_control_unit_test_runner.o: tests/electronic_control_unit_test_runner.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/electronic_control_unit_test_runner.o tests/electronic_control_unit_test_runner.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/electronic_control_unit_test_runner.o tests/electronic_control_unit_test_runner.cpp
 
 
 ${TESTDIR}/tests/isotp_sender_test.o: tests/isotp_sender_test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/isotp_sender_test.o tests/isotp_sender_test.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/isotp_sender_test.o tests/isotp_sender_test.cpp
 
 
 ${TESTDIR}/tests/isotp_sender_test_runner.o: tests/isotp_sender_test_runner.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/isotp_sender_test_runner.o tests/isotp_sender_test_runner.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/isotp_sender_test_runner.o tests/isotp_sender_test_runner.cpp
 
 
 ${TESTDIR}/tests/uds_receiver_test.o: tests/uds_receiver_test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/uds_receiver_test.o tests/uds_receiver_test.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/uds_receiver_test.o tests/uds_receiver_test.cpp
 
 
 ${TESTDIR}/tests/uds_receiver_test_runner.o: tests/uds_receiver_test_runner.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/uds_receiver_test_runner.o tests/uds_receiver_test_runner.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/uds_receiver_test_runner.o tests/uds_receiver_test_runner.cpp
 
 
 ${TESTDIR}/tests/utils_test.o: tests/utils_test.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/utils_test.o tests/utils_test.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/utils_test.o tests/utils_test.cpp
 
 
 ${TESTDIR}/tests/utils_test_runner.o: tests/utils_test_runner.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
-	$(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include -Isrc `pkg-config --cflags lua-5.2` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/utils_test_runner.o tests/utils_test_runner.cpp
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/utils_test_runner.o tests/utils_test_runner.cpp
+
+
+${TESTDIR}/tests/dtc_store_test.o: tests/dtc_store_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/dtc_store_test.o tests/dtc_store_test.cpp
+
+
+${TESTDIR}/tests/dtc_store_test_runner.o: tests/dtc_store_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/dtc_store_test_runner.o tests/dtc_store_test_runner.cpp
+
+
+${TESTDIR}/tests/did_store_test.o: tests/did_store_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/did_store_test.o tests/did_store_test.cpp
+
+
+${TESTDIR}/tests/did_store_test_runner.o: tests/did_store_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/did_store_test_runner.o tests/did_store_test_runner.cpp
+
+
+${TESTDIR}/tests/timer_service_test.o: tests/timer_service_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/timer_service_test.o tests/timer_service_test.cpp
+
+
+${TESTDIR}/tests/timer_service_test_runner.o: tests/timer_service_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/timer_service_test_runner.o tests/timer_service_test_runner.cpp
+
+
+${TESTDIR}/tests/routine_controller_test.o: tests/routine_controller_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/routine_controller_test.o tests/routine_controller_test.cpp
+
+
+${TESTDIR}/tests/routine_controller_test_runner.o: tests/routine_controller_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/routine_controller_test_runner.o tests/routine_controller_test_runner.cpp
+
+
+${TESTDIR}/tests/security_manager_test.o: tests/security_manager_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/security_manager_test.o tests/security_manager_test.cpp
+
+
+${TESTDIR}/tests/security_manager_test_runner.o: tests/security_manager_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/security_manager_test_runner.o tests/security_manager_test_runner.cpp
+
+
+${TESTDIR}/tests/communication_control_test.o: tests/communication_control_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/communication_control_test.o tests/communication_control_test.cpp
+
+
+${TESTDIR}/tests/communication_control_test_runner.o: tests/communication_control_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/communication_control_test_runner.o tests/communication_control_test_runner.cpp
+
+
+${TESTDIR}/tests/uds_request_test.o: tests/uds_request_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/uds_request_test.o tests/uds_request_test.cpp
+
+
+${TESTDIR}/tests/uds_request_test_runner.o: tests/uds_request_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/uds_request_test_runner.o tests/uds_request_test_runner.cpp
+
+
+${TESTDIR}/tests/request_arena_test.o: tests/request_arena_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/request_arena_test.o tests/request_arena_test.cpp
+
+
+${TESTDIR}/tests/request_arena_test_runner.o: tests/request_arena_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/request_arena_test_runner.o tests/request_arena_test_runner.cpp
+
+
+${TESTDIR}/tests/script_slot_test.o: tests/script_slot_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/script_slot_test.o tests/script_slot_test.cpp
+
+
+${TESTDIR}/tests/script_slot_test_runner.o: tests/script_slot_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/script_slot_test_runner.o tests/script_slot_test_runner.cpp
+
+
+${TESTDIR}/tests/lua_chunk_cache_test.o: tests/lua_chunk_cache_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_chunk_cache_test.o tests/lua_chunk_cache_test.cpp
+
+
+${TESTDIR}/tests/lua_chunk_cache_test_runner.o: tests/lua_chunk_cache_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_chunk_cache_test_runner.o tests/lua_chunk_cache_test_runner.cpp
+
+
+${TESTDIR}/tests/lua_allocator_test.o: tests/lua_allocator_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_allocator_test.o tests/lua_allocator_test.cpp
+
+
+${TESTDIR}/tests/lua_allocator_test_runner.o: tests/lua_allocator_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_allocator_test_runner.o tests/lua_allocator_test_runner.cpp
+
+
+${TESTDIR}/tests/lua_libraries_test.o: tests/lua_libraries_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_libraries_test.o tests/lua_libraries_test.cpp
+
+
+${TESTDIR}/tests/lua_libraries_test_runner.o: tests/lua_libraries_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_libraries_test_runner.o tests/lua_libraries_test_runner.cpp
+
+
+${TESTDIR}/tests/lua_collector_test.o: tests/lua_collector_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_collector_test.o tests/lua_collector_test.cpp
+
+
+${TESTDIR}/tests/lua_collector_test_runner.o: tests/lua_collector_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_collector_test_runner.o tests/lua_collector_test_runner.cpp
+
+
+${TESTDIR}/tests/lua_budget_test.o: tests/lua_budget_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_budget_test.o tests/lua_budget_test.cpp
+
+
+${TESTDIR}/tests/lua_budget_test_runner.o: tests/lua_budget_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/lua_budget_test_runner.o tests/lua_budget_test_runner.cpp
+
+
+${TESTDIR}/tests/handler_benchmark_test.o: tests/handler_benchmark_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/handler_benchmark_test.o tests/handler_benchmark_test.cpp
+
+
+${TESTDIR}/tests/handler_benchmark_test_runner.o: tests/handler_benchmark_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/handler_benchmark_test_runner.o tests/handler_benchmark_test_runner.cpp
+
+
+${TESTDIR}/tests/static_entries_test.o: tests/static_entries_test.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/static_entries_test.o tests/static_entries_test.cpp
+
+
+${TESTDIR}/tests/static_entries_test_runner.o: tests/static_entries_test_runner.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include -Isrc `pkg-config --cflags ${LUA_PKG}` -std=c++17 `cppunit-config --cflags` -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/static_entries_test_runner.o tests/static_entries_test_runner.cpp
 
 
 ${OBJECTDIR}/src/broadcast_receiver_nomain.o: ${OBJECTDIR}/src/broadcast_receiver.o src/broadcast_receiver.cpp 
@@ -248,7 +687,7 @@ ${OBJECTDIR}/src/broadcast_receiver_nomain.o: ${OBJECTDIR}/src/broadcast_receive
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/broadcast_receiver_nomain.o src/broadcast_receiver.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/broadcast_receiver_nomain.o src/broadcast_receiver.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/broadcast_receiver.o ${OBJECTDIR}/src/broadcast_receiver_nomain.o;\
 	fi
@@ -261,7 +700,7 @@ ${OBJECTDIR}/src/ecu_lua_script_nomain.o: ${OBJECTDIR}/src/ecu_lua_script.o src/
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_lua_script_nomain.o src/ecu_lua_script.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_lua_script_nomain.o src/ecu_lua_script.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/ecu_lua_script.o ${OBJECTDIR}/src/ecu_lua_script_nomain.o;\
 	fi
@@ -274,7 +713,7 @@ ${OBJECTDIR}/src/ecu_timer_nomain.o: ${OBJECTDIR}/src/ecu_timer.o src/ecu_timer.
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_timer_nomain.o src/ecu_timer.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/ecu_timer_nomain.o src/ecu_timer.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/ecu_timer.o ${OBJECTDIR}/src/ecu_timer_nomain.o;\
 	fi
@@ -287,7 +726,7 @@ ${OBJECTDIR}/src/electronic_control_unit_nomain.o: ${OBJECTDIR}/src/electronic_c
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/electronic_control_unit_nomain.o src/electronic_control_unit.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/electronic_control_unit_nomain.o src/electronic_control_unit.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/electronic_control_unit.o ${OBJECTDIR}/src/electronic_control_unit_nomain.o;\
 	fi
@@ -300,7 +739,7 @@ ${OBJECTDIR}/src/isotp_receiver_nomain.o: ${OBJECTDIR}/src/isotp_receiver.o src/
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_receiver_nomain.o src/isotp_receiver.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_receiver_nomain.o src/isotp_receiver.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/isotp_receiver.o ${OBJECTDIR}/src/isotp_receiver_nomain.o;\
 	fi
@@ -313,7 +752,7 @@ ${OBJECTDIR}/src/isotp_sender_nomain.o: ${OBJECTDIR}/src/isotp_sender.o src/isot
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_sender_nomain.o src/isotp_sender.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/isotp_sender_nomain.o src/isotp_sender.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/isotp_sender.o ${OBJECTDIR}/src/isotp_sender_nomain.o;\
 	fi
@@ -326,7 +765,7 @@ ${OBJECTDIR}/src/main_nomain.o: ${OBJECTDIR}/src/main.o src/main.cpp
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/main_nomain.o src/main.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/main_nomain.o src/main.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/main.o ${OBJECTDIR}/src/main_nomain.o;\
 	fi
@@ -339,7 +778,7 @@ ${OBJECTDIR}/src/session_controller_nomain.o: ${OBJECTDIR}/src/session_controlle
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/session_controller_nomain.o src/session_controller.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/session_controller_nomain.o src/session_controller.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/session_controller.o ${OBJECTDIR}/src/session_controller_nomain.o;\
 	fi
@@ -352,7 +791,7 @@ ${OBJECTDIR}/src/uds_receiver_nomain.o: ${OBJECTDIR}/src/uds_receiver.o src/uds_
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/uds_receiver_nomain.o src/uds_receiver.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/uds_receiver_nomain.o src/uds_receiver.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/uds_receiver.o ${OBJECTDIR}/src/uds_receiver_nomain.o;\
 	fi
@@ -365,7 +804,7 @@ ${OBJECTDIR}/src/utilities_nomain.o: ${OBJECTDIR}/src/utilities.o src/utilities.
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utilities_nomain.o src/utilities.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utilities_nomain.o src/utilities.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/utilities.o ${OBJECTDIR}/src/utilities_nomain.o;\
 	fi
@@ -378,11 +817,297 @@ ${OBJECTDIR}/src/j1939_simulator_nomain.o: ${OBJECTDIR}/src/j1939_simulator.o sr
 	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
 	then  \
 	    ${RM} "$@.d";\
-	    $(COMPILE.cc) -O2 -I/usr/include/lua5.2 -ISelene/include `pkg-config --cflags lua-5.2` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/j1939_simulator_nomain.o src/j1939_simulator.cpp;\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/j1939_simulator_nomain.o src/j1939_simulator.cpp;\
 	else  \
 	    ${CP} ${OBJECTDIR}/src/j1939_simulator.o ${OBJECTDIR}/src/j1939_simulator_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/dtc_store_nomain.o: ${OBJECTDIR}/src/dtc_store.o src/dtc_store.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/dtc_store.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/dtc_store_nomain.o src/dtc_store.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/dtc_store.o ${OBJECTDIR}/src/dtc_store_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/did_store_nomain.o: ${OBJECTDIR}/src/did_store.o src/did_store.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/did_store.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/did_store_nomain.o src/did_store.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/did_store.o ${OBJECTDIR}/src/did_store_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/timer_service_nomain.o: ${OBJECTDIR}/src/timer_service.o src/timer_service.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/timer_service.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/timer_service_nomain.o src/timer_service.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/timer_service.o ${OBJECTDIR}/src/timer_service_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/metrics_nomain.o: ${OBJECTDIR}/src/metrics.o src/metrics.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/metrics.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/metrics_nomain.o src/metrics.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/metrics.o ${OBJECTDIR}/src/metrics_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/worker_pool_nomain.o: ${OBJECTDIR}/src/worker_pool.o src/worker_pool.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/worker_pool.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/worker_pool_nomain.o src/worker_pool.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/worker_pool.o ${OBJECTDIR}/src/worker_pool_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/routine_controller_nomain.o: ${OBJECTDIR}/src/routine_controller.o src/routine_controller.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/routine_controller.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/routine_controller_nomain.o src/routine_controller.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/routine_controller.o ${OBJECTDIR}/src/routine_controller_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/security_algorithm_nomain.o: ${OBJECTDIR}/src/security_algorithm.o src/security_algorithm.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/security_algorithm.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/security_algorithm_nomain.o src/security_algorithm.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/security_algorithm.o ${OBJECTDIR}/src/security_algorithm_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/security_manager_nomain.o: ${OBJECTDIR}/src/security_manager.o src/security_manager.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/security_manager.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/security_manager_nomain.o src/security_manager.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/security_manager.o ${OBJECTDIR}/src/security_manager_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/communication_control_nomain.o: ${OBJECTDIR}/src/communication_control.o src/communication_control.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/communication_control.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/communication_control_nomain.o src/communication_control.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/communication_control.o ${OBJECTDIR}/src/communication_control_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/lua_snapshot_nomain.o: ${OBJECTDIR}/src/lua_snapshot.o src/lua_snapshot.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/lua_snapshot.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_snapshot_nomain.o src/lua_snapshot.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/lua_snapshot.o ${OBJECTDIR}/src/lua_snapshot_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/uds_request_nomain.o: ${OBJECTDIR}/src/uds_request.o src/uds_request.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/uds_request.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/uds_request_nomain.o src/uds_request.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/uds_request.o ${OBJECTDIR}/src/uds_request_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/request_arena_nomain.o: ${OBJECTDIR}/src/request_arena.o src/request_arena.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/request_arena.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/request_arena_nomain.o src/request_arena.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/request_arena.o ${OBJECTDIR}/src/request_arena_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/lua_bytes_nomain.o: ${OBJECTDIR}/src/lua_bytes.o src/lua_bytes.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/lua_bytes.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_bytes_nomain.o src/lua_bytes.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/lua_bytes.o ${OBJECTDIR}/src/lua_bytes_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/script_slot_nomain.o: ${OBJECTDIR}/src/script_slot.o src/script_slot.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/script_slot.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/script_slot_nomain.o src/script_slot.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/script_slot.o ${OBJECTDIR}/src/script_slot_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/config_watcher_nomain.o: ${OBJECTDIR}/src/config_watcher.o src/config_watcher.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/config_watcher.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/config_watcher_nomain.o src/config_watcher.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/config_watcher.o ${OBJECTDIR}/src/config_watcher_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/lua_chunk_cache_nomain.o: ${OBJECTDIR}/src/lua_chunk_cache.o src/lua_chunk_cache.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/lua_chunk_cache.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_chunk_cache_nomain.o src/lua_chunk_cache.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/lua_chunk_cache.o ${OBJECTDIR}/src/lua_chunk_cache_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/lua_allocator_nomain.o: ${OBJECTDIR}/src/lua_allocator.o src/lua_allocator.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/lua_allocator.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_allocator_nomain.o src/lua_allocator.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/lua_allocator.o ${OBJECTDIR}/src/lua_allocator_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/lua_libraries_nomain.o: ${OBJECTDIR}/src/lua_libraries.o src/lua_libraries.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/lua_libraries.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_libraries_nomain.o src/lua_libraries.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/lua_libraries.o ${OBJECTDIR}/src/lua_libraries_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/lua_collector_nomain.o: ${OBJECTDIR}/src/lua_collector.o src/lua_collector.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/lua_collector.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_collector_nomain.o src/lua_collector.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/lua_collector.o ${OBJECTDIR}/src/lua_collector_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/lua_budget_nomain.o: ${OBJECTDIR}/src/lua_budget.o src/lua_budget.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/lua_budget.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/lua_budget_nomain.o src/lua_budget.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/lua_budget.o ${OBJECTDIR}/src/lua_budget_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/static_entries_nomain.o: ${OBJECTDIR}/src/static_entries.o src/static_entries.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/static_entries.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/static_entries_nomain.o src/static_entries.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/static_entries.o ${OBJECTDIR}/src/static_entries_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/static_tables_nomain.o: ${OBJECTDIR}/src/static_tables.o src/static_tables.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/static_tables.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -I/usr/include/${LUA_PKG} -ISelene/include `pkg-config --cflags ${LUA_PKG}` -std=c++17  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/static_tables_nomain.o src/static_tables.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/static_tables.o ${OBJECTDIR}/src/static_tables_nomain.o;\
+	fi
+
 # Run Test Targets
 .test-conf:
 	@if [ "${TEST}" = "" ]; \
@@ -392,6 +1117,22 @@ ${OBJECTDIR}/src/j1939_simulator_nomain.o: ${OBJECTDIR}/src/j1939_simulator.o sr
 	    ${TESTDIR}/TestFiles/f5 || true; \
 	    ${TESTDIR}/TestFiles/f6 || true; \
 	    ${TESTDIR}/TestFiles/f1 || true; \
+	    ${TESTDIR}/TestFiles/f7 || true; \
+	    ${TESTDIR}/TestFiles/f8 || true; \
+	    ${TESTDIR}/TestFiles/f9 || true; \
+	    ${TESTDIR}/TestFiles/f10 || true; \
+	    ${TESTDIR}/TestFiles/f11 || true; \
+	    ${TESTDIR}/TestFiles/f12 || true; \
+	    ${TESTDIR}/TestFiles/f13 || true; \
+	    ${TESTDIR}/TestFiles/f14 || true; \
+	    ${TESTDIR}/TestFiles/f15 || true; \
+	    ${TESTDIR}/TestFiles/f16 || true; \
+	    ${TESTDIR}/TestFiles/f17 || true; \
+	    ${TESTDIR}/TestFiles/f18 || true; \
+	    ${TESTDIR}/TestFiles/f19 || true; \
+	    ${TESTDIR}/TestFiles/f20 || true; \
+	    ${TESTDIR}/TestFiles/f21 || true; \
+	    ${TESTDIR}/TestFiles/f22 || true; \
 	else  \
 	    ./${TEST} || true; \
 	fi
@@ -2,25 +2,103 @@
  * @file broadcast_receiver.cpp
  * 
  * This file contains the broadcast receiver which handles messages like 
- * `TesterPresent`.
+ * `TesterPresent` and forwards all other functional requests to the ECUs on
+ * the same interface.
  */
 
 #include "broadcast_receiver.h"
 #include "service_identifier.h"
+#include "worker_pool.h"
+#include "metrics.h"
 #include <iostream>
+#include <algorithm>
+#include <map>
+#include <deque>
+#include <chrono>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
 
 using namespace std;
 
-BroadcastReceiver::BroadcastReceiver(canid_t source,
-                                     const string& device,
-                                     UdsReceiver* pUdsRec)
+/// All functional receivers, one per CAN interface and functional address.
+static mutex registryMutex;
+static map<pair<string, canid_t>, weak_ptr<BroadcastReceiver>> registry;
+
+BroadcastReceiver::BroadcastReceiver(canid_t source, const string& device)
 : IsoTpReceiver(BROADCAST_ADDR, source, device)
-, pUdsReceiver_(pUdsRec)
 {
+    receiverThread_ = thread(&IsoTpReceiver::readData, this);
+}
+
+/**
+ * Destructor. Waits for the receiver thread.
+ */
+BroadcastReceiver::~BroadcastReceiver()
+{
+    if (receiverThread_.joinable())
+    {
+        receiverThread_.join();
+    }
+}
+
+/**
+ * Registers an ECU at the functional receiver of the interface. The receiver
+ * is created by the first ECU and shared by all further ECUs.
+ *
+ * @param source: the functional address (e.g. `0x7DF`)
+ * @param device: the CAN interface (e.g. "vcan0")
+ * @param pUdsRec: the UDS receiver of the ECU
+ * @return the shared functional receiver
+ * @see BroadcastReceiver::unsubscribe()
+ */
+shared_ptr<BroadcastReceiver> BroadcastReceiver::subscribe(canid_t source,
+                                                           const string& device,
+                                                           UdsReceiver* pUdsRec)
+{
+    const lock_guard<mutex> lock(registryMutex);
+    auto& entry = registry[make_pair(device, source)];
+    shared_ptr<BroadcastReceiver> pReceiver = entry.lock();
+    if (pReceiver == nullptr)
+    {
+        pReceiver = make_shared<BroadcastReceiver>(source, device);
+        entry = pReceiver;
+    }
+
+    const lock_guard<mutex> receiverLock(pReceiver->mutex_);
+    pReceiver->udsReceivers_.push_back(pUdsRec);
+    return pReceiver;
 }
 
 /**
- * Handles the broadcast messages (e.g. `TesterPresent`).
+ * Removes an ECU from the functional receiver. The socket is closed after the
+ * last ECU has been removed.
+ *
+ * @param pUdsRec: the UDS receiver of the ECU
+ */
+void BroadcastReceiver::unsubscribe(UdsReceiver* pUdsRec)
+{
+    const lock_guard<mutex> lock(registryMutex);
+    const lock_guard<mutex> receiverLock(mutex_);
+    udsReceivers_.erase(remove(udsReceivers_.begin(), udsReceivers_.end(), pUdsRec), udsReceivers_.end());
+    if (udsReceivers_.empty())
+    {
+        closeReceiver();
+        // a new ECU on this address has to open a new receiver
+        for (auto it = registry.begin(); it != registry.end(); ++it)
+        {
+            if (it->second.lock().get() == this)
+            {
+                registry.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Handles the broadcast messages. `TesterPresent` is handled directly for all
+ * ECUs without `Raw` entries for it, all other requests are fanned out.
  * 
  * @param buffer: the buffer of the UDS message
  * @param num_bytes: the number of transmitted data in bytes
@@ -28,26 +106,141 @@ BroadcastReceiver::BroadcastReceiver(canid_t source,
 void BroadcastReceiver::proceedReceivedData(const uint8_t* buffer,
                                             const size_t num_bytes) noexcept
 {
+    vector<UdsReceiver*> udsReceivers;
+    {
+        const lock_guard<mutex> lock(mutex_);
+        udsReceivers = udsReceivers_;
+    }
+
     switch (buffer[0])
     {
         case TESTER_PRESENT_REQ:
         {
-            if(buffer[1] == 0x80 && num_bytes >= 2)
+            // functional requests with an unsupported sub-function stay
+            // unanswered (ISO 14229-1)
+            if (num_bytes < 2
+                || (buffer[1] & ~SUPPRESS_POS_RSP_MSG_INDICATION_BIT) != TESTER_PRESENT_ZERO_SUB_FUNCTION)
+            {
+                break;
+            }
+            // ECUs with `Raw` entries for `TesterPresent` answer from their script
+            vector<UdsReceiver*> rawReceivers;
+            for (UdsReceiver* pUdsReceiver : udsReceivers)
             {
-                pUdsReceiver_->pSessionCtrl_->reset();
+                if (pUdsReceiver->pScriptSlot_->hasRawTesterPresent())
+                {
+                    rawReceivers.push_back(pUdsReceiver);
+                }
+                else
+                {
+                    pUdsReceiver->testerPresent(UdsRequest(buffer, num_bytes));
+                }
             }
-            else
+            if (!rawReceivers.empty())
             {
-                // -> beware of arrows ->
-                pUdsReceiver_->pSessionCtrl_->reset();
-                constexpr array<uint8_t, 1> tp = {TESTER_PRESENT_RES};
-                pUdsReceiver_->pIsoTpSender_->sendData(tp.data(), tp.size());
+                fanOut(rawReceivers, buffer, num_bytes);
             }
             break;
         }
         default:
         {
-            pUdsReceiver_->proceedReceivedData(buffer, num_bytes);
+            fanOut(udsReceivers, buffer, num_bytes);
         }
     }
 }
+
+/// Evaluation of a functional request, shared by `BroadcastReceiver::fanOut()` and its jobs.
+struct FanOutState
+{
+    using Responses = vector<vector<uint8_t>>;
+
+    vector<UdsReceiver*> udsReceivers;
+    const uint8_t* buffer;
+    size_t num_bytes;
+    atomic<size_t> next{0}; ///< index of the next ECU to evaluate
+    mutex doneMutex;
+    condition_variable doneCond;
+    deque<pair<UdsReceiver*, Responses>> done;
+};
+
+/**
+ * Evaluates a functional request by all ECUs in parallel on the worker pool.
+ * The responses are collected and sent by this thread in the order the ECUs
+ * finish, so the bus sees one controlled burst of responses instead of
+ * concurrent writes. The ECUs are taken one by one by the jobs and by this
+ * thread, which evaluates the ECUs left over while it waits, so the request
+ * never waits for a busy worker pool. The time from the reception until the
+ * last response has been sent is recorded as fan-out latency.
+ *
+ * @param udsReceivers: the receivers of all ECUs on the functional address
+ * @param buffer: the buffer of the UDS message
+ * @param num_bytes: the number of transmitted data in bytes
+ */
+void BroadcastReceiver::fanOut(const vector<UdsReceiver*>& udsReceivers,
+                               const uint8_t* buffer,
+                               const size_t num_bytes) noexcept
+{
+    static metrics::Histogram& fanOutTime = metrics::histogram("broadcast.fanout_time_us");
+    static metrics::Counter& numRequests = metrics::counter("broadcast.requests");
+    const auto start = chrono::steady_clock::now();
+    numRequests.increment();
+
+    // the state outlives this call, since a job may still be queued after all
+    // ECUs have been evaluated; such a job returns without an ECU, the request
+    // is only accessed while this thread waits for the taken ECUs
+    const auto pState = make_shared<FanOutState>();
+    pState->udsReceivers = udsReceivers;
+    pState->buffer = buffer;
+    pState->num_bytes = num_bytes;
+
+    // evaluates the next ECU, false if all ECUs have been taken
+    const auto evaluateNext = [](FanOutState& state)
+    {
+        const size_t index = state.next++;
+        if (index >= state.udsReceivers.size())
+        {
+            return false;
+        }
+        UdsReceiver* pUdsReceiver = state.udsReceivers[index];
+        FanOutState::Responses responses = pUdsReceiver->evaluate(state.buffer, state.num_bytes, true);
+        {
+            const lock_guard<mutex> lock(state.doneMutex);
+            state.done.emplace_back(pUdsReceiver, move(responses));
+        }
+        state.doneCond.notify_one();
+        return true;
+    };
+
+    for (size_t i = 1; i < udsReceivers.size(); ++i)
+    {
+        WorkerPool::instance().submit([pState, evaluateNext]() { while (evaluateNext(*pState)) { } });
+    }
+
+    for (size_t numSent = 0; numSent < udsReceivers.size(); ++numSent)
+    {
+        pair<UdsReceiver*, FanOutState::Responses> next;
+        {
+            unique_lock<mutex> lock(pState->doneMutex);
+            while (pState->done.empty())
+            {
+                lock.unlock();
+                if (!evaluateNext(*pState))
+                {
+                    // all ECUs taken, wait for the ones evaluated by the jobs
+                    lock.lock();
+                    pState->doneCond.wait(lock, [&pState] { return !pState->done.empty(); });
+                    break;
+                }
+                lock.lock();
+            }
+            next = move(pState->done.front());
+            pState->done.pop_front();
+        }
+        for (const auto& resp : next.second)
+        {
+            next.first->pIsoTpSender_->sendData(resp.data(), resp.size());
+        }
+    }
+
+    fanOutTime.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+}
@@ -10,31 +10,48 @@
 #include "uds_receiver.h"
 #include "session_controller.h"
 #include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 /// CAN address for broadcast messages like `TesterPresent`
 static constexpr canid_t BROADCAST_ADDR = 0x000;
 
+/**
+ * Receiver of the functional address (e.g. `0x7DF`) of a CAN interface. All
+ * ECUs on the same interface and functional address share one instance, so
+ * each functional request is received once and then evaluated by all ECUs in
+ * parallel.
+ */
 class BroadcastReceiver : public IsoTpReceiver
 {
 public:
 
     BroadcastReceiver() = delete;
-    BroadcastReceiver(canid_t source,
-                      const std::string& device,
-                      UdsReceiver* udsRec);
-    BroadcastReceiver(const BroadcastReceiver& orig) = default;
-    BroadcastReceiver& operator =(const BroadcastReceiver& orig) = default;
-    BroadcastReceiver(BroadcastReceiver&& orig) = default;
-    BroadcastReceiver& operator =(BroadcastReceiver&& orig) = default;
-    virtual ~BroadcastReceiver() = default;
+    BroadcastReceiver(canid_t source, const std::string& device);
+    BroadcastReceiver(const BroadcastReceiver& orig) = delete;
+    BroadcastReceiver& operator =(const BroadcastReceiver& orig) = delete;
+    BroadcastReceiver(BroadcastReceiver&& orig) = delete;
+    BroadcastReceiver& operator =(BroadcastReceiver&& orig) = delete;
+    virtual ~BroadcastReceiver();
+
+    static std::shared_ptr<BroadcastReceiver> subscribe(canid_t source,
+                                                        const std::string& device,
+                                                        UdsReceiver* pUdsRec);
+    void unsubscribe(UdsReceiver* pUdsRec);
 
     virtual void proceedReceivedData(const std::uint8_t* buffer,
                                      const std::size_t num_bytes) noexcept override;
 
 private:
-    UdsReceiver* pUdsReceiver_;
+    std::mutex mutex_;
+    std::vector<UdsReceiver*> udsReceivers_;
+    std::thread receiverThread_;
 
+    void fanOut(const std::vector<UdsReceiver*>& udsReceivers,
+                const std::uint8_t* buffer,
+                const std::size_t num_bytes) noexcept;
 };
 
 #endif /* BROADCAST_RECEIVER_H */
-
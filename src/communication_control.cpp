@@ -0,0 +1,171 @@
+/**
+ * @file communication_control.cpp
+ *
+ * This file contains the communication state of an ECU, which is switched by
+ * the UDS services `CommunicationControl` (0x28) and `ControlDTCSetting`
+ * (0x85).
+ */
+
+#include "communication_control.h"
+
+using namespace std;
+using std::chrono::steady_clock;
+
+/*
+ * Layout of the state word. Each communication type has a pair of disable
+ * bits, so 0 means "everything enabled".
+ */
+constexpr uint32_t TX_DISABLED = 0x01;
+constexpr uint32_t RX_DISABLED = 0x02;
+constexpr unsigned NORMAL_SHIFT = 0;
+constexpr unsigned NETWORK_MANAGEMENT_SHIFT = 2;
+constexpr uint32_t DTC_SETTING_DISABLED = 0x100;
+
+static_assert(atomic<uint32_t>::is_always_lock_free,
+              "the cyclic senders expect a lock-free communication state");
+
+/**
+ * Returns the mask of the given disable bit for all addressed communication
+ * types.
+ */
+static uint32_t maskOf(uint32_t bit, uint8_t communicationType) noexcept
+{
+    uint32_t mask = 0;
+    if (communicationType & NORMAL_COMMUNICATION)
+    {
+        mask |= bit << NORMAL_SHIFT;
+    }
+    if (communicationType & NETWORK_MANAGEMENT_COMMUNICATION)
+    {
+        mask |= bit << NETWORK_MANAGEMENT_SHIFT;
+    }
+    return mask;
+}
+
+/**
+ * Applies a `CommunicationControl` request.
+ *
+ * @param controlType: the sub-function (without the SPRMIB)
+ * @param communicationType: the communicationType byte, the subnet number in
+ *                           the upper nibble is ignored
+ * @return false if the control type or communication type is not supported
+ */
+bool CommunicationControl::control(uint8_t controlType, uint8_t communicationType) noexcept
+{
+    const uint32_t txMask = maskOf(TX_DISABLED, communicationType);
+    const uint32_t rxMask = maskOf(RX_DISABLED, communicationType);
+    if (txMask == 0)
+    {
+        return false;
+    }
+
+    uint32_t disable;
+    switch (controlType)
+    {
+        case ENABLE_RX_AND_TX:
+            disable = 0;
+            break;
+        case ENABLE_RX_AND_DISABLE_TX:
+            disable = txMask;
+            break;
+        case DISABLE_RX_AND_ENABLE_TX:
+            disable = rxMask;
+            break;
+        case DISABLE_RX_AND_TX:
+            disable = txMask | rxMask;
+            break;
+        default:
+            return false;
+    }
+
+    uint32_t state = state_.load(memory_order_relaxed);
+    while (!state_.compare_exchange_weak(state,
+                                         (state & ~(txMask | rxMask)) | disable,
+                                         memory_order_release,
+                                         memory_order_relaxed))
+    {
+    }
+    return true;
+}
+
+/**
+ * Checks if the ECU may transmit messages of the given type.
+ *
+ * @param communicationType: `NORMAL_COMMUNICATION` or
+ *                           `NETWORK_MANAGEMENT_COMMUNICATION`
+ * @return true if transmitting is enabled
+ */
+bool CommunicationControl::isTxEnabled(uint8_t communicationType) const noexcept
+{
+    return !isSuspended() && (state_.load(memory_order_acquire) & maskOf(TX_DISABLED, communicationType)) == 0;
+}
+
+/**
+ * Checks if the ECU handles received messages of the given type.
+ *
+ * @param communicationType: `NORMAL_COMMUNICATION` or
+ *                           `NETWORK_MANAGEMENT_COMMUNICATION`
+ * @return true if receiving is enabled
+ */
+bool CommunicationControl::isRxEnabled(uint8_t communicationType) const noexcept
+{
+    return !isSuspended() && (state_.load(memory_order_acquire) & maskOf(RX_DISABLED, communicationType)) == 0;
+}
+
+/**
+ * Switches the update of the DTC status bits on or off (`ControlDTCSetting`).
+ *
+ * @param isEnabled: true to resume the updates
+ */
+void CommunicationControl::setDtcSettingEnabled(bool isEnabled) noexcept
+{
+    if (isEnabled)
+    {
+        state_.fetch_and(~DTC_SETTING_DISABLED, memory_order_release);
+    }
+    else
+    {
+        state_.fetch_or(DTC_SETTING_DISABLED, memory_order_release);
+    }
+}
+
+/**
+ * Checks if the DTC status bits may be updated.
+ */
+bool CommunicationControl::isDtcSettingEnabled() const noexcept
+{
+    return (state_.load(memory_order_acquire) & DTC_SETTING_DISABLED) == 0;
+}
+
+/**
+ * Enables all communication and the DTC setting again, e.g. after returning
+ * to the default session.
+ */
+void CommunicationControl::reset() noexcept
+{
+    state_.store(0, memory_order_release);
+}
+
+/**
+ * Silences the ECU completely for the given time, e.g. while it reboots after
+ * an `ECUReset`. Neither `reset()` nor `control()` end the suspension.
+ *
+ * @param duration: the time without any communication
+ */
+void CommunicationControl::suspend(chrono::milliseconds duration) noexcept
+{
+    const auto resumeAt = steady_clock::now() + duration;
+    resumeAt_.store(resumeAt.time_since_epoch().count(), memory_order_release);
+}
+
+/**
+ * Checks if the ECU is suspended.
+ *
+ * @return true while the ECU must not communicate at all
+ * @see CommunicationControl::suspend()
+ */
+bool CommunicationControl::isSuspended() const noexcept
+{
+    const steady_clock::rep resumeAt = resumeAt_.load(memory_order_acquire);
+    return resumeAt != 0 && steady_clock::now().time_since_epoch().count() < resumeAt;
+}
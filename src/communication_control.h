@@ -0,0 +1,59 @@
+/**
+ * @file communication_control.h
+ *
+ */
+
+#ifndef COMMUNICATION_CONTROL_H
+#define COMMUNICATION_CONTROL_H
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+/// controlType of `CommunicationControl` (0x28)
+enum CommunicationControlType : std::uint8_t
+{
+    ENABLE_RX_AND_TX = 0x00,
+    ENABLE_RX_AND_DISABLE_TX = 0x01,
+    DISABLE_RX_AND_ENABLE_TX = 0x02,
+    DISABLE_RX_AND_TX = 0x03
+};
+
+/// Bits of the communicationType byte (the upper nibble addresses a subnet).
+enum CommunicationType : std::uint8_t
+{
+    NORMAL_COMMUNICATION = 0x01,
+    NETWORK_MANAGEMENT_COMMUNICATION = 0x02
+};
+
+/**
+ * Per-ECU communication state, set by `CommunicationControl` (0x28) and
+ * `ControlDTCSetting` (0x85). All flags share one atomic word, so the cyclic
+ * senders check it before every frame without taking a lock. Diagnostic
+ * communication is only affected while the ECU reboots after an `ECUReset`.
+ */
+class CommunicationControl
+{
+public:
+    CommunicationControl() = default;
+    CommunicationControl(const CommunicationControl& orig) = delete;
+    CommunicationControl& operator =(const CommunicationControl& orig) = delete;
+    CommunicationControl(CommunicationControl&& orig) = delete;
+    CommunicationControl& operator =(CommunicationControl&& orig) = delete;
+    virtual ~CommunicationControl() = default;
+
+    bool control(std::uint8_t controlType, std::uint8_t communicationType) noexcept;
+    bool isTxEnabled(std::uint8_t communicationType = NORMAL_COMMUNICATION) const noexcept;
+    bool isRxEnabled(std::uint8_t communicationType = NORMAL_COMMUNICATION) const noexcept;
+    void setDtcSettingEnabled(bool isEnabled) noexcept;
+    bool isDtcSettingEnabled() const noexcept;
+    void reset() noexcept;
+    void suspend(std::chrono::milliseconds duration) noexcept;
+    bool isSuspended() const noexcept;
+
+private:
+    std::atomic<std::uint32_t> state_{0}; ///< set bits disable, 0 is the default
+    std::atomic<std::chrono::steady_clock::rep> resumeAt_{0}; ///< end of the suspension (steady_clock ticks)
+};
+
+#endif /* COMMUNICATION_CONTROL_H */
@@ -0,0 +1,257 @@
+/**
+ * @file config_watcher.cpp
+ *
+ * This file contains the hot reload of the Lua configs, which are replaced at
+ * run-time without restarting the simulation.
+ */
+
+#include "config_watcher.h"
+#include "metrics.h"
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <iostream>
+#include <chrono>
+#include <set>
+#include <cstring>
+#include <cerrno>
+
+using namespace std;
+
+/// Interval in which the watcher checks for exit and frees replaced scripts.
+constexpr int POLL_INTERVAL_MS = 500;
+
+/// Size of the buffer for inotify events (several events with file names).
+constexpr size_t EVENT_BUFFER_SIZE = 4096;
+
+/**
+ * Checks if a reloaded script addresses the ECU like the running one. The CAN
+ * IDs are bound to the sockets and broadcast subscriptions, so changing them
+ * needs a restart.
+ *
+ * @param running: the currently active script
+ * @param reloaded: the new script
+ * @return true if the new script can replace the running one
+ */
+static bool isCompatible(const EcuLuaScript& running, const EcuLuaScript& reloaded) noexcept
+{
+    return running.hasRequestId() == reloaded.hasRequestId()
+        && running.hasResponseId() == reloaded.hasResponseId()
+        && running.hasJ1939SourceAddress() == reloaded.hasJ1939SourceAddress()
+        && (!running.hasRequestId() || running.getRequestId() == reloaded.getRequestId())
+        && (!running.hasResponseId() || running.getResponseId() == reloaded.getResponseId())
+        && running.getBroadcastId() == reloaded.getBroadcastId()
+        && (!running.hasJ1939SourceAddress() || running.getJ1939SourceAddress() == reloaded.getJ1939SourceAddress());
+}
+
+/**
+ * Constructor.
+ *
+ * @param directory: the directory of the Lua configs
+ */
+ConfigWatcher::ConfigWatcher(const string& directory)
+: directory_(directory)
+{
+}
+
+/**
+ * Destructor. Stops the watcher thread.
+ */
+ConfigWatcher::~ConfigWatcher()
+{
+    stop();
+}
+
+/**
+ * Starts watching the directory for changed Lua configs. Only files
+ * registered with `watch()` are reloaded.
+ *
+ * @return 0 on success, otherwise a negative value
+ */
+int ConfigWatcher::start()
+{
+    if (inotifyFd_ >= 0)
+    {
+        cerr << __func__ << "() already watching " << directory_ << '\n';
+        return -1;
+    }
+
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        cerr << __func__ << "() inotify_init1: " << strerror(errno) << '\n';
+        return -2;
+    }
+    // editors either write the file in place or rename a temporary file
+    if (inotify_add_watch(fd, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        cerr << __func__ << "() inotify_add_watch: " << strerror(errno) << '\n';
+        close(fd);
+        return -3;
+    }
+
+    inotifyFd_ = fd;
+    isOnExit_ = false;
+    thread_ = thread(&ConfigWatcher::run, this);
+    return 0;
+}
+
+/**
+ * Stops the watcher thread. Replaced scripts, which are still in use, are
+ * kept until the watcher is destroyed.
+ */
+void ConfigWatcher::stop() noexcept
+{
+    isOnExit_ = true;
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+    if (inotifyFd_ >= 0)
+    {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+}
+
+/**
+ * Registers the Lua config of an ECU for the hot reload.
+ *
+ * @param fileName: the name of the Lua file inside the watched directory
+ * @param ecuIdent: the identifier name of the ECU (e.g. "Main")
+ * @param pSlot: the slot holding the current script of the ECU
+ */
+void ConfigWatcher::watch(const string& fileName, const string& ecuIdent, shared_ptr<ScriptSlot> pSlot)
+{
+    const lock_guard<mutex> lock(mutex_);
+    configs_[fileName] = Config{ecuIdent, move(pSlot)};
+}
+
+/**
+ * Loads a registered Lua config again and publishes the new script. If the
+ * script can not be loaded or changes the CAN IDs of the ECU, the running
+ * script stays active.
+ *
+ * @param fileName: the name of the Lua file inside the watched directory
+ * @return true if the new script has been published
+ */
+bool ConfigWatcher::reload(const string& fileName)
+{
+    static metrics::Counter& numReloads = metrics::counter("lua.reloads");
+    static metrics::Counter& numFailures = metrics::counter("lua.reload_failures");
+    static metrics::Histogram& reloadTime = metrics::histogram("lua.reload_time_us");
+
+    Config config;
+    {
+        const lock_guard<mutex> lock(mutex_);
+        auto it = configs_.find(fileName);
+        if (it == configs_.cend())
+        {
+            return false;
+        }
+        config = it->second;
+    }
+    const string path = directory_ + '/' + fileName;
+
+    const auto start = chrono::steady_clock::now();
+    const shared_ptr<EcuLuaScript> pRunning = config.pSlot->load();
+    shared_ptr<EcuLuaScript> pReloaded;
+    try
+    {
+        pReloaded = make_shared<EcuLuaScript>(config.ecuIdent, path, *pRunning);
+    }
+    catch (const exception& e)
+    {
+        cerr << __func__ << "() " << fileName << ": " << e.what() << '\n';
+    }
+
+    if (pReloaded == nullptr || !pReloaded->isLoaded())
+    {
+        cerr << __func__ << "() " << fileName << " is invalid, keeping the running version\n";
+        numFailures.increment();
+        return false;
+    }
+    if (!isCompatible(*pRunning, *pReloaded))
+    {
+        cerr << __func__ << "() " << fileName << " changes the CAN IDs, restart to apply it\n";
+        numFailures.increment();
+        return false;
+    }
+
+    shared_ptr<EcuLuaScript> pReplaced = config.pSlot->publish(move(pReloaded));
+    {
+        const lock_guard<mutex> lock(mutex_);
+        retired_.push_back(move(pReplaced));
+    }
+    numReloads.increment();
+    reloadTime.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+    cout << "reloaded " << fileName << " (version " << config.pSlot->getVersion() << ")\n";
+    return true;
+}
+
+/**
+ * Frees the replaced scripts, which are neither used by a request in progress
+ * nor by a routine body anymore. Since a replaced script can not be loaded
+ * from its slot again, an unused script stays unused.
+ *
+ * @return the number of replaced scripts, which are still in use
+ */
+size_t ConfigWatcher::collectRetired()
+{
+    vector<shared_ptr<EcuLuaScript>> unused; // freed after the lock is released
+    const lock_guard<mutex> lock(mutex_);
+    for (auto it = retired_.begin(); it != retired_.end();)
+    {
+        if (it->use_count() == 1 && !(*it)->getRoutineController().isBusy())
+        {
+            unused.push_back(move(*it));
+            it = retired_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return retired_.size();
+}
+
+void ConfigWatcher::run() noexcept
+{
+    while (!isOnExit_)
+    {
+        struct pollfd pfd = {inotifyFd_, POLLIN, 0};
+        if (poll(&pfd, 1, POLL_INTERVAL_MS) > 0 && (pfd.revents & POLLIN))
+        {
+            for (const string& fileName : readEvents())
+            {
+                reload(fileName);
+            }
+        }
+        collectRetired();
+    }
+}
+
+/**
+ * Reads all pending inotify events.
+ *
+ * @return the names of the changed files, each name only once
+ */
+vector<string> ConfigWatcher::readEvents() noexcept
+{
+    set<string> fileNames;
+    alignas(struct inotify_event) char buffer[EVENT_BUFFER_SIZE];
+    ssize_t len;
+    while ((len = read(inotifyFd_, buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t pos = 0; pos < len;)
+        {
+            const struct inotify_event* pEvent = reinterpret_cast<const struct inotify_event*> (buffer + pos);
+            if (pEvent->len > 0)
+            {
+                fileNames.insert(pEvent->name);
+            }
+            pos += sizeof(struct inotify_event) + pEvent->len;
+        }
+    }
+    return vector<string>(fileNames.cbegin(), fileNames.cend());
+}
@@ -0,0 +1,61 @@
+/**
+ * @file config_watcher.h
+ *
+ */
+
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include "script_slot.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+/**
+ * Watches the directory of the Lua configs and reloads a changed script while
+ * the simulation keeps running. The new script is loaded on the watcher
+ * thread and published in the `ScriptSlot` of the ECU afterwards, so the
+ * receivers never wait for the Lua parser. Sockets, the session and the state
+ * taken over by `EcuLuaScript` are kept.
+ */
+class ConfigWatcher
+{
+public:
+    ConfigWatcher() = delete;
+    explicit ConfigWatcher(const std::string& directory);
+    ConfigWatcher(const ConfigWatcher& orig) = delete;
+    ConfigWatcher& operator =(const ConfigWatcher& orig) = delete;
+    ConfigWatcher(ConfigWatcher&& orig) = delete;
+    ConfigWatcher& operator =(ConfigWatcher&& orig) = delete;
+    virtual ~ConfigWatcher();
+
+    int start();
+    void stop() noexcept;
+    void watch(const std::string& fileName, const std::string& ecuIdent, std::shared_ptr<ScriptSlot> pSlot);
+    bool reload(const std::string& fileName);
+    std::size_t collectRetired();
+
+private:
+    struct Config
+    {
+        std::string ecuIdent;
+        std::shared_ptr<ScriptSlot> pSlot;
+    };
+
+    const std::string directory_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Config> configs_;
+    std::vector<std::shared_ptr<EcuLuaScript>> retired_; ///< replaced scripts, which may still be in use
+    int inotifyFd_ = -1;
+    std::atomic<bool> isOnExit_{false};
+    std::thread thread_;
+
+    void run() noexcept;
+    std::vector<std::string> readEvents() noexcept;
+};
+
+#endif /* CONFIG_WATCHER_H */
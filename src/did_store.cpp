@@ -0,0 +1,556 @@
+/**
+ * @file did_store.cpp
+ *
+ * This file contains the persistent value store for data identifiers, which
+ * serves `WriteDataByIdentifier` (0x2E) and the according reads of
+ * `ReadDataByIdentifier` (0x22) without calling into Lua.
+ *
+ * Journal layout: an 8 byte header followed by records of the form
+ * `A5 <DID:2> <LEN:2> <DATA:LEN> <CHECKSUM:1>`. The unused tail of the file is
+ * zero filled, so replaying stops at the first byte which is not a record
+ * marker (or at a record torn by a crash).
+ */
+
+#include "did_store.h"
+#include "worker_pool.h"
+#include "metrics.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
+
+using namespace std;
+
+static constexpr char JOURNAL_HEADER[] = "DIDJRNL1";
+static constexpr size_t HEADER_SIZE = sizeof(JOURNAL_HEADER) - 1;
+static constexpr uint8_t RECORD_MARKER = 0xA5;
+static constexpr size_t RECORD_OVERHEAD = 6; ///< marker + DID + length + checksum
+static constexpr size_t JOURNAL_CHUNK = 64 * 1024; ///< the journal grows in steps of 64 KiB
+static constexpr size_t MIN_COMPACT_SIZE = JOURNAL_CHUNK; ///< never compact smaller journals
+
+/**
+ * Destructor. Waits for a pending compaction and closes the journal.
+ */
+DidStore::~DidStore()
+{
+    close();
+}
+
+/**
+ * Defines a writable data identifier. Has to be called before `open()`, since
+ * journal records of undefined identifiers are ignored during the replay.
+ *
+ * @param did: the data identifier (e.g. `0xF190`)
+ * @param type: the type of the value
+ * @param length: the fixed length in bytes or 0 for a variable length
+ * @param defaultValue: the value until the first write
+ */
+void DidStore::define(uint16_t did, DidType type, size_t length, const vector<uint8_t>& defaultValue)
+{
+    const unique_lock<shared_timed_mutex> lock(mutex_);
+    entries_[did] = DidEntry{type, length, defaultValue};
+}
+
+/**
+ * Opens (or creates) the journal file and replays all stored writes.
+ *
+ * @param journalPath: the path to the journal file
+ * @return 0 on success, otherwise a negative value
+ * @see DidStore::close()
+ */
+int DidStore::open(const string& journalPath) noexcept
+{
+    assert(fd_ < 0);
+
+    int fd = ::open(journalPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        cerr << __func__ << "() open " << journalPath << ": " << strerror(errno) << '\n';
+        return -1;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) < 0)
+    {
+        cerr << __func__ << "() fstat: " << strerror(errno) << '\n';
+        ::close(fd);
+        return -2;
+    }
+
+    bool isNew = size_t(sb.st_size) < HEADER_SIZE;
+    size_t size = isNew ? JOURNAL_CHUNK : size_t(sb.st_size);
+    if (isNew && ftruncate(fd, size) < 0)
+    {
+        cerr << __func__ << "() ftruncate: " << strerror(errno) << '\n';
+        ::close(fd);
+        return -3;
+    }
+
+    const unique_lock<shared_timed_mutex> lock(mutex_);
+    if (mapFile(fd, size) != 0)
+    {
+        ::close(fd);
+        return -4;
+    }
+    path_ = journalPath;
+
+    if (!isNew && memcmp(map_, JOURNAL_HEADER, HEADER_SIZE) != 0)
+    {
+        cerr << __func__ << "() " << journalPath << " is no DID journal, starting a new one\n";
+        memset(map_, 0, mapSize_);
+        isNew = true;
+    }
+
+    if (isNew)
+    {
+        memcpy(map_, JOURNAL_HEADER, HEADER_SIZE);
+        writePos_ = HEADER_SIZE;
+    }
+    else
+    {
+        replay();
+    }
+
+    const lock_guard<mutex> compactLock(compactMutex_);
+    isOnExit_ = false;
+    return 0;
+}
+
+/**
+ * Waits for a pending compaction, flushes and closes the journal.
+ *
+ * @see DidStore::open()
+ */
+void DidStore::close() noexcept
+{
+    {
+        unique_lock<mutex> lock(compactMutex_);
+        isOnExit_ = true;
+        compactCond_.wait(lock, [this] { return !isCompactionPending_; });
+    }
+
+    const unique_lock<shared_timed_mutex> lock(mutex_);
+    unmapFile();
+}
+
+/**
+ * Checks if the data identifier is defined in the store.
+ *
+ * @param did: the data identifier
+ * @return true if the identifier is stored, otherwise false
+ */
+bool DidStore::has(uint16_t did) const
+{
+    const shared_lock<shared_timed_mutex> lock(mutex_);
+    return entries_.find(did) != entries_.cend();
+}
+
+/**
+ * Appends the current value of the data identifier to the given buffer.
+ *
+ * @param did: the data identifier
+ * @param out: the buffer to append the value to
+ * @return true on success, false if the identifier is unknown
+ */
+bool DidStore::read(uint16_t did, vector<uint8_t>& out) const
+{
+    return readInto(did, out);
+}
+
+/**
+ * Appends the current value of the data identifier to a request scoped buffer.
+ *
+ * @param did: the data identifier
+ * @param out: the buffer to append the value to
+ * @return true on success, false if the identifier is unknown
+ */
+bool DidStore::read(uint16_t did, pmr::vector<uint8_t>& out) const
+{
+    return readInto(did, out);
+}
+
+template <typename Bytes>
+bool DidStore::readInto(uint16_t did, Bytes& out) const
+{
+    const shared_lock<shared_timed_mutex> lock(mutex_);
+    auto it = entries_.find(did);
+    if (it == entries_.cend())
+    {
+        return false;
+    }
+    out.insert(out.end(), it->second.value.cbegin(), it->second.value.cend());
+    return true;
+}
+
+/**
+ * Writes a new value of the data identifier and appends it to the journal.
+ *
+ * @param did: the data identifier
+ * @param data: pointer to the new value
+ * @param len: the length of the new value in bytes
+ * @return `DidWriteResult::OK` on success, otherwise the reason of rejection
+ */
+DidWriteResult DidStore::write(uint16_t did, const uint8_t* data, size_t len)
+{
+    bool compactionNeeded;
+    {
+        const unique_lock<shared_timed_mutex> lock(mutex_);
+        auto it = entries_.find(did);
+        if (it == entries_.end())
+        {
+            return DidWriteResult::UNKNOWN_IDENTIFIER;
+        }
+
+        DidEntry& entry = it->second;
+        if ((entry.length != 0 && len != entry.length) || len == 0 || len > 0xFFFF)
+        {
+            return DidWriteResult::INVALID_LENGTH;
+        }
+        if (entry.type == DidType::ASCII)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (data[i] < 0x20 || data[i] > 0x7E)
+                {
+                    return DidWriteResult::INVALID_VALUE;
+                }
+            }
+        }
+
+        // the value is only changed, once it is journaled
+        vector<uint8_t> value(data, data + len);
+        const size_t oldSize = entry.value.size();
+        const bool wasJournaled = entry.journaled != 0;
+        if (!append(did, value))
+        {
+            return DidWriteResult::JOURNAL_FAILED;
+        }
+        if (wasJournaled)
+        {
+            liveBytes_ -= oldSize + RECORD_OVERHEAD;
+        }
+        entry.value = move(value);
+        compactionNeeded = needsCompaction();
+    }
+
+    if (compactionNeeded)
+    {
+        requestCompaction();
+    }
+    return DidWriteResult::OK;
+}
+
+/**
+ * Rewrites the journal with the current values only. The new journal is
+ * written into a temporary file without blocking readers and writers. Only
+ * the records appended meanwhile are copied over with the lock held before
+ * the temporary file replaces the journal.
+ */
+void DidStore::compact()
+{
+    vector<uint8_t> data(JOURNAL_HEADER, JOURNAL_HEADER + HEADER_SIZE);
+    size_t snapshotPos;
+    {
+        const shared_lock<shared_timed_mutex> lock(mutex_);
+        if (map_ == nullptr)
+        {
+            return;
+        }
+        // the replayed and the written values are the only ones in the journal
+        for (size_t pos = HEADER_SIZE; pos < writePos_;)
+        {
+            const uint16_t did = (map_[pos + 1] << 8) | map_[pos + 2];
+            const size_t len = (map_[pos + 3] << 8) | map_[pos + 4];
+            pos += len + RECORD_OVERHEAD;
+            auto it = entries_.find(did);
+            if (it != entries_.cend() && it->second.journaled == pos)
+            {
+                serialize(did, it->second.value, data);
+            }
+        }
+        snapshotPos = writePos_;
+    }
+
+    const string tmpPath = path_ + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        cerr << __func__ << "() open " << tmpPath << ": " << strerror(errno) << '\n';
+        return;
+    }
+    if (::write(fd, data.data(), data.size()) != ssize_t(data.size()))
+    {
+        cerr << __func__ << "() write: " << strerror(errno) << '\n';
+        ::close(fd);
+        unlink(tmpPath.c_str());
+        return;
+    }
+
+    const unique_lock<shared_timed_mutex> lock(mutex_);
+    const size_t tail = writePos_ - snapshotPos;
+    const size_t size = ((data.size() + tail) / JOURNAL_CHUNK + 1) * JOURNAL_CHUNK;
+    if ((tail > 0 && ::write(fd, map_ + snapshotPos, tail) != ssize_t(tail))
+        || ftruncate(fd, size) < 0
+        || fsync(fd) < 0
+        || rename(tmpPath.c_str(), path_.c_str()) < 0)
+    {
+        cerr << __func__ << "() " << tmpPath << ": " << strerror(errno) << '\n';
+        ::close(fd);
+        unlink(tmpPath.c_str());
+        return;
+    }
+
+    unmapFile();
+    if (mapFile(fd, size) != 0)
+    {
+        ::close(fd);
+        return;
+    }
+    // the positions of the journaled values have moved
+    replay();
+}
+
+/**
+ * Converts the type name used in the Lua script into a `DidType`.
+ *
+ * @param type: "ascii", "uint" or "bytes"
+ * @return the according type, `DidType::BYTES` on default
+ */
+DidType DidStore::typeFromString(const string& type) noexcept
+{
+    if (type == "ascii")
+    {
+        return DidType::ASCII;
+    }
+    if (type == "uint")
+    {
+        return DidType::UINT;
+    }
+    return DidType::BYTES;
+}
+
+int DidStore::mapFile(int fd, size_t size) noexcept
+{
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        cerr << __func__ << "() mmap: " << strerror(errno) << '\n';
+        return -1;
+    }
+    fd_ = fd;
+    map_ = static_cast<uint8_t*> (map);
+    mapSize_ = size;
+    return 0;
+}
+
+void DidStore::unmapFile() noexcept
+{
+    if (map_ != nullptr)
+    {
+        msync(map_, mapSize_, MS_SYNC);
+        munmap(map_, mapSize_);
+        map_ = nullptr;
+        mapSize_ = 0;
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+/**
+ * Grows the journal file and its mapping, if the given number of bytes does
+ * not fit behind the current write position. Requires the unique lock.
+ */
+bool DidStore::ensureCapacity(size_t bytes) noexcept
+{
+    if (writePos_ + bytes <= mapSize_)
+    {
+        return true;
+    }
+
+    const size_t size = ((writePos_ + bytes) / JOURNAL_CHUNK + 1) * JOURNAL_CHUNK;
+    if (ftruncate(fd_, size) < 0)
+    {
+        cerr << __func__ << "() ftruncate: " << strerror(errno) << '\n';
+        return false;
+    }
+    void* map = mremap(map_, mapSize_, size, MREMAP_MAYMOVE);
+    if (map == MAP_FAILED)
+    {
+        cerr << __func__ << "() mremap: " << strerror(errno) << '\n';
+        return false;
+    }
+    map_ = static_cast<uint8_t*> (map);
+    mapSize_ = size;
+    return true;
+}
+
+/**
+ * Applies all valid journal records to the defined entries and sets the write
+ * position behind the last valid record. Requires the unique lock.
+ */
+void DidStore::replay() noexcept
+{
+    size_t pos = HEADER_SIZE;
+    while (pos + RECORD_OVERHEAD <= mapSize_ && map_[pos] == RECORD_MARKER)
+    {
+        const uint16_t did = (map_[pos + 1] << 8) | map_[pos + 2];
+        const size_t len = (map_[pos + 3] << 8) | map_[pos + 4];
+        if (pos + len + RECORD_OVERHEAD > mapSize_)
+        {
+            break;
+        }
+
+        uint8_t sum = 0;
+        for (size_t i = 1; i < len + RECORD_OVERHEAD - 1; ++i)
+        {
+            sum += map_[pos + i];
+        }
+        if (uint8_t(~sum) != map_[pos + len + RECORD_OVERHEAD - 1])
+        {
+            cerr << __func__ << "() " << path_ << ": torn record at offset " << pos << '\n';
+            break;
+        }
+
+        pos += len + RECORD_OVERHEAD;
+        auto it = entries_.find(did);
+        if (it != entries_.end() && (it->second.length == 0 || it->second.length == len))
+        {
+            it->second.value.assign(map_ + pos - len - 1, map_ + pos - 1);
+            it->second.journaled = pos;
+        }
+    }
+
+    // wipe a torn record, so the next append does not end up behind garbage
+    memset(map_ + pos, 0, mapSize_ - pos);
+    writePos_ = pos;
+
+    liveBytes_ = HEADER_SIZE;
+    for (const auto& entry : entries_)
+    {
+        if (entry.second.journaled != 0)
+        {
+            liveBytes_ += entry.second.value.size() + RECORD_OVERHEAD;
+        }
+    }
+}
+
+/**
+ * Appends a record to the journal. Failures are logged and counted in the
+ * metric `did.journal_failures`. Requires the unique lock.
+ *
+ * @return true on success or without journal, false if the record could not
+ *         be appended
+ */
+bool DidStore::append(uint16_t did, const vector<uint8_t>& value) noexcept
+{
+    static metrics::Counter& numFailures = metrics::counter("did.journal_failures");
+
+    if (map_ == nullptr)
+    {
+        return true; // no journal opened, values are kept in memory only
+    }
+
+    vector<uint8_t> record;
+    try
+    {
+        record.reserve(value.size() + RECORD_OVERHEAD);
+        serialize(did, value, record);
+    }
+    catch (const bad_alloc&)
+    {
+        record.clear();
+    }
+    if (record.empty() || !ensureCapacity(record.size()))
+    {
+        cerr << __func__ << "() " << path_ << ": DID 0x" << hex << did << dec << " not journaled\n";
+        numFailures.increment();
+        return false;
+    }
+    memcpy(map_ + writePos_, record.data(), record.size());
+    writePos_ += record.size();
+    liveBytes_ += record.size();
+    entries_[did].journaled = writePos_;
+    return true;
+}
+
+bool DidStore::needsCompaction() const noexcept
+{
+    return writePos_ > MIN_COMPACT_SIZE && writePos_ > 2 * liveBytes_;
+}
+
+/**
+ * Queues a compaction on the worker pool, unless one is pending already or the
+ * journal is being closed.
+ */
+void DidStore::requestCompaction() noexcept
+{
+    const lock_guard<mutex> lock(compactMutex_);
+    if (isCompactionPending_ || isOnExit_)
+    {
+        return;
+    }
+    try
+    {
+        WorkerPool::instance().submit([this]() { compactJob(); });
+        isCompactionPending_ = true;
+    }
+    catch (const exception& e)
+    {
+        // the next write requests the compaction again
+        cerr << __func__ << "() " << e.what() << '\n';
+    }
+}
+
+/**
+ * Compaction job of the worker pool. `close()` waits for it, so the store
+ * outlives the job.
+ */
+void DidStore::compactJob() noexcept
+{
+    bool isOnExit;
+    {
+        const lock_guard<mutex> lock(compactMutex_);
+        isOnExit = isOnExit_;
+    }
+    if (!isOnExit)
+    {
+        try
+        {
+            compact();
+        }
+        catch (const exception& e)
+        {
+            cerr << __func__ << "() " << e.what() << '\n';
+        }
+    }
+
+    // notified with the lock held, since the store may be destroyed right after
+    const lock_guard<mutex> lock(compactMutex_);
+    isCompactionPending_ = false;
+    compactCond_.notify_all();
+}
+
+void DidStore::serialize(uint16_t did, const vector<uint8_t>& value, vector<uint8_t>& out)
+{
+    const size_t start = out.size();
+    out.push_back(RECORD_MARKER);
+    out.push_back(uint8_t(did >> 8));
+    out.push_back(uint8_t(did));
+    out.push_back(uint8_t(value.size() >> 8));
+    out.push_back(uint8_t(value.size()));
+    out.insert(out.end(), value.cbegin(), value.cend());
+
+    uint8_t sum = 0;
+    for (size_t i = start + 1; i < out.size(); ++i)
+    {
+        sum += out[i];
+    }
+    out.push_back(uint8_t(~sum));
+}
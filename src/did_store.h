@@ -0,0 +1,102 @@
+/**
+ * @file did_store.h
+ *
+ */
+
+#ifndef DID_STORE_H
+#define DID_STORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory_resource>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
+
+enum class DidType : std::uint8_t
+{
+    BYTES, ///< arbitrary bytes, given as literal hex string in Lua
+    ASCII, ///< printable ASCII characters
+    UINT   ///< unsigned big endian number
+};
+
+enum class DidWriteResult : std::uint8_t
+{
+    OK,
+    UNKNOWN_IDENTIFIER,
+    INVALID_LENGTH,
+    INVALID_VALUE,
+    JOURNAL_FAILED ///< the value could not be journaled and is unchanged
+};
+
+struct DidEntry
+{
+    DidType type;
+    std::size_t length; ///< fixed length in bytes, 0 for variable length
+    std::vector<std::uint8_t> value;
+    std::size_t journaled = 0; ///< end offset of the latest journal record, 0 if not journaled
+};
+
+/**
+ * Typed value store for data identifiers written via `WriteDataByIdentifier`.
+ * Every write is appended to a memory mapped journal file, which is replayed
+ * on start-up, so written values survive a restart of the simulator. Once the
+ * journal has grown well beyond the size of the live values, a job on the
+ * `WorkerPool` rewrites it with the current values only.
+ */
+class DidStore
+{
+public:
+    DidStore() = default;
+    DidStore(const DidStore& orig) = delete;
+    DidStore& operator =(const DidStore& orig) = delete;
+    DidStore(DidStore&& orig) = delete;
+    DidStore& operator =(DidStore&& orig) = delete;
+    virtual ~DidStore();
+
+    void define(std::uint16_t did, DidType type, std::size_t length, const std::vector<std::uint8_t>& defaultValue);
+    int open(const std::string& journalPath) noexcept;
+    void close() noexcept;
+
+    bool has(std::uint16_t did) const;
+    bool read(std::uint16_t did, std::vector<std::uint8_t>& out) const;
+    bool read(std::uint16_t did, std::pmr::vector<std::uint8_t>& out) const;
+    DidWriteResult write(std::uint16_t did, const std::uint8_t* data, std::size_t len);
+    void compact();
+
+    static DidType typeFromString(const std::string& type) noexcept;
+
+private:
+    mutable std::shared_timed_mutex mutex_;
+    std::unordered_map<std::uint16_t, DidEntry> entries_;
+
+    std::string path_;
+    int fd_ = -1;
+    std::uint8_t* map_ = nullptr;
+    std::size_t mapSize_ = 0;
+    std::size_t writePos_ = 0;
+    std::size_t liveBytes_ = 0;
+
+    std::mutex compactMutex_;
+    std::condition_variable compactCond_;
+    bool isCompactionPending_ = false; ///< a compaction job is queued or running
+    bool isOnExit_ = false;
+
+    int mapFile(int fd, std::size_t size) noexcept;
+    void unmapFile() noexcept;
+    bool ensureCapacity(std::size_t bytes) noexcept;
+    void replay() noexcept;
+    bool append(std::uint16_t did, const std::vector<std::uint8_t>& value) noexcept;
+    bool needsCompaction() const noexcept;
+    template <typename Bytes>
+    bool readInto(std::uint16_t did, Bytes& out) const;
+    void requestCompaction() noexcept;
+    void compactJob() noexcept;
+
+    static void serialize(std::uint16_t did, const std::vector<std::uint8_t>& value, std::vector<std::uint8_t>& out);
+};
+
+#endif /* DID_STORE_H */
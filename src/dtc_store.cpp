@@ -0,0 +1,382 @@
+/**
+ * @file dtc_store.cpp
+ *
+ * This file contains the native store for Diagnostic Trouble Codes (DTC),
+ * which serves the UDS services `ReadDTCInformation` (0x19) and
+ * `ClearDiagnosticInformation` (0x14) without calling into Lua.
+ */
+
+#include "dtc_store.h"
+#include <cstring>
+#include <cassert>
+
+using namespace std;
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "DtcStore::matchMask() expects a little endian target"
+#endif
+
+/// Every byte lane set to 0x7F.
+static constexpr uint64_t LOW_SEVEN_BITS = 0x7F7F7F7F7F7F7F7Full;
+
+/// Every byte lane set to 0x80.
+static constexpr uint64_t HIGH_BITS = 0x8080808080808080ull;
+
+/**
+ * Move constructor.
+ *
+ * @param orig: the originating instance
+ */
+DtcStore::DtcStore(DtcStore&& orig) noexcept
+{
+    const lock_guard<mutex> lock(orig.mutex_);
+    numbers_ = move(orig.numbers_);
+    status_ = move(orig.status_);
+    index_ = move(orig.index_);
+    snapshots_ = move(orig.snapshots_);
+    extendedData_ = move(orig.extendedData_);
+    availabilityMask_ = orig.availabilityMask_;
+}
+
+/**
+ * Move assignment operator.
+ *
+ * @param orig: the originating instance
+ * @return reference to the moved instance
+ */
+DtcStore& DtcStore::operator=(DtcStore&& orig) noexcept
+{
+    assert(this != &orig);
+    const lock_guard<mutex> lock(mutex_);
+    const lock_guard<mutex> lockOrig(orig.mutex_);
+    numbers_ = move(orig.numbers_);
+    status_ = move(orig.status_);
+    index_ = move(orig.index_);
+    snapshots_ = move(orig.snapshots_);
+    extendedData_ = move(orig.extendedData_);
+    availabilityMask_ = orig.availabilityMask_;
+    return *this;
+}
+
+/**
+ * Adds a DTC to the store. If the DTC is already stored, only its status gets
+ * updated.
+ *
+ * @param dtc: the 3 byte DTC number (e.g. `0xC01234`)
+ * @param status: the DTC status byte
+ */
+void DtcStore::add(uint32_t dtc, uint8_t status)
+{
+    const lock_guard<mutex> lock(mutex_);
+    addUnlocked(dtc, status);
+}
+
+/**
+ * Sets the status byte of the given DTC. Unknown DTCs are added to the store.
+ *
+ * @param dtc: the 3 byte DTC number
+ * @param status: the new DTC status byte
+ */
+void DtcStore::setStatus(uint32_t dtc, uint8_t status)
+{
+    add(dtc, status);
+}
+
+/**
+ * Gets the status byte of the given DTC.
+ *
+ * @param dtc: the 3 byte DTC number
+ * @return the status byte or -1 if the DTC is unknown
+ */
+int DtcStore::getStatus(uint32_t dtc) const
+{
+    const lock_guard<mutex> lock(mutex_);
+    auto it = index_.find(dtc);
+    if (it == index_.cend())
+    {
+        return -1;
+    }
+    return status_[it->second];
+}
+
+/**
+ * Checks if the given DTC is stored.
+ *
+ * @param dtc: the 3 byte DTC number
+ * @return true if the DTC is known, otherwise false
+ */
+bool DtcStore::contains(uint32_t dtc) const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return index_.find(dtc) != index_.cend();
+}
+
+/**
+ * Returns the number of stored DTCs.
+ */
+size_t DtcStore::size() const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return numbers_.size();
+}
+
+/**
+ * Clears the diagnostic information of a single DTC or of all DTCs. The status
+ * byte is reset to `DTC_STATUS_AFTER_CLEAR` and all snapshot and extended data
+ * records are removed. The DTCs themselves stay supported.
+ *
+ * @param groupOfDtc: the DTC number or `DTC_GROUP_ALL`
+ * @return true on success, false if the DTC is unknown
+ */
+bool DtcStore::clear(uint32_t groupOfDtc)
+{
+    const lock_guard<mutex> lock(mutex_);
+
+    if (groupOfDtc == DTC_GROUP_ALL)
+    {
+        fill(status_.begin(), status_.end(), DTC_STATUS_AFTER_CLEAR);
+        snapshots_.clear();
+        extendedData_.clear();
+        return true;
+    }
+
+    auto it = index_.find(groupOfDtc);
+    if (it == index_.cend())
+    {
+        return false;
+    }
+    status_[it->second] = DTC_STATUS_AFTER_CLEAR;
+    snapshots_.erase(groupOfDtc);
+    extendedData_.erase(groupOfDtc);
+    return true;
+}
+
+/**
+ * Starts a new operation cycle, e.g. after an `ECUReset`. The status bits,
+ * which only refer to the current operation cycle, are reset in all DTCs.
+ * Records and all other status bits are kept.
+ */
+void DtcStore::startOperationCycle()
+{
+    const lock_guard<mutex> lock(mutex_);
+    for (uint8_t& status : status_)
+    {
+        status = (status & ~DTC_STATUS_TEST_FAILED_THIS_OPERATION_CYCLE)
+                 | DTC_STATUS_TEST_NOT_COMPLETED_THIS_OPERATION_CYCLE;
+    }
+}
+
+/**
+ * Sets a snapshot record (`DTCSnapshotRecord`) of the given DTC.
+ *
+ * @param dtc: the 3 byte DTC number, unknown DTCs are added with status 0x00
+ * @param record: the record number [0x00..0xFE]
+ * @param data: the record data (e.g. `{0x01, 0xF1, 0x90, 0x12}`)
+ */
+void DtcStore::setSnapshotRecord(uint32_t dtc, uint8_t record, const vector<uint8_t>& data)
+{
+    const lock_guard<mutex> lock(mutex_);
+    if (index_.find(dtc) == index_.cend())
+    {
+        addUnlocked(dtc, 0x00);
+    }
+    snapshots_[dtc][record] = data;
+}
+
+/**
+ * Sets an extended data record (`DTCExtendedDataRecord`) of the given DTC.
+ *
+ * @param dtc: the 3 byte DTC number, unknown DTCs are added with status 0x00
+ * @param record: the record number [0x00..0xFE]
+ * @param data: the record data
+ */
+void DtcStore::setExtendedDataRecord(uint32_t dtc, uint8_t record, const vector<uint8_t>& data)
+{
+    const lock_guard<mutex> lock(mutex_);
+    if (index_.find(dtc) == index_.cend())
+    {
+        addUnlocked(dtc, 0x00);
+    }
+    extendedData_[dtc][record] = data;
+}
+
+/**
+ * Counts all DTCs whose status byte matches at least one bit of the mask
+ * (`reportNumberOfDTCByStatusMask`).
+ *
+ * @param mask: the DTC status mask
+ * @return the number of matching DTCs
+ */
+size_t DtcStore::countByStatusMask(uint8_t mask) const
+{
+    const lock_guard<mutex> lock(mutex_);
+
+    size_t count = 0;
+    for (size_t pos = 0; pos < status_.size(); pos += sizeof(uint64_t))
+    {
+        count += __builtin_popcountll(matchMask(pos, mask));
+    }
+    return count;
+}
+
+/**
+ * Appends all DTCs whose status byte matches the mask to the given response
+ * buffer. Each entry consists of the 3 DTC bytes followed by the status byte,
+ * masked with the `DTCStatusAvailabilityMask` (`reportDTCByStatusMask`).
+ *
+ * @param mask: the DTC status mask
+ * @param out: the response buffer to append to
+ */
+void DtcStore::appendByStatusMask(uint8_t mask, vector<uint8_t>& out) const
+{
+    const lock_guard<mutex> lock(mutex_);
+
+    for (size_t pos = 0; pos < status_.size(); pos += sizeof(uint64_t))
+    {
+        uint64_t hits = matchMask(pos, mask);
+        while (hits != 0)
+        {
+            const size_t idx = pos + (__builtin_ctzll(hits) / 8);
+            if (idx >= status_.size())
+            {
+                break;
+            }
+            appendDtc(idx, out);
+            // clear the whole byte lane of the reported DTC
+            hits &= ~(0xFFull << ((idx - pos) * 8));
+        }
+    }
+}
+
+/**
+ * Appends all supported DTCs, regardless of their status, to the given
+ * response buffer. Each entry consists of the 3 DTC bytes followed by the
+ * status byte, masked with the `DTCStatusAvailabilityMask`
+ * (`reportSupportedDTC`).
+ *
+ * @param out: the response buffer to append to
+ */
+void DtcStore::appendAll(vector<uint8_t>& out) const
+{
+    const lock_guard<mutex> lock(mutex_);
+
+    for (size_t idx = 0; idx < status_.size(); ++idx)
+    {
+        appendDtc(idx, out);
+    }
+}
+
+/**
+ * Appends the DTC, its status and the requested snapshot record(s) to the
+ * response buffer (`reportDTCSnapshotRecordByDTCNumber`).
+ *
+ * @param dtc: the 3 byte DTC number
+ * @param record: the record number or `DTC_RECORD_ALL`
+ * @param out: the response buffer to append to
+ * @return false if the DTC is unknown or the record does not exist
+ */
+bool DtcStore::appendSnapshotRecords(uint32_t dtc, uint8_t record, vector<uint8_t>& out) const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return appendRecords(snapshots_, dtc, record, out);
+}
+
+/**
+ * Appends the DTC, its status and the requested extended data record(s) to
+ * the response buffer (`reportDTCExtDataRecordByDTCNumber`).
+ *
+ * @param dtc: the 3 byte DTC number
+ * @param record: the record number or `DTC_RECORD_ALL`
+ * @param out: the response buffer to append to
+ * @return false if the DTC is unknown or the record does not exist
+ */
+bool DtcStore::appendExtendedDataRecords(uint32_t dtc, uint8_t record, vector<uint8_t>& out) const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return appendRecords(extendedData_, dtc, record, out);
+}
+
+size_t DtcStore::addUnlocked(uint32_t dtc, uint8_t status)
+{
+    dtc &= DTC_GROUP_ALL;
+    auto it = index_.find(dtc);
+    if (it != index_.cend())
+    {
+        status_[it->second] = status;
+        return it->second;
+    }
+
+    numbers_.push_back(dtc);
+    status_.push_back(status);
+    index_.emplace(dtc, numbers_.size() - 1);
+    return numbers_.size() - 1;
+}
+
+/**
+ * Checks up to eight status bytes starting at `pos` against the mask at once.
+ * Every byte lane of the returned word has its highest bit set, if the
+ * according status byte matches the mask. Lanes behind the end of the store
+ * are always zero.
+ *
+ * @param pos: index of the first status byte
+ * @param mask: the DTC status mask
+ * @return word with 0x80 in every matching byte lane
+ */
+uint64_t DtcStore::matchMask(size_t pos, uint8_t mask) const noexcept
+{
+    uint64_t word = 0;
+    const size_t len = min(sizeof(word), status_.size() - pos);
+    memcpy(&word, status_.data() + pos, len);
+
+    const uint64_t masked = word & (uint64_t(mask) * 0x0101010101010101ull);
+    // set the high bit of each lane if any of the lower 7 bits is set (no
+    // carry into the next lane possible), then merge in the high bits
+    return (((masked & LOW_SEVEN_BITS) + LOW_SEVEN_BITS) | masked) & HIGH_BITS;
+}
+
+void DtcStore::appendDtc(size_t idx, vector<uint8_t>& out) const
+{
+    const uint32_t dtc = numbers_[idx];
+    out.push_back(uint8_t(dtc >> 16));
+    out.push_back(uint8_t(dtc >> 8));
+    out.push_back(uint8_t(dtc));
+    // the ECU does not support the other status bits, so never reports them
+    out.push_back(status_[idx] & availabilityMask_);
+}
+
+bool DtcStore::appendRecords(const unordered_map<uint32_t, RecordMap>& records,
+                             uint32_t dtc,
+                             uint8_t record,
+                             vector<uint8_t>& out) const
+{
+    auto idx = index_.find(dtc);
+    if (idx == index_.cend())
+    {
+        return false;
+    }
+
+    auto recs = records.find(dtc);
+    if (record != DTC_RECORD_ALL)
+    {
+        if (recs == records.cend() || recs->second.find(record) == recs->second.cend())
+        {
+            return false;
+        }
+    }
+
+    appendDtc(idx->second, out);
+    if (recs == records.cend())
+    {
+        return true;
+    }
+
+    for (const auto& rec : recs->second)
+    {
+        if (record == DTC_RECORD_ALL || record == rec.first)
+        {
+            out.push_back(rec.first);
+            out.insert(out.end(), rec.second.cbegin(), rec.second.cend());
+        }
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file dtc_store.h
+ *
+ */
+
+#ifndef DTC_STORE_H
+#define DTC_STORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+
+/// Status byte after a `ClearDiagnosticInformation` (bits 4 and 6 set).
+constexpr std::uint8_t DTC_STATUS_AFTER_CLEAR = 0x50;
+
+/// testFailedThisOperationCycle, cleared at the start of an operation cycle.
+constexpr std::uint8_t DTC_STATUS_TEST_FAILED_THIS_OPERATION_CYCLE = 0x02;
+
+/// testNotCompletedThisOperationCycle, set at the start of an operation cycle.
+constexpr std::uint8_t DTC_STATUS_TEST_NOT_COMPLETED_THIS_OPERATION_CYCLE = 0x40;
+
+/// Group of DTC which addresses all stored DTCs (`14 FF FF FF`).
+constexpr std::uint32_t DTC_GROUP_ALL = 0xFFFFFF;
+
+/// Record number which addresses all snapshot / extended data records.
+constexpr std::uint8_t DTC_RECORD_ALL = 0xFF;
+
+/**
+ * Native store for Diagnostic Trouble Codes. The DTC numbers and their status
+ * bytes are kept in two parallel arrays (struct-of-arrays), so a status mask
+ * can be checked against eight DTCs per machine word without touching the
+ * numbers at all. Snapshot and extended data records are rarely requested and
+ * therefore stored per DTC on the side.
+ */
+class DtcStore
+{
+public:
+    DtcStore() = default;
+    DtcStore(const DtcStore& orig) = delete;
+    DtcStore& operator =(const DtcStore& orig) = delete;
+    DtcStore(DtcStore&& orig) noexcept;
+    DtcStore& operator =(DtcStore&& orig) noexcept;
+    virtual ~DtcStore() = default;
+
+    void add(std::uint32_t dtc, std::uint8_t status);
+    void setStatus(std::uint32_t dtc, std::uint8_t status);
+    int getStatus(std::uint32_t dtc) const;
+    bool contains(std::uint32_t dtc) const;
+    std::size_t size() const;
+    bool clear(std::uint32_t groupOfDtc);
+    void startOperationCycle();
+
+    void setSnapshotRecord(std::uint32_t dtc, std::uint8_t record, const std::vector<std::uint8_t>& data);
+    void setExtendedDataRecord(std::uint32_t dtc, std::uint8_t record, const std::vector<std::uint8_t>& data);
+
+    void setStatusAvailabilityMask(std::uint8_t mask) noexcept { availabilityMask_ = mask; };
+    std::uint8_t getStatusAvailabilityMask() const noexcept { return availabilityMask_; };
+
+    std::size_t countByStatusMask(std::uint8_t mask) const;
+    void appendByStatusMask(std::uint8_t mask, std::vector<std::uint8_t>& out) const;
+    void appendAll(std::vector<std::uint8_t>& out) const;
+    bool appendSnapshotRecords(std::uint32_t dtc, std::uint8_t record, std::vector<std::uint8_t>& out) const;
+    bool appendExtendedDataRecords(std::uint32_t dtc, std::uint8_t record, std::vector<std::uint8_t>& out) const;
+
+private:
+    using RecordMap = std::map<std::uint8_t, std::vector<std::uint8_t>>;
+
+    mutable std::mutex mutex_;
+    std::vector<std::uint32_t> numbers_;
+    std::vector<std::uint8_t> status_;
+    std::unordered_map<std::uint32_t, std::size_t> index_;
+    std::unordered_map<std::uint32_t, RecordMap> snapshots_;
+    std::unordered_map<std::uint32_t, RecordMap> extendedData_;
+    std::uint8_t availabilityMask_ = 0xFF;
+
+    std::size_t addUnlocked(std::uint32_t dtc, std::uint8_t status);
+    std::uint64_t matchMask(std::size_t pos, std::uint8_t mask) const noexcept;
+    void appendDtc(std::size_t idx, std::vector<std::uint8_t>& out) const;
+    bool appendRecords(const std::unordered_map<std::uint32_t, RecordMap>& records,
+                       std::uint32_t dtc,
+                       std::uint8_t record,
+                       std::vector<std::uint8_t>& out) const;
+};
+
+#endif /* DTC_STORE_H */
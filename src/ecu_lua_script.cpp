@@ -7,6 +7,9 @@
 #include "ecu_lua_script.h"
 #include "libcrc/crcccitt.c"
 #include "utilities.h"
+#include "lua_bytes.h"
+#include "lua_chunk_cache.h"
+#include "lua_libraries.h"
 #include <iostream>
 #include <string.h>
 #include <stdio.h>
@@ -25,6 +28,108 @@ static constexpr char HEX_LUT[] = "0123456789ABCDEF";
 static constexpr int MAX_UDS_SIZE = 4096;
 
 static string receivedDataBytes = "";
+
+/**
+ * Constructor. Creates a Lua state with the minimal standard libraries, the
+ * others are opened on first use, and installs the execution budget.
+ *
+ * @param name: the name of the memory metrics (e.g. the path of the Lua script)
+ */
+LuaContext::LuaContext(const string& name)
+: allocator(name)
+, state(&LuaAllocator::allocate, &allocator, false)
+{
+    LuaLibraries::open(state.GetLuaState());
+    budget.install(state.GetLuaState());
+}
+
+/**
+ * Configures the garbage collector of the state. Idle steps are taken from the
+ * timer thread, as long as no request holds the Lua lock. Has to be called
+ * with the Lua lock held.
+ *
+ * @param settings: the collector settings
+ */
+void LuaContext::configureCollector(const LuaGcSettings& settings)
+{
+    collector.configure(state.GetLuaState(), settings);
+    if (settings.steps != LuaGcSteps::IDLE)
+    {
+        return;
+    }
+
+    collector.startIdleSteps([pWeak = weak_from_this()]()
+    {
+        const shared_ptr<LuaContext> pLua = pWeak.lock();
+        if (pLua == nullptr)
+        {
+            return;
+        }
+        const unique_lock<std::mutex> lock(pLua->mutex, try_to_lock);
+        if (lock.owns_lock())
+        {
+            pLua->collector.idleStep(pLua->state.GetLuaState());
+        }
+    });
+}
+
+/**
+ * Returns the memory in use by the Lua state in bytes.
+ */
+static size_t luaMemory(lua_State* L) noexcept
+{
+    return size_t(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + size_t(lua_gc(L, LUA_GCCOUNTB, 0));
+}
+
+/**
+ * Sets `instance[field]` to `template[field] + (index - 1) * step`, if the
+ * template has a number in this field. The step is taken from the `Fleet`-table
+ * and defaults to 1.
+ */
+static void setSteppedField(lua_State* L, int tmpl, int fleet, int instance,
+                            const char* field, const char* stepField, unsigned int index)
+{
+    lua_getfield(L, tmpl, field);
+    if (lua_isnumber(L, -1))
+    {
+        lua_getfield(L, fleet, stepField);
+        const lua_Integer step = lua_isnumber(L, -1) ? lua_tointeger(L, -1) : 1;
+        lua_pushinteger(L, lua_tointeger(L, -2) + lua_Integer(index - 1) * step);
+        lua_setfield(L, instance, field);
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+}
+
+/**
+ * The member functions of the active instance, which are injected into the
+ * Lua state as `sel::bound_trampoline` with the `LuaContext` as upvalue.
+ */
+static uint32_t activeGetCurrentSession(LuaContext* pLua)
+{
+    return pLua->pActive->getCurrentSession();
+}
+
+static void activeSwitchToSession(LuaContext* pLua, uint32_t ses)
+{
+    pLua->pActive->switchToSession(ses);
+}
+
+static void activeSendRaw(LuaContext* pLua, string_view msg)
+{
+    pLua->pActive->sendRaw(msg);
+}
+
+static void activeSetDTCStatus(LuaContext* pLua, const string& dtc, uint32_t status)
+{
+    pLua->pActive->setDTCStatus(dtc, status);
+}
+
+static int activeGetDTCStatus(LuaContext* pLua, const string& dtc)
+{
+    return pLua->pActive->getDTCStatus(dtc);
+}
+
 /**
  * Constructor. Loads a Lua script and injects common used functions.
  *
@@ -32,60 +137,86 @@ static string receivedDataBytes = "";
  * @param luaScript: the path to the Lua script
  */
 EcuLuaScript::EcuLuaScript(const string& ecuIdent, const string& luaScript)
+: pLua_(make_shared<LuaContext>(luaScript))
 {
-    const std::lock_guard<std::mutex> lock(luaLock_);
-
-    if (utils::existsFile(luaScript))
-    {
-        // inject the C++ functions into the Lua script
-        // static functions
-        lua_state_["ascii"] = [](const string& utf8_str) -> string { return ascii(utf8_str); };
-        lua_state_["getCounterByte"] = [](const string& msg) -> string { return getCounterByte(msg); };
-        lua_state_["getDataBytes"] = [](const string& msg) { return getDataBytes(msg); };
-        lua_state_["createHash"] = []() -> string { return createHash(); };
-        lua_state_["toByteResponse"] = [](uint32_t value, uint32_t len = sizeof(uint32_t)) -> string { return toByteResponse(value, len); };
-        lua_state_["sleep"] = [](unsigned int ms) { return sleep(ms); };
-        // member functions
-        lua_state_["getCurrentSession"] = [this]() -> uint32_t { return this->getCurrentSession(); }; 
-        lua_state_["switchToSession"] = [this](uint32_t ses) { this->switchToSession(ses); };
-        lua_state_["sendRaw"] = [this](const string& msg) { this->sendRaw(msg); };
-
-        lua_state_.Load(luaScript);
-        if (lua_state_[ecuIdent.c_str()].exists())
-        {
-            ecu_ident_ = ecuIdent;
+    loadScript(ecuIdent, luaScript);
+}
 
-            auto requId = lua_state_[ecu_ident_.c_str()][REQ_ID_FIELD];
-            if (requId.exists())
-            {
-                hasRequestId_ = true;
-                requestId_ = uint32_t(requId);
-            }
+/**
+ * Constructor for a reloaded script, which replaces the given predecessor at
+ * run-time. The new script takes over the state, which has to survive the
+ * reload: the registered sender and session controller, the communication
+ * state, the security access (incl. an unlocked level) and the written DIDs.
+ * Everything else is loaded from the script again.
+ *
+ * @param ecuIdent: the identifier name for the ECU (e.g. "PCM")
+ * @param luaScript: the path to the Lua script
+ * @param predecessor: the currently active script of the ECU
+ * @see ScriptSlot::publish()
+ */
+EcuLuaScript::EcuLuaScript(const string& ecuIdent, const string& luaScript, const EcuLuaScript& predecessor)
+: pLua_(make_shared<LuaContext>(luaScript))
+, pSessionCtrl_(predecessor.pSessionCtrl_)
+, pIsoTpSender_(predecessor.pIsoTpSender_)
+, didStore_(predecessor.didStore_)
+, securityManager_(predecessor.securityManager_)
+, communication_(predecessor.communication_)
+{
+    loadScript(ecuIdent, luaScript);
+}
 
-            auto respId = lua_state_[ecu_ident_.c_str()][RES_ID_FIELD];
-            if (respId.exists())
-            {
-                hasResponseId_ = true;
-                responseId_ = uint32_t(respId);
-            }
+/**
+ * Constructor for an instance of a fleet. The instance shares the Lua state
+ * with the template and gets its own table `<ecuIdent>#<index>`, which holds
+ * the addresses and overrides of the instance and falls back to the template
+ * for everything else. While the instance is active, its table is the global
+ * `ECU`.
+ *
+ * @param fleetTemplate: the script loaded from the fleet config
+ * @param index: the instance number [1..count]
+ * @see EcuLuaScript::loadFleet()
+ */
+EcuLuaScript::EcuLuaScript(const EcuLuaScript& fleetTemplate, unsigned int index)
+: pLua_(fleetTemplate.pLua_)
+, ecu_ident_(fleetTemplate.ecu_ident_)
+, luaScript_(fleetTemplate.luaScript_)
+, fleetIndex_(index)
+{
+    const LuaLock lock(*this);
 
-            auto broadcastId = lua_state_[ecu_ident_.c_str()][BROADCAST_ID_FIELD];
-            if (broadcastId.exists())
-            {
-                hasBroadcastId_ = true;
-                broadcastId_ = uint32_t(broadcastId);
-            }
+    lua_State* L = pLua_->state.GetLuaState();
+    const size_t memory = luaMemory(L);
+    createInstanceTable(L, index);
+    ecu_ident_ += '#' + to_string(index);
+    setInstanceGlobal();
+    loadEcu();
+    privateMemory_ = luaMemory(L) - memory;
+}
 
-            auto j1939SourceAddress = lua_state_[ecu_ident_.c_str()][J1939_SOURCE_ADDRESS_FIELD];
-            if (j1939SourceAddress.exists())
-            {
-                hasJ1939SourceAddress_ = true;
-                j1939SourceAddress_ = uint32_t(j1939SourceAddress);
-            }
+/**
+ * Loads a config, which may define a fleet of ECUs by a `Fleet`-table in the
+ * ECU table. A fleet gives one script per instance, which all share the Lua
+ * state, an ordinary config gives a single script.
+ *
+ * @param ecuIdent: the identifier name for the ECU (e.g. "PCM")
+ * @param luaScript: the path to the Lua script
+ * @return the scripts of all instances
+ */
+vector<shared_ptr<EcuLuaScript>> EcuLuaScript::loadFleet(const string& ecuIdent, const string& luaScript)
+{
+    auto pScript = make_shared<EcuLuaScript>(ecuIdent, luaScript);
+    if (pScript->fleetSize_ == 0)
+    {
+        return {pScript};
+    }
 
-            return;
-        }
+    vector<shared_ptr<EcuLuaScript>> instances;
+    instances.reserve(pScript->fleetSize_);
+    for (unsigned int index = 1; index <= pScript->fleetSize_; ++index)
+    {
+        instances.push_back(make_shared<EcuLuaScript>(*pScript, index));
     }
+    return instances;
 }
 
 /**
@@ -94,14 +225,28 @@ EcuLuaScript::EcuLuaScript(const string& ecuIdent, const string& luaScript)
  * @param orig: the originating instance
  */
 EcuLuaScript::EcuLuaScript(EcuLuaScript&& orig) noexcept
-: lua_state_(move(orig.lua_state_))
+: pLua_(move(orig.pLua_))
 , ecu_ident_(move(orig.ecu_ident_))
+, luaScript_(move(orig.luaScript_))
+, fleetIndex_(orig.fleetIndex_)
+, fleetSize_(orig.fleetSize_)
+, privateMemory_(orig.privateMemory_)
 , pSessionCtrl_(orig.pSessionCtrl_)
 , pIsoTpSender_(orig.pIsoTpSender_)
 , requestId_(orig.requestId_)
 , responseId_(orig.responseId_)
 , broadcastId_(orig.broadcastId_)
 , j1939SourceAddress_(orig.j1939SourceAddress_)
+, rebootTime_(orig.rebootTime_)
+, budgetNrc_(orig.budgetNrc_)
+, snapshot_(move(orig.snapshot_))
+, dtcStore_(move(orig.dtcStore_))
+, didStore_(move(orig.didStore_))
+, routines_(move(orig.routines_))
+, securityManager_(move(orig.securityManager_))
+, communication_(move(orig.communication_))
+, rawSids_(orig.rawSids_)
+, didCalls_(move(orig.didCalls_))
 {
     orig.pSessionCtrl_ = nullptr;
     orig.pIsoTpSender_ = nullptr;
@@ -116,19 +261,56 @@ EcuLuaScript::EcuLuaScript(EcuLuaScript&& orig) noexcept
 EcuLuaScript& EcuLuaScript::operator=(EcuLuaScript&& orig) noexcept
 {
     assert(this != &orig);
-    lua_state_ = move(orig.lua_state_);
+    clearPreparedCalls();
+    pLua_ = move(orig.pLua_);
     ecu_ident_ = move(orig.ecu_ident_);
+    luaScript_ = move(orig.luaScript_);
+    fleetIndex_ = orig.fleetIndex_;
+    fleetSize_ = orig.fleetSize_;
+    privateMemory_ = orig.privateMemory_;
     pSessionCtrl_ = orig.pSessionCtrl_;
     pIsoTpSender_ = orig.pIsoTpSender_;
     requestId_ = orig.requestId_;
     responseId_ = orig.responseId_;
     broadcastId_ = orig.broadcastId_;
     j1939SourceAddress_ = orig.j1939SourceAddress_;
+    rebootTime_ = orig.rebootTime_;
+    budgetNrc_ = orig.budgetNrc_;
+    snapshot_ = move(orig.snapshot_);
+    dtcStore_ = move(orig.dtcStore_);
+    didStore_ = move(orig.didStore_);
+    routines_ = move(orig.routines_);
+    securityManager_ = move(orig.securityManager_);
+    communication_ = move(orig.communication_);
+    rawSids_ = orig.rawSids_;
+    didCalls_ = move(orig.didCalls_);
     orig.pIsoTpSender_ = nullptr;
     orig.pSessionCtrl_ = nullptr;
     return *this;
 };
 
+/**
+ * Destructor. The prepared calls are released with the Lua state locked, the
+ * state may be shared by the other instances of a fleet.
+ */
+EcuLuaScript::~EcuLuaScript()
+{
+    clearPreparedCalls();
+}
+
+/**
+ * Releases the prepared calls of the `ReadDataByIdentifier`-tables, before the
+ * Lua state is released.
+ */
+void EcuLuaScript::clearPreparedCalls() noexcept
+{
+    if (pLua_ != nullptr && !didCalls_.empty())
+    {
+        const lock_guard<mutex> lock(pLua_->mutex);
+        didCalls_.clear();
+    }
+}
+
 /**
  * Gets the UDS request ID according to the loaded Lua script. Since this call
  * is very common, the value is cached at the instantiation to avoid expensive
@@ -176,24 +358,23 @@ uint8_t EcuLuaScript::getJ1939SourceAddress() const
 
 /**
  * Reads the data according to `ReadDataByIdentifier`-table in the Lua script.
+ * The entry is either a string or a function returning a string or `Bytes`.
+ * Static entries are read without locking the Lua state.
  *
  * @param identifier: the identifier to access the field in the Lua table
  * @return the identifier field on success, otherwise an empty string
  */
 string EcuLuaScript::getDataByIdentifier(const string& identifier)
 {
-    const std::lock_guard<std::mutex> lock(luaLock_);
-
-    auto val = lua_state_[ecu_ident_.c_str()][READ_DATA_BY_IDENTIFIER_TABLE][identifier];
-
-    if (val.isFunction())
+    const auto pStatic = currentStaticEntries();
+    const string* pData = pStatic ? pStatic->findDataByIdentifier("", identifier) : nullptr;
+    if (pData != nullptr)
     {
-        return val(identifier);
-    }
-    else
-    {
-        return val;
+        return *pData;
     }
+
+    const LuaLock lock(*this);
+    return readDataByIdentifier(nullptr, identifier);
 }
 
 /**
@@ -205,25 +386,127 @@ string EcuLuaScript::getDataByIdentifier(const string& identifier)
  */
 string EcuLuaScript::getDataByIdentifier(const string& identifier, const string& session)
 {
-    const std::lock_guard<std::mutex> lock(luaLock_);
+    const auto pStatic = currentStaticEntries();
+    const string* pData = pStatic ? pStatic->findDataByIdentifier(session, identifier) : nullptr;
+    if (pData != nullptr)
+    {
+        return *pData;
+    }
 
-    auto val = lua_state_[ecu_ident_.c_str()][session][READ_DATA_BY_IDENTIFIER_TABLE][identifier];
+    const LuaLock lock(*this);
+    return readDataByIdentifier(session.c_str(), identifier);
+}
 
-    if (val.isFunction())
+/**
+ * Returns the data of the value at the given index of the stack: the buffer of
+ * `Bytes`, a string or an empty string for any other value.
+ */
+static string dataOf(lua_State* L, int index)
+{
+    const vector<uint8_t>* pBytes = LuaBytes::get(L, index);
+    if (pBytes != nullptr)
     {
-        return val(identifier);
+        return string(pBytes->cbegin(), pBytes->cend());
     }
-    else
+    if (lua_isstring(L, index))
     {
-        return val;
+        size_t len;
+        const char* str = lua_tolstring(L, index, &len);
+        return string(str, len);
+    }
+    return "";
+}
+
+/**
+ * Looks up and evaluates an entry of the `ReadDataByIdentifier`-table. Has to
+ * be called with the `LuaLock` held. Function entries are resolved into a
+ * `sel::PreparedCall` at their first read. Later reads only compare the entry
+ * with the prepared function, so an entry replaced at runtime takes effect
+ * with the next read.
+ *
+ * @param session: the session table or nullptr for the top level table
+ * @param identifier: the identifier to access the field in the Lua table
+ * @return the data (binary, if the function returned `Bytes`) or an empty string
+ */
+string EcuLuaScript::readDataByIdentifier(const char* session, const string& identifier)
+{
+    const string_view sessionKey = (session != nullptr) ? session : "";
+    lua_State* L = pLua_->state.GetLuaState();
+    const int top = lua_gettop(L);
+
+    lua_getglobal(L, ecu_ident_.c_str());
+    if (session != nullptr && lua_istable(L, -1))
+    {
+        lua_getfield(L, -1, session);
+    }
+    if (lua_istable(L, -1))
+    {
+        lua_getfield(L, -1, READ_DATA_BY_IDENTIFIER_TABLE);
+    }
+    if (lua_istable(L, -1))
+    {
+        lua_getfield(L, -1, identifier.c_str());
+    }
+    sel::PreparedCall* pCall = nullptr;
+    const auto calls = didCalls_.find(sessionKey);
+    if (calls != didCalls_.end())
+    {
+        const auto call = calls->second.find(identifier);
+        pCall = (call != calls->second.end()) ? &call->second : nullptr;
+    }
+    if (lua_isfunction(L, -1))
+    {
+        if (pCall == nullptr || !pCall->Refers(-1))
+        {
+            pCall = &(didCalls_[string(sessionKey)][identifier] = sel::PreparedCall(L, -1));
+        }
+        lua_settop(L, top);
+        return callDataByIdentifier(*pCall, identifier);
+    }
+    if (pCall != nullptr)
+    {
+        calls->second.erase(identifier); // the function has been replaced by a value
+    }
+
+    string data = dataOf(L, -1);
+    lua_settop(L, top);
+    return data;
+}
+
+/**
+ * Calls a function entry of the `ReadDataByIdentifier`-table with the
+ * identifier. Has to be called with the `LuaLock` held.
+ *
+ * @param call: the function of the entry
+ * @param identifier: the identifier passed to the function
+ * @return the data (binary, if the function returned `Bytes`) or an empty string
+ */
+string EcuLuaScript::callDataByIdentifier(const sel::PreparedCall& call, const string& identifier)
+{
+    lua_State* L = pLua_->state.GetLuaState();
+    const int top = lua_gettop(L);
+
+    if (call.Invoke(1, identifier) != LUA_OK)
+    {
+        cerr << __func__ << ": " << lua_tostring(L, -1) << endl;
+        if (pLua_->budget.isExceeded())
+        {
+            cerr << __func__ << "() ReadDataByIdentifier[\"" << identifier << "\"] exceeded its execution budget\n";
+        }
+        lua_settop(L, top);
+        return "";
     }
+
+    string data = dataOf(L, -1);
+    lua_settop(L, top);
+    return data;
 }
 
 string EcuLuaScript::getSeed(uint8_t seed_level)
 {
-    const std::lock_guard<std::mutex> lock(luaLock_);
+    const LuaLock lock(*this);
 
-    auto val = lua_state_[ecu_ident_.c_str()][READ_SEED][seed_level];
+    auto val = pLua_->state[ecu_ident_.c_str()][READ_SEED][seed_level];
     if (val.exists())
     {
         return val;
@@ -231,31 +514,110 @@ string EcuLuaScript::getSeed(uint8_t seed_level)
     return "";
 }
 
+/**
+ * Returns the value of a hex digit or -1 for any other character.
+ */
+static int hexDigitValue(char c) noexcept
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * Appends the bytes of a literal hex string to the given buffer. Blanks are
+ * ignored, the remaining characters are taken pairwise. A pair starting with
+ * a non hex character gives 0x00, a single trailing digit gives its value.
+ *
+ * @param hexString: the literal hex string (e.g. "41 6f 54")
+ * @param out: the buffer to append the bytes to
+ */
+template <typename Bytes>
+static void appendHexBytes(string_view hexString, Bytes& out)
+{
+    out.reserve(out.size() + (hexString.length() + 1) / 2);
+    int pending = -1; // first digit of the current pair, -2 for a non hex character
+    for (const char c : hexString)
+    {
+        if (c == ' ')
+        {
+            continue;
+        }
+        const int digit = hexDigitValue(c);
+        if (pending == -1)
+        {
+            pending = (digit < 0) ? -2 : digit;
+            continue;
+        }
+        if (pending == -2)
+        {
+            out.push_back(0x00);
+        }
+        else
+        {
+            out.push_back(uint8_t((digit < 0) ? pending : (pending << 4) | digit));
+        }
+        pending = -1;
+    }
+    if (pending != -1)
+    {
+        out.push_back(uint8_t((pending < 0) ? 0x00 : pending));
+    }
+}
+
 /**
  * Converts a literal hex string into a value vector.
  *
  * @param hexString: the literal hex string (e.g. "41 6f 54")
  * @return a vector with the byte values
  */
-vector<uint8_t> EcuLuaScript::literalHexStrToBytes(const string& hexString)
+vector<uint8_t> EcuLuaScript::literalHexStrToBytes(string_view hexString)
 {
-    // make a working copy
-    string tmpStr = hexString;
-    // remove white spaces from string
-    tmpStr.erase(remove(tmpStr.begin(), tmpStr.end(), ' '), tmpStr.end());
     vector<uint8_t> data;
-    // plus `% 2` just in case of a "odd" byte number
-    data.reserve(tmpStr.length() / 2 + (tmpStr.length() % 2));
-    string byteString;
-    uint8_t byte;
-    for (size_t i = 0; i < tmpStr.length(); i += 2)
+    appendHexBytes(hexString, data);
+    return data;
+}
+
+/**
+ * Appends the bytes of a literal hex string to a request scoped buffer.
+ *
+ * @param hexString: the literal hex string (e.g. "41 6f 54")
+ * @param out: the buffer to append the bytes to
+ * @see EcuLuaScript::literalHexStrToBytes()
+ */
+void EcuLuaScript::appendLiteralHexStr(string_view hexString, ArenaBytes& out)
+{
+    appendHexBytes(hexString, out);
+}
+
+/**
+ * Converts a literal DTC string into the numeric 3 byte DTC.
+ *
+ * Example:
+ *     `dtcFromString("C0 12 34")` -> `0xC01234`
+ *
+ * @param dtcString: the literal hex string of the DTC
+ * @return the DTC number (only the first 3 bytes are considered)
+ */
+uint32_t EcuLuaScript::dtcFromString(const string& dtcString)
+{
+    const vector<uint8_t> bytes = literalHexStrToBytes(dtcString);
+    uint32_t dtc = 0;
+    for (size_t i = 0; i < bytes.size() && i < 3; ++i)
     {
-        byteString = tmpStr.substr(i, 2);
-        byte = static_cast<uint8_t> (strtol(byteString.c_str(), NULL, 16));
-        data.push_back(byte);
+        dtc = (dtc << 8) | bytes[i];
     }
-    cout << endl;
-    return data;
+    return dtc;
 }
 
 /**
@@ -273,7 +635,7 @@ vector<uint8_t> EcuLuaScript::literalHexStrToBytes(const string& hexString)
  * @note To allow a seamless string concatenation, the returned string always
  * begins and ends with an whitespace.
  */
-string EcuLuaScript::ascii(const string& utf8_str) noexcept
+string EcuLuaScript::ascii(string_view utf8_str) noexcept
 {
     const size_t len = utf8_str.length();
     if (len == 0)
@@ -361,48 +723,22 @@ string EcuLuaScript::toByteResponse(uint32_t value,
     {
         len = MAX_UDS_SIZE;
     }
-
-    static constexpr int CHAR_SP = 3; // character space for 2 hex digits + 1 whitespace
-    const int zeroFill = len - sizeof(value);
-
-    if (zeroFill < 0)
+    if (len == 0)
     {
-        // truncated value
-        const size_t space = len * CHAR_SP;
-        char str[space];
-        for (size_t i = 0, j = (len * 2 - 1) * 4; i < space; i += CHAR_SP, j -= 8)
-        {
-            str[i] = HEX_LUT[(value >> j) & 0x0F];
-            str[i + 1] = HEX_LUT[(value >> (j - 4)) & 0x0F];
-            str[i + 2] = ' ';
-        }
-        str[space - 1] = '\0';
-        return str;
+        return "";
     }
-    else
-    {
-        // fill up wit zeros
-        const size_t space = ((sizeof(value) + zeroFill) * CHAR_SP);
-        const size_t valSpace = zeroFill * CHAR_SP;
-        char str[space];
-        for (size_t i = 0; i < valSpace; i += CHAR_SP)
-        {
-            str[i] = '0';
-            str[i + 1] = '0';
-            str[i + 2] = ' ';
-        }
 
-        // insert hex values
-        for (size_t i = valSpace, j = (sizeof(value) * 2 - 1) * 4; i < space; i += CHAR_SP, j -= 8)
-        {
-            str[i] = HEX_LUT[(value >> j) & 0x0F];
-            str[i + 1] = HEX_LUT[(value >> (j - 4)) & 0x0F];
-            str[i + 2] = ' ';
-        }
-        str[space - 1] = '\0';
-        return str;
+    static constexpr size_t CHAR_SP = 3; // character space for 2 hex digits + 1 whitespace
+    string str(len * CHAR_SP - 1, ' ');
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        // bytes in front of the value are filled up with zeros
+        const uint32_t shift = (len - 1 - i) * 8;
+        const uint8_t byte = (shift < sizeof(value) * 8) ? uint8_t(value >> shift) : 0x00;
+        str[i * CHAR_SP] = HEX_LUT[byte >> 4];
+        str[i * CHAR_SP + 1] = HEX_LUT[byte & 0x0F];
     }
-    return "";
+    return str;
 }
 
 /**
@@ -410,7 +746,7 @@ string EcuLuaScript::toByteResponse(uint32_t value,
  *
  * @param response: the raw response message to send (e.g. "DE AD C0 DE")
  */
-void EcuLuaScript::sendRaw(const string& response) const
+void EcuLuaScript::sendRaw(string_view response) const
 {
     assert(pIsoTpSender_ != nullptr);
 
@@ -452,75 +788,771 @@ void EcuLuaScript::switchToSession(int ses)
 }
 
 /**
- * Checks if the identifier is in the Raw-section of the lua script.
- *
- * @param identStr: the identifier string for the entry in the Lua "Raw"-table
- * @return true if identifier is in the raw section, false otherwise
+ * Resets the volatile state of the ECU like a power cycle: running routines
+ * are stopped, the security access is locked, all communication and the DTC
+ * setting are enabled and a new DTC operation cycle starts. The Lua globals
+ * are restored from the snapshot taken after loading the script. Afterwards,
+ * the ECU stays silent for `RebootTime` milliseconds. Written DIDs and the DTC
+ * records are kept, since they are non-volatile.
  */
-bool EcuLuaScript::hasRaw(const string& identStr)
+void EcuLuaScript::reset()
 {
-    const std::lock_guard<std::mutex> lock(luaLock_);
-
-    auto val = lua_state_[ecu_ident_.c_str()][RAW_TABLE][identStr.c_str()];
-    if(val.exists()==false){
-        string identStrWorking = " ";
-        //offset for the first byte
-        int counter = 2;
-        while(val.exists() == false && identStrWorking.length() < identStr.length()){
-            //appends wildcard sign after the bytes that are tested
-            identStrWorking = identStr.substr(0,counter).append(" *");
-            val = lua_state_[ecu_ident_.c_str()][RAW_TABLE][identStrWorking.c_str()];
-            //counter + blank + bytelength
-            counter = counter + 3;
-        }
+    communication_->suspend(rebootTime_);
+    routines_->stopAll();
+    if (securityManager_ != nullptr)
+    {
+        securityManager_->lock();
     }
-    return val.exists();
+    communication_->reset();
+    dtcStore_.startOperationCycle();
+
+    const LuaLock lock(*this);
+    pLua_->staticTables.invalidate();
+    snapshot_.restore(pLua_->state.GetLuaState());
+    didCalls_.clear();
 }
 
 /**
- * Gets all request entries from the Lua "Raw"-Table.
+ * Sets the status byte of a DTC. Unknown DTCs are added to the DTC store.
+ * While the DTC setting is switched off (`85 02`), the call is ignored.
  *
- * @return vector of raw request data as they are configured in lua
+ * @param dtc: the literal DTC string (e.g. "C0 12 34")
+ * @param status: the new status byte
  */
-vector<string> EcuLuaScript::getRawRequests()
+void EcuLuaScript::setDTCStatus(const string& dtc, uint32_t status)
 {
-    const std::lock_guard<std::mutex> lock(luaLock_);
-
-    auto rawTable = lua_state_[ecu_ident_.c_str()][RAW_TABLE];
-    if(rawTable.exists()) {
-        return rawTable.getKeys();
-    } else {
-        return vector<string>();
+    if (!communication_->isDtcSettingEnabled())
+    {
+        return;
     }
+    dtcStore_.setStatus(dtcFromString(dtc), uint8_t(status));
 }
 
 /**
- * Gets J1939 PGNS from the Lua PGN-Table.
+ * Gets the status byte of a DTC.
  *
- * @return vector of raw message data as they are configured in lua
+ * @param dtc: the literal DTC string (e.g. "C0 12 34")
+ * @return the status byte or -1 if the DTC is unknown
  */
-vector<string> EcuLuaScript::getJ1939PGNs()
+int EcuLuaScript::getDTCStatus(const string& dtc) const
 {
-    const std::lock_guard<std::mutex> lock(luaLock_);
-
-    cout << "Get PGNs from ident: " << ecu_ident_ << endl;
-    auto pgnTable = lua_state_[ecu_ident_.c_str()][J1939_PGN_TABLE];
-    if(pgnTable.exists()) {
-        return pgnTable.getKeys();
-    } else {
-        return vector<string>();
-    }
+    return dtcStore_.getStatus(dtcFromString(dtc));
 }
 
-J1939PGNData EcuLuaScript::getJ1939PGNData(const string& pgn)
-{
-    const std::lock_guard<std::mutex> lock(luaLock_);
-
+/**
+ * Locks the Lua state, activates the script and starts the execution budget,
+ * which is shared by all calls into Lua while the lock is held. The counter
+ * `lua.lock_contended` gives the number of times the lock was held by another
+ * thread, the histogram `lua.lock_wait_us` the time waited for it then.
+ *
+ * @param script: the script to call into
+ */
+EcuLuaScript::LuaLock::LuaLock(EcuLuaScript& script)
+: lock_(script.pLua_->mutex, try_to_lock)
+, context_(*script.pLua_)
+{
+    static metrics::Counter& numContended = metrics::counter("lua.lock_contended");
+    static metrics::Histogram& waitTime = metrics::histogram("lua.lock_wait_us");
+
+    if (!lock_.owns_lock())
+    {
+        numContended.increment();
+        const auto start = chrono::steady_clock::now();
+        lock_.lock();
+        waitTime.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+    }
+    acquired_ = chrono::steady_clock::now();
+    script.activate();
+    context_.budget.start();
+}
+
+/**
+ * Destructor. Records the spent budget, compiles the static tables again, if
+ * the Lua code has written or replaced one, and gives the garbage collector
+ * the chance to run a step, before the Lua state is unlocked. The
+ * histogram `lua.lock_hold_us` gives the time the lock was held.
+ */
+EcuLuaScript::LuaLock::~LuaLock()
+{
+    static metrics::Histogram& holdTime = metrics::histogram("lua.lock_hold_us");
+
+    context_.budget.stop();
+    context_.staticTables.refresh(context_.state.GetLuaState());
+    context_.collector.afterCall(context_.state.GetLuaState());
+    holdTime.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - acquired_).count());
+}
+
+/**
+ * Returns the static entries of the script, if they are up to date with the
+ * Lua state, so they can be read without the `LuaLock`.
+ *
+ * @return the static entries or nullptr if they are outdated
+ * @see StaticTables::get()
+ */
+shared_ptr<const StaticEntries> EcuLuaScript::currentStaticEntries() const noexcept
+{
+    return pLua_->staticTables.get(fleetIndex_);
+}
+
+/**
+ * Makes the script the instance, which the injected member functions (e.g.
+ * `getCurrentSession()`) and the global `ECU` refer to. Only instances of a
+ * fleet ever take turns. Has to be called with the `LuaLock` held.
+ */
+void EcuLuaScript::activate() noexcept
+{
+    if (pLua_->pActive != this)
+    {
+        pLua_->pActive = this;
+        setInstanceGlobal();
+    }
+}
+
+/**
+ * Sets the global `ECU` to the table of the script.
+ */
+void EcuLuaScript::setInstanceGlobal() noexcept
+{
+    lua_State* L = pLua_->state.GetLuaState();
+    lua_getglobal(L, ecu_ident_.c_str());
+    lua_setglobal(L, FLEET_INSTANCE_GLOBAL);
+}
+
+/**
+ * Gets the memory in use by the Lua state, which is shared by all instances of
+ * a fleet.
+ *
+ * @return the size in bytes
+ * @see getPrivateMemory()
+ */
+size_t EcuLuaScript::getLuaMemory()
+{
+    const LuaLock lock(*this);
+    return luaMemory(pLua_->state.GetLuaState());
+}
+
+/**
+ * Loads a Lua script and injects common used functions. If the script has no
+ * table for the given ECU, nothing but the functions is loaded. A table with a
+ * `Fleet`-table is only loaded as template.
+ *
+ * @param ecuIdent: the identifier name for the ECU (e.g. "PCM")
+ * @param luaScript: the path to the Lua script
+ * @see EcuLuaScript::loadFleet()
+ */
+void EcuLuaScript::loadScript(const string& ecuIdent, const string& luaScript)
+{
+    const LuaLock lock(*this);
+
+    if (utils::existsFile(luaScript))
+    {
+        // inject the C++ functions into the Lua script, as plain C functions
+        // with the argument conversion inlined
+        // static functions
+        pLua_->state["ascii"] = sel::trampoline<&ascii>;
+        pLua_->state["getCounterByte"] = sel::trampoline<&getCounterByte>;
+        pLua_->state["getDataBytes"] = sel::trampoline<&getDataBytes>;
+        pLua_->state["createHash"] = sel::trampoline<&createHash>;
+        pLua_->state["toByteResponse"] = sel::trampoline<&toByteResponse>;
+        pLua_->state["sleep"] = sel::trampoline<&sleep>;
+        // member functions of the active instance
+        LuaContext* pLua = pLua_.get();
+        pLua_->state["getCurrentSession"].SetClosure(sel::bound_trampoline<&activeGetCurrentSession>, pLua);
+        pLua_->state["switchToSession"].SetClosure(sel::bound_trampoline<&activeSwitchToSession>, pLua);
+        pLua_->state["sendRaw"].SetClosure(sel::bound_trampoline<&activeSendRaw>, pLua);
+        pLua_->state["setDTCStatus"].SetClosure(sel::bound_trampoline<&activeSetDTCStatus>, pLua);
+        pLua_->state["getDTCStatus"].SetClosure(sel::bound_trampoline<&activeGetDTCStatus>, pLua);
+        LuaBytes::registerType(pLua_->state.GetLuaState());
+        StaticTables::registerIterators(pLua_->state.GetLuaState());
+
+        // unchanged scripts are loaded as precompiled bytecode
+        lua_State* L = pLua_->state.GetLuaState();
+        if (LuaChunkCache::load(L, luaScript) != LUA_OK || lua_pcall(L, 0, 0, 0) != LUA_OK)
+        {
+            cerr << __func__ << "() " << lua_tostring(L, -1) << '\n';
+            lua_pop(L, 1);
+        }
+        if (pLua_->state[ecuIdent.c_str()].exists())
+        {
+            ecu_ident_ = ecuIdent;
+            luaScript_ = luaScript;
+
+            // scripts running out of memory fail instead of growing the simulator
+            auto memoryLimit = pLua_->state[ecu_ident_.c_str()][MEMORY_LIMIT_FIELD];
+            if (memoryLimit.exists())
+            {
+                pLua_->allocator.setLimit(uint32_t(memoryLimit));
+            }
+            auto libraries = pLua_->state[ecu_ident_.c_str()][LUA_LIBRARIES_FIELD];
+            if (libraries.exists())
+            {
+                LuaLibraries::setProfile(L, LuaLibraries::profileFromString(string(libraries)));
+            }
+            loadGarbageCollector();
+            loadExecutionBudget();
+
+            auto fleet = pLua_->state[ecu_ident_.c_str()][FLEET_TABLE];
+            if (fleet.isTable())
+            {
+                auto count = fleet[FLEET_COUNT_FIELD];
+                fleetSize_ = count.exists() ? uint32_t(count) : 0;
+                return; // the instances are created by loadFleet()
+            }
+            setInstanceGlobal();
+            loadEcu();
+        }
+    }
+}
+
+/**
+ * Configures the garbage collector from the optional `GarbageCollector`-table
+ * of the Lua script. The `mode` is "incremental" or "generational" (Lua 5.2
+ * and 5.4), `pause` and `stepmul` tune the collector in percent. `steps`
+ * selects who runs the collector: Lua itself ("auto"), a step after every
+ * call ("request") or steps every `interval` ms while the ECU is idle
+ * ("idle"), each step doing the work of `stepSize` KiB allocations. Has to be
+ * called with the `LuaLock` held.
+ */
+void EcuLuaScript::loadGarbageCollector()
+{
+    auto table = pLua_->state[ecu_ident_.c_str()][GC_TABLE];
+    if (!table.isTable())
+    {
+        return;
+    }
+
+    LuaGcSettings settings;
+    auto mode = table[GC_MODE_FIELD];
+    settings.isGenerational = mode.exists() && string(mode) == "generational";
+    auto pause = table[GC_PAUSE_FIELD];
+    settings.pause = pause.exists() ? int(pause) : 0;
+    auto stepMul = table[GC_STEPMUL_FIELD];
+    settings.stepMul = stepMul.exists() ? int(stepMul) : 0;
+    auto stepSize = table[GC_STEP_SIZE_FIELD];
+    settings.stepSize = stepSize.exists() ? int(stepSize) : 0;
+    auto steps = table[GC_STEPS_FIELD];
+    settings.steps = steps.exists() ? LuaCollector::stepsFromString(string(steps)) : LuaGcSteps::AUTO;
+    auto interval = table[GC_INTERVAL_FIELD];
+    if (interval.exists())
+    {
+        settings.interval = chrono::milliseconds(max(uint32_t(interval), uint32_t(1)));
+    }
+    pLua_->configureCollector(settings);
+}
+
+/**
+ * Sets the execution budget of a single call from the optional
+ * `ExecutionBudget`-table of the Lua script. A call running more than
+ * `instructions` VM instructions or longer than `time` ms is aborted, a `Raw`
+ * request is then answered with the negative response code `nrc` (default
+ * generalReject). Has to be called with the `LuaLock` held.
+ */
+void EcuLuaScript::loadExecutionBudget()
+{
+    auto table = pLua_->state[ecu_ident_.c_str()][BUDGET_TABLE];
+    if (!table.isTable())
+    {
+        return;
+    }
+
+    auto instructions = table[BUDGET_INSTRUCTIONS_FIELD];
+    auto time = table[BUDGET_TIME_FIELD];
+    pLua_->budget.setLimits(instructions.exists() ? uint32_t(instructions) : 0,
+                            chrono::milliseconds(time.exists() ? uint32_t(time) : 0));
+    auto nrc = table[BUDGET_NRC_FIELD];
+    if (nrc.exists())
+    {
+        budgetNrc_ = uint8_t(uint32_t(nrc));
+    }
+}
+
+/**
+ * Creates the table of a fleet instance as global `<ecuIdent>#<index>`. The
+ * `RequestId`, `ResponseId` and `J1939SourceAddress` of the template are
+ * increased by `(index - 1)` times the step given in the `Fleet`-table. The
+ * entries of `Fleet[index]` override the template, tables are merged with the
+ * according table of the template. Has to be called with the `LuaLock` held.
+ *
+ * @param L: the Lua state
+ * @param index: the instance number [1..count]
+ */
+void EcuLuaScript::createInstanceTable(lua_State* L, unsigned int index)
+{
+    const int top = lua_gettop(L);
+    lua_getglobal(L, ecu_ident_.c_str());
+    const int tmpl = lua_gettop(L);
+    lua_getfield(L, tmpl, FLEET_TABLE);
+    const int fleet = lua_gettop(L);
+    lua_newtable(L);
+    const int instance = lua_gettop(L);
+
+    setSteppedField(L, tmpl, fleet, instance, REQ_ID_FIELD, FLEET_REQ_ID_STEP_FIELD, index);
+    setSteppedField(L, tmpl, fleet, instance, RES_ID_FIELD, FLEET_RES_ID_STEP_FIELD, index);
+    setSteppedField(L, tmpl, fleet, instance, J1939_SOURCE_ADDRESS_FIELD, FLEET_J1939_SOURCE_ADDRESS_STEP_FIELD, index);
+
+    lua_rawgeti(L, fleet, index);
+    const int overrides = lua_gettop(L);
+    if (lua_istable(L, overrides))
+    {
+        lua_pushnil(L);
+        while (lua_next(L, overrides) != 0)
+        {
+            // stack: key, value
+            lua_pushvalue(L, -2);
+            lua_gettable(L, tmpl);
+            if (lua_istable(L, -1) && lua_istable(L, -2))
+            {
+                // shallow copy of the template table, updated by the override
+                lua_newtable(L);
+                for (const int src : {-2, -3})
+                {
+                    StaticTables::pushStorage(L, src);
+                    const int from = lua_gettop(L);
+                    lua_pushnil(L);
+                    while (lua_next(L, from) != 0)
+                    {
+                        lua_pushvalue(L, -2);
+                        lua_insert(L, -2);
+                        lua_rawset(L, -5);
+                    }
+                    lua_pop(L, 1);
+                }
+                lua_replace(L, -3);
+            }
+            lua_pop(L, 1);
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, instance);
+        }
+    }
+
+    lua_createtable(L, 0, 1);
+    lua_pushvalue(L, tmpl);
+    lua_setfield(L, -2, "__index");
+    lua_setmetatable(L, instance);
+
+    lua_pushvalue(L, instance);
+    lua_setglobal(L, (ecu_ident_ + '#' + to_string(index)).c_str());
+    lua_settop(L, top);
+}
+
+/**
+ * Reads the addresses of the ECU table, loads the native tables and takes the
+ * snapshot for `reset()`. The snapshot of a fleet instance only covers its own
+ * table, the template is shared. Has to be called with the `LuaLock` held.
+ */
+void EcuLuaScript::loadEcu()
+{
+    auto requId = pLua_->state[ecu_ident_.c_str()][REQ_ID_FIELD];
+    if (requId.exists())
+    {
+        hasRequestId_ = true;
+        requestId_ = uint32_t(requId);
+    }
+
+    auto respId = pLua_->state[ecu_ident_.c_str()][RES_ID_FIELD];
+    if (respId.exists())
+    {
+        hasResponseId_ = true;
+        responseId_ = uint32_t(respId);
+    }
+
+    auto broadcastId = pLua_->state[ecu_ident_.c_str()][BROADCAST_ID_FIELD];
+    if (broadcastId.exists())
+    {
+        hasBroadcastId_ = true;
+        broadcastId_ = uint32_t(broadcastId);
+    }
+
+    auto j1939SourceAddress = pLua_->state[ecu_ident_.c_str()][J1939_SOURCE_ADDRESS_FIELD];
+    if (j1939SourceAddress.exists())
+    {
+        hasJ1939SourceAddress_ = true;
+        j1939SourceAddress_ = uint32_t(j1939SourceAddress);
+    }
+
+    auto rebootTime = pLua_->state[ecu_ident_.c_str()][REBOOT_TIME_FIELD];
+    if (rebootTime.exists())
+    {
+        rebootTime_ = chrono::milliseconds(uint32_t(rebootTime));
+    }
+
+    loadDtcs();
+    loadDids();
+    loadRoutines();
+    loadSecurityAccess();
+    loadRawServices();
+    pLua_->staticTables.addInstance(fleetIndex_, ecu_ident_);
+
+    lua_State* L = pLua_->state.GetLuaState();
+    if (fleetIndex_ == 0)
+    {
+        snapshot_.take(L);
+        return;
+    }
+    lua_getglobal(L, ecu_ident_.c_str());
+    snapshot_.take(L, lua_gettop(L));
+    lua_pop(L, 1);
+}
+
+/**
+ * Loads the `DTCs`-table of the Lua script into the native DTC store. An entry
+ * is either a plain status byte or a table with a `status` field and optional
+ * `Snapshots` and `ExtendedData` tables (record number -> literal hex string).
+ * Has to be called with the `LuaLock` held.
+ */
+void EcuLuaScript::loadDtcs()
+{
+    auto mask = pLua_->state[ecu_ident_.c_str()][DTC_AVAILABILITY_MASK_FIELD];
+    if (mask.exists())
+    {
+        dtcStore_.setStatusAvailabilityMask(uint8_t(uint32_t(mask)));
+    }
+
+    auto dtcTable = pLua_->state[ecu_ident_.c_str()][DTC_TABLE];
+    if (!dtcTable.isTable())
+    {
+        return;
+    }
+
+    for (const string& key : dtcTable.getKeys())
+    {
+        const uint32_t dtc = dtcFromString(key);
+        auto val = pLua_->state[ecu_ident_.c_str()][DTC_TABLE][key];
+        if (!val.isTable())
+        {
+            dtcStore_.add(dtc, uint8_t(uint32_t(val)));
+            continue;
+        }
+
+        auto status = val[DTC_STATUS_FIELD];
+        dtcStore_.add(dtc, status.exists() ? uint8_t(uint32_t(status)) : 0x00);
+
+        auto snapshots = val[DTC_SNAPSHOT_TABLE];
+        for (const string& rec : snapshots.isTable() ? snapshots.getKeys() : vector<string>())
+        {
+            const int record = stoi(rec, nullptr, 0);
+            dtcStore_.setSnapshotRecord(dtc, uint8_t(record), literalHexStrToBytes(snapshots[record]));
+        }
+
+        auto extended = val[DTC_EXTENDED_DATA_TABLE];
+        for (const string& rec : extended.isTable() ? extended.getKeys() : vector<string>())
+        {
+            const int record = stoi(rec, nullptr, 0);
+            dtcStore_.setExtendedDataRecord(dtc, uint8_t(record), literalHexStrToBytes(extended[record]));
+        }
+    }
+}
+
+/**
+ * Loads the `DIDStore`-table of the Lua script into the native DID store and
+ * replays the journal file of previously written values. An entry consists of
+ * a `type` ("ascii", "uint" or "bytes"), an optional fixed `length` and the
+ * `default` value. The journal is stored next to the Lua script, unless the
+ * path is given by the `DIDStoreFile` field. A store taken over from the
+ * predecessor of a reloaded script is kept as it is. Each instance of a fleet
+ * has its own journal with the instance number appended. Has to be called
+ * with the `LuaLock` held.
+ */
+void EcuLuaScript::loadDids()
+{
+    auto didTable = pLua_->state[ecu_ident_.c_str()][DID_STORE_TABLE];
+    if (!didTable.isTable())
+    {
+        return;
+    }
+
+    if (didStore_ != nullptr)
+    {
+        return; // taken over from the predecessor
+    }
+
+    didStore_ = make_shared<DidStore>();
+    for (const string& key : didTable.getKeys())
+    {
+        const uint16_t did = uint16_t(dtcFromString(key));
+        auto entry = pLua_->state[ecu_ident_.c_str()][DID_STORE_TABLE][key];
+        auto typeField = entry[DID_TYPE_FIELD];
+        const DidType type = DidStore::typeFromString(typeField.exists() ? string(typeField) : "");
+        auto lengthField = entry[DID_LENGTH_FIELD];
+        size_t length = lengthField.exists() ? size_t(uint32_t(lengthField)) : 0;
+
+        vector<uint8_t> value;
+        auto defaultField = entry[DID_DEFAULT_FIELD];
+        const string defaultStr = (defaultField.exists() && type != DidType::UINT) ? string(defaultField) : "";
+        switch (type)
+        {
+            case DidType::ASCII:
+            {
+                value.assign(defaultStr.cbegin(), defaultStr.cend());
+                break;
+            }
+            case DidType::UINT:
+            {
+                // unsigned numbers always have a fixed length
+                length = (length == 0) ? sizeof(uint32_t) : length;
+                const uint32_t number = defaultField.exists() ? uint32_t(defaultField) : 0;
+                for (size_t i = length; i > 0; --i)
+                {
+                    value.push_back((i > sizeof(number)) ? 0 : uint8_t(number >> ((i - 1) * 8)));
+                }
+                break;
+            }
+            default:
+                value = literalHexStrToBytes(defaultStr);
+                break;
+        }
+        if (length != 0)
+        {
+            value.resize(length, type == DidType::ASCII ? ' ' : 0x00);
+        }
+        didStore_->define(did, type, length, value);
+    }
+
+    auto fileField = pLua_->state[ecu_ident_.c_str()][DID_STORE_FILE_FIELD];
+    string journal = fileField.exists() ? string(fileField) : luaScript_ + ".dids";
+    if (fleetIndex_ != 0)
+    {
+        journal += '.' + to_string(fleetIndex_);
+    }
+    if (didStore_->open(journal) != 0)
+    {
+        cerr << __func__ << "() written DIDs of " << ecu_ident_ << " are not persistent\n";
+    }
+}
+
+/**
+ * Defines the routines of the `Routines`-table of the Lua script. The run time
+ * of a routine is simulated by its `duration` in milliseconds, during which
+ * the progress is increased in steps of 5 %. The optional `start` entry is
+ * evaluated with the start request, the `result` entry once the duration
+ * elapsed. Both are either literal hex strings or functions, which are called
+ * with the routine identifier. Has to be called with the `LuaLock` held.
+ */
+void EcuLuaScript::loadRoutines()
+{
+    auto routineTable = pLua_->state[ecu_ident_.c_str()][ROUTINE_TABLE];
+    if (!routineTable.isTable())
+    {
+        return;
+    }
+
+    for (const string& key : routineTable.getKeys())
+    {
+        const uint16_t rid = uint16_t(dtcFromString(key));
+        auto duration = pLua_->state[ecu_ident_.c_str()][ROUTINE_TABLE][key][ROUTINE_DURATION_FIELD];
+        const unsigned int durationMs = duration.exists() ? uint32_t(duration) : 0;
+
+        routines_->define(rid,
+            [this, key, durationMs](RoutineRun& run)
+            {
+                constexpr unsigned int NUM_STEPS = 20;
+                for (unsigned int step = 1; step <= NUM_STEPS; ++step)
+                {
+                    if (!run.sleepFor(chrono::milliseconds(durationMs / NUM_STEPS)))
+                    {
+                        return;
+                    }
+                    run.setProgress(uint8_t(step * 100 / NUM_STEPS));
+                }
+                run.setResult(getRoutineBytes(key, ROUTINE_RESULT_FIELD));
+            },
+            [this, key]()
+            {
+                return getRoutineBytes(key, ROUTINE_START_FIELD);
+            });
+    }
+}
+
+/**
+ * Creates the native `SecurityAccess` handling from the `SecurityAccess`-table
+ * of the Lua script. The `algorithm` is either the name of a built-in
+ * algorithm ("xor", "add") or the path to a shared object, which gets the
+ * secret `constant` as parameter. The security access taken over from the
+ * predecessor of a reloaded script is kept. Has to be called with the
+ * `LuaLock` held.
+ *
+ * @see SecurityAlgorithm::create()
+ */
+void EcuLuaScript::loadSecurityAccess()
+{
+    auto table = pLua_->state[ecu_ident_.c_str()][SECURITY_ACCESS_TABLE];
+    if (!table.isTable() || securityManager_ != nullptr)
+    {
+        return;
+    }
+
+    auto algorithm = table[SECURITY_ALGORITHM_FIELD];
+    auto constant = table[SECURITY_CONSTANT_FIELD];
+    auto seedLength = table[SECURITY_SEED_LENGTH_FIELD];
+    auto maxAttempts = table[SECURITY_MAX_ATTEMPTS_FIELD];
+    auto delay = table[SECURITY_DELAY_FIELD];
+
+    auto pAlgorithm = SecurityAlgorithm::create(algorithm.exists() ? string(algorithm) : "xor",
+                                                constant.exists() ? uint32_t(constant) : 0);
+    if (pAlgorithm == nullptr)
+    {
+        cerr << __func__ << "() SecurityAccess of " << ecu_ident_ << " is disabled\n";
+        return;
+    }
+    securityManager_ = make_shared<SecurityManager>(move(pAlgorithm),
+                                                    seedLength.exists() ? uint32_t(seedLength) : 4,
+                                                    maxAttempts.exists() ? uint32_t(maxAttempts) : 3,
+                                                    chrono::milliseconds(delay.exists() ? uint32_t(delay) : 10000));
+}
+
+/**
+ * Evaluates an entry of a routine in the `Routines`-table. The literal hex
+ * string is parsed in place, while the lock is held.
+ *
+ * @param rid: the routine identifier string (e.g. "FF 00")
+ * @param field: the name of the entry (e.g. "result")
+ * @return the bytes of the entry or an empty vector if there is no entry
+ */
+vector<uint8_t> EcuLuaScript::getRoutineBytes(const string& rid, const char* field)
+{
+    const LuaLock lock(*this);
+
+    auto val = pLua_->state[ecu_ident_.c_str()][ROUTINE_TABLE][rid][field];
+    if (val.isFunction())
+    {
+        return literalHexStrToBytes(val(rid).toStringView());
+    }
+    if (val.exists())
+    {
+        return literalHexStrToBytes(val);
+    }
+    return {};
+}
+
+/**
+ * Checks if the identifier is in the Raw-section of the lua script.
+ *
+ * @param identStr: the identifier string for the entry in the Lua "Raw"-table
+ * @return true if identifier is in the raw section, false otherwise
+ */
+bool EcuLuaScript::hasRaw(const string& identStr)
+{
+    const LuaLock lock(*this);
+
+    auto val = pLua_->state[ecu_ident_.c_str()][RAW_TABLE][identStr];
+    if(val.exists()==false){
+        string identStrWorking = " ";
+        //offset for the first byte
+        int counter = 2;
+        while(val.exists() == false && identStrWorking.length() < identStr.length()){
+            //appends wildcard sign after the bytes that are tested
+            identStrWorking.assign(identStr, 0, counter).append(" *");
+            val = pLua_->state[ecu_ident_.c_str()][RAW_TABLE][identStrWorking];
+            //counter + blank + bytelength
+            counter = counter + 3;
+        }
+    }
+    return val.exists();
+}
+
+/**
+ * Gets the keys of a table of the ECU table like `sel::Selector::getKeys()`,
+ * also of a table behind the barrier of the static tables.
+ *
+ * @param L: the Lua state
+ * @param ecuIdent: the name of the ECU table
+ * @param field: the name of the table
+ * @return the keys, which are strings or numbers
+ * @see StaticTables::pushStorage()
+ */
+static vector<string> keysOf(lua_State* L, const string& ecuIdent, const char* field)
+{
+    vector<string> keys;
+    const int top = lua_gettop(L);
+    lua_getglobal(L, ecuIdent.c_str());
+    if (lua_istable(L, -1))
+    {
+        lua_getfield(L, -1, field);
+        if (lua_istable(L, -1))
+        {
+            StaticTables::pushStorage(L, -1);
+            lua_pushnil(L);
+            while (lua_next(L, -2) != 0)
+            {
+                lua_pop(L, 1);
+                if (lua_type(L, -1) == LUA_TSTRING || lua_type(L, -1) == LUA_TNUMBER)
+                {
+                    // a copy, lua_tostring() would change the key of a number
+                    lua_pushvalue(L, -1);
+                    keys.push_back(lua_tostring(L, -1));
+                    lua_pop(L, 1);
+                }
+            }
+        }
+    }
+    lua_settop(L, top);
+    return keys;
+}
+
+/**
+ * Remembers the service identifiers, which have at least one entry in the
+ * `Raw`-table of the Lua script (the first byte of the literal request). Only
+ * requests of these services are looked up in Lua by `UdsReceiver`, entries
+ * added to the table at runtime are therefore only seen for services without
+ * a native handler. Has to be called with the `LuaLock` held.
+ */
+void EcuLuaScript::loadRawServices()
+{
+    for (const string& key : keysOf(pLua_->state.GetLuaState(), ecu_ident_, RAW_TABLE))
+    {
+        char* end = nullptr;
+        const unsigned long sid = strtoul(key.substr(0, 2).c_str(), &end, 16);
+        if (end == nullptr || *end != '\0' || sid > 0xFF)
+        {
+            cerr << __func__ << ": invalid Raw request '" << key << "'\n";
+            continue;
+        }
+        rawSids_.set(sid);
+    }
+}
+
+/**
+ * Gets all request entries from the Lua "Raw"-Table.
+ *
+ * @return vector of raw request data as they are configured in lua
+ */
+vector<string> EcuLuaScript::getRawRequests()
+{
+    const LuaLock lock(*this);
+
+    return keysOf(pLua_->state.GetLuaState(), ecu_ident_, RAW_TABLE);
+}
+
+/**
+ * Gets J1939 PGNS from the Lua PGN-Table.
+ *
+ * @return vector of raw message data as they are configured in lua
+ */
+vector<string> EcuLuaScript::getJ1939PGNs()
+{
+    const LuaLock lock(*this);
+
+    cout << "Get PGNs from ident: " << ecu_ident_ << endl;
+    return keysOf(pLua_->state.GetLuaState(), ecu_ident_, J1939_PGN_TABLE);
+}
+
+J1939PGNData EcuLuaScript::getJ1939PGNData(const string& pgn)
+{
+    const auto pStatic = currentStaticEntries();
+    const J1939PGNData* pStaticData = pStatic ? pStatic->findPgn(pgn) : nullptr;
+    if (pStaticData != nullptr)
+    {
+        return *pStaticData;
+    }
+
+    const LuaLock lock(*this);
+
     J1939PGNData pgnData;
     pgnData.cycleTime = 0;
 
     cout << "Looking for PGN: " << pgn << endl;
-    auto val = lua_state_[ecu_ident_.c_str()][J1939_PGN_TABLE][pgn.c_str()];
+    auto val = pLua_->state[ecu_ident_.c_str()][J1939_PGN_TABLE][pgn.c_str()];
     cout << "Checking PGN value: " << pgn << endl;
     if(val.exists() == true) {
         cout << "Found PGN: " << pgn << endl;
@@ -557,6 +1589,105 @@ J1939PGNData EcuLuaScript::getJ1939PGNData(const string& pgn)
     return pgnData;
 }
 
+/**
+ * Evaluates the matching entry of the Lua "Raw"-Table and passes the response
+ * bytes to `sink`. Functions get the literal request string and the request as
+ * `Bytes`. If a function returns `Bytes`, the sink gets its buffer directly,
+ * a literal hex string is parsed into the request arena. Static entries are
+ * served from the compiled copy without locking the Lua state, otherwise the
+ * sink is called with the `LuaLock` held. The data is only valid during the
+ * call.
+ *
+ * @param identStr: the literal request string (e.g. "22 F1 90")
+ * @param request: the UDS request
+ * @param sink: receives the response
+ * @return false if there is no entry or it did not give a response
+ * @see EcuLuaScript::getRaw(const std::string&)
+ */
+bool EcuLuaScript::getRaw(const string& identStr, const UdsRequest& request, const ResponseSink& sink)
+{
+    static metrics::Counter& numStaticReads = metrics::counter("lua.static_reads");
+
+    const auto pStatic = currentStaticEntries();
+    const StaticEntries::RawEntry* pEntry = pStatic ? pStatic->findRaw(identStr) : nullptr;
+    if (pEntry != nullptr && pEntry->isStatic)
+    {
+        numStaticReads.increment();
+        sink(pEntry->response.data(), pEntry->response.size());
+        return true;
+    }
+
+    const LuaLock lock(*this);
+
+    lua_State* L = pLua_->state.GetLuaState();
+    const int top = lua_gettop(L);
+
+    lua_getglobal(L, ecu_ident_.c_str());
+    if (lua_istable(L, -1))
+    {
+        lua_getfield(L, -1, RAW_TABLE);
+    }
+    if (!lua_istable(L, -1))
+    {
+        lua_settop(L, top);
+        return false;
+    }
+
+    const int rawTable = lua_gettop(L);
+    lua_getfield(L, rawTable, identStr.c_str());
+    // wildcard entries (e.g. "31 01 *"), like in `getRaw(const std::string&)`
+    for (size_t counter = 2; lua_isnil(L, -1) && counter <= identStr.length(); counter += 3)
+    {
+        lua_pop(L, 1);
+        lua_getfield(L, rawTable, identStr.substr(0, counter).append(" *").c_str());
+    }
+
+    if (lua_isfunction(L, -1))
+    {
+        lua_pushstring(L, identStr.c_str());
+        vector<uint8_t>& requestBytes = LuaBytes::push(L);
+        requestBytes.reserve(request.size());
+        for (size_t i = 0; i < request.size(); ++i)
+        {
+            requestBytes.push_back(request[i]);
+        }
+        if (lua_pcall(L, 2, 1, 0) != LUA_OK)
+        {
+            cerr << __func__ << ": " << lua_tostring(L, -1) << endl;
+            lua_settop(L, top);
+            if (!pLua_->budget.isExceeded())
+            {
+                return false;
+            }
+            cerr << __func__ << "() Raw[\"" << identStr << "\"] exceeded its execution budget\n";
+            const uint8_t response[] = {ERROR, request.sid(), budgetNrc_};
+            sink(response, sizeof(response));
+            return true;
+        }
+    }
+
+    bool hasResponse = true;
+    const vector<uint8_t>* pBytes = LuaBytes::get(L, -1);
+    if (pBytes != nullptr)
+    {
+        sink(pBytes->data(), pBytes->size());
+    }
+    else if (lua_isstring(L, -1))
+    {
+        size_t len;
+        const char* hex = lua_tolstring(L, -1, &len);
+        ArenaBytes bytes(RequestArena::resource());
+        appendLiteralHexStr(string_view(hex, len), bytes);
+        sink(bytes.data(), bytes.size());
+    }
+    else
+    {
+        hasResponse = false;
+    }
+    lua_settop(L, top);
+    return hasResponse;
+}
+
 /**
  * Gets the raw data entries from the Lua "Raw"-Table.
  * The identifiers of the corresponding entries are literal hex byte strings
@@ -568,9 +1699,9 @@ J1939PGNData EcuLuaScript::getJ1939PGNData(const string& pgn)
  */
 string EcuLuaScript::getRaw(const string& identStr)
 { 
-    const std::lock_guard<std::mutex> scopelock(luaLock_);
+    const LuaLock lock(*this);
 
-    auto val = lua_state_[ecu_ident_.c_str()][RAW_TABLE][identStr.c_str()];
+    auto val = pLua_->state[ecu_ident_.c_str()][RAW_TABLE][identStr];
     if(val.exists() == true){
         
         if (val.isFunction())
@@ -587,8 +1718,8 @@ string EcuLuaScript::getRaw(const string& identStr)
         int counter = 2;
         while(val.exists() == false && identStrWorking.length() < identStr.length()){
             //appends wildcard sign after the bytes that are tested
-            identStrWorking = identStr.substr(0,counter).append(" *");
-            val = lua_state_[ecu_ident_.c_str()][RAW_TABLE][identStrWorking.c_str()];
+            identStrWorking.assign(identStr, 0, counter).append(" *");
+            val = pLua_->state[ecu_ident_.c_str()][RAW_TABLE][identStrWorking];
             //counter + blank + bytelength
             counter = counter + 3;
         }
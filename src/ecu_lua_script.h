@@ -9,40 +9,129 @@
 #include "selene.h"
 #include "isotp_sender.h"
 #include "session_controller.h"
+#include "dtc_store.h"
+#include "did_store.h"
+#include "routine_controller.h"
+#include "security_manager.h"
+#include "communication_control.h"
+#include "lua_snapshot.h"
+#include "lua_allocator.h"
+#include "lua_collector.h"
+#include "lua_budget.h"
+#include "request_arena.h"
+#include "static_entries.h"
+#include "static_tables.h"
+#include "uds_request.h"
 #include <string>
+#include <string_view>
+#include <functional>
 #include <cstdint>
 #include <vector>
 #include <mutex>
+#include <memory>
+#include <chrono>
+#include <bitset>
+#include <map>
 
 constexpr char REQ_ID_FIELD[] = "RequestId";
 constexpr char RES_ID_FIELD[] = "ResponseId";
 constexpr char BROADCAST_ID_FIELD[] = "BroadcastId";
+constexpr char REBOOT_TIME_FIELD[] = "RebootTime";
+constexpr char MEMORY_LIMIT_FIELD[] = "MemoryLimit";
+constexpr char LUA_LIBRARIES_FIELD[] = "LuaLibraries";
+constexpr char GC_TABLE[] = "GarbageCollector";
+constexpr char GC_MODE_FIELD[] = "mode";
+constexpr char GC_PAUSE_FIELD[] = "pause";
+constexpr char GC_STEPMUL_FIELD[] = "stepmul";
+constexpr char GC_STEP_SIZE_FIELD[] = "stepSize";
+constexpr char GC_STEPS_FIELD[] = "steps";
+constexpr char GC_INTERVAL_FIELD[] = "interval";
+constexpr char BUDGET_TABLE[] = "ExecutionBudget";
+constexpr char BUDGET_INSTRUCTIONS_FIELD[] = "instructions";
+constexpr char BUDGET_TIME_FIELD[] = "time";
+constexpr char BUDGET_NRC_FIELD[] = "nrc";
 constexpr char READ_DATA_BY_IDENTIFIER_TABLE[] = "ReadDataByIdentifier";
+constexpr char PROGRAMMING_SESSION_TABLE[] = "Programming";
+constexpr char EXTENDED_SESSION_TABLE[] = "Extended";
 constexpr char READ_SEED[] = "Seed";
 constexpr char RAW_TABLE[] = "Raw";
 constexpr char J1939_SOURCE_ADDRESS_FIELD[] = "J1939SourceAddress";
 constexpr char J1939_PGN_TABLE[] = "PGNs";
 constexpr char J1939_PGN_PAYLOAD[] = "payload";
 constexpr char J1939_PGN_CYCLETIME[] = "cycleTime";
+constexpr char DTC_TABLE[] = "DTCs";
+constexpr char DTC_STATUS_FIELD[] = "status";
+constexpr char DTC_SNAPSHOT_TABLE[] = "Snapshots";
+constexpr char DTC_EXTENDED_DATA_TABLE[] = "ExtendedData";
+constexpr char DTC_AVAILABILITY_MASK_FIELD[] = "DTCStatusAvailabilityMask";
+constexpr char DID_STORE_TABLE[] = "DIDStore";
+constexpr char DID_STORE_FILE_FIELD[] = "DIDStoreFile";
+constexpr char DID_TYPE_FIELD[] = "type";
+constexpr char DID_LENGTH_FIELD[] = "length";
+constexpr char DID_DEFAULT_FIELD[] = "default";
+constexpr char ROUTINE_TABLE[] = "Routines";
+constexpr char ROUTINE_DURATION_FIELD[] = "duration";
+constexpr char ROUTINE_START_FIELD[] = "start";
+constexpr char ROUTINE_RESULT_FIELD[] = "result";
+constexpr char SECURITY_ACCESS_TABLE[] = "SecurityAccess";
+constexpr char SECURITY_ALGORITHM_FIELD[] = "algorithm";
+constexpr char SECURITY_CONSTANT_FIELD[] = "constant";
+constexpr char SECURITY_SEED_LENGTH_FIELD[] = "seedLength";
+constexpr char SECURITY_MAX_ATTEMPTS_FIELD[] = "maxAttempts";
+constexpr char SECURITY_DELAY_FIELD[] = "delay";
+constexpr char FLEET_TABLE[] = "Fleet";
+constexpr char FLEET_COUNT_FIELD[] = "count";
+constexpr char FLEET_REQ_ID_STEP_FIELD[] = "RequestIdStep";
+constexpr char FLEET_RES_ID_STEP_FIELD[] = "ResponseIdStep";
+constexpr char FLEET_J1939_SOURCE_ADDRESS_STEP_FIELD[] = "J1939SourceAddressStep";
+constexpr char FLEET_INSTANCE_GLOBAL[] = "ECU";
 constexpr uint32_t DEFAULT_BROADCAST_ADDR = 0x7DF;
+constexpr uint8_t DEFAULT_BUDGET_NRC = 0x10; ///< generalReject
 
-struct J1939PGNData
+class EcuLuaScript;
+
+/**
+ * Lua state of a config. All instances of a fleet share the state, so the
+ * tables of the template are only loaded once.
+ */
+struct LuaContext : public std::enable_shared_from_this<LuaContext>
 {
-    unsigned int cycleTime;
-    std::string payload;
+    explicit LuaContext(const std::string& name);
+
+    void configureCollector(const LuaGcSettings& settings);
+
+    LuaAllocator allocator; ///< has to outlive the state
+    sel::State state;
+    LuaCollector collector;
+    LuaBudget budget;
+    std::mutex mutex;
+    StaticTables staticTables; ///< compiled static entries of all instances
+    EcuLuaScript* pActive = nullptr; ///< instance, the injected functions refer to
 };
 
+/// Receives a response, the data is only valid during the call.
+using ResponseSink = std::function<void(const std::uint8_t* data, std::size_t size)>;
+
 class EcuLuaScript
 {
 public:
     EcuLuaScript() = delete;
     EcuLuaScript(const std::string& ecuIdent, const std::string& luaScript);
+    EcuLuaScript(const std::string& ecuIdent, const std::string& luaScript, const EcuLuaScript& predecessor);
+    EcuLuaScript(const EcuLuaScript& fleetTemplate, unsigned int index);
     EcuLuaScript(const EcuLuaScript& orig) = delete;
     EcuLuaScript& operator =(const EcuLuaScript& orig) = delete;
     EcuLuaScript(EcuLuaScript&& orig) noexcept;
     EcuLuaScript& operator =(EcuLuaScript&& orig) noexcept;
-    virtual ~EcuLuaScript() = default;
+    virtual ~EcuLuaScript();
 
+    static std::vector<std::shared_ptr<EcuLuaScript>> loadFleet(const std::string& ecuIdent, const std::string& luaScript);
+
+    bool isLoaded() const noexcept { return !ecu_ident_.empty(); };
+    const std::string& getIdent() const noexcept { return ecu_ident_; };
+    unsigned int getFleetIndex() const noexcept { return fleetIndex_; };
+    std::size_t getPrivateMemory() const noexcept { return privateMemory_; };
+    std::size_t getLuaMemory();
     bool hasRequestId() const { return hasRequestId_; };
     std::uint32_t getRequestId() const;
     bool hasResponseId() const { return hasResponseId_; };
@@ -60,25 +149,56 @@ public:
     J1939PGNData getJ1939PGNData(const std::string& pgn);
 
     std::string getRaw(const std::string& identStr);
+    bool getRaw(const std::string& identStr, const UdsRequest& request, const ResponseSink& sink);
     bool hasRaw(const std::string& identStr);
-    static std::vector<std::uint8_t> literalHexStrToBytes(const std::string& hexString);
+    bool hasRawService(std::uint8_t sid) const noexcept { return rawSids_.test(sid); };
+    static std::vector<std::uint8_t> literalHexStrToBytes(std::string_view hexString);
+    static void appendLiteralHexStr(std::string_view hexString, ArenaBytes& out);
+    static std::uint32_t dtcFromString(const std::string& dtcString);
 
-    static std::string ascii(const std::string& utf8_str) noexcept;
+    static std::string ascii(std::string_view utf8_str) noexcept;
     static std::string getCounterByte(const std::string& msg) noexcept;
     static void getDataBytes(const std::string& msg) noexcept;
     static std::string createHash() noexcept;
     static std::string toByteResponse(std::uint32_t value, std::uint32_t len = sizeof(std::uint32_t)) noexcept;
     static void sleep(unsigned int ms) noexcept;
-    void sendRaw(const std::string& response) const;
+    void sendRaw(std::string_view response) const;
     std::uint8_t getCurrentSession() const;
     void switchToSession(int ses);
+    void setDTCStatus(const std::string& dtc, std::uint32_t status);
+    int getDTCStatus(const std::string& dtc) const;
+
+    DtcStore& getDtcStore() noexcept { return dtcStore_; };
+    DidStore* getDidStore() noexcept { return didStore_.get(); };
+    RoutineController& getRoutineController() noexcept { return *routines_; };
+    SecurityManager* getSecurityManager() noexcept { return securityManager_.get(); };
+    CommunicationControl& getCommunicationControl() noexcept { return *communication_; };
+    std::chrono::milliseconds getRebootTime() const noexcept { return rebootTime_; };
+    void reset();
 
     void registerSessionController(SessionController* pSesCtrl) noexcept;
     void registerIsoTpSender(IsoTpSender* pSender) noexcept;
 
 private:
-    sel::State lua_state_{true};
+    /// Locks the Lua state and makes the script the active instance.
+    class LuaLock
+    {
+    public:
+        explicit LuaLock(EcuLuaScript& script);
+        ~LuaLock();
+
+    private:
+        std::unique_lock<std::mutex> lock_;
+        LuaContext& context_;
+        std::chrono::steady_clock::time_point acquired_;
+    };
+
+    std::shared_ptr<LuaContext> pLua_;
     std::string ecu_ident_;
+    std::string luaScript_;
+    unsigned int fleetIndex_ = 0;
+    unsigned int fleetSize_ = 0;
+    std::size_t privateMemory_ = 0;
     SessionController* pSessionCtrl_ = nullptr;
     IsoTpSender* pIsoTpSender_ = nullptr;
     bool hasRequestId_ = false;
@@ -89,7 +209,35 @@ private:
     std::uint32_t broadcastId_ = DEFAULT_BROADCAST_ADDR;
     bool hasJ1939SourceAddress_ = false;
     std::uint8_t j1939SourceAddress_;
-    std::mutex luaLock_;
+    std::chrono::milliseconds rebootTime_{0};
+    std::uint8_t budgetNrc_ = DEFAULT_BUDGET_NRC;
+    LuaSnapshot snapshot_;
+    DtcStore dtcStore_;
+    std::shared_ptr<DidStore> didStore_;
+    std::unique_ptr<RoutineController> routines_ = std::make_unique<RoutineController>();
+    std::shared_ptr<SecurityManager> securityManager_;
+    std::shared_ptr<CommunicationControl> communication_ = std::make_shared<CommunicationControl>();
+    std::bitset<256> rawSids_;
+    /// Function entries of the `ReadDataByIdentifier`-tables by session ("" for the top level table)
+    std::map<std::string, std::map<std::string, sel::PreparedCall, std::less<>>, std::less<>> didCalls_;
+
+    void activate() noexcept;
+    void setInstanceGlobal() noexcept;
+    void loadScript(const std::string& ecuIdent, const std::string& luaScript);
+    void loadGarbageCollector();
+    void loadExecutionBudget();
+    void loadEcu();
+    void createInstanceTable(lua_State* L, unsigned int index);
+    void loadDtcs();
+    void loadDids();
+    void loadRoutines();
+    void loadSecurityAccess();
+    void loadRawServices();
+    std::vector<std::uint8_t> getRoutineBytes(const std::string& rid, const char* field);
+    std::string readDataByIdentifier(const char* session, const std::string& identifier);
+    std::string callDataByIdentifier(const sel::PreparedCall& call, const std::string& identifier);
+    void clearPreparedCalls() noexcept;
+    std::shared_ptr<const StaticEntries> currentStaticEntries() const noexcept;
 };
 
 #endif /* ECU_LUA_SCRIPT_H */
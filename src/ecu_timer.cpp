@@ -8,7 +8,10 @@
 #include <thread>
 
 using namespace std;
-using std::chrono::system_clock;
+using std::chrono::steady_clock;
+
+static_assert(atomic<steady_clock::rep>::is_always_lock_free,
+              "EcuTimer::reset() has to be lock-free");
 
 EcuTimer::EcuTimer() {
     t_id_ = 0;
@@ -23,7 +26,7 @@ EcuTimer::EcuTimer() {
 void EcuTimer::start(int ms)
 {
     mutex_.lock();
-    t_start_ = system_clock::now();
+    t_start_ = steady_clock::now().time_since_epoch().count();
     duration_ = ms;
     t_id_ += 1;
     mutex_.unlock();
@@ -53,7 +56,8 @@ void EcuTimer::sleep()
     while (true)
     {
         mutex_.lock();
-        auto diff = chrono::duration_cast<chrono::milliseconds>(system_clock::now() - t_start_);
+        const steady_clock::time_point start(steady_clock::duration(t_start_.load(memory_order_relaxed)));
+        auto diff = chrono::duration_cast<chrono::milliseconds>(steady_clock::now() - start);
         id_now = t_id_;
         duration = duration_;
         mutex_.unlock();
@@ -86,11 +90,10 @@ void EcuTimer::sleep()
 }
 
 /**
- * Resets the timer.
+ * Resets the timer. This is a single atomic store, so it neither blocks nor
+ * restarts the timer thread.
  */
-void EcuTimer::reset()
+void EcuTimer::reset() noexcept
 {
-    mutex_.lock();
-    t_start_ = system_clock::now();
-    mutex_.unlock();
+    t_start_.store(steady_clock::now().time_since_epoch().count(), memory_order_relaxed);
 }
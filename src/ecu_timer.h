@@ -14,6 +14,7 @@
 #include <errno.h>
 #include <mutex>
 #include <chrono>
+#include <atomic>
 
 class EcuTimer {
 public:
@@ -21,12 +22,12 @@ public:
     EcuTimer(const EcuTimer& orig)= default;
     virtual ~EcuTimer() = default;
     void start(int ms);
-    void reset();
+    void reset() noexcept;
 
 private:
     std::mutex mutex_;
     useconds_t duration_; // [ms]
-    std::chrono::system_clock::time_point t_start_;
+    std::atomic<std::chrono::steady_clock::rep> t_start_{0}; // steady_clock ticks
     int t_id_;
 
     void sleep();
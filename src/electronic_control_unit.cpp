@@ -11,26 +11,31 @@
 using namespace std;
 
 ElectronicControlUnit::ElectronicControlUnit(const string& device, EcuLuaScript *pEcuScript)
-: requId_(pEcuScript->getRequestId())
-, respId_(pEcuScript->getResponseId())
+: ElectronicControlUnit(device, ScriptSlot::borrow(pEcuScript))
+{
+}
+
+ElectronicControlUnit::ElectronicControlUnit(const string& device, shared_ptr<ScriptSlot> pScriptSlot)
+: pScriptSlot_(move(pScriptSlot))
+, requId_(pScriptSlot_->load()->getRequestId())
+, respId_(pScriptSlot_->load()->getResponseId())
 , sender_(respId_, requId_, device)
-, broadcastReceiver_(pEcuScript->getBroadcastId(), device, &udsReceiver_)
-, udsReceiver_(respId_, requId_, device, pEcuScript, &sender_, &sessionControl_)
+, udsReceiver_(respId_, requId_, device, pScriptSlot_, &sender_, &sessionControl_)
+, pBroadcastReceiver_(BroadcastReceiver::subscribe(pScriptSlot_->load()->getBroadcastId(), device, &udsReceiver_))
 , udsReceiverThread_(&IsoTpReceiver::readData, &udsReceiver_)
-, broadcastReceiverThread_(&IsoTpReceiver::readData, &broadcastReceiver_)
 {
 }
 
 void ElectronicControlUnit::stopSimulation()
 {
     sender_.closeSender();
-    broadcastReceiver_.closeReceiver();
+    pBroadcastReceiver_->unsubscribe(&udsReceiver_);
     udsReceiver_.closeReceiver();
+    pScriptSlot_->load()->getRoutineController().stopAll();
 }
 
 void ElectronicControlUnit::waitForSimulationEnd()
 {
-    broadcastReceiverThread_.join();
     udsReceiverThread_.join();
 }
 
@@ -8,6 +8,7 @@
 
 #include "selene.h"
 #include "ecu_lua_script.h"
+#include "script_slot.h"
 #include "config.h"
 #include "session_controller.h"
 #include "isotp_sender.h"
@@ -26,6 +27,7 @@ public:
 public:
     ElectronicControlUnit() = delete;
     ElectronicControlUnit(const std::string& device, EcuLuaScript *pEcuScript);
+    ElectronicControlUnit(const std::string& device, std::shared_ptr<ScriptSlot> pScriptSlot);
     ElectronicControlUnit(const ElectronicControlUnit& orig) = default;
     ElectronicControlUnit& operator =(const ElectronicControlUnit& orig) = default;
     ElectronicControlUnit(ElectronicControlUnit&& orig) = default;
@@ -37,14 +39,14 @@ public:
 
 
 private:
+    std::shared_ptr<ScriptSlot> pScriptSlot_;
     std::uint32_t requId_;
     std::uint32_t respId_;
     SessionController sessionControl_;
     IsoTpSender sender_;
-    BroadcastReceiver broadcastReceiver_;
     UdsReceiver udsReceiver_;
+    std::shared_ptr<BroadcastReceiver> pBroadcastReceiver_;
     std::thread udsReceiverThread_;
-    std::thread broadcastReceiverThread_;
 };
 
 #endif /* ELECTRONIC_CONTROL_UNIT_H */
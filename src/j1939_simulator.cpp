@@ -1,5 +1,6 @@
 
 #include "j1939_simulator.h"
+#include "metrics.h"
 #include "can/j1939.h"
 #include <linux/can.h>
 #include <iostream>
@@ -33,10 +34,17 @@ bool J1939Simulator::hasSimulation(EcuLuaScript *pEcuScript)
 
 J1939Simulator::J1939Simulator(const std::string& device,
                                EcuLuaScript *pEcuScript)
+: J1939Simulator(device, ScriptSlot::borrow(pEcuScript))
+{
+}
+
+J1939Simulator::J1939Simulator(const std::string& device,
+                               shared_ptr<ScriptSlot> pScriptSlot)
 : device_(device)
-, pEcuScript_(pEcuScript)
+, pScriptSlot_(move(pScriptSlot))
 //, j1939ReceiverThread_(&J1939Simulator::readData, this)
 {
+    const shared_ptr<EcuLuaScript> pEcuScript = pScriptSlot_->load();
     source_address_ = pEcuScript->getJ1939SourceAddress();
     pgns_ = new uint16_t[1];
 
@@ -47,16 +55,12 @@ J1939Simulator::J1939Simulator(const std::string& device,
     }
 
     sendVIN(0x03);
-    // This is just a demo for the getKeys function I implemented into Selene
-    // One could use that to fetch a list of configured PDNs from the lua file
+    // only the keys are printed, evaluating the entries would run the Lua
+    // functions of every config at startup (the payloads are printed by the
+    // cyclic senders)
     cout << "Requests:" << endl;
-    for(auto const &request : pEcuScript_->getRawRequests()) {
-        cout << request << " -> "<< pEcuScript_->getRaw(request) << endl;
-    }
-
-    cout << "PGNs:" << endl;
-    for(auto const &pgn : pEcuScript_->getJ1939PGNs()) {
-        cout << pgn << " -> "<< pEcuScript_->getJ1939PGNData(pgn).payload << endl;
+    for(auto const &request : pEcuScript->getRawRequests()) {
+        cout << request << endl;
     }
 
     startPeriodicSenderThreads();
@@ -87,7 +91,7 @@ J1939Simulator::~J1939Simulator()
 void J1939Simulator::startPeriodicSenderThreads()
 {
     cout << "Fetching PGNs" << endl;
-    vector<string> pgns = pEcuScript_->getJ1939PGNs();
+    vector<string> pgns = pScriptSlot_->load()->getJ1939PGNs();
     cout << "PGNs fetched" << endl;
 
     for (auto pgn : pgns) {
@@ -228,6 +232,11 @@ void J1939Simulator::proceedReceivedData(const uint8_t* buffer, const size_t num
     }
     cout << endl;
 
+    if (!pScriptSlot_->load()->getCommunicationControl().isRxEnabled())
+    {
+        return; // disabled by `CommunicationControl`
+    }
+
     if(num_bytes > 2 
         && buffer[0] == 0xec
         && buffer[1] == 0xfe
@@ -239,6 +248,13 @@ void J1939Simulator::proceedReceivedData(const uint8_t* buffer, const size_t num
 
 void J1939Simulator::sendVIN(const uint8_t targetAddress) noexcept
 {
+    static metrics::Counter& numSuppressed = metrics::counter("j1939.frames_suppressed");
+    if (!pScriptSlot_->load()->getCommunicationControl().isTxEnabled())
+    {
+        numSuppressed.increment();
+        return;
+    }
+
     cout << "Sending VIN" << endl;
     // Sending some dummy PGN to see that it works
     struct sockaddr_can saddr = {};
@@ -258,6 +274,9 @@ void J1939Simulator::sendVIN(const uint8_t targetAddress) noexcept
 
 void J1939Simulator::sendCyclicMessage(const string pgn) noexcept
 {
+    static metrics::Counter& numSuppressed = metrics::counter("j1939.frames_suppressed");
+    // the communication state is shared by all versions of the script
+    const CommunicationControl& commCtrl = pScriptSlot_->load()->getCommunicationControl();
     uint32_t pgnNum = parsePGN(pgn);
     cout << "Sending Cyclic PGN: " << pgn << " as " << pgnNum << endl;
 
@@ -268,16 +287,28 @@ void J1939Simulator::sendCyclicMessage(const string pgn) noexcept
     saddr.can_addr.j1939.addr = 0xff;
 
 
+    bool isFirstCycle = true;
     do {
-        J1939PGNData pgnData = pEcuScript_->getJ1939PGNData(pgn);
+        // load the script per cycle, so a reloaded payload is sent right away
+        J1939PGNData pgnData = pScriptSlot_->load()->getJ1939PGNData(pgn);
         string pgnMessage = pgnData.payload;
-        vector<unsigned char> rawMessage = pEcuScript_->literalHexStrToBytes(pgnMessage);
+        if (isFirstCycle)
+        {
+            cout << pgn << " -> " << pgnMessage << endl;
+            isFirstCycle = false;
+        }
+        vector<unsigned char> rawMessage = EcuLuaScript::literalHexStrToBytes(pgnMessage);
         unsigned int cycleTime = pgnData.cycleTime;
         if(cycleTime == 0) {
             return;
         }
 
-        if(isBusActive()) {
+        if (!commCtrl.isTxEnabled())
+        {
+            // silenced by `CommunicationControl`, keep the cycle running
+            numSuppressed.increment();
+        }
+        else if(isBusActive()) {
             int sendSkt = openBroadcastSocket();
 
             int retries = 5;
@@ -352,7 +383,7 @@ uint32_t J1939Simulator::parsePGN(string pgn) const noexcept
 
     // If number parsing fails or number is longer than 5 digits, try parsing a string instead
     if(pgnNum == 0 || pgnNum > 99999) {
-        vector<uint8_t> pgnBytes = pEcuScript_->literalHexStrToBytes(pgn);
+        vector<uint8_t> pgnBytes = EcuLuaScript::literalHexStrToBytes(pgn);
         pgnNum = 0;
         if(pgnBytes.size() <= 3) {
             // put byte together in reverse order (little endian)
@@ -12,6 +12,7 @@
 #include <thread>
 
 #include "ecu_lua_script.h"
+#include "script_slot.h"
 
 
 class J1939Simulator
@@ -23,6 +24,8 @@ public:
     J1939Simulator() = delete;
     J1939Simulator(const std::string& device,
                    EcuLuaScript* pEcuScript);
+    J1939Simulator(const std::string& device,
+                   std::shared_ptr<ScriptSlot> pScriptSlot);
     virtual ~J1939Simulator();
     int openReceiver() noexcept;
     void closeReceiver() noexcept;
@@ -39,7 +42,7 @@ public:
 private:
     uint8_t source_address_;
     std::string device_;
-    EcuLuaScript* pEcuScript_;
+    std::shared_ptr<ScriptSlot> pScriptSlot_;
     int receive_skt_ = -1;
     bool isOnExit_ = false;
     //std::thread j1939ReceiverThread_;
@@ -0,0 +1,205 @@
+/**
+ * @file lua_allocator.cpp
+ *
+ * This file contains the memory allocator of the Lua states, which keeps the
+ * many small Lua objects of an ECU together and accounts their memory.
+ */
+
+#include "lua_allocator.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Returns the index of the size class of a pooled block.
+ */
+static constexpr size_t sizeClassOf(size_t size) noexcept
+{
+    return (size - 1) / LuaAllocator::GRANULARITY;
+}
+
+/**
+ * Checks if a block of the given size is served from the pools.
+ */
+static constexpr bool isPooled(size_t size) noexcept
+{
+    return size <= LuaAllocator::MAX_POOLED_SIZE;
+}
+
+/**
+ * Constructor. The gauges `lua.memory.<name>.bytes` and
+ * `lua.memory.<name>.blocks` show the memory in use, the counter
+ * `lua.memory.<name>.limit_hits` the allocations refused due to the limit.
+ * Allocators with the same name (e.g. of a reloaded script) add up.
+ *
+ * @param name: the name of the metrics (e.g. the path of the Lua script)
+ */
+LuaAllocator::LuaAllocator(const string& name)
+: bytesGauge_(metrics::gauge("lua.memory." + name + ".bytes"))
+, blocksGauge_(metrics::gauge("lua.memory." + name + ".blocks"))
+, limitHits_(metrics::counter("lua.memory." + name + ".limit_hits"))
+{
+}
+
+/**
+ * Destructor. Hands all chunks back to the heap, the Lua state has to be
+ * closed already.
+ */
+LuaAllocator::~LuaAllocator()
+{
+    while (pChunks_ != nullptr)
+    {
+        void* pNext = *static_cast<void**>(pChunks_);
+        free(pChunks_);
+        pChunks_ = pNext;
+    }
+    bytesGauge_.add(-int64_t(bytes_));
+    blocksGauge_.add(-int64_t(numBlocks_));
+}
+
+/**
+ * Allocation function of the Lua state (`lua_Alloc`), see the Lua reference
+ * manual. Shrinking a block never fails.
+ *
+ * @param ud: the allocator
+ * @param ptr: the block to resize or free, nullptr for a new block
+ * @param osize: the size of the block, the type of the new object if `ptr` is nullptr
+ * @param nsize: the new size, 0 to free the block
+ * @return the block or nullptr if it has been freed or the allocation failed
+ */
+void* LuaAllocator::allocate(void* ud, void* ptr, size_t osize, size_t nsize) noexcept
+{
+    LuaAllocator* self = static_cast<LuaAllocator*>(ud);
+    if (ptr == nullptr)
+    {
+        osize = 0;
+    }
+
+    if (nsize == 0)
+    {
+        if (ptr != nullptr)
+        {
+            self->release(ptr, osize);
+            self->bytes_ -= osize;
+            --self->numBlocks_;
+            self->bytesGauge_.add(-int64_t(osize));
+            self->blocksGauge_.add(-1);
+        }
+        return nullptr;
+    }
+
+    if (nsize > osize && self->limit_ != 0 && self->bytes_ + (nsize - osize) > self->limit_)
+    {
+        self->limitHits_.increment();
+        return nullptr;
+    }
+
+    void* pBlock = (ptr == nullptr) ? self->acquire(nsize) : self->resize(ptr, osize, nsize);
+    if (pBlock == nullptr)
+    {
+        return nullptr;
+    }
+    self->bytes_ += nsize - osize;
+    self->bytesGauge_.add(int64_t(nsize) - int64_t(osize));
+    if (ptr == nullptr)
+    {
+        ++self->numBlocks_;
+        self->blocksGauge_.add(1);
+    }
+    return pBlock;
+}
+
+/**
+ * Takes a block from the pool of its size class, or from the heap for large
+ * blocks. An empty pool is refilled from the current chunk.
+ *
+ * @param size: the size of the block in bytes
+ * @return the block or nullptr if the heap is exhausted
+ */
+void* LuaAllocator::acquire(size_t size) noexcept
+{
+    if (!isPooled(size))
+    {
+        return malloc(size);
+    }
+
+    FreeBlock*& pFree = freeLists_[sizeClassOf(size)];
+    if (pFree != nullptr)
+    {
+        FreeBlock* pBlock = pFree;
+        pFree = pBlock->pNext;
+        return pBlock;
+    }
+
+    const size_t blockSize = (sizeClassOf(size) + 1) * GRANULARITY;
+    if (pChunkPos_ == nullptr || size_t(pChunkEnd_ - pChunkPos_) < blockSize)
+    {
+        // the rest of the old chunk stays unused, it is less than a block
+        void* pChunk = malloc(CHUNK_SIZE);
+        if (pChunk == nullptr)
+        {
+            return nullptr;
+        }
+        *static_cast<void**>(pChunk) = pChunks_;
+        pChunks_ = pChunk;
+        pChunkPos_ = static_cast<char*>(pChunk) + GRANULARITY; // behind the link
+        pChunkEnd_ = static_cast<char*>(pChunk) + CHUNK_SIZE;
+    }
+    void* pBlock = pChunkPos_;
+    pChunkPos_ += blockSize;
+    return pBlock;
+}
+
+/**
+ * Puts a block back into the pool of its size class, or frees a large block.
+ *
+ * @param ptr: the block
+ * @param size: the size of the block in bytes
+ */
+void LuaAllocator::release(void* ptr, size_t size) noexcept
+{
+    if (!isPooled(size))
+    {
+        free(ptr);
+        return;
+    }
+
+    FreeBlock* pBlock = static_cast<FreeBlock*>(ptr);
+    FreeBlock*& pFree = freeLists_[sizeClassOf(size)];
+    pBlock->pNext = pFree;
+    pFree = pBlock;
+}
+
+/**
+ * Resizes a block. Blocks staying in their size class are not moved at all.
+ *
+ * @param ptr: the block
+ * @param osize: the current size of the block in bytes
+ * @param nsize: the new size in bytes
+ * @return the resized block or nullptr if a growing block could not be moved
+ */
+void* LuaAllocator::resize(void* ptr, size_t osize, size_t nsize) noexcept
+{
+    if (isPooled(osize) && isPooled(nsize) && sizeClassOf(osize) == sizeClassOf(nsize))
+    {
+        return ptr;
+    }
+    if (!isPooled(osize) && !isPooled(nsize))
+    {
+        void* pBlock = realloc(ptr, nsize);
+        return (pBlock == nullptr && nsize < osize) ? ptr : pBlock;
+    }
+
+    void* pBlock = acquire(nsize);
+    if (pBlock == nullptr)
+    {
+        // shrinking must not fail: keep the block, it is large enough and goes
+        // to the pool of the new size once it is freed (heap exhausted only)
+        return (nsize < osize) ? ptr : nullptr;
+    }
+    memcpy(pBlock, ptr, min(osize, nsize));
+    release(ptr, osize);
+    return pBlock;
+}
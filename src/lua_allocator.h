@@ -0,0 +1,74 @@
+/**
+ * @file lua_allocator.h
+ *
+ */
+
+#ifndef LUA_ALLOCATOR_H
+#define LUA_ALLOCATOR_H
+
+#include "metrics.h"
+#include <cstddef>
+#include <array>
+#include <string>
+
+/**
+ * Memory allocator of a single Lua state (`lua_Alloc`). Small blocks are
+ * taken from size-class pools, which are carved out of large chunks and only
+ * handed back to the heap together with the state. Larger blocks go to the
+ * heap directly. The bytes and blocks in use are accounted per state and
+ * published as gauges. With a limit set, allocations beyond the limit fail,
+ * which raises a Lua memory error instead of growing without bounds.
+ *
+ * The allocator is not thread-safe, like the Lua state it belongs to.
+ */
+class LuaAllocator
+{
+public:
+    /// Size difference between neighbouring size classes.
+    static constexpr std::size_t GRANULARITY = 16;
+
+    /// Largest block size, which is served from the pools.
+    static constexpr std::size_t MAX_POOLED_SIZE = 512;
+
+    /// Size of the chunks the pools are carved out of.
+    static constexpr std::size_t CHUNK_SIZE = 16384;
+
+    LuaAllocator() = delete;
+    explicit LuaAllocator(const std::string& name);
+    LuaAllocator(const LuaAllocator& orig) = delete;
+    LuaAllocator& operator =(const LuaAllocator& orig) = delete;
+    LuaAllocator(LuaAllocator&& orig) = delete;
+    LuaAllocator& operator =(LuaAllocator&& orig) = delete;
+    virtual ~LuaAllocator();
+
+    static void* allocate(void* ud, void* ptr, std::size_t osize, std::size_t nsize) noexcept;
+
+    void setLimit(std::size_t bytes) noexcept { limit_ = bytes; };
+    std::size_t getLimit() const noexcept { return limit_; };
+    std::size_t getBytes() const noexcept { return bytes_; };
+    std::size_t getBlocks() const noexcept { return numBlocks_; };
+
+private:
+    /// Unused block of a pool.
+    struct FreeBlock
+    {
+        FreeBlock* pNext;
+    };
+
+    std::array<FreeBlock*, MAX_POOLED_SIZE / GRANULARITY> freeLists_{};
+    void* pChunks_ = nullptr;
+    char* pChunkPos_ = nullptr;
+    char* pChunkEnd_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::size_t numBlocks_ = 0;
+    std::size_t limit_ = 0;
+    metrics::Gauge& bytesGauge_;
+    metrics::Gauge& blocksGauge_;
+    metrics::Counter& limitHits_;
+
+    void* acquire(std::size_t size) noexcept;
+    void release(void* ptr, std::size_t size) noexcept;
+    void* resize(void* ptr, std::size_t osize, std::size_t nsize) noexcept;
+};
+
+#endif /* LUA_ALLOCATOR_H */
@@ -0,0 +1,116 @@
+/**
+ * @file lua_budget.cpp
+ *
+ * This file contains the execution budget of the Lua handlers, which keeps a
+ * broken script from blocking its ECU forever.
+ */
+
+#include "lua_budget.h"
+#include "metrics.h"
+
+#include "selene/compat.h"
+
+using namespace std;
+
+/// Address of this variable is the registry key of the budget of a state.
+static const char BUDGET_KEY = 0;
+
+/**
+ * Installs the count hook in the Lua state. Coroutines created later inherit
+ * the hook.
+ *
+ * @param L: the Lua state
+ */
+void LuaBudget::install(lua_State* L)
+{
+    L_ = L;
+    lua_pushlightuserdata(L, this);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &BUDGET_KEY);
+    lua_sethook(L, &LuaBudget::hook, LUA_MASKCOUNT, HOOK_INTERVAL);
+}
+
+/**
+ * Sets the limits of a single call. Under LuaJIT, the JIT compiler of the
+ * installed state is turned off while a limit is set, since compiled code
+ * does not call the count hook, and turned on again without limits.
+ *
+ * @param maxInstructions: the maximum number of VM instructions or 0 for no limit
+ * @param maxTime: the maximum run time or 0 for no limit
+ */
+void LuaBudget::setLimits(uint64_t maxInstructions, chrono::milliseconds maxTime) noexcept
+{
+    const bool hadLimit = hasLimit();
+    maxInstructions_ = maxInstructions;
+    maxTime_ = maxTime;
+#ifdef SELENE_LUAJIT
+    if (L_ != nullptr && hasLimit() != hadLimit)
+    {
+        luaJIT_setmode(L_, 0, LUAJIT_MODE_ENGINE | (hasLimit() ? LUAJIT_MODE_OFF : LUAJIT_MODE_ON));
+    }
+#else
+    (void) hadLimit;
+#endif
+}
+
+/**
+ * Starts the budget of a call into Lua.
+ */
+void LuaBudget::start() noexcept
+{
+    instructions_ = 0;
+    isExceeded_ = false;
+    isActive_ = true;
+    if (maxTime_.count() > 0)
+    {
+        start_ = chrono::steady_clock::now();
+    }
+}
+
+/**
+ * Ends the call and records its instructions.
+ */
+void LuaBudget::stop() noexcept
+{
+    static metrics::Histogram& callInstructions = metrics::histogram("lua.call_instructions");
+    static metrics::Counter& numExceeded = metrics::counter("lua.budget_exceeded");
+
+    if (!isActive_)
+    {
+        return;
+    }
+    isActive_ = false;
+    callInstructions.record(instructions_);
+    if (isExceeded_)
+    {
+        numExceeded.increment();
+    }
+}
+
+/**
+ * Count hook of the Lua state. Raises an error in the running call, as soon
+ * as it has exceeded its budget, and again on every further call of the hook,
+ * so even a script catching the error with `pcall()` gets aborted.
+ */
+void LuaBudget::hook(lua_State* L, lua_Debug* /* ar */)
+{
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &BUDGET_KEY);
+    LuaBudget* self = static_cast<LuaBudget*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    if (self == nullptr || !self->isActive_)
+    {
+        return;
+    }
+
+    self->instructions_ += HOOK_INTERVAL;
+    if (!self->isExceeded_)
+    {
+        const bool isOverCount = self->maxInstructions_ != 0 && self->instructions_ > self->maxInstructions_;
+        const bool isOverTime = self->maxTime_.count() > 0
+                                && chrono::steady_clock::now() - self->start_ > self->maxTime_;
+        self->isExceeded_ = isOverCount || isOverTime;
+    }
+    if (self->isExceeded_)
+    {
+        luaL_error(L, "execution budget exceeded after %f instructions", lua_Number(self->instructions_));
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file lua_budget.h
+ *
+ */
+
+#ifndef LUA_BUDGET_H
+#define LUA_BUDGET_H
+
+#include <cstdint>
+#include <chrono>
+
+struct lua_State;
+struct lua_Debug;
+
+/**
+ * Execution budget of the calls into a Lua state. A count hook runs every
+ * `HOOK_INTERVAL` VM instructions, counts the instructions of the current
+ * call and aborts the call with a Lua error, once it exceeds the instruction
+ * or time limit. A script stuck in an endless loop thereby releases the Lua
+ * lock instead of wedging the ECU. The instructions of every call are
+ * recorded in the histogram `lua.call_instructions`. LuaJIT does not call the
+ * hook inside compiled code, so its JIT compiler is turned off while a limit
+ * is set.
+ *
+ * Like the Lua state, the budget has to be used with the Lua lock held.
+ */
+class LuaBudget
+{
+public:
+    /// Number of VM instructions between two calls of the hook.
+    static constexpr int HOOK_INTERVAL = 1000;
+
+    LuaBudget() = default;
+    LuaBudget(const LuaBudget& orig) = delete;
+    LuaBudget& operator =(const LuaBudget& orig) = delete;
+    LuaBudget(LuaBudget&& orig) = delete;
+    LuaBudget& operator =(LuaBudget&& orig) = delete;
+    virtual ~LuaBudget() = default;
+
+    void install(lua_State* L);
+    void setLimits(std::uint64_t maxInstructions, std::chrono::milliseconds maxTime) noexcept;
+    void start() noexcept;
+    void stop() noexcept;
+    bool isExceeded() const noexcept { return isExceeded_; };
+    std::uint64_t getInstructions() const noexcept { return instructions_; };
+
+private:
+    lua_State* L_ = nullptr;
+    std::uint64_t maxInstructions_ = 0;
+    std::chrono::milliseconds maxTime_{0};
+    std::uint64_t instructions_ = 0;
+    std::chrono::steady_clock::time_point start_;
+    bool isActive_ = false;
+    bool isExceeded_ = false;
+
+    bool hasLimit() const noexcept { return maxInstructions_ != 0 || maxTime_.count() > 0; };
+    static void hook(lua_State* L, lua_Debug* ar);
+};
+
+#endif /* LUA_BUDGET_H */
@@ -0,0 +1,404 @@
+/**
+ * @file lua_bytes.cpp
+ *
+ * This file contains the `Bytes` userdata type, which lets Lua scripts build
+ * binary responses without literal hex strings.
+ */
+
+#include "lua_bytes.h"
+#include "ecu_lua_script.h"
+#include <atomic>
+#include <new>
+#include <string>
+
+#include "selene/compat.h"
+
+using namespace std;
+
+using Buffer = vector<uint8_t>;
+
+/// Userdata of a `Bytes` value.
+struct Userdata
+{
+    Buffer bytes;
+    uint64_t version = 0; ///< incremented by every change of the buffer
+    bool isWatched = false; ///< see `LuaBytes::watch()`
+};
+
+/// Number of changes of watched buffers, see `LuaBytes::watchedChanges()`.
+static atomic<uint64_t> numWatchedChanges{0};
+
+static constexpr char HEX_LUT[] = "0123456789ABCDEF";
+
+/**
+ * Returns the userdata of the `Bytes` argument at the given index or raises a
+ * Lua error. Lua errors unwind with `longjmp()`, therefore all functions below
+ * check their arguments before any C++ object with a destructor is alive.
+ */
+static Userdata& checkUserdata(lua_State* L, int idx)
+{
+    return *static_cast<Userdata*> (luaL_checkudata(L, idx, LuaBytes::METATABLE));
+}
+
+/**
+ * Returns the buffer of the `Bytes` argument at the given index or raises a
+ * Lua error, see `checkUserdata()`.
+ */
+static Buffer& checkBytes(lua_State* L, int idx)
+{
+    return checkUserdata(L, idx).bytes;
+}
+
+/**
+ * Returns the buffer of the `Bytes` argument at the given index, which is
+ * about to be changed, or raises a Lua error.
+ */
+static Buffer& modifyBytes(lua_State* L, int idx)
+{
+    Userdata& userdata = checkUserdata(L, idx);
+    ++userdata.version;
+    if (userdata.isWatched)
+    {
+        numWatchedChanges.fetch_add(1, memory_order_relaxed);
+    }
+    return userdata.bytes;
+}
+
+/**
+ * Pushes the literal hex string (e.g. "62 F1 90") of the buffer.
+ */
+static void pushHex(lua_State* L, const Buffer& bytes)
+{
+    luaL_Buffer b;
+    luaL_buffinit(L, &b);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        if (i > 0)
+        {
+            luaL_addchar(&b, ' ');
+        }
+        luaL_addchar(&b, HEX_LUT[bytes[i] >> 4]);
+        luaL_addchar(&b, HEX_LUT[bytes[i] & 0x0F]);
+    }
+    luaL_pushresult(&b);
+}
+
+/**
+ * Appends a `Bytes` value or a literal hex string to the buffer.
+ */
+static void appendValue(lua_State* L, Buffer& bytes, int idx)
+{
+    const Buffer* pOther = LuaBytes::get(L, idx);
+    if (pOther != nullptr)
+    {
+        bytes.insert(bytes.end(), pOther->cbegin(), pOther->cend());
+        return;
+    }
+
+    size_t len;
+    const char* hex = luaL_checklstring(L, idx, &len);
+    const vector<uint8_t> parsed = EcuLuaScript::literalHexStrToBytes(string_view(hex, len));
+    bytes.insert(bytes.end(), parsed.cbegin(), parsed.cend());
+}
+
+/**
+ * Appends an unsigned big endian number of `size` bytes.
+ */
+static int appendNumber(lua_State* L, int size)
+{
+    checkBytes(L, 1);
+    const auto value = static_cast<uint32_t> (luaL_checkinteger(L, 2));
+    Buffer& bytes = modifyBytes(L, 1);
+    for (int shift = (size - 1) * 8; shift >= 0; shift -= 8)
+    {
+        bytes.push_back(uint8_t(value >> shift));
+    }
+    lua_settop(L, 1);
+    return 1;
+}
+
+/// `Bytes.new([value])`: new buffer, optionally filled from `Bytes` or a hex string.
+static int bytesNew(lua_State* L)
+{
+    if (!lua_isnoneornil(L, 1) && LuaBytes::get(L, 1) == nullptr)
+    {
+        luaL_checkstring(L, 1);
+    }
+    Buffer& bytes = LuaBytes::push(L);
+    if (!lua_isnoneornil(L, 1))
+    {
+        appendValue(L, bytes, 1);
+    }
+    return 1;
+}
+
+/// `bytes:append(value)`: appends `Bytes` or a literal hex string.
+static int bytesAppend(lua_State* L)
+{
+    checkBytes(L, 1);
+    if (LuaBytes::get(L, 2) == nullptr)
+    {
+        luaL_checkstring(L, 2);
+    }
+    appendValue(L, modifyBytes(L, 1), 2);
+    lua_settop(L, 1);
+    return 1;
+}
+
+/// `bytes:u8(value)`
+static int bytesU8(lua_State* L)
+{
+    return appendNumber(L, 1);
+}
+
+/// `bytes:u16be(value)`
+static int bytesU16be(lua_State* L)
+{
+    return appendNumber(L, 2);
+}
+
+/// `bytes:u32be(value)`
+static int bytesU32be(lua_State* L)
+{
+    return appendNumber(L, 4);
+}
+
+/// `bytes:ascii(text)`: appends the characters of the string as they are.
+static int bytesAscii(lua_State* L)
+{
+    checkBytes(L, 1);
+    size_t len;
+    const char* text = luaL_checklstring(L, 2, &len);
+    Buffer& bytes = modifyBytes(L, 1);
+    bytes.insert(bytes.end(), text, text + len);
+    lua_settop(L, 1);
+    return 1;
+}
+
+/// `bytes:slice(i [, j])`: copy of the bytes i..j, negative indices count from the end.
+static int bytesSlice(lua_State* L)
+{
+    const Buffer& bytes = checkBytes(L, 1);
+    const auto size = static_cast<lua_Integer> (bytes.size());
+    lua_Integer first = luaL_checkinteger(L, 2);
+    lua_Integer last = luaL_optinteger(L, 3, -1);
+    if (first < 0)
+    {
+        first += size + 1;
+    }
+    if (last < 0)
+    {
+        last += size + 1;
+    }
+    first = (first < 1) ? 1 : first;
+    last = (last > size) ? size : last;
+
+    if (first > last)
+    {
+        LuaBytes::push(L);
+    }
+    else
+    {
+        LuaBytes::push(L, bytes.data() + first - 1, size_t(last - first + 1));
+    }
+    return 1;
+}
+
+/// `bytes:at(i)`: the byte at the 1-based position or nil.
+static int bytesAt(lua_State* L)
+{
+    const Buffer& bytes = checkBytes(L, 1);
+    const lua_Integer pos = luaL_checkinteger(L, 2);
+    if (pos < 1 || pos > static_cast<lua_Integer> (bytes.size()))
+    {
+        lua_pushnil(L);
+    }
+    else
+    {
+        lua_pushinteger(L, bytes[pos - 1]);
+    }
+    return 1;
+}
+
+/// `bytes:resize(n)`: truncates the buffer or pads it with zeros.
+static int bytesResize(lua_State* L)
+{
+    checkBytes(L, 1);
+    const lua_Integer size = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, size >= 0, 2, "negative size");
+    modifyBytes(L, 1).resize(size_t(size));
+    lua_settop(L, 1);
+    return 1;
+}
+
+/// `bytes:ptr()`: address of the first byte, valid until the size changes.
+/// Counts as change, since the buffer can be written through the address.
+static int bytesPtr(lua_State* L)
+{
+    lua_pushlightuserdata(L, modifyBytes(L, 1).data());
+    return 1;
+}
+
+/// `bytes:hex()` and `tostring(bytes)`
+static int bytesHex(lua_State* L)
+{
+    pushHex(L, checkBytes(L, 1));
+    return 1;
+}
+
+/// `#bytes`
+static int bytesLen(lua_State* L)
+{
+    lua_pushinteger(L, lua_Integer(checkBytes(L, 1).size()));
+    return 1;
+}
+
+/// `bytes == other`
+static int bytesEq(lua_State* L)
+{
+    const Buffer* pLeft = LuaBytes::get(L, 1);
+    const Buffer* pRight = LuaBytes::get(L, 2);
+    lua_pushboolean(L, pLeft != nullptr && pRight != nullptr && *pLeft == *pRight);
+    return 1;
+}
+
+/// `"62 F1 90" .. bytes`: both operands as literal hex string.
+static int bytesConcat(lua_State* L)
+{
+    for (int idx = 1; idx <= 2; ++idx)
+    {
+        const Buffer* pBytes = LuaBytes::get(L, idx);
+        if (pBytes != nullptr)
+        {
+            pushHex(L, *pBytes);
+        }
+        else
+        {
+            luaL_checkstring(L, idx);
+            lua_pushvalue(L, idx);
+        }
+    }
+    lua_concat(L, 2);
+    return 1;
+}
+
+static int bytesGc(lua_State* L)
+{
+    checkUserdata(L, 1).~Userdata();
+    return 0;
+}
+
+static const luaL_Reg BYTES_METHODS[] = {
+    {"append", bytesAppend},
+    {"u8", bytesU8},
+    {"u16be", bytesU16be},
+    {"u32be", bytesU32be},
+    {"ascii", bytesAscii},
+    {"slice", bytesSlice},
+    {"at", bytesAt},
+    {"hex", bytesHex},
+    {"resize", bytesResize},
+    {"ptr", bytesPtr},
+    {nullptr, nullptr}
+};
+
+static const luaL_Reg BYTES_METAMETHODS[] = {
+    {"__len", bytesLen},
+    {"__eq", bytesEq},
+    {"__concat", bytesConcat},
+    {"__tostring", bytesHex},
+    {"__gc", bytesGc},
+    {nullptr, nullptr}
+};
+
+/**
+ * Creates the metatable of the `Bytes` type and the global table `Bytes`
+ * with the constructor `Bytes.new()`. Call this before loading the script.
+ *
+ * @param L: the Lua state
+ */
+void LuaBytes::registerType(lua_State* L)
+{
+    luaL_newmetatable(L, METATABLE);
+    luaL_setfuncs(L, BYTES_METAMETHODS, 0);
+    luaL_newlib(L, BYTES_METHODS);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 1);
+
+    lua_createtable(L, 0, 1);
+    lua_pushcfunction(L, bytesNew);
+    lua_setfield(L, -2, "new");
+    lua_setglobal(L, METATABLE);
+}
+
+/**
+ * Pushes a new, empty `Bytes` value.
+ *
+ * @param L: the Lua state
+ * @return the buffer of the new value, valid as long as the value is alive
+ */
+vector<uint8_t>& LuaBytes::push(lua_State* L)
+{
+    void* p = lua_newuserdata(L, sizeof(Userdata));
+    Userdata* pUserdata = new (p) Userdata();
+    luaL_setmetatable(L, METATABLE);
+    return pUserdata->bytes;
+}
+
+/**
+ * Pushes a new `Bytes` value holding a copy of the given data.
+ *
+ * @param L: the Lua state
+ * @param data: the bytes to copy
+ * @param size: the number of bytes
+ */
+void LuaBytes::push(lua_State* L, const uint8_t* data, size_t size)
+{
+    push(L).assign(data, data + size);
+}
+
+/**
+ * Returns the buffer of the `Bytes` value at the given index.
+ *
+ * @param L: the Lua state
+ * @param idx: the stack index
+ * @return the buffer or nullptr if the value is not of type `Bytes`
+ */
+const vector<uint8_t>* LuaBytes::get(lua_State* L, int idx) noexcept
+{
+    const auto* pUserdata = static_cast<const Userdata*> (luaL_testudata(L, idx, METATABLE));
+    return (pUserdata != nullptr) ? &pUserdata->bytes : nullptr;
+}
+
+/**
+ * Watches the `Bytes` value at the given index for changes: every change of
+ * the buffer increments its version and the counter `watchedChanges()`, so a
+ * copy of the buffer can be checked for being outdated without comparing it.
+ *
+ * @param L: the Lua state
+ * @param idx: the stack index
+ * @return the version of the buffer, valid as long as the value is alive, or
+ *         nullptr if the value is not of type `Bytes`
+ */
+const uint64_t* LuaBytes::watch(lua_State* L, int idx) noexcept
+{
+    auto* pUserdata = static_cast<Userdata*> (luaL_testudata(L, idx, METATABLE));
+    if (pUserdata == nullptr)
+    {
+        return nullptr;
+    }
+    pUserdata->isWatched = true;
+    return &pUserdata->version;
+}
+
+/**
+ * Returns the number of changes of all watched `Bytes` values so far, so
+ * checking them for changes does not depend on their number.
+ *
+ * @return the number of changes
+ * @see LuaBytes::watch()
+ */
+uint64_t LuaBytes::watchedChanges() noexcept
+{
+    return numWatchedChanges.load(memory_order_relaxed);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file lua_bytes.h
+ *
+ */
+
+#ifndef LUA_BYTES_H
+#define LUA_BYTES_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct lua_State;
+
+/**
+ * The `Bytes` userdata type of the Lua scripts. It is backed by a byte vector,
+ * so responses can be built without converting them to a literal hex string
+ * and back. Example:
+ *
+ *     Bytes.new("62 F1 90"):ascii("SALGA2EV9HA298784")
+ *     Bytes.new():u8(0x59):u8(0x02):u16be(0x1234):u32be(value)
+ *
+ * The methods `append`, `u8`, `u16be`, `u32be` and `ascii` modify the buffer
+ * and return it again, `slice(i, j)` returns a new buffer (1-based, inclusive
+ * like `string.sub`). `at(i)` returns a single byte, `hex()` or `tostring()`
+ * the literal hex string and `#` the length. Concatenation with a string
+ * yields a literal hex string, so existing scripts keep working.
+ *
+ * `ptr()` returns the address of the buffer as light userdata, so LuaJIT
+ * scripts can read and write it through the FFI without copies, after sizing
+ * it with `resize(n)`:
+ *
+ *     local p = ffi.cast("uint8_t*", bytes:resize(8):ptr())
+ *
+ * Taking the address counts as change of the buffer, writes through an
+ * address kept from an earlier call are not noticed.
+ */
+class LuaBytes
+{
+public:
+    /// Name of the metatable in the Lua registry.
+    static constexpr char METATABLE[] = "Bytes";
+
+    LuaBytes() = delete;
+
+    static void registerType(lua_State* L);
+    static std::vector<std::uint8_t>& push(lua_State* L);
+    static void push(lua_State* L, const std::uint8_t* data, std::size_t size);
+    static const std::vector<std::uint8_t>* get(lua_State* L, int idx) noexcept;
+    static const std::uint64_t* watch(lua_State* L, int idx) noexcept;
+    static std::uint64_t watchedChanges() noexcept;
+};
+
+#endif /* LUA_BYTES_H */
@@ -0,0 +1,231 @@
+/**
+ * @file lua_chunk_cache.cpp
+ *
+ * This file contains the cache of precompiled Lua scripts, which saves the
+ * parsing of unchanged configs at startup.
+ *
+ * Entry layout: a 24 byte header (`LUAC`, `LUA_VERSION_NUM`, the source hash
+ * and the source size) followed by the output of `lua_dump()`.
+ */
+
+#include "lua_chunk_cache.h"
+#include "metrics.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+
+#include "selene/compat.h"
+
+using namespace std;
+
+/// Header of a cache entry.
+struct EntryHeader
+{
+    char magic[4];
+    uint32_t luaVersion;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+};
+
+static constexpr char ENTRY_MAGIC[4] = {'L', 'U', 'A', 'C'};
+
+/// FNV-1a parameters (64 bit).
+static constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+static constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+
+/**
+ * Collects the output of `lua_dump()`.
+ */
+static int appendChunk(lua_State*, const void* p, size_t sz, void* ud)
+{
+    auto* pOut = static_cast<vector<char>*> (ud);
+    const char* bytes = static_cast<const char*> (p);
+    pOut->insert(pOut->end(), bytes, bytes + sz);
+    return 0;
+}
+
+/**
+ * Loads the bytecode of a cache entry. The entry is only mapped during the
+ * call, since Lua copies the functions out of the buffer.
+ *
+ * @param L: the Lua state
+ * @param path: the path of the cache entry
+ * @param header: the expected header of the entry
+ * @param chunkName: the name of the chunk for error messages
+ * @return true if the chunk has been pushed, false if the entry is missing or
+ *         does not fit the source
+ */
+static bool loadEntry(lua_State* L, const string& path, const EntryHeader& header, const string& chunkName)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || size_t(st.st_size) <= sizeof(EntryHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = size_t(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        cerr << __func__ << "() mmap: " << strerror(errno) << '\n';
+        return false;
+    }
+
+    const char* data = static_cast<const char*> (map);
+    bool isLoaded = false;
+    if (memcmp(data, &header, sizeof(header)) == 0)
+    {
+        // mode "b": a damaged entry must never be taken for source text
+        if (luaL_loadbufferx(L, data + sizeof(header), size - sizeof(header), chunkName.c_str(), "b") == LUA_OK)
+        {
+            isLoaded = true;
+        }
+        else
+        {
+            cerr << __func__ << "() " << path << ": " << lua_tostring(L, -1) << '\n';
+            lua_pop(L, 1);
+        }
+    }
+    munmap(map, size);
+    return isLoaded;
+}
+
+/**
+ * Stores the compiled chunk on top of the stack as cache entry. The entry is
+ * written to a temporary file and renamed, so concurrently starting ECUs
+ * with the same config never see a partial entry.
+ *
+ * @param L: the Lua state
+ * @param path: the path of the cache entry
+ * @param header: the header of the entry
+ */
+static void storeEntry(lua_State* L, const string& path, const EntryHeader& header)
+{
+    vector<char> data(reinterpret_cast<const char*> (&header), reinterpret_cast<const char*> (&header) + sizeof(header));
+    if (lua_dump(L, appendChunk, &data) != 0)
+    {
+        return;
+    }
+
+    const string dir = path.substr(0, path.rfind('/'));
+    if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST)
+    {
+        cerr << __func__ << "() mkdir " << dir << ": " << strerror(errno) << '\n';
+        return;
+    }
+
+    const string tmpPath = path + '.' + to_string(getpid()) + '.' + to_string(uintptr_t(L));
+    const int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        cerr << __func__ << "() open " << tmpPath << ": " << strerror(errno) << '\n';
+        return;
+    }
+    if (::write(fd, data.data(), data.size()) != ssize_t(data.size())
+        || rename(tmpPath.c_str(), path.c_str()) < 0)
+    {
+        cerr << __func__ << "() " << tmpPath << ": " << strerror(errno) << '\n';
+        unlink(tmpPath.c_str());
+    }
+    ::close(fd);
+}
+
+/**
+ * Loads a Lua script like `luaL_loadfile()`, but takes the precompiled chunk
+ * from the cache, if the source did not change since it has been stored.
+ * Otherwise the source is compiled and the cache entry is written. On
+ * success, the chunk is pushed onto the stack, otherwise the error message.
+ *
+ * @param L: the Lua state
+ * @param luaScript: the path to the Lua script
+ * @return `LUA_OK` on success, otherwise the error code of `luaL_loadfile()`
+ */
+int LuaChunkCache::load(lua_State* L, const string& luaScript)
+{
+    static metrics::Counter& numHits = metrics::counter("lua.chunk_cache_hits");
+    static metrics::Counter& numMisses = metrics::counter("lua.chunk_cache_misses");
+
+    ifstream file(luaScript, ios::binary);
+    if (!file)
+    {
+        lua_pushfstring(L, "cannot open %s", luaScript.c_str());
+        return LUA_ERRFILE;
+    }
+    const string source((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    EntryHeader header = {};
+    memcpy(header.magic, ENTRY_MAGIC, sizeof(header.magic));
+    header.luaVersion = LUA_VERSION_NUM;
+    header.sourceHash = hash(source.data(), source.size());
+    header.sourceSize = source.size();
+
+    const string chunkName = '@' + luaScript;
+    const string path = entryPath(luaScript, header.sourceHash);
+    if (loadEntry(L, path, header, chunkName))
+    {
+        numHits.increment();
+        return LUA_OK;
+    }
+
+    numMisses.increment();
+    const int status = luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t");
+    if (status == LUA_OK)
+    {
+        storeEntry(L, path, header);
+    }
+    return status;
+}
+
+/**
+ * Gets the path of the cache entry for a script.
+ *
+ * @param luaScript: the path to the Lua script
+ * @param hash: the hash of the source text
+ * @return the path of the entry (e.g. "lua_config/.luacache/0123456789ABCDEF.luac")
+ */
+string LuaChunkCache::entryPath(const string& luaScript, uint64_t hash)
+{
+    static constexpr char HEX_LUT[] = "0123456789ABCDEF";
+
+    const size_t slash = luaScript.rfind('/');
+    string path = (slash == string::npos) ? string() : luaScript.substr(0, slash + 1);
+    path += LUA_CHUNK_CACHE_DIR;
+    path += '/';
+    for (int shift = 60; shift >= 0; shift -= 4)
+    {
+        path += HEX_LUT[(hash >> shift) & 0x0F];
+    }
+    path += ".luac";
+    return path;
+}
+
+/**
+ * Hashes the source text of a script (FNV-1a, 64 bit).
+ *
+ * @param data: the source text
+ * @param size: the length of the source text
+ * @return the hash value
+ */
+uint64_t LuaChunkCache::hash(const char* data, size_t size) noexcept
+{
+    uint64_t value = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; ++i)
+    {
+        value = (value ^ uint8_t(data[i])) * FNV_PRIME;
+    }
+    return value;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file lua_chunk_cache.h
+ *
+ */
+
+#ifndef LUA_CHUNK_CACHE_H
+#define LUA_CHUNK_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+struct lua_State;
+
+/// Directory of the cache entries, relative to the directory of the script.
+constexpr char LUA_CHUNK_CACHE_DIR[] = ".luacache";
+
+/**
+ * Cache of precompiled Lua scripts. The bytecode of a script (`lua_dump()`)
+ * is stored in `.luacache/<hash>.luac` next to the script, keyed by a hash of
+ * the source text. On the next start, the entry is mapped into memory and
+ * loaded without running the Lua parser. Identical configs share one entry,
+ * a changed config simply gets a new one.
+ */
+class LuaChunkCache
+{
+public:
+    LuaChunkCache() = delete;
+
+    static int load(lua_State* L, const std::string& luaScript);
+    static std::string entryPath(const std::string& luaScript, std::uint64_t hash);
+    static std::uint64_t hash(const char* data, std::size_t size) noexcept;
+};
+
+#endif /* LUA_CHUNK_CACHE_H */
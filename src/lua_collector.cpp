@@ -0,0 +1,210 @@
+/**
+ * @file lua_collector.cpp
+ *
+ * This file contains the control of the Lua garbage collector, which moves
+ * the collection out of the requests and makes its pauses visible.
+ */
+
+#include "lua_collector.h"
+#include "metrics.h"
+#include <iostream>
+
+#include "selene/compat.h"
+
+using namespace std;
+
+/// Lua default of the pause between two cycles in percent.
+static constexpr int DEFAULT_PAUSE = 200;
+
+/// Heap growth in KiB per idle step, unless `stepSize` is given.
+static constexpr int DEFAULT_IDLE_STEP_SIZE = 16;
+
+/// Time spent in explicit steps on the calling thread, -1 if there was none.
+static thread_local int64_t threadGcTime = -1;
+
+/**
+ * Returns the heap size of the Lua state in KiB.
+ */
+static size_t heapKb(lua_State* L) noexcept
+{
+    return size_t(lua_gc(L, LUA_GCCOUNT, 0));
+}
+
+/**
+ * Destructor. Stops the idle steps.
+ */
+LuaCollector::~LuaCollector()
+{
+    if (timerId_ != 0)
+    {
+        TimerService::instance().cancel(timerId_);
+    }
+}
+
+/**
+ * Applies the settings to the collector of the state. With explicit steps,
+ * the automatic collector is stopped.
+ *
+ * @param L: the Lua state
+ * @param settings: the collector settings
+ */
+void LuaCollector::configure(lua_State* L, const LuaGcSettings& settings)
+{
+    settings_ = settings;
+#ifdef LUA_GCGEN
+    if (settings_.isGenerational)
+    {
+#if LUA_VERSION_NUM >= 504
+        lua_gc(L, LUA_GCGEN, 0, 0);
+#else
+        lua_gc(L, LUA_GCGEN, 0);
+#endif
+    }
+    else
+    {
+#if LUA_VERSION_NUM >= 504
+        lua_gc(L, LUA_GCINC, 0, 0, 0);
+#else
+        lua_gc(L, LUA_GCINC, 0);
+#endif
+    }
+#else
+    if (settings_.isGenerational)
+    {
+        cerr << __func__ << "() the generational collector is not supported by Lua " << LUA_VERSION_NUM << '\n';
+    }
+#endif
+    if (settings_.pause > 0)
+    {
+        lua_gc(L, LUA_GCSETPAUSE, settings_.pause);
+    }
+    if (settings_.stepMul > 0)
+    {
+        lua_gc(L, LUA_GCSETSTEPMUL, settings_.stepMul);
+    }
+
+    if (settings_.steps == LuaGcSteps::AUTO)
+    {
+        lua_gc(L, LUA_GCRESTART, 0);
+    }
+    else
+    {
+        lua_gc(L, LUA_GCSTOP, 0);
+    }
+    lastKb_ = heapKb(L);
+    cycleKb_ = lastKb_;
+}
+
+/**
+ * Runs the idle steps by a periodic timer. The callback has to take the Lua
+ * lock without blocking and call `idleStep()`, a busy ECU is not idle.
+ *
+ * @param callback: the timer callback
+ */
+void LuaCollector::startIdleSteps(TimerService::Callback callback)
+{
+    if (timerId_ != 0)
+    {
+        TimerService::instance().cancel(timerId_);
+    }
+    timerId_ = TimerService::instance().schedule(settings_.interval, move(callback), settings_.interval);
+}
+
+/**
+ * Called at the end of every call into Lua. With steps per request, the
+ * memory allocated by the call is collected right away. With idle steps, a
+ * request only steps in if the heap outgrew twice the pause, e.g. since the
+ * ECU has been busy for too long.
+ *
+ * @param L: the Lua state
+ */
+void LuaCollector::afterCall(lua_State* L) noexcept
+{
+    if (settings_.steps == LuaGcSteps::AUTO)
+    {
+        return;
+    }
+
+    const size_t kb = heapKb(L);
+    if (settings_.steps == LuaGcSteps::REQUEST)
+    {
+        if (kb > lastKb_ || settings_.stepSize > 0)
+        {
+            step(L, (settings_.stepSize > 0) ? settings_.stepSize : int(kb - lastKb_));
+        }
+        return;
+    }
+
+    const int pause = (settings_.pause > 0) ? settings_.pause : DEFAULT_PAUSE;
+    if (kb * 100 > cycleKb_ * pause * 2)
+    {
+        step(L, int(kb - lastKb_));
+    }
+}
+
+/**
+ * Runs a single step while the ECU is idle.
+ *
+ * @param L: the Lua state
+ */
+void LuaCollector::idleStep(lua_State* L) noexcept
+{
+    step(L, (settings_.stepSize > 0) ? settings_.stepSize : DEFAULT_IDLE_STEP_SIZE);
+}
+
+/**
+ * Runs a timed step of the collector.
+ *
+ * @param L: the Lua state
+ * @param kb: the amount of work, as if this many KiB had been allocated
+ */
+void LuaCollector::step(lua_State* L, int kb) noexcept
+{
+    static metrics::Histogram& stepTime = metrics::histogram("lua.gc_step_us");
+    static metrics::Counter& numCycles = metrics::counter("lua.gc_cycles");
+
+    const auto start = chrono::steady_clock::now();
+    const bool isCycleEnd = (lua_gc(L, LUA_GCSTEP, kb) != 0);
+    const int64_t duration = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    stepTime.record(uint64_t(duration));
+    threadGcTime = (threadGcTime < 0) ? duration : threadGcTime + duration;
+    lastKb_ = heapKb(L);
+    if (isCycleEnd)
+    {
+        numCycles.increment();
+        cycleKb_ = lastKb_;
+    }
+}
+
+/**
+ * Returns the time the calling thread spent in explicit steps since the last
+ * call, e.g. during a single request.
+ *
+ * @return the time in microseconds or -1 if no step has been run
+ */
+int64_t LuaCollector::takeThreadTime() noexcept
+{
+    const int64_t time = threadGcTime;
+    threadGcTime = -1;
+    return time;
+}
+
+/**
+ * Converts the name of a step mode ("auto", "request" or "idle").
+ *
+ * @param name: the name of the mode
+ * @return the mode, `AUTO` for unknown names
+ */
+LuaGcSteps LuaCollector::stepsFromString(const string& name) noexcept
+{
+    if (name == "request")
+    {
+        return LuaGcSteps::REQUEST;
+    }
+    if (name == "idle")
+    {
+        return LuaGcSteps::IDLE;
+    }
+    return LuaGcSteps::AUTO;
+}
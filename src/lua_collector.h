@@ -0,0 +1,74 @@
+/**
+ * @file lua_collector.h
+ *
+ */
+
+#ifndef LUA_COLLECTOR_H
+#define LUA_COLLECTOR_H
+
+#include "timer_service.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <chrono>
+
+struct lua_State;
+
+/// Who runs the steps of the garbage collector of a Lua state.
+enum class LuaGcSteps
+{
+    AUTO,    ///< Lua itself, inside the allocations of a request (default)
+    REQUEST, ///< a timed step after every call into Lua
+    IDLE     ///< timed steps from the timer service, while the ECU is idle
+};
+
+/// Settings of the garbage collector, from the `GarbageCollector`-table.
+struct LuaGcSettings
+{
+    bool isGenerational = false;
+    int pause = 0;       ///< in percent, 0 keeps the Lua default
+    int stepMul = 0;     ///< in percent, 0 keeps the Lua default
+    int stepSize = 0;    ///< in KiB per explicit step, 0 for the allocated memory
+    LuaGcSteps steps = LuaGcSteps::AUTO;
+    std::chrono::milliseconds interval{10};
+};
+
+/**
+ * Control of the garbage collector of a Lua state. Lua collects garbage in
+ * small steps inside the allocations, i.e. during a request and with the
+ * Lua lock held, which makes its pauses part of the response time without
+ * showing up anywhere. With explicit steps, the automatic collector is
+ * stopped and every step is timed: `lua.gc_step_us` records all steps, the
+ * time spent on the thread of a request is taken by `takeThreadTime()`.
+ *
+ * All calls except `takeThreadTime()` have to be made with the Lua lock held.
+ */
+class LuaCollector
+{
+public:
+    LuaCollector() = default;
+    LuaCollector(const LuaCollector& orig) = delete;
+    LuaCollector& operator =(const LuaCollector& orig) = delete;
+    LuaCollector(LuaCollector&& orig) = delete;
+    LuaCollector& operator =(LuaCollector&& orig) = delete;
+    virtual ~LuaCollector();
+
+    void configure(lua_State* L, const LuaGcSettings& settings);
+    void startIdleSteps(TimerService::Callback callback);
+    void afterCall(lua_State* L) noexcept;
+    void idleStep(lua_State* L) noexcept;
+    LuaGcSteps getSteps() const noexcept { return settings_.steps; };
+
+    static std::int64_t takeThreadTime() noexcept;
+    static LuaGcSteps stepsFromString(const std::string& name) noexcept;
+
+private:
+    LuaGcSettings settings_;
+    TimerService::TimerId timerId_ = 0;
+    std::size_t lastKb_ = 0;   ///< heap size after the last explicit step
+    std::size_t cycleKb_ = 0;  ///< heap size at the end of the last cycle
+
+    void step(lua_State* L, int kb) noexcept;
+};
+
+#endif /* LUA_COLLECTOR_H */
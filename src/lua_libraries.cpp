@@ -0,0 +1,210 @@
+/**
+ * @file lua_libraries.cpp
+ *
+ * This file contains the minimal set of Lua standard libraries and the lazy
+ * loading of the other ones.
+ */
+
+#include "lua_libraries.h"
+#include <cstring>
+
+#include "selene/compat.h"
+
+using namespace std;
+
+/// Standard library with its global name.
+struct Library
+{
+    const char* name;
+    lua_CFunction open;
+};
+
+/// Libraries opened with every state. LuaJIT only compiles with `jit` opened.
+static const Library MINIMAL_LIBRARIES[] =
+{
+    {"_G", luaopen_base},
+    {LUA_STRLIBNAME, luaopen_string},
+    {LUA_TABLIBNAME, luaopen_table},
+    {LUA_MATHLIBNAME, luaopen_math},
+#ifdef SELENE_LUAJIT
+    {LUA_JITLIBNAME, luaopen_jit},
+#endif
+};
+
+/// Libraries opened on first use. LuaJIT opens `coroutine` with the base library.
+static const Library LAZY_LIBRARIES[] =
+{
+    {LUA_IOLIBNAME, luaopen_io},
+    {LUA_OSLIBNAME, luaopen_os},
+    {LUA_DBLIBNAME, luaopen_debug},
+    {LUA_LOADLIBNAME, luaopen_package},
+#ifdef SELENE_LUAJIT
+    {LUA_BITLIBNAME, luaopen_bit},
+    {LUA_FFILIBNAME, luaopen_ffi},
+#else
+    {LUA_COLIBNAME, luaopen_coroutine},
+#ifdef LUA_BITLIBNAME
+    {LUA_BITLIBNAME, luaopen_bit32},
+#endif
+#endif
+#ifdef LUA_UTF8LIBNAME
+    {LUA_UTF8LIBNAME, luaopen_utf8},
+#endif
+};
+
+/// Global function of the package library, which opens it on first use.
+static constexpr char REQUIRE_FUNCTION[] = "require";
+
+/**
+ * Finds the lazy library, which provides the given global.
+ *
+ * @param name: the name of the global
+ * @return the library or nullptr if it is no library global
+ */
+static const Library* findLazyLibrary(const char* name) noexcept
+{
+    if (strcmp(name, REQUIRE_FUNCTION) == 0)
+    {
+        name = LUA_LOADLIBNAME;
+    }
+    for (const Library& library : LAZY_LIBRARIES)
+    {
+        if (strcmp(name, library.name) == 0)
+        {
+            return &library;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Opens a library and sets its global (like `require`).
+ */
+static void openLibrary(lua_State* L, const Library& library)
+{
+    luaL_requiref(L, library.name, library.open, 1);
+#ifdef SELENE_LUAJIT
+    // `require("ffi")` works like in a state with all libraries opened
+    if (library.open == luaopen_package)
+    {
+        lua_getfield(L, -1, "preload");
+        lua_pushcfunction(L, luaopen_ffi);
+        lua_setfield(L, -2, LUA_FFILIBNAME);
+        lua_pop(L, 1);
+    }
+#endif
+    lua_pop(L, 1);
+}
+
+/**
+ * `__index` metamethod of the global table: reading an undefined global,
+ * which belongs to a lazy library, opens the library.
+ *
+ * @param L: the Lua state with the global table and the key on the stack
+ * @return the number of results (1)
+ */
+static int indexGlobals(lua_State* L)
+{
+    const Library* pLibrary = (lua_type(L, 2) == LUA_TSTRING) ? findLazyLibrary(lua_tostring(L, 2)) : nullptr;
+    if (pLibrary == nullptr)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+    openLibrary(L, *pLibrary);
+    lua_pushvalue(L, 2);
+    lua_rawget(L, 1);
+    return 1;
+}
+
+/**
+ * Opens the minimal libraries in a new state and lets the global table open
+ * the other ones on first use.
+ *
+ * @param L: the Lua state
+ */
+void LuaLibraries::open(lua_State* L)
+{
+    for (const Library& library : MINIMAL_LIBRARIES)
+    {
+        openLibrary(L, library);
+    }
+    setProfile(L, LuaLibraryProfile::LAZY);
+}
+
+/**
+ * Changes the profile of a state. Libraries, which are already open, stay
+ * open. A global table with a metatable of the script is not touched.
+ *
+ * @param L: the Lua state
+ * @param profile: the new profile
+ */
+void LuaLibraries::setProfile(lua_State* L, LuaLibraryProfile profile)
+{
+    const int top = lua_gettop(L);
+    lua_pushglobaltable(L);
+    const int globals = lua_gettop(L);
+
+    bool isLazy = false;
+    const bool hasMetatable = lua_getmetatable(L, globals);
+    if (hasMetatable)
+    {
+        lua_getfield(L, -1, "__index");
+        isLazy = (lua_tocfunction(L, -1) == indexGlobals);
+    }
+    if (hasMetatable && !isLazy)
+    {
+        lua_settop(L, top);
+        return;
+    }
+
+    switch (profile)
+    {
+        case LuaLibraryProfile::LAZY:
+            if (!isLazy)
+            {
+                lua_createtable(L, 0, 1);
+                lua_pushcfunction(L, indexGlobals);
+                lua_setfield(L, -2, "__index");
+                lua_setmetatable(L, globals);
+            }
+            break;
+        case LuaLibraryProfile::FULL:
+            for (const Library& library : LAZY_LIBRARIES)
+            {
+                lua_pushstring(L, library.name);
+                lua_rawget(L, globals);
+                const bool isOpen = !lua_isnil(L, -1);
+                lua_pop(L, 1);
+                if (!isOpen)
+                {
+                    openLibrary(L, library);
+                }
+            }
+            [[fallthrough]];
+        case LuaLibraryProfile::MINIMAL:
+            lua_pushnil(L);
+            lua_setmetatable(L, globals);
+            break;
+    }
+    lua_settop(L, top);
+}
+
+/**
+ * Converts the name of a profile ("minimal", "lazy" or "full").
+ *
+ * @param name: the name of the profile
+ * @return the profile, `LAZY` for unknown names
+ */
+LuaLibraryProfile LuaLibraries::profileFromString(const string& name) noexcept
+{
+    if (name == "minimal")
+    {
+        return LuaLibraryProfile::MINIMAL;
+    }
+    if (name == "full")
+    {
+        return LuaLibraryProfile::FULL;
+    }
+    return LuaLibraryProfile::LAZY;
+}
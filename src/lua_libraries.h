@@ -0,0 +1,38 @@
+/**
+ * @file lua_libraries.h
+ *
+ */
+
+#ifndef LUA_LIBRARIES_H
+#define LUA_LIBRARIES_H
+
+#include <string>
+
+struct lua_State;
+
+/// Standard libraries available to a Lua config, see `LuaLibraries`.
+enum class LuaLibraryProfile
+{
+    MINIMAL, ///< base, string, table and math only
+    LAZY,    ///< the others are opened on first use (default)
+    FULL     ///< all libraries are opened at once
+};
+
+/**
+ * Standard libraries of the Lua states. A new state only gets the base,
+ * string, table and math libraries. The others (io, os, debug, package,
+ * coroutine, ...) are opened on the first access to their global name, so
+ * the hundreds of states of a large simulation do not pay for libraries
+ * their configs never use.
+ */
+class LuaLibraries
+{
+public:
+    LuaLibraries() = delete;
+
+    static void open(lua_State* L);
+    static void setProfile(lua_State* L, LuaLibraryProfile profile);
+    static LuaLibraryProfile profileFromString(const std::string& name) noexcept;
+};
+
+#endif /* LUA_LIBRARIES_H */
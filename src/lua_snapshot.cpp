@@ -0,0 +1,220 @@
+/**
+ * @file lua_snapshot.cpp
+ *
+ * This file contains the snapshot of the global Lua variables, which is used
+ * to reset an ECU without reloading its Lua script.
+ */
+
+#include "lua_snapshot.h"
+
+#include "selene/compat.h"
+
+using namespace std;
+
+/// Index of the copied globals inside the snapshot table.
+constexpr int SNAPSHOT_GLOBALS = 1;
+
+/// Index of the set of tables, which are shared instead of copied.
+constexpr int SNAPSHOT_SHARED = 2;
+
+/// Index of the live table, which the snapshot has been taken of.
+constexpr int SNAPSHOT_LIVE = 3;
+
+/// Stack slots used by a single level of `pushCopy()`.
+constexpr int COPY_STACK_SLOTS = 6;
+
+static void copyEntries(lua_State* L, int src, int dst, int shared, int memo);
+
+/**
+ * Pushes a deep copy of the value at the given index. Tables in `shared` (the
+ * loaded libraries) are pushed as they are, tables which have already been
+ * copied are taken from `memo`, so cycles and tables referenced twice keep
+ * their structure. Functions and userdata are never copied.
+ *
+ * @param L: the Lua state
+ * @param idx: stack index of the value
+ * @param shared: stack index of the set of shared tables
+ * @param memo: stack index of the table mapping originals to copies
+ */
+static void pushCopy(lua_State* L, int idx, int shared, int memo)
+{
+    idx = lua_absindex(L, idx);
+    if (lua_type(L, idx) != LUA_TTABLE)
+    {
+        lua_pushvalue(L, idx);
+        return;
+    }
+
+    lua_pushvalue(L, idx);
+    lua_rawget(L, shared);
+    const bool isShared = lua_toboolean(L, -1);
+    lua_pop(L, 1);
+    if (isShared || !lua_checkstack(L, COPY_STACK_SLOTS))
+    {
+        lua_pushvalue(L, idx);
+        return;
+    }
+
+    lua_pushvalue(L, idx);
+    lua_rawget(L, memo);
+    if (!lua_isnil(L, -1))
+    {
+        return;
+    }
+    lua_pop(L, 1);
+
+    lua_newtable(L);
+    const int copy = lua_gettop(L);
+    lua_pushvalue(L, idx);
+    lua_pushvalue(L, copy);
+    lua_rawset(L, memo);
+
+    copyEntries(L, idx, copy, shared, memo);
+    if (lua_getmetatable(L, idx))
+    {
+        lua_setmetatable(L, copy);
+    }
+}
+
+/**
+ * Copies all entries of the table `src` into the table `dst`.
+ *
+ * @see pushCopy()
+ */
+static void copyEntries(lua_State* L, int src, int dst, int shared, int memo)
+{
+    lua_pushnil(L);
+    while (lua_next(L, src) != 0)
+    {
+        // stack: key, value
+        pushCopy(L, -2, shared, memo);
+        pushCopy(L, -2, shared, memo);
+        lua_rawset(L, dst);
+        lua_pop(L, 1);
+    }
+}
+
+/**
+ * Takes the snapshot of all global variables or of the given table. Call this
+ * once, right after the script has been loaded. The libraries of
+ * `package.loaded` are shared with the live state, all other tables are
+ * copied.
+ *
+ * @param L: the Lua state
+ * @param table: stack index of the table or 0 for the global table
+ */
+void LuaSnapshot::take(lua_State* L, int table)
+{
+    const int top = lua_gettop(L);
+    if (table == 0)
+    {
+        lua_pushglobaltable(L);
+    }
+    else
+    {
+        lua_pushvalue(L, table);
+    }
+    const int live = lua_gettop(L);
+    if (isTaken_)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, ref_);
+    }
+
+    lua_createtable(L, 3, 0);
+    const int snapshot = lua_gettop(L);
+
+    lua_newtable(L);
+    const int shared = lua_gettop(L);
+    lua_getfield(L, LUA_REGISTRYINDEX, "_LOADED");
+    if (lua_istable(L, -1))
+    {
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0)
+        {
+            if (lua_istable(L, -1))
+            {
+                lua_pushboolean(L, 1);
+                lua_rawset(L, shared); // pops the value, keeps the key
+            }
+            else
+            {
+                lua_pop(L, 1);
+            }
+        }
+    }
+    lua_pop(L, 1);
+
+    lua_newtable(L);
+    const int memo = lua_gettop(L);
+    lua_newtable(L);
+    const int globals = lua_gettop(L);
+    copyEntries(L, live, globals, shared, memo);
+
+    lua_pushvalue(L, globals);
+    lua_rawseti(L, snapshot, SNAPSHOT_GLOBALS);
+    lua_pushvalue(L, shared);
+    lua_rawseti(L, snapshot, SNAPSHOT_SHARED);
+    lua_pushvalue(L, live);
+    lua_rawseti(L, snapshot, SNAPSHOT_LIVE);
+    lua_pushvalue(L, snapshot);
+    ref_ = luaL_ref(L, LUA_REGISTRYINDEX);
+    isTaken_ = true;
+
+    lua_settop(L, top);
+}
+
+/**
+ * Restores all global variables (or the table) from the snapshot. Globals
+ * created later are removed, all others get a fresh copy of their value at
+ * snapshot time. The table itself stays the same, so functions of the script
+ * keep working. Local variables captured by functions (upvalues) are not restored.
+ *
+ * @param L: the Lua state
+ * @return false if no snapshot has been taken
+ */
+bool LuaSnapshot::restore(lua_State* L) const
+{
+    if (!isTaken_)
+    {
+        return false;
+    }
+
+    const int top = lua_gettop(L);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, ref_);
+    const int snapshot = lua_gettop(L);
+    lua_rawgeti(L, snapshot, SNAPSHOT_GLOBALS);
+    const int globals = lua_gettop(L);
+    lua_rawgeti(L, snapshot, SNAPSHOT_SHARED);
+    const int shared = lua_gettop(L);
+    lua_rawgeti(L, snapshot, SNAPSHOT_LIVE);
+    const int live = lua_gettop(L);
+
+    // remove the globals, which did not exist at snapshot time (clearing
+    // existing fields is allowed while traversing)
+    lua_pushnil(L);
+    while (lua_next(L, live) != 0)
+    {
+        lua_pop(L, 1);
+        lua_pushvalue(L, -1);
+        lua_rawget(L, globals);
+        const bool isKnown = !lua_isnil(L, -1);
+        lua_pop(L, 1);
+        if (!isKnown)
+        {
+            lua_pushvalue(L, -1);
+            lua_pushnil(L);
+            lua_rawset(L, live);
+        }
+    }
+
+    // references to the copied global table lead back to the live one
+    lua_newtable(L);
+    const int memo = lua_gettop(L);
+    lua_pushvalue(L, globals);
+    lua_pushvalue(L, live);
+    lua_rawset(L, memo);
+    copyEntries(L, globals, live, shared, memo);
+
+    lua_settop(L, top);
+    return true;
+}
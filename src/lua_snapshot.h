@@ -0,0 +1,35 @@
+/**
+ * @file lua_snapshot.h
+ *
+ */
+
+#ifndef LUA_SNAPSHOT_H
+#define LUA_SNAPSHOT_H
+
+struct lua_State;
+
+/**
+ * Copy of the global Lua variables (or of a single table), kept in the
+ * registry of the Lua state. Restoring it brings the script back to the state
+ * right after loading, without parsing and running the file again.
+ */
+class LuaSnapshot
+{
+public:
+    LuaSnapshot() = default;
+    LuaSnapshot(const LuaSnapshot& orig) = delete;
+    LuaSnapshot& operator =(const LuaSnapshot& orig) = delete;
+    LuaSnapshot(LuaSnapshot&& orig) = default;
+    LuaSnapshot& operator =(LuaSnapshot&& orig) = default;
+    virtual ~LuaSnapshot() = default;
+
+    void take(lua_State* L, int table = 0);
+    bool restore(lua_State* L) const;
+    bool isTaken() const noexcept { return isTaken_; };
+
+private:
+    int ref_ = 0;
+    bool isTaken_ = false;
+};
+
+#endif /* LUA_SNAPSHOT_H */
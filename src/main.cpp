@@ -8,61 +8,161 @@
 #include "ecu_lua_script.h"
 #include "electronic_control_unit.h"
 #include "j1939_simulator.h"
+#include "script_slot.h"
+#include "config_watcher.h"
+#include "worker_pool.h"
 #include "ecu_timer.h"
 #include "utilities.h"
+#include "metrics.h"
 #include <string>
 #include <thread>
+#include <future>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
 #include <csignal>
+#include <cerrno>
 #include <cstdio>
 #include <filesystem>
+#include <iostream>
+#include <unistd.h>
 
 using namespace std;
 
 vector<ElectronicControlUnit *> udsSimulators;
 vector<J1939Simulator *> j1939Simulators;
+mutex simulatorsMutex;
+ConfigWatcher configWatcher(".");
+int signalPipe[2] = {-1, -1}; ///< self-pipe, the signal handler passes the signals through
 
 
+/**
+ * Loads a config and starts the simulations of its ECU, or of all ECUs of a
+ * fleet config. The simulations run on their own threads, so the call returns
+ * as soon as the ECUs are ready.
+ *
+ * @param config_file: the name of the Lua config
+ * @param device: the CAN interface (e.g. "vcan0")
+ */
 void start_server(const string &config_file, const string &device)
 {
+    static metrics::Histogram& readyTime = metrics::histogram("ecu.ready_time_us");
+
     cout << "start_server for config file: " << config_file
          << " on device: " << device << endl;
+    const auto start = chrono::steady_clock::now();
 
-    EcuLuaScript *script = new EcuLuaScript("Main", config_file);
-
-    ElectronicControlUnit *udsSimulator = NULL;
-    J1939Simulator *j1939Simulator = NULL;
+    const auto scripts = EcuLuaScript::loadFleet("Main", config_file);
+    for (const auto& script : scripts)
+    {
+        auto slot = make_shared<ScriptSlot>(script);
 
-    if(ElectronicControlUnit::hasSimulation(script)) {
-        udsSimulator = new ElectronicControlUnit(device, script);
-        udsSimulators.push_back(udsSimulator);
+        if(ElectronicControlUnit::hasSimulation(script.get())) {
+            auto udsSimulator = new ElectronicControlUnit(device, slot);
+            const lock_guard<mutex> lock(simulatorsMutex);
+            udsSimulators.push_back(udsSimulator);
+        }
+        if(J1939Simulator::hasSimulation(script.get())) {
+            auto j1939Simulator = new J1939Simulator(device, slot);
+            const lock_guard<mutex> lock(simulatorsMutex);
+            j1939Simulators.push_back(j1939Simulator);
+        }
+        if (script->getFleetIndex() == 0)
+        {
+            configWatcher.watch(config_file, "Main", slot);
+        }
+        else
+        {
+            // fleets are not reloaded, their instances share a single Lua state
+            cout << script->getIdent() << ": " << script->getPrivateMemory()
+                 << " bytes private Lua memory" << endl;
+        }
     }
-    if(J1939Simulator::hasSimulation(script)) {
-        j1939Simulator = new J1939Simulator(device, script);
-        j1939Simulators.push_back(j1939Simulator);
+    if (scripts.size() > 1)
+    {
+        cout << config_file << ": " << scripts.size() << " instances share "
+             << scripts.front()->getLuaMemory() << " bytes Lua memory" << endl;
     }
 
-    if(udsSimulator) {
-        udsSimulator->waitForSimulationEnd();
-        cout << "UDS terminated" << endl;
-        delete udsSimulator;
+    const auto timeToReady = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+    readyTime.record(timeToReady.count());
+    cout << config_file << " ready after " << dec << timeToReady.count() / 1000 << " ms" << endl;
+}
+
+/**
+ * Loads all configs in parallel on a bounded number of threads.
+ *
+ * @param config_files: the names of the Lua configs
+ * @param device: the CAN interface (e.g. "vcan0")
+ * @return the number of configs, which have been started successfully
+ */
+size_t start_servers(const vector<string> &config_files, const string &device)
+{
+    const size_t numLoaders = max(size_t(1), min(config_files.size(), size_t(thread::hardware_concurrency())));
+    WorkerPool loaders(numLoaders);
+
+    vector<future<void>> results;
+    for (const string &config_file : config_files)
+    {
+        auto pTask = make_shared<packaged_task<void()>>([config_file, &device]() { start_server(config_file, device); });
+        results.push_back(pTask->get_future());
+        loaders.submit([pTask]() { (*pTask)(); });
     }
-    if(j1939Simulator) {
-        j1939Simulator->waitForSimulationEnd();
-        cout << "J1939 terminated" << endl;
-        delete j1939Simulator;
+
+    size_t numStarted = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        try
+        {
+            results[i].get();
+            ++numStarted;
+        }
+        catch (const exception& e)
+        {
+            cerr << config_files[i] << " failed to start: " << e.what() << endl;
+        }
     }
+    return numStarted;
 }
 
+/**
+ * Passes the signal number to `handleSignals()` through the self-pipe. Only
+ * calls `write()`, which is async-signal-safe.
+ *
+ * @param signum: the signal number
+ */
 void signalHandler(int signum) {
-    printf("Received signal %d\n",signum);
-    if(signum == SIGINT) {
-        for (ElectronicControlUnit *simulator : udsSimulators) {
-            simulator->stopSimulation();
+    const unsigned char sig = static_cast<unsigned char>(signum);
+    const int savedErrno = errno;
+    const ssize_t written = write(signalPipe[1], &sig, 1);
+    (void) written; // nothing can be reported from the handler
+    errno = savedErrno;
+}
+
+/**
+ * Handles the signals passed by `signalHandler()` on an ordinary thread: dumps
+ * the metrics on SIGUSR1, and on SIGINT before stopping the simulations.
+ */
+void handleSignals() {
+    unsigned char sig;
+    while (read(signalPipe[0], &sig, 1) == 1) {
+        cout << "Received signal " << int(sig) << endl;
+        if(sig == SIGUSR1) {
+            metrics::dump(cout);
         }
-        for (J1939Simulator *simulator : j1939Simulators) {
-            simulator->stopSimulation();
+        if(sig == SIGINT) {
+            metrics::dump(cout);
+            {
+                const lock_guard<mutex> lock(simulatorsMutex);
+                for (ElectronicControlUnit *simulator : udsSimulators) {
+                    simulator->stopSimulation();
+                }
+                for (J1939Simulator *simulator : j1939Simulators) {
+                    simulator->stopSimulation();
+                }
+            }
+            exit(1);
         }
-        exit(1);
     }
 }
 /**
@@ -79,28 +179,58 @@ int main(int argc, char** argv)
     {
         device = argv[1];
     }
+    // written as soon as all ECUs are ready, e.g. for CI jobs waiting on the simulator
+    string readyFile;
+    if (argc > 2)
+    {
+        readyFile = filesystem::absolute(argv[2]);
+    }
     
     // listen to this communication with `isotpsniffer -s 100 -d 200 -c -td vcan0`
 
     filesystem::current_path(filesystem::path(LUA_CONFIG_PATH));
 
     vector<string> config_files = utils::getConfigFilenames(".");
-    vector<thread> threads;
 
-    signal(SIGINT, signalHandler);
+    if (pipe(signalPipe) == 0)
+    {
+        thread(handleSignals).detach();
+        signal(SIGINT, signalHandler);
+        signal(SIGUSR1, signalHandler);
+    }
+    else
+    {
+        perror("pipe");
+    }
 
-    for (const string &config_file : config_files)
+    const auto start = chrono::steady_clock::now();
+    const size_t numStarted = start_servers(config_files, device);
+    const auto startupTime = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    cout << numStarted << " of " << config_files.size() << " configs ready after "
+         << dec << startupTime.count() << " ms" << endl;
+
+    // changed configs are reloaded without restarting the simulation
+    configWatcher.start();
+
+    const string status = to_string(numStarted) + " of " + to_string(config_files.size()) + " configs ready";
+    utils::notifyServiceManager("READY=1\nSTATUS=" + status + '\n');
+    if (!readyFile.empty())
     {
-        thread t(start_server, config_file, device);
-        threads.push_back(move(t));
-        usleep(50000);
+        utils::writeFileAtomically(readyFile, status + '\n');
     }
 
-    for (unsigned int i = 0; i < threads.size(); ++i)
+    for (ElectronicControlUnit *udsSimulator : udsSimulators)
     {
-        threads[i].join();
+        udsSimulator->waitForSimulationEnd();
+        cout << "UDS terminated" << endl;
+        delete udsSimulator;
+    }
+    for (J1939Simulator *j1939Simulator : j1939Simulators)
+    {
+        j1939Simulator->waitForSimulationEnd();
+        cout << "J1939 terminated" << endl;
+        delete j1939Simulator;
     }
 
     return 0;
 }
-
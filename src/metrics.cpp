@@ -0,0 +1,144 @@
+/**
+ * @file metrics.cpp
+ *
+ * This file contains the registry of the run-time metrics.
+ */
+
+#include "metrics.h"
+#include <map>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+namespace metrics {
+
+static mutex registryMutex;
+static map<string, unique_ptr<Counter>> counters;
+static map<string, unique_ptr<Gauge>> gauges;
+static map<string, unique_ptr<Histogram>> histograms;
+
+/**
+ * Adds a value to the histogram.
+ *
+ * @param value: the value to record (e.g. a duration in microseconds)
+ */
+void Histogram::record(uint64_t value) noexcept
+{
+    buckets_[bucketOf(value)].fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * Returns the number of recorded values.
+ */
+uint64_t Histogram::count() const noexcept
+{
+    uint64_t sum = 0;
+    for (const auto& bucket : buckets_)
+    {
+        sum += bucket.load(memory_order_relaxed);
+    }
+    return sum;
+}
+
+/**
+ * Returns the index of the bucket the value belongs to. Values beyond the
+ * last bucket are counted in the last bucket.
+ */
+size_t Histogram::bucketOf(uint64_t value) noexcept
+{
+    if (value == 0)
+    {
+        return 0;
+    }
+    const size_t idx = 64 - __builtin_clzll(value);
+    return (idx < NUM_BUCKETS) ? idx : NUM_BUCKETS - 1;
+}
+
+/**
+ * Returns the counter with the given name. The counter is created on the
+ * first call and lives until the end of the process.
+ *
+ * @param name: the name of the counter (e.g. "uds.requests")
+ * @return reference to the counter
+ */
+Counter& counter(const string& name)
+{
+    const lock_guard<mutex> lock(registryMutex);
+    auto& entry = counters[name];
+    if (!entry)
+    {
+        entry = make_unique<Counter>();
+    }
+    return *entry;
+}
+
+/**
+ * Returns the gauge with the given name. The gauge is created on the first
+ * call and lives until the end of the process.
+ *
+ * @param name: the name of the gauge (e.g. "lua.memory.PCM.lua.bytes")
+ * @return reference to the gauge
+ */
+Gauge& gauge(const string& name)
+{
+    const lock_guard<mutex> lock(registryMutex);
+    auto& entry = gauges[name];
+    if (!entry)
+    {
+        entry = make_unique<Gauge>();
+    }
+    return *entry;
+}
+
+/**
+ * Returns the histogram with the given name. The histogram is created on the
+ * first call and lives until the end of the process.
+ *
+ * @param name: the name of the histogram (e.g. "uds.handler_us")
+ * @return reference to the histogram
+ */
+Histogram& histogram(const string& name)
+{
+    const lock_guard<mutex> lock(registryMutex);
+    auto& entry = histograms[name];
+    if (!entry)
+    {
+        entry = make_unique<Histogram>();
+    }
+    return *entry;
+}
+
+/**
+ * Writes all metrics in a human readable format. Histograms print the upper
+ * bound of each non-empty bucket followed by its count.
+ *
+ * @param out: the stream to write to
+ */
+void dump(ostream& out)
+{
+    const lock_guard<mutex> lock(registryMutex);
+    for (const auto& entry : counters)
+    {
+        out << entry.first << " = " << entry.second->value() << '\n';
+    }
+    for (const auto& entry : gauges)
+    {
+        out << entry.first << " = " << entry.second->value() << '\n';
+    }
+    for (const auto& entry : histograms)
+    {
+        out << entry.first << " (n = " << entry.second->count() << ")\n";
+        for (size_t i = 0; i < Histogram::NUM_BUCKETS; ++i)
+        {
+            const uint64_t n = entry.second->bucket(i);
+            if (n != 0)
+            {
+                out << "    < " << (uint64_t(1) << i) << ": " << n << '\n';
+            }
+        }
+    }
+    out.flush();
+}
+
+}
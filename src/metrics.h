@@ -0,0 +1,70 @@
+/**
+ * @file metrics.h
+ *
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <array>
+#include <string>
+#include <ostream>
+
+/**
+ * Lightweight run-time metrics. Counters, gauges and histograms are registered
+ * once by name and then updated with relaxed atomic operations only, so they
+ * can be used on every request. Callers are supposed to keep the returned
+ * reference, e.g. in a function local static.
+ */
+namespace metrics {
+
+class Counter
+{
+public:
+    void increment(std::uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); };
+    std::uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); };
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+/// Value, which goes up and down (e.g. the memory in use).
+class Gauge
+{
+public:
+    void add(std::int64_t n) noexcept { value_.fetch_add(n, std::memory_order_relaxed); };
+    std::int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); };
+
+private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+/**
+ * Histogram with power of two buckets. Bucket `i` counts the values in the
+ * range [2^(i-1), 2^i), bucket 0 counts the value 0.
+ */
+class Histogram
+{
+public:
+    static constexpr std::size_t NUM_BUCKETS = 32;
+
+    void record(std::uint64_t value) noexcept;
+    std::uint64_t count() const noexcept;
+    std::uint64_t bucket(std::size_t idx) const noexcept { return buckets_[idx].load(std::memory_order_relaxed); };
+    static std::size_t bucketOf(std::uint64_t value) noexcept;
+
+private:
+    std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> buckets_{};
+};
+
+Counter& counter(const std::string& name);
+Gauge& gauge(const std::string& name);
+Histogram& histogram(const std::string& name);
+void dump(std::ostream& out);
+
+}
+
+#endif /* METRICS_H */
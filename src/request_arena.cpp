@@ -0,0 +1,64 @@
+/**
+ * @file request_arena.cpp
+ *
+ * This file contains the per-thread arena for the temporaries of a UDS request.
+ */
+
+#include "request_arena.h"
+#include "metrics.h"
+
+using namespace std;
+
+/**
+ * Upstream of the arena, which counts the requests not fitting into the
+ * per-thread buffer.
+ */
+class OverflowResource : public pmr::memory_resource
+{
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        static metrics::Counter& overflows = metrics::counter("uds.arena_overflows");
+        overflows.increment();
+        return pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/// Buffer and resource of one thread.
+struct ThreadArena
+{
+    alignas(max_align_t) byte buffer[RequestArena::BUFFER_SIZE];
+    OverflowResource upstream;
+    pmr::monotonic_buffer_resource resource{buffer, sizeof(buffer), &upstream};
+};
+
+static thread_local ThreadArena arena;
+
+/**
+ * Returns the arena of the calling thread.
+ *
+ * @return the memory resource to allocate request temporaries from
+ */
+pmr::memory_resource* RequestArena::resource() noexcept
+{
+    return &arena.resource;
+}
+
+/**
+ * Hands back all memory of the calling thread's arena. The next request
+ * starts again at the beginning of the buffer.
+ */
+void RequestArena::release() noexcept
+{
+    arena.resource.release();
+}
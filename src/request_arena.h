@@ -0,0 +1,50 @@
+/**
+ * @file request_arena.h
+ *
+ */
+
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+
+/// Response bytes, which are only valid until the end of the request.
+using ArenaBytes = std::pmr::vector<std::uint8_t>;
+
+/**
+ * Per-thread monotonic arena for all temporaries of a single UDS request. The
+ * memory is taken from a fixed buffer of the calling thread and handed back
+ * at once, when the `Scope` of the request ends. Only requests exceeding the
+ * buffer fall back to the heap.
+ */
+class RequestArena
+{
+public:
+    /// Size of the per-thread buffer in bytes.
+    static constexpr std::size_t BUFFER_SIZE = 16384;
+
+    /**
+     * Releases all memory of the calling thread's arena on destruction. Every
+     * object allocated from the arena has to be gone by then.
+     */
+    class Scope
+    {
+    public:
+        Scope() = default;
+        Scope(const Scope& orig) = delete;
+        Scope& operator =(const Scope& orig) = delete;
+        Scope(Scope&& orig) = delete;
+        Scope& operator =(Scope&& orig) = delete;
+        ~Scope() { RequestArena::release(); };
+    };
+
+    RequestArena() = delete;
+
+    static std::pmr::memory_resource* resource() noexcept;
+    static void release() noexcept;
+};
+
+#endif /* REQUEST_ARENA_H */
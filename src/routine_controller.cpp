@@ -0,0 +1,262 @@
+/**
+ * @file routine_controller.cpp
+ *
+ * This file contains the routine subsystem for the UDS service
+ * `RoutineControl` (0x31).
+ */
+
+#include "routine_controller.h"
+#include "worker_pool.h"
+#include <iostream>
+#include <exception>
+
+using namespace std;
+
+/// Max. number of routine bodies executed at the same time, further bodies are queued.
+static constexpr size_t MAX_NUM_ROUTINE_WORKERS = 256;
+
+/**
+ * Returns the worker pool of the routine bodies. A body blocks for the run
+ * time of its routine, so the bodies get their own pool, which grows with the
+ * number of running routines. Thus a started routine is executed right away
+ * instead of waiting for other routines, and the jobs of the process wide pool
+ * (e.g. functional requests) never wait for a routine.
+ */
+static WorkerPool& routinePool()
+{
+    static WorkerPool pool(0, MAX_NUM_ROUTINE_WORKERS);
+    return pool;
+}
+
+/**
+ * Constructor.
+ *
+ * @param options: the `routineControlOptionRecord` of the start request
+ */
+RoutineRun::RoutineRun(const vector<uint8_t>& options)
+: options_(options)
+{
+}
+
+/**
+ * Sleeps for the given duration, but returns early once the routine is
+ * stopped. Routine bodies use this to simulate their run time.
+ *
+ * @param duration: the time to sleep
+ * @return true if the duration elapsed, false if the routine was stopped
+ */
+bool RoutineRun::sleepFor(chrono::milliseconds duration)
+{
+    unique_lock<mutex> lock(mutex_);
+    return !stopCond_.wait_for(lock, duration, [this] { return bool(isStopRequested_); });
+}
+
+/**
+ * Sets the result (`routineStatusRecord`) reported by `requestRoutineResults`.
+ *
+ * @param result: the result bytes
+ */
+void RoutineRun::setResult(const vector<uint8_t>& result)
+{
+    const lock_guard<mutex> lock(mutex_);
+    result_ = result;
+}
+
+/**
+ * Returns a copy of the current result.
+ */
+vector<uint8_t> RoutineRun::getResult() const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return result_;
+}
+
+void RoutineRun::requestStop()
+{
+    {
+        const lock_guard<mutex> lock(mutex_);
+        isStopRequested_ = true;
+    }
+    state_ = RoutineState::STOPPED;
+    stopCond_.notify_all();
+}
+
+/**
+ * Destructor. Requests all running routines to stop.
+ */
+RoutineController::~RoutineController()
+{
+    stopAll();
+}
+
+/**
+ * Defines a routine. An already defined routine with the same identifier is
+ * replaced.
+ *
+ * @param rid: the routine identifier (e.g. `0xFF00`)
+ * @param body: the function which runs on the worker pool
+ * @param startHook: optional function which is called synchronously on start
+ * and returns the `routineStatusRecord` of the start response
+ */
+void RoutineController::define(uint16_t rid, RoutineBody body, StartHook startHook)
+{
+    const lock_guard<mutex> lock(mutex_);
+    routines_[rid] = Routine{move(body), move(startHook), nullptr};
+}
+
+/**
+ * Checks if a routine with the given identifier is defined.
+ */
+bool RoutineController::has(uint16_t rid) const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return routines_.find(rid) != routines_.cend();
+}
+
+/**
+ * Starts a routine (`startRoutine`). The call returns immediately, the body
+ * runs on the routine pool.
+ *
+ * @param rid: the routine identifier
+ * @param options: the `routineControlOptionRecord` of the request
+ * @param statusRecord: the `routineStatusRecord` of the start response
+ * @return `RoutineResult::OK` on success, otherwise the reason of rejection
+ */
+RoutineResult RoutineController::start(uint16_t rid,
+                                       const vector<uint8_t>& options,
+                                       vector<uint8_t>& statusRecord)
+{
+    const lock_guard<mutex> lock(mutex_);
+    auto it = routines_.find(rid);
+    if (it == routines_.end())
+    {
+        return RoutineResult::UNKNOWN_ROUTINE;
+    }
+
+    Routine& routine = it->second;
+    if (routine.pRun != nullptr && routine.pRun->getState() == RoutineState::RUNNING)
+    {
+        return RoutineResult::ALREADY_RUNNING;
+    }
+    if (routine.startHook != nullptr)
+    {
+        statusRecord = routine.startHook();
+    }
+
+    // the run is shared with the job, since a stopped body may still be busy
+    // after the routine has been started again
+    auto pRun = make_shared<RoutineRun>(options);
+    routine.pRun = pRun;
+    RoutineBody body = routine.body;
+    auto pNumBusy = pNumBusy_;
+    ++*pNumBusy;
+    routinePool().submit([pRun, body, pNumBusy]()
+    {
+        RoutineState state = RoutineState::COMPLETED;
+        try
+        {
+            body(*pRun);
+        }
+        catch (const exception& e)
+        {
+            cerr << "routine failed: " << e.what() << '\n';
+            state = RoutineState::FAILED;
+        }
+        // a stopped routine stays stopped
+        RoutineState running = RoutineState::RUNNING;
+        if (pRun->state_.compare_exchange_strong(running, state) && state == RoutineState::COMPLETED)
+        {
+            pRun->setProgress(100);
+        }
+        --*pNumBusy;
+    });
+    return RoutineResult::OK;
+}
+
+/**
+ * Stops a running routine (`stopRoutine`). The body is notified and
+ * expected to return soon, the routine is reported as stopped immediately.
+ *
+ * @param rid: the routine identifier
+ * @return `RoutineResult::OK` on success, otherwise the reason of rejection
+ */
+RoutineResult RoutineController::stop(uint16_t rid)
+{
+    const lock_guard<mutex> lock(mutex_);
+    auto it = routines_.find(rid);
+    if (it == routines_.end())
+    {
+        return RoutineResult::UNKNOWN_ROUTINE;
+    }
+
+    const shared_ptr<RoutineRun>& pRun = it->second.pRun;
+    if (pRun == nullptr || pRun->getState() != RoutineState::RUNNING)
+    {
+        return RoutineResult::NOT_STARTED;
+    }
+    pRun->requestStop();
+    return RoutineResult::OK;
+}
+
+/**
+ * Gets the state of the latest run of a routine (`requestRoutineResults`)
+ * without waiting for the routine body.
+ *
+ * @param rid: the routine identifier
+ * @param state: the state of the routine
+ * @param progress: the progress of the routine in percent
+ * @param result: the result bytes of the routine
+ * @return `RoutineResult::OK` on success, otherwise the reason of rejection
+ */
+RoutineResult RoutineController::getStatus(uint16_t rid,
+                                           RoutineState& state,
+                                           uint8_t& progress,
+                                           vector<uint8_t>& result) const
+{
+    shared_ptr<RoutineRun> pRun;
+    {
+        const lock_guard<mutex> lock(mutex_);
+        auto it = routines_.find(rid);
+        if (it == routines_.cend())
+        {
+            return RoutineResult::UNKNOWN_ROUTINE;
+        }
+        pRun = it->second.pRun;
+    }
+
+    if (pRun == nullptr)
+    {
+        return RoutineResult::NOT_STARTED;
+    }
+    state = pRun->getState();
+    progress = pRun->getProgress();
+    result = pRun->getResult();
+    return RoutineResult::OK;
+}
+
+/**
+ * Checks if a routine body is still executed on the worker pool. Unlike the
+ * routine state, this includes stopped routines, whose body did not return
+ * yet.
+ *
+ * @return true while at least one body is executed
+ */
+bool RoutineController::isBusy() const noexcept
+{
+    return *pNumBusy_ != 0;
+}
+
+/**
+ * Requests all running routines to stop (e.g. on shutdown).
+ */
+void RoutineController::stopAll()
+{
+    const lock_guard<mutex> lock(mutex_);
+    for (auto& routine : routines_)
+    {
+        if (routine.second.pRun != nullptr && routine.second.pRun->getState() == RoutineState::RUNNING)
+        {
+            routine.second.pRun->requestStop();
+        }
+    }
+}
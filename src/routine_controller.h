@@ -0,0 +1,123 @@
+/**
+ * @file routine_controller.h
+ *
+ */
+
+#ifndef ROUTINE_CONTROLLER_H
+#define ROUTINE_CONTROLLER_H
+
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/// Value of `routineInfo` in `RoutineControl` responses.
+enum class RoutineState : std::uint8_t
+{
+    COMPLETED = 0x00,
+    RUNNING = 0x01,
+    STOPPED = 0x02,
+    FAILED = 0x03,
+    IDLE = 0xFF ///< never started, not sent on the bus
+};
+
+enum class RoutineResult : std::uint8_t
+{
+    OK,
+    UNKNOWN_ROUTINE,
+    ALREADY_RUNNING,
+    NOT_STARTED
+};
+
+/**
+ * A single execution of a routine. The routine body runs on the worker pool
+ * and reports its progress and result through this object, while the UDS
+ * thread reads them without blocking on the body.
+ */
+class RoutineRun
+{
+public:
+    RoutineRun() = delete;
+    explicit RoutineRun(const std::vector<std::uint8_t>& options);
+    RoutineRun(const RoutineRun& orig) = delete;
+    RoutineRun& operator =(const RoutineRun& orig) = delete;
+    RoutineRun(RoutineRun&& orig) = delete;
+    RoutineRun& operator =(RoutineRun&& orig) = delete;
+    virtual ~RoutineRun() = default;
+
+    const std::vector<std::uint8_t>& getOptions() const noexcept { return options_; };
+    bool isStopRequested() const noexcept { return isStopRequested_; };
+    bool sleepFor(std::chrono::milliseconds duration);
+    void setProgress(std::uint8_t percent) noexcept { progress_ = percent; };
+    void setResult(const std::vector<std::uint8_t>& result);
+
+    RoutineState getState() const noexcept { return state_; };
+    std::uint8_t getProgress() const noexcept { return progress_; };
+    std::vector<std::uint8_t> getResult() const;
+
+private:
+    friend class RoutineController;
+
+    const std::vector<std::uint8_t> options_;
+    std::atomic<RoutineState> state_{RoutineState::RUNNING};
+    std::atomic<std::uint8_t> progress_{0};
+    std::atomic<bool> isStopRequested_{false};
+    mutable std::mutex mutex_;
+    std::condition_variable stopCond_;
+    std::vector<std::uint8_t> result_;
+
+    void requestStop();
+};
+
+/**
+ * Serves `RoutineControl` (0x31). Routines are either native C++ functions or
+ * declared in the `Routines`-table of the Lua script. A started routine runs
+ * asynchronously on the worker pool, so the ECU keeps answering other
+ * requests and `requestRoutineResults` polls the state without blocking.
+ */
+class RoutineController
+{
+public:
+    using RoutineBody = std::function<void(RoutineRun& run)>;
+    using StartHook = std::function<std::vector<std::uint8_t>()>;
+
+    RoutineController() = default;
+    RoutineController(const RoutineController& orig) = delete;
+    RoutineController& operator =(const RoutineController& orig) = delete;
+    RoutineController(RoutineController&& orig) = delete;
+    RoutineController& operator =(RoutineController&& orig) = delete;
+    virtual ~RoutineController();
+
+    void define(std::uint16_t rid, RoutineBody body, StartHook startHook = nullptr);
+    bool has(std::uint16_t rid) const;
+    RoutineResult start(std::uint16_t rid,
+                        const std::vector<std::uint8_t>& options,
+                        std::vector<std::uint8_t>& statusRecord);
+    RoutineResult stop(std::uint16_t rid);
+    RoutineResult getStatus(std::uint16_t rid,
+                            RoutineState& state,
+                            std::uint8_t& progress,
+                            std::vector<std::uint8_t>& result) const;
+    void stopAll();
+    bool isBusy() const noexcept;
+
+private:
+    struct Routine
+    {
+        RoutineBody body;
+        StartHook startHook;
+        std::shared_ptr<RoutineRun> pRun;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::uint16_t, Routine> routines_;
+    /// number of bodies on the worker pool, shared with the jobs
+    std::shared_ptr<std::atomic<unsigned>> pNumBusy_ = std::make_shared<std::atomic<unsigned>>(0);
+};
+
+#endif /* ROUTINE_CONTROLLER_H */
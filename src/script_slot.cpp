@@ -0,0 +1,66 @@
+/**
+ * @file script_slot.cpp
+ *
+ * This file contains the slot holding the current Lua script of an ECU, which
+ * allows to replace the script at run-time.
+ */
+
+#include "script_slot.h"
+#include "service_identifier.h"
+#include <cassert>
+
+using namespace std;
+
+/**
+ * Constructor.
+ *
+ * @param pScript: the initially loaded script
+ */
+ScriptSlot::ScriptSlot(shared_ptr<EcuLuaScript> pScript) noexcept
+: pScript_(move(pScript))
+{
+    assert(pScript_ != nullptr);
+    hasRawTesterPresent_ = pScript_->hasRawService(TESTER_PRESENT_REQ);
+}
+
+/**
+ * Creates a slot for a script, which is owned by the caller and outlives the
+ * slot. Such a script must not be replaced.
+ *
+ * @param pScript: the script
+ * @return the new slot
+ */
+shared_ptr<ScriptSlot> ScriptSlot::borrow(EcuLuaScript* pScript)
+{
+    return make_shared<ScriptSlot>(shared_ptr<EcuLuaScript>(pScript, [](EcuLuaScript*) {}));
+}
+
+/**
+ * Gets the current version of the script. The returned pointer keeps this
+ * version alive, even if a newer one gets published meanwhile.
+ *
+ * @return the current script
+ */
+shared_ptr<EcuLuaScript> ScriptSlot::load() const noexcept
+{
+    return atomic_load(&pScript_);
+}
+
+/**
+ * Publishes a new version of the script. Requests in progress complete with
+ * the old version, all later ones use the new version. Routines still running
+ * in the old version are stopped, because their results could not be
+ * requested anymore.
+ *
+ * @param pScript: the new script
+ * @return the replaced script
+ */
+shared_ptr<EcuLuaScript> ScriptSlot::publish(shared_ptr<EcuLuaScript> pScript) noexcept
+{
+    assert(pScript != nullptr);
+    hasRawTesterPresent_ = pScript->hasRawService(TESTER_PRESENT_REQ);
+    shared_ptr<EcuLuaScript> pOld = atomic_exchange(&pScript_, move(pScript));
+    ++version_;
+    pOld->getRoutineController().stopAll();
+    return pOld;
+}
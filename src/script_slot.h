@@ -0,0 +1,43 @@
+/**
+ * @file script_slot.h
+ *
+ */
+
+#ifndef SCRIPT_SLOT_H
+#define SCRIPT_SLOT_H
+
+#include "ecu_lua_script.h"
+#include <memory>
+#include <atomic>
+
+/**
+ * Holds the current version of the Lua script of an ECU. A request loads the
+ * current version once and keeps it until its response is sent, while a
+ * reloaded script is published by swapping the pointer (read-copy-update).
+ * The old version is freed, as soon as the last request using it completed.
+ */
+class ScriptSlot
+{
+public:
+    ScriptSlot() = delete;
+    explicit ScriptSlot(std::shared_ptr<EcuLuaScript> pScript) noexcept;
+    ScriptSlot(const ScriptSlot& orig) = delete;
+    ScriptSlot& operator =(const ScriptSlot& orig) = delete;
+    ScriptSlot(ScriptSlot&& orig) = delete;
+    ScriptSlot& operator =(ScriptSlot&& orig) = delete;
+    virtual ~ScriptSlot() = default;
+
+    static std::shared_ptr<ScriptSlot> borrow(EcuLuaScript* pScript);
+
+    std::shared_ptr<EcuLuaScript> load() const noexcept;
+    std::shared_ptr<EcuLuaScript> publish(std::shared_ptr<EcuLuaScript> pScript) noexcept;
+    unsigned getVersion() const noexcept { return version_; };
+    bool hasRawTesterPresent() const noexcept { return hasRawTesterPresent_; };
+
+private:
+    std::shared_ptr<EcuLuaScript> pScript_;
+    std::atomic<unsigned> version_{0};
+    std::atomic<bool> hasRawTesterPresent_{false}; ///< of the current script, read without loading it
+};
+
+#endif /* SCRIPT_SLOT_H */
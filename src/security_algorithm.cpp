@@ -0,0 +1,137 @@
+/**
+ * @file security_algorithm.cpp
+ *
+ * This file contains the built-in seed/key algorithms of `SecurityAccess` and
+ * the loader for algorithms compiled into shared objects.
+ */
+
+#include "security_algorithm.h"
+#include "utilities.h"
+#include <dlfcn.h>
+#include <iostream>
+
+using namespace std;
+
+using ComputeKeyFunction = int (*)(uint8_t level,
+                                   const uint8_t* seed, size_t seedLength,
+                                   uint8_t* key, size_t maxKeyLength,
+                                   uint32_t constant);
+
+/**
+ * Key = seed XOR constant (big endian, repeated for seeds longer than 4 bytes).
+ */
+class XorAlgorithm : public SecurityAlgorithm
+{
+public:
+    explicit XorAlgorithm(uint32_t constant) : constant_(constant) { };
+
+    vector<uint8_t> computeKey(uint8_t level, const vector<uint8_t>& seed) const override
+    {
+        vector<uint8_t> key(seed);
+        for (size_t i = 0; i < key.size(); ++i)
+        {
+            key[i] ^= uint8_t(constant_ >> ((3 - (i % 4)) * 8));
+        }
+        return key;
+    }
+
+private:
+    const uint32_t constant_;
+};
+
+/**
+ * Key = seed + constant + level, with the seed as big endian number (overflows
+ * are truncated to the seed length).
+ */
+class AddAlgorithm : public SecurityAlgorithm
+{
+public:
+    explicit AddAlgorithm(uint32_t constant) : constant_(constant) { };
+
+    vector<uint8_t> computeKey(uint8_t level, const vector<uint8_t>& seed) const override
+    {
+        vector<uint8_t> key(seed);
+        uint64_t carry = uint64_t(constant_) + level;
+        for (size_t i = key.size(); i > 0 && carry != 0; --i)
+        {
+            carry += key[i - 1];
+            key[i - 1] = uint8_t(carry);
+            carry >>= 8;
+        }
+        return key;
+    }
+
+private:
+    const uint32_t constant_;
+};
+
+/**
+ * Algorithm of a shared object which exports `SECURITY_PLUGIN_SYMBOL`.
+ */
+class PluginAlgorithm : public SecurityAlgorithm
+{
+public:
+    PluginAlgorithm(void* handle, ComputeKeyFunction function, uint32_t constant)
+    : handle_(handle), function_(function), constant_(constant) { };
+
+    virtual ~PluginAlgorithm()
+    {
+        dlclose(handle_);
+    }
+
+    vector<uint8_t> computeKey(uint8_t level, const vector<uint8_t>& seed) const override
+    {
+        vector<uint8_t> key(MAX_SECURITY_KEY_LENGTH);
+        const int len = function_(level, seed.data(), seed.size(), key.data(), key.size(), constant_);
+        key.resize((len > 0 && size_t(len) <= key.size()) ? size_t(len) : 0);
+        return key;
+    }
+
+private:
+    void* const handle_;
+    const ComputeKeyFunction function_;
+    const uint32_t constant_;
+};
+
+/**
+ * Creates a seed/key algorithm by its name. Names ending with `.so` are loaded
+ * as shared object, the built-in algorithms are:
+ *
+ * - "xor": key = seed XOR constant
+ * - "add": key = seed + constant + level
+ *
+ * @param name: the name of the algorithm or the path to the shared object
+ * @param constant: the secret parameter passed to the algorithm
+ * @return the algorithm or `nullptr` if the name is unknown or loading failed
+ */
+unique_ptr<SecurityAlgorithm> SecurityAlgorithm::create(const string& name, uint32_t constant)
+{
+    if (name == "xor")
+    {
+        return make_unique<XorAlgorithm>(constant);
+    }
+    if (name == "add")
+    {
+        return make_unique<AddAlgorithm>(constant);
+    }
+    if (!utils::endsWith(name, ".so"))
+    {
+        cerr << __func__ << "() unknown seed/key algorithm: " << name << '\n';
+        return nullptr;
+    }
+
+    void* handle = dlopen(name.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr)
+    {
+        cerr << __func__ << "() dlopen: " << dlerror() << '\n';
+        return nullptr;
+    }
+    auto function = reinterpret_cast<ComputeKeyFunction> (dlsym(handle, SECURITY_PLUGIN_SYMBOL));
+    if (function == nullptr)
+    {
+        cerr << __func__ << "() " << name << " does not export " << SECURITY_PLUGIN_SYMBOL << '\n';
+        dlclose(handle);
+        return nullptr;
+    }
+    return make_unique<PluginAlgorithm>(handle, function, constant);
+}
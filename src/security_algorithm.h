@@ -0,0 +1,55 @@
+/**
+ * @file security_algorithm.h
+ *
+ */
+
+#ifndef SECURITY_ALGORITHM_H
+#define SECURITY_ALGORITHM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+
+/**
+ * Name of the function a seed/key plugin (shared object) has to export:
+ *
+ *     extern "C" int computeSecurityKey(uint8_t level,
+ *                                       const uint8_t* seed, size_t seedLength,
+ *                                       uint8_t* key, size_t maxKeyLength,
+ *                                       uint32_t constant);
+ *
+ * The function writes the key for the requested seed and returns its length
+ * in bytes or a negative value on error.
+ */
+constexpr char SECURITY_PLUGIN_SYMBOL[] = "computeSecurityKey";
+
+/// Max. length of a key computed by a plugin.
+constexpr std::size_t MAX_SECURITY_KEY_LENGTH = 64;
+
+/**
+ * Interface of the seed/key algorithms of `SecurityAccess`.
+ */
+class SecurityAlgorithm
+{
+public:
+    SecurityAlgorithm() = default;
+    SecurityAlgorithm(const SecurityAlgorithm& orig) = delete;
+    SecurityAlgorithm& operator =(const SecurityAlgorithm& orig) = delete;
+    virtual ~SecurityAlgorithm() = default;
+
+    /**
+     * Computes the expected key of a seed.
+     *
+     * @param level: the security level of the seed request (odd number)
+     * @param seed: the seed sent to the tester
+     * @return the key or an empty vector on error
+     */
+    virtual std::vector<std::uint8_t> computeKey(std::uint8_t level,
+                                                 const std::vector<std::uint8_t>& seed) const = 0;
+
+    static std::unique_ptr<SecurityAlgorithm> create(const std::string& name, std::uint32_t constant);
+};
+
+#endif /* SECURITY_ALGORITHM_H */
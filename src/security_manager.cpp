@@ -0,0 +1,161 @@
+/**
+ * @file security_manager.cpp
+ *
+ * This file contains the native implementation of the UDS service
+ * `SecurityAccess` (0x27).
+ */
+
+#include "security_manager.h"
+#include "utilities.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+/**
+ * Constructor.
+ *
+ * @param pAlgorithm: the seed/key algorithm
+ * @param seedLength: the length of the seeds in bytes
+ * @param maxAttempts: the number of invalid keys which activate the delay
+ * @param delay: the time until seeds are sent again after too many attempts
+ */
+SecurityManager::SecurityManager(unique_ptr<SecurityAlgorithm> pAlgorithm,
+                                 size_t seedLength,
+                                 unsigned int maxAttempts,
+                                 chrono::milliseconds delay)
+: pAlgorithm_(move(pAlgorithm))
+, seedLength_(max(seedLength, size_t(1)))
+, maxAttempts_(maxAttempts)
+, delay_(delay)
+{
+    assert(pAlgorithm_ != nullptr);
+}
+
+/**
+ * Destructor. Cancels a running delay timer.
+ */
+SecurityManager::~SecurityManager()
+{
+    if (delayTimer_ != 0)
+    {
+        TimerService::instance().cancel(delayTimer_);
+    }
+}
+
+/**
+ * Handles `requestSeed`. If the level is already unlocked, the seed consists of
+ * zero bytes.
+ *
+ * @param level: the requested security level (odd number)
+ * @param seed: the seed to send
+ * @return `SecurityResult::OK` on success, otherwise the reason of rejection
+ */
+SecurityResult SecurityManager::requestSeed(uint8_t level, vector<uint8_t>& seed)
+{
+    if (level % 2 == 0 || level > 0x41)
+    {
+        return SecurityResult::INVALID_LEVEL;
+    }
+    {
+        const lock_guard<mutex> lock(pDelay_->mutex);
+        if (pDelay_->isActive)
+        {
+            return SecurityResult::DELAY_NOT_EXPIRED;
+        }
+    }
+
+    const lock_guard<mutex> lock(mutex_);
+    if (unlockedLevel_ == level)
+    {
+        seed.assign(seedLength_, 0x00);
+        return SecurityResult::OK;
+    }
+
+    seed_.resize(seedLength_);
+    for (size_t i = 0; i < seed_.size(); i += sizeof(uint64_t))
+    {
+        const uint64_t rnd = utils::fastRandom();
+        for (size_t j = 0; j < sizeof(rnd) && i + j < seed_.size(); ++j)
+        {
+            seed_[i + j] = uint8_t(rnd >> (j * 8));
+        }
+    }
+    // an all zero seed would signal an unlocked level
+    if (all_of(seed_.cbegin(), seed_.cend(), [](uint8_t b) { return b == 0x00; }))
+    {
+        seed_.back() = 0x01;
+    }
+    seedLevel_ = level;
+    seed = seed_;
+    return SecurityResult::OK;
+}
+
+/**
+ * Handles `sendKey`. The key has to match the latest seed of the level below.
+ *
+ * @param level: the security level of the key (even number)
+ * @param key: pointer to the received key
+ * @param len: the length of the key in bytes
+ * @return `SecurityResult::OK` if the level is unlocked, otherwise the reason
+ * of rejection
+ */
+SecurityResult SecurityManager::sendKey(uint8_t level, const uint8_t* key, size_t len)
+{
+    if (level % 2 != 0 || level > 0x42)
+    {
+        return SecurityResult::INVALID_LEVEL;
+    }
+
+    const lock_guard<mutex> lock(mutex_);
+    if (seedLevel_ == 0x00 || seedLevel_ != level - 1)
+    {
+        return SecurityResult::SEQUENCE_ERROR;
+    }
+    const uint8_t seedLevel = seedLevel_;
+    seedLevel_ = 0x00; // every seed allows a single attempt
+
+    const vector<uint8_t> expected = pAlgorithm_->computeKey(seedLevel, seed_);
+    const lock_guard<mutex> delayLock(pDelay_->mutex);
+    if (!expected.empty() && expected.size() == len && equal(expected.cbegin(), expected.cend(), key))
+    {
+        unlockedLevel_ = seedLevel;
+        pDelay_->numFailedAttempts = 0;
+        return SecurityResult::OK;
+    }
+
+    if (++pDelay_->numFailedAttempts < maxAttempts_)
+    {
+        return SecurityResult::INVALID_KEY;
+    }
+
+    pDelay_->isActive = true;
+    shared_ptr<Delay> pDelay = pDelay_;
+    delayTimer_ = TimerService::instance().schedule(delay_, [pDelay]()
+    {
+        const lock_guard<mutex> lock(pDelay->mutex);
+        pDelay->isActive = false;
+        pDelay->numFailedAttempts = 0;
+    });
+    return SecurityResult::EXCEEDED_ATTEMPTS;
+}
+
+/**
+ * Returns the unlocked security level (the level of the seed request) or 0 if
+ * the ECU is locked.
+ */
+uint8_t SecurityManager::getUnlockedLevel() const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return unlockedLevel_;
+}
+
+/**
+ * Locks the ECU again (e.g. on a session change). Running delays are kept.
+ */
+void SecurityManager::lock()
+{
+    const lock_guard<mutex> lock(mutex_);
+    unlockedLevel_ = 0x00;
+    seedLevel_ = 0x00;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file security_manager.h
+ *
+ */
+
+#ifndef SECURITY_MANAGER_H
+#define SECURITY_MANAGER_H
+
+#include "security_algorithm.h"
+#include "timer_service.h"
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+enum class SecurityResult : std::uint8_t
+{
+    OK,
+    INVALID_LEVEL,
+    SEQUENCE_ERROR,
+    INVALID_KEY,
+    EXCEEDED_ATTEMPTS,
+    DELAY_NOT_EXPIRED
+};
+
+/**
+ * Native state machine of `SecurityAccess` (0x27). Seeds come from a fast
+ * per-thread PRNG and keys are computed by a compiled `SecurityAlgorithm`, so
+ * an unlock never calls into Lua. After `maxAttempts` invalid keys, further
+ * seed requests are rejected until a delay timer of the timer service
+ * expires.
+ */
+class SecurityManager
+{
+public:
+    SecurityManager() = delete;
+    SecurityManager(std::unique_ptr<SecurityAlgorithm> pAlgorithm,
+                    std::size_t seedLength,
+                    unsigned int maxAttempts,
+                    std::chrono::milliseconds delay);
+    SecurityManager(const SecurityManager& orig) = delete;
+    SecurityManager& operator =(const SecurityManager& orig) = delete;
+    SecurityManager(SecurityManager&& orig) = delete;
+    SecurityManager& operator =(SecurityManager&& orig) = delete;
+    virtual ~SecurityManager();
+
+    SecurityResult requestSeed(std::uint8_t level, std::vector<std::uint8_t>& seed);
+    SecurityResult sendKey(std::uint8_t level, const std::uint8_t* key, std::size_t len);
+    std::uint8_t getUnlockedLevel() const;
+    void lock();
+
+private:
+    /// Delay state, shared with the timer callback.
+    struct Delay
+    {
+        std::mutex mutex;
+        bool isActive = false;
+        unsigned int numFailedAttempts = 0;
+    };
+
+    const std::unique_ptr<SecurityAlgorithm> pAlgorithm_;
+    const std::size_t seedLength_;
+    const unsigned int maxAttempts_;
+    const std::chrono::milliseconds delay_;
+
+    mutable std::mutex mutex_;
+    std::uint8_t unlockedLevel_ = 0x00;
+    std::uint8_t seedLevel_ = 0x00; ///< level of the pending seed, 0 if none
+    std::vector<std::uint8_t> seed_;
+    std::shared_ptr<Delay> pDelay_ = std::make_shared<Delay>();
+    TimerService::TimerId delayTimer_ = 0;
+};
+
+#endif /* SECURITY_MANAGER_H */
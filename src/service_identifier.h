@@ -72,6 +72,14 @@ constexpr uint8_t CLEAR_DIAGNOSTIC_INFORMATION_RES = 0x54;
 constexpr uint8_t READ_DTC_INFORMATION_REQ = 0x19;
 constexpr uint8_t READ_DTC_INFORMATION_RES = 0x59;
 
+// Sub-functions of ReadDTCInformation
+constexpr uint8_t REPORT_NUMBER_OF_DTC_BY_STATUS_MASK = 0x01;
+constexpr uint8_t REPORT_DTC_BY_STATUS_MASK = 0x02;
+constexpr uint8_t REPORT_DTC_SNAPSHOT_RECORD_BY_DTC_NUMBER = 0x04;
+constexpr uint8_t REPORT_DTC_EXT_DATA_RECORD_BY_DTC_NUMBER = 0x06;
+constexpr uint8_t REPORT_SUPPORTED_DTC = 0x0A;
+constexpr uint8_t DTC_FORMAT_ISO_14229_1 = 0x01;
+
 // Function Group: Input / Output Control
 constexpr uint8_t INPUT_OUTPUT_CONTROL_BY_IDENTIFIER_REQ = 0x2f;
 constexpr uint8_t INPUT_OUTPUT_CONTROL_BY_IDENTIFIER_RES = 0x6f;
@@ -80,6 +88,11 @@ constexpr uint8_t INPUT_OUTPUT_CONTROL_BY_IDENTIFIER_RES = 0x6f;
 constexpr uint8_t ROUTINE_CONTROL_REQ = 0x31;
 constexpr uint8_t ROUTINE_CONTROL_RES = 0x71;
 
+// Sub-functions of RoutineControl
+constexpr uint8_t START_ROUTINE = 0x01;
+constexpr uint8_t STOP_ROUTINE = 0x02;
+constexpr uint8_t REQUEST_ROUTINE_RESULTS = 0x03;
+
 // Function Group: Upload / Download
 constexpr uint8_t REQUEST_DOWNLOAD_REQ = 0x34;
 constexpr uint8_t REQUEST_DOWNLOAD_RES = 0x74;
@@ -103,7 +116,53 @@ constexpr uint8_t SUBFUNCTION_NOT_SUPPORTED = 0x12;
 constexpr uint8_t INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT = 0x13; ///< IMLOIF
 constexpr uint8_t RESPONSE_TOO_LONG = 0x14; ///< RTL
 constexpr uint8_t CONDITIONS_NOT_CORRECT = 0x22; ///< CNC
+constexpr uint8_t REQUEST_SEQUENCE_ERROR = 0x24; ///< RSE
 constexpr uint8_t REQUEST_OUT_OF_RANGE = 0x31; ///< ROOR
 constexpr uint8_t SECURITY_ACCESS_DENIED = 0x33; ///< SAD
+constexpr uint8_t INVALID_KEY = 0x35; ///< IK
+constexpr uint8_t EXCEEDED_NUMBER_OF_ATTEMPTS = 0x36; ///< ENOA
+constexpr uint8_t REQUIRED_TIME_DELAY_NOT_EXPIRED = 0x37; ///< RTDNE
+constexpr uint8_t GENERAL_PROGRAMMING_FAILURE = 0x72; ///< GPF
+constexpr uint8_t REQUEST_CORRECTLY_RECEIVED_RESPONSE_PENDING = 0x78; ///< RCRRP
+constexpr uint8_t SUBFUNCTION_NOT_SUPPORTED_IN_ACTIVE_SESSION = 0x7E; ///< SFNSIAS
+constexpr uint8_t SERVICE_NOT_SUPPORTED_IN_ACTIVE_SESSION = 0x7F; ///< SNSIAS
+
+// Sub-function byte
+constexpr uint8_t SUPPRESS_POS_RSP_MSG_INDICATION_BIT = 0x80; ///< SPRMIB
+constexpr uint8_t TESTER_PRESENT_ZERO_SUB_FUNCTION = 0x00;
+constexpr uint8_t HARD_RESET = 0x01;
+constexpr uint8_t KEY_OFF_ON_RESET = 0x02;
+constexpr uint8_t SOFT_RESET = 0x03;
+constexpr uint8_t DTC_SETTING_ON = 0x01;
+constexpr uint8_t DTC_SETTING_OFF = 0x02;
+
+/**
+ * Checks if the sub-function byte of the service may carry the
+ * suppressPosRspMsgIndicationBit (ISO 14229-1). `ReadDTCInformation` has a
+ * sub-function, but always requires a response.
+ *
+ * @param sid: the service identifier of the request
+ * @return true if the SPRMIB is defined for the service
+ */
+constexpr bool hasSuppressPosRspBit(uint8_t sid) noexcept
+{
+    switch (sid)
+    {
+        case DIAGNOSTIC_SESSION_CONTROL_REQ:
+        case ECU_RESET_REQ:
+        case SECURITY_ACCESS_REQ:
+        case COMMUNICATION_CONTROL_REQ:
+        case TESTER_PRESENT_REQ:
+        case ACCESS_TIMING_PARAMETERS_REQ:
+        case CONTROL_DTC_SETTINGS_REQ:
+        case RESPONSE_ON_EVENT_REQ:
+        case LINK_CONTROL_REQ:
+        case DYNAMICALLY_DEFINE_DATA_IDENTIFIER_REQ:
+        case ROUTINE_CONTROL_REQ:
+            return true;
+        default:
+            return false;
+    }
+}
 
 #endif /* SEVICE_IDENTIFIER_H */
@@ -48,6 +48,17 @@ void SessionController::setCurrentUdsSession(const UdsSession ses) noexcept
     }
 }
 
+/**
+ * Sets a function, which is called after the session expired and the default
+ * session is active again. Set this before the first session is started.
+ *
+ * @param handler: the function to call from the timer thread
+ */
+void SessionController::setTimeoutHandler(function<void()> handler)
+{
+    timeoutHandler_ = move(handler);
+}
+
 /**
  * Overridden function which is called after the timer expired. Since the
  * `session_`-member is atomic, we don't need to use a mutex.
@@ -68,4 +79,8 @@ void SessionController::wakeup()
     }
 
     session_ = UdsSession::DEFAULT;
+    if (timeoutHandler_)
+    {
+        timeoutHandler_();
+    }
 }
@@ -9,6 +9,7 @@
 #include "ecu_timer.h"
 #include <atomic>
 #include <cstdint>
+#include <functional>
 
 enum UdsSession : std::uint8_t
 {
@@ -31,9 +32,11 @@ public:
     void startSession();
     UdsSession getCurrentUdsSession() const noexcept;
     void setCurrentUdsSession(const UdsSession ses) noexcept;
+    void setTimeoutHandler(std::function<void()> handler);
 
 private:
     std::atomic<UdsSession> session_{UdsSession::DEFAULT};
+    std::function<void()> timeoutHandler_;
     virtual void wakeup() override;
 };
 
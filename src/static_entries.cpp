@@ -0,0 +1,89 @@
+/**
+ * @file static_entries.cpp
+ *
+ * This file contains the copy of the static entries of the Lua tables, which
+ * are served without locking the Lua state.
+ */
+
+#include "static_entries.h"
+
+using namespace std;
+
+/**
+ * Sets the compiled static entries of a `ReadDataByIdentifier`-table.
+ *
+ * @param session: the session table (e.g. "Programming"), "" for the top level table
+ * @param pData: the data by identifier (binary, if the entry is `Bytes`)
+ */
+void StaticEntries::setDataByIdentifier(const string& session, shared_ptr<const DataTable> pData)
+{
+    dids_[session] = move(pData);
+}
+
+/**
+ * Looks up the entry of a request like the `Raw`-table lookup in Lua: the
+ * literal request first, then the wildcard entries from the shortest prefix
+ * (e.g. "31 *", "31 01 *").
+ *
+ * @param request: the literal request string (e.g. "31 01 FF 00")
+ * @return the entry or nullptr if no entry matches
+ */
+const StaticEntries::RawEntry* StaticEntries::findRaw(const string& request) const
+{
+    if (pRaw_ == nullptr)
+    {
+        return nullptr;
+    }
+    auto it = pRaw_->find(request);
+    if (it != pRaw_->end())
+    {
+        return &it->second;
+    }
+
+    string key;
+    key.reserve(request.length() + 2);
+    for (size_t counter = 2; counter <= request.length(); counter += 3)
+    {
+        key.assign(request, 0, counter).append(" *");
+        it = pRaw_->find(key);
+        if (it != pRaw_->end())
+        {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Looks up a static entry of a `ReadDataByIdentifier`-table.
+ *
+ * @param session: the session table (e.g. "Programming"), "" for the top level table
+ * @param identifier: the identifier (e.g. "F1 90")
+ * @return the data or nullptr if the entry is not static
+ */
+const string* StaticEntries::findDataByIdentifier(string_view session, const string& identifier) const
+{
+    const auto dids = dids_.find(session);
+    if (dids == dids_.end() || dids->second == nullptr)
+    {
+        return nullptr;
+    }
+    const auto it = dids->second->find(identifier);
+    return (it != dids->second->end()) ? &it->second : nullptr;
+}
+
+/**
+ * Looks up a static entry of the `PGNs`-table.
+ *
+ * @param pgn: the PGN (e.g. "FEF1")
+ * @return the payload and cycle time or nullptr if the entry is not static
+ */
+const J1939PGNData* StaticEntries::findPgn(const string& pgn) const
+{
+    if (pPgns_ == nullptr)
+    {
+        return nullptr;
+    }
+    const auto it = pPgns_->find(pgn);
+    return (it != pPgns_->end()) ? &it->second : nullptr;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file static_entries.h
+ *
+ */
+
+#ifndef STATIC_ENTRIES_H
+#define STATIC_ENTRIES_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+struct J1939PGNData
+{
+    unsigned int cycleTime;
+    std::string payload;
+};
+
+/**
+ * Copy of the static entries of the Lua tables of an ECU: the literal
+ * responses of the `Raw`-table, the data of the `ReadDataByIdentifier`-tables
+ * and the PGN payloads. The copy is compiled by `StaticTables` and never
+ * changed afterwards (a changed table gives a new copy), so any number of
+ * threads can read it without locking the Lua state. The compiled tables are
+ * shared by all ECUs using the same Lua table (e.g. the instances of a
+ * fleet). Function entries are evaluated in Lua, the `Raw`-table only marks
+ * them, since they take part in the wildcard matching.
+ */
+class StaticEntries
+{
+public:
+    /// Entry of the `Raw`-table.
+    struct RawEntry
+    {
+        bool isStatic = false; ///< false, if the entry has to be evaluated in Lua
+        std::vector<std::uint8_t> response;
+    };
+    using RawTable = std::unordered_map<std::string, RawEntry>;
+    using DataTable = std::unordered_map<std::string, std::string>;
+    using PgnTable = std::unordered_map<std::string, J1939PGNData>;
+
+    StaticEntries() = default;
+    StaticEntries(const StaticEntries& orig) = delete;
+    StaticEntries& operator =(const StaticEntries& orig) = delete;
+    StaticEntries(StaticEntries&& orig) = default;
+    StaticEntries& operator =(StaticEntries&& orig) = default;
+    virtual ~StaticEntries() = default;
+
+    void setRaw(std::shared_ptr<const RawTable> pRaw) noexcept { pRaw_ = std::move(pRaw); };
+    void setDataByIdentifier(const std::string& session, std::shared_ptr<const DataTable> pData);
+    void setPgns(std::shared_ptr<const PgnTable> pPgns) noexcept { pPgns_ = std::move(pPgns); };
+
+    const RawEntry* findRaw(const std::string& request) const;
+    const std::string* findDataByIdentifier(std::string_view session, const std::string& identifier) const;
+    const J1939PGNData* findPgn(const std::string& pgn) const;
+
+private:
+    std::shared_ptr<const RawTable> pRaw_;
+    std::map<std::string, std::shared_ptr<const DataTable>, std::less<>> dids_;
+    std::shared_ptr<const PgnTable> pPgns_;
+};
+
+#endif /* STATIC_ENTRIES_H */
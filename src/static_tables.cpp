@@ -0,0 +1,788 @@
+/**
+ * @file static_tables.cpp
+ *
+ * This file contains the write barrier of the Lua tables, which the static
+ * entries are compiled from, and their compilation.
+ */
+
+#include "static_tables.h"
+#include "ecu_lua_script.h"
+#include "lua_bytes.h"
+#include "metrics.h"
+#include <iostream>
+
+#include "selene/compat.h"
+
+using namespace std;
+
+/**
+ * Pushes the field of the table at the given index of the stack, or nil if
+ * the value is not a table.
+ */
+static void pushField(lua_State* L, int table, const char* field)
+{
+    if (lua_istable(L, table))
+    {
+        lua_getfield(L, table, field);
+    }
+    else
+    {
+        lua_pushnil(L);
+    }
+}
+
+/**
+ * `next()` of the storage table, the iterator returned by `__pairs`.
+ */
+static int storageNext(lua_State* L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    lua_settop(L, 2);
+    if (lua_next(L, 1) != 0)
+    {
+        return 2;
+    }
+    lua_pushnil(L);
+    return 1;
+}
+
+/**
+ * `__pairs` of a table behind the barrier: iterates the storage table, which
+ * is the upvalue.
+ */
+static int storagePairs(lua_State* L)
+{
+    lua_pushcfunction(L, storageNext);
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_pushnil(L);
+    return 3;
+}
+
+/**
+ * Iterator of the storage table returned by `__ipairs`.
+ */
+static int storageNextIndex(lua_State* L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    const lua_Integer index = luaL_checkinteger(L, 2) + 1;
+    lua_pushinteger(L, index);
+    lua_rawgeti(L, 1, index);
+    return lua_isnil(L, -1) ? 1 : 2;
+}
+
+/**
+ * `__ipairs` of a table behind the barrier: iterates the array part of the
+ * storage table, which is the upvalue.
+ */
+static int storageIpairs(lua_State* L)
+{
+    lua_pushcfunction(L, storageNextIndex);
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_pushinteger(L, 0);
+    return 3;
+}
+
+#if LUA_VERSION_NUM >= 502
+/**
+ * `__len` of a table behind the barrier: the length of the storage table,
+ * which is the upvalue.
+ */
+static int storageLen(lua_State* L)
+{
+    lua_pushinteger(L, lua_Integer(lua_rawlen(L, lua_upvalueindex(1))));
+    return 1;
+}
+#else
+/**
+ * `pairs()` and `ipairs()` honouring the metamethods `__pairs` and `__ipairs`
+ * like Lua 5.2, for LuaJIT built without `LUAJIT_ENABLE_LUA52COMPAT`.
+ * Upvalues: the original function and the name of the metamethod.
+ */
+static int iterateCompat(lua_State* L)
+{
+    luaL_checkany(L, 1);
+    lua_settop(L, 1);
+    if (luaL_getmetafield(L, 1, lua_tostring(L, lua_upvalueindex(2))))
+    {
+        lua_insert(L, 1);
+    }
+    else
+    {
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_insert(L, 1);
+    }
+    lua_call(L, 1, 3);
+    return 3;
+}
+
+/**
+ * Replaces a global iterator function by `iterateCompat()`.
+ */
+static void replaceIterator(lua_State* L, const char* function, const char* metamethod)
+{
+    lua_getglobal(L, function);
+    lua_pushstring(L, metamethod);
+    lua_pushcclosure(L, iterateCompat, 2);
+    lua_setglobal(L, function);
+}
+#endif
+
+/**
+ * Moves the entries of a table into the storage table of its barrier.
+ * Clearing existing fields is allowed while traversing.
+ */
+static void moveEntries(lua_State* L, int table, int storage)
+{
+    lua_pushnil(L);
+    while (lua_next(L, table) != 0)
+    {
+        lua_pushvalue(L, -2);
+        lua_insert(L, -2);
+        lua_rawset(L, storage);
+        lua_pushvalue(L, -1);
+        lua_pushnil(L);
+        lua_rawset(L, table);
+    }
+}
+
+/**
+ * Checks, whether the table at the given index of the stack has entries of
+ * its own. A table behind the barrier only gets them by `rawset()`.
+ */
+static bool hasEntries(lua_State* L, int index)
+{
+    index = lua_absindex(L, index);
+    lua_pushnil(L);
+    if (lua_next(L, index) != 0)
+    {
+        lua_pop(L, 2);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Makes `pairs()` and `ipairs()` iterate the tables behind the barrier under
+ * LuaJIT, whose iterators do not honour `__pairs` and `__ipairs`. Nothing is
+ * done for Lua 5.2 and later. Call this before loading the script.
+ *
+ * @param L: the Lua state
+ */
+void StaticTables::registerIterators(lua_State* L)
+{
+#if LUA_VERSION_NUM < 502
+    replaceIterator(L, "pairs", "__pairs");
+    replaceIterator(L, "ipairs", "__ipairs");
+#else
+    (void) L;
+#endif
+}
+
+/**
+ * Registers the ECU table of an instance, whose tables are compiled.
+ *
+ * @param index: the fleet index (0 for an ECU without fleet)
+ * @param ecuIdent: the name of the global ECU table (e.g. "PCM#1")
+ */
+void StaticTables::addInstance(unsigned int index, const string& ecuIdent)
+{
+    if (index >= ecuIdents_.size())
+    {
+        ecuIdents_.resize(index + 1);
+    }
+    ecuIdents_[index] = ecuIdent;
+    invalidate();
+}
+
+/**
+ * Returns the static entries of an instance, if they are up to date with the
+ * Lua state, so they can be read without locking it. A written table is only
+ * compiled when the Lua state is unlocked, until then the caller has to fall
+ * back to Lua.
+ *
+ * @param index: the fleet index
+ * @return the static entries or nullptr if they are outdated
+ */
+shared_ptr<const StaticEntries> StaticTables::get(unsigned int index) const noexcept
+{
+    const auto pEntries = atomic_load(&pEntries_);
+    return (pEntries != nullptr && index < pEntries->size()) ? (*pEntries)[index] : nullptr;
+}
+
+/**
+ * Withdraws the static entries of all instances, e.g. before the tables are
+ * replaced by a snapshot. They are compiled again by the next `refresh()`.
+ */
+void StaticTables::invalidate() noexcept
+{
+    isDirty_ = true;
+    atomic_store(&pEntries_, shared_ptr<const Entries>());
+}
+
+/**
+ * Compiles the static entries again, if a table has been written or replaced.
+ * Called before the Lua state is unlocked.
+ *
+ * @param L: the Lua state
+ */
+void StaticTables::refresh(lua_State* L) noexcept
+{
+    const int top = lua_gettop(L);
+    try
+    {
+        if (isOutdated(L))
+        {
+            compile(L);
+        }
+    }
+    catch (const exception& e)
+    {
+        // the entries stay withdrawn, the reads fall back to Lua
+        cerr << __func__ << "() " << e.what() << '\n';
+    }
+    lua_settop(L, top);
+}
+
+/**
+ * Pushes the table holding the entries of the table at the given index: the
+ * storage table, if the table is behind the barrier, or the table itself.
+ * Code traversing the entries with `lua_next()` has to use it.
+ *
+ * @param L: the Lua state
+ * @param index: stack index of the table
+ */
+void StaticTables::pushStorage(lua_State* L, int index)
+{
+    index = lua_absindex(L, index);
+    if (lua_getmetatable(L, index))
+    {
+        if (isBarrier(L, -1))
+        {
+            lua_pushliteral(L, "__index");
+            lua_rawget(L, -2);
+            lua_remove(L, -2);
+            return;
+        }
+        lua_pop(L, 1);
+    }
+    lua_pushvalue(L, index);
+}
+
+/**
+ * Checks, whether the compiled entries are outdated: a table has been written
+ * (marked by the barrier or holding entries written by `rawset()`), a watched
+ * table has been replaced (its identity differs) or a watched `Bytes` value has been changed in place (which of the
+ * compiled tables is affected is only checked by the compilation). The cost
+ * does not depend on the size of the tables.
+ *
+ * @param L: the Lua state
+ * @return true if the entries have to be compiled
+ */
+bool StaticTables::isOutdated(lua_State* L)
+{
+    if (isDirty_)
+    {
+        return true;
+    }
+
+    const int top = lua_gettop(L);
+    for (size_t index = 0; index < ecuIdents_.size(); ++index)
+    {
+        if (ecuIdents_[index].empty())
+        {
+            continue;
+        }
+        lua_getglobal(L, ecuIdents_[index].c_str());
+        const int ecu = lua_gettop(L);
+        for (int watched = RAW; watched < NUM_WATCHED_TABLES; ++watched)
+        {
+            pushWatchedTable(L, ecu, WatchedTable(watched));
+            const bool isSame = identityOf(L, -1) == identities_[index][watched]
+                             && !(ownsBarrier(L, -1) && hasEntries(L, -1));
+            lua_settop(L, ecu);
+            if (!isSame)
+            {
+                lua_settop(L, top);
+                return true;
+            }
+        }
+        lua_settop(L, top);
+    }
+
+    return LuaBytes::watchedChanges() != watchedChanges_;
+}
+
+/**
+ * Compiles the static entries of all instances. The watched tables are put
+ * behind the barrier first, tables which have not been written since the
+ * last compilation are taken over from it. A table used by several instances
+ * (e.g. a table of the fleet template) is compiled once and shared.
+ *
+ * @param L: the Lua state
+ */
+void StaticTables::compile(lua_State* L)
+{
+    static metrics::Counter& numCompilations = metrics::counter("lua.static_compilations");
+
+    const int top = lua_gettop(L);
+    lua_newtable(L);
+    const int anchor = lua_gettop(L);
+
+    // read before, so `Bytes` of other Lua states changed meanwhile are checked again
+    const uint64_t watchedChanges = LuaBytes::watchedChanges();
+    Compilation next;
+    const auto reuse = [this, &next](const auto& previous, const void* pTable)
+    {
+        typename decay_t<decltype(previous)>::mapped_type pCompiled;
+        const auto it = previous.find(pTable);
+        if (it != previous.end() && !isModified(compilation_, pTable))
+        {
+            pCompiled = it->second;
+            const auto bytes = compilation_.bytes.find(pTable);
+            if (bytes != compilation_.bytes.end())
+            {
+                next.bytes[pTable] = bytes->second;
+            }
+            const auto entryTables = compilation_.entryTables.find(pTable);
+            if (entryTables != compilation_.entryTables.end())
+            {
+                next.entryTables[pTable] = entryTables->second;
+            }
+        }
+        return pCompiled;
+    };
+
+    auto pEntries = make_shared<Entries>(ecuIdents_.size());
+    vector<Identities> identities(ecuIdents_.size());
+    for (size_t index = 0; index < ecuIdents_.size(); ++index)
+    {
+        if (ecuIdents_[index].empty())
+        {
+            continue;
+        }
+        lua_getglobal(L, ecuIdents_[index].c_str());
+        const int ecu = lua_gettop(L);
+        auto pInstance = make_shared<StaticEntries>();
+        for (int watched = RAW; watched < NUM_WATCHED_TABLES; ++watched)
+        {
+            pushWatchedTable(L, ecu, WatchedTable(watched));
+            const int table = lua_gettop(L);
+            // entries written by `rawset()` passed the barrier unnoticed
+            const bool hadBarrier = ownsBarrier(L, table) && !hasEntries(L, table);
+            if (lua_istable(L, table) && makeBarrier(L, table))
+            {
+                const void* pTable = lua_topointer(L, table);
+                lua_pushvalue(L, table);
+                lua_pushboolean(L, 1);
+                lua_rawset(L, anchor);
+
+                if (watched == RAW)
+                {
+                    auto& pRaw = next.rawTables[pTable];
+                    if (pRaw == nullptr && hadBarrier)
+                    {
+                        pRaw = reuse(compilation_.rawTables, pTable);
+                    }
+                    if (pRaw == nullptr)
+                    {
+                        pRaw = compileRaw(L, table, next.bytes[pTable]);
+                    }
+                    pInstance->setRaw(pRaw);
+                }
+                else if (watched == PGNS)
+                {
+                    auto& pPgns = next.pgnTables[pTable];
+                    if (pPgns == nullptr && hadBarrier)
+                    {
+                        pPgns = reuse(compilation_.pgnTables, pTable);
+                    }
+                    if (pPgns == nullptr)
+                    {
+                        pPgns = compilePgns(L, table, next.entryTables[pTable]);
+                    }
+                    pInstance->setPgns(pPgns);
+                }
+                else
+                {
+                    auto& pData = next.dataTables[pTable];
+                    if (pData == nullptr && hadBarrier)
+                    {
+                        pData = reuse(compilation_.dataTables, pTable);
+                    }
+                    if (pData == nullptr)
+                    {
+                        pData = compileData(L, table, next.bytes[pTable]);
+                    }
+                    const char* session = (watched == PROGRAMMING_DIDS) ? PROGRAMMING_SESSION_TABLE
+                                        : (watched == EXTENDED_DIDS) ? EXTENDED_SESSION_TABLE : "";
+                    pInstance->setDataByIdentifier(session, pData);
+                }
+            }
+            identities[index][watched] = identityOf(L, table);
+            lua_settop(L, ecu);
+        }
+        (*pEntries)[index] = move(pInstance);
+        lua_settop(L, anchor);
+    }
+
+    if (isAnchored_)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, anchorRef_);
+    }
+    anchorRef_ = luaL_ref(L, LUA_REGISTRYINDEX);
+    isAnchored_ = true;
+    lua_settop(L, top);
+
+    compilation_ = move(next);
+    identities_ = move(identities);
+    dirtyTables_.clear();
+    isDirty_ = false;
+    watchedChanges_ = watchedChanges;
+    atomic_store(&pEntries_, shared_ptr<const Entries>(move(pEntries)));
+    numCompilations.increment();
+}
+
+/**
+ * Checks, whether a table of the given compilation has been modified since:
+ * the table itself or one of its entry tables (`PGNs`) has been written or
+ * one of its `Bytes` entries has been changed in place.
+ */
+bool StaticTables::isModified(const Compilation& compilation, const void* pTable) const
+{
+    if (dirtyTables_.count(pTable) != 0)
+    {
+        return true;
+    }
+    const auto bytes = compilation.bytes.find(pTable);
+    if (bytes != compilation.bytes.end())
+    {
+        for (const WatchedBytes& watched : bytes->second)
+        {
+            if (*watched.pVersion != watched.version)
+            {
+                return true;
+            }
+        }
+    }
+    const auto entryTables = compilation.entryTables.find(pTable);
+    if (entryTables != compilation.entryTables.end())
+    {
+        for (const void* pEntryTable : entryTables->second)
+        {
+            if (dirtyTables_.count(pEntryTable) != 0)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Marks a table behind the barrier as written and withdraws the compiled
+ * entries of all instances.
+ *
+ * @param pTable: the table
+ */
+void StaticTables::markDirty(const void* pTable) noexcept
+{
+    isDirty_ = true;
+    atomic_store(&pEntries_, shared_ptr<const Entries>());
+    try
+    {
+        dirtyTables_.insert(pTable);
+    }
+    catch (const bad_alloc&)
+    {
+        // the table cannot be marked, so nothing of the last compilation is reused
+        compilation_ = Compilation();
+    }
+}
+
+/**
+ * Puts the table at the given index behind the barrier: its entries are moved
+ * into a new storage table and the metatable reads from it (`__index`),
+ * writes into it and marks the table (`__newindex`), iterates it (`__pairs`,
+ * `__ipairs`) and gives its length (`__len`). Entries written into a table
+ * behind the barrier by `rawset()` are moved into the storage. A copy of a
+ * table behind the barrier (e.g. by a snapshot), which still shares the
+ * storage of the original, gets its own storage.
+ *
+ * @param L: the Lua state
+ * @param index: stack index of the table
+ * @return false if the table has a metatable of its own and cannot be watched
+ */
+bool StaticTables::makeBarrier(lua_State* L, int index)
+{
+    index = lua_absindex(L, index);
+    const int top = lua_gettop(L);
+    const void* pTable = lua_topointer(L, index);
+    if (ownsBarrier(L, index))
+    {
+        pushStorage(L, index);
+        moveEntries(L, index, lua_gettop(L));
+        lua_settop(L, top);
+        return true;
+    }
+
+    lua_newtable(L);
+    const int storage = lua_gettop(L);
+    if (lua_getmetatable(L, index))
+    {
+        if (!isBarrier(L, -1))
+        {
+            lua_settop(L, top);
+            return false;
+        }
+        lua_pushliteral(L, "__index");
+        lua_rawget(L, -2);
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0)
+        {
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, storage);
+        }
+        lua_settop(L, storage);
+    }
+
+    moveEntries(L, index, storage);
+
+    lua_createtable(L, 0, 5);
+    lua_pushvalue(L, storage);
+    lua_setfield(L, -2, "__index");
+    lua_pushlightuserdata(L, this);
+    lua_pushlightuserdata(L, const_cast<void*>(pTable));
+    lua_pushvalue(L, storage);
+    lua_pushcclosure(L, newIndex, 3);
+    lua_setfield(L, -2, "__newindex");
+    lua_pushvalue(L, storage);
+    lua_pushcclosure(L, storagePairs, 1);
+    lua_setfield(L, -2, "__pairs");
+    lua_pushvalue(L, storage);
+    lua_pushcclosure(L, storageIpairs, 1);
+    lua_setfield(L, -2, "__ipairs");
+#if LUA_VERSION_NUM >= 502
+    lua_pushvalue(L, storage);
+    lua_pushcclosure(L, storageLen, 1);
+    lua_setfield(L, -2, "__len");
+#endif
+    lua_setmetatable(L, index);
+    lua_settop(L, top);
+    return true;
+}
+
+/**
+ * Compiles the `Raw`-table at the given index of the stack: the literal
+ * responses (strings and `Bytes`), other entries (functions) are only marked.
+ */
+shared_ptr<const StaticEntries::RawTable> StaticTables::compileRaw(lua_State* L, int table, vector<WatchedBytes>& bytes)
+{
+    auto pRaw = make_shared<StaticEntries::RawTable>();
+    pushStorage(L, table);
+    const int storage = lua_gettop(L);
+    lua_pushnil(L);
+    while (lua_next(L, storage) != 0)
+    {
+        if (lua_type(L, -2) == LUA_TSTRING)
+        {
+            StaticEntries::RawEntry entry;
+            const vector<uint8_t>* pBytes = LuaBytes::get(L, -1);
+            if (pBytes != nullptr)
+            {
+                entry.isStatic = true;
+                entry.response = *pBytes;
+                const uint64_t* pVersion = LuaBytes::watch(L, -1);
+                bytes.push_back(WatchedBytes{pVersion, *pVersion});
+            }
+            else if (lua_isstring(L, -1))
+            {
+                size_t len;
+                const char* hex = lua_tolstring(L, -1, &len);
+                entry.isStatic = true;
+                entry.response = EcuLuaScript::literalHexStrToBytes(string_view(hex, len));
+            }
+            (*pRaw)[lua_tostring(L, -2)] = move(entry);
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    return pRaw;
+}
+
+/**
+ * Compiles the `ReadDataByIdentifier`-table at the given index of the stack:
+ * strings, numbers and `Bytes` (binary).
+ */
+shared_ptr<const StaticEntries::DataTable> StaticTables::compileData(lua_State* L, int table, vector<WatchedBytes>& bytes)
+{
+    auto pData = make_shared<StaticEntries::DataTable>();
+    pushStorage(L, table);
+    const int storage = lua_gettop(L);
+    lua_pushnil(L);
+    while (lua_next(L, storage) != 0)
+    {
+        if (lua_type(L, -2) == LUA_TSTRING)
+        {
+            const vector<uint8_t>* pBytes = LuaBytes::get(L, -1);
+            if (pBytes != nullptr)
+            {
+                (*pData)[lua_tostring(L, -2)].assign(pBytes->cbegin(), pBytes->cend());
+                const uint64_t* pVersion = LuaBytes::watch(L, -1);
+                bytes.push_back(WatchedBytes{pVersion, *pVersion});
+            }
+            else if (lua_isstring(L, -1))
+            {
+                size_t len;
+                const char* str = lua_tolstring(L, -1, &len);
+                (*pData)[lua_tostring(L, -2)].assign(str, len);
+            }
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    return pData;
+}
+
+/**
+ * Compiles the `PGNs`-table at the given index of the stack: the PGNs given by
+ * a string or by a table of a string `payload` and a number `cycleTime`. The
+ * entry tables are put behind the barrier as well.
+ */
+shared_ptr<const StaticEntries::PgnTable> StaticTables::compilePgns(lua_State* L, int table, vector<const void*>& entryTables)
+{
+    auto pPgns = make_shared<StaticEntries::PgnTable>();
+    pushStorage(L, table);
+    const int storage = lua_gettop(L);
+    lua_pushnil(L);
+    while (lua_next(L, storage) != 0)
+    {
+        if (lua_type(L, -2) == LUA_TSTRING && lua_isstring(L, -1))
+        {
+            (*pPgns)[lua_tostring(L, -2)] = J1939PGNData{0, lua_tostring(L, -1)};
+        }
+        else if (lua_type(L, -2) == LUA_TSTRING && lua_istable(L, -1) && makeBarrier(L, -1))
+        {
+            entryTables.push_back(lua_topointer(L, -1));
+            lua_getfield(L, -1, J1939_PGN_PAYLOAD);
+            lua_getfield(L, -2, J1939_PGN_CYCLETIME);
+            if ((lua_isnil(L, -2) || lua_isstring(L, -2)) && (lua_isnil(L, -1) || lua_isnumber(L, -1)))
+            {
+                J1939PGNData pgnData{0, ""};
+                if (!lua_isnil(L, -1))
+                {
+                    pgnData.cycleTime = static_cast<unsigned int>(lua_tointeger(L, -1));
+                }
+                if (!lua_isnil(L, -2))
+                {
+                    pgnData.payload = lua_tostring(L, -2);
+                }
+                (*pPgns)[lua_tostring(L, -4)] = move(pgnData);
+            }
+            lua_pop(L, 2);
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    return pPgns;
+}
+
+/**
+ * `__newindex` of a table behind the barrier: writes the entry into the
+ * storage table and marks the table. Upvalues: the `StaticTables`, the table
+ * and the storage table.
+ */
+int StaticTables::newIndex(lua_State* L)
+{
+    lua_settop(L, 3);
+    lua_rawset(L, lua_upvalueindex(3));
+    auto* pTables = static_cast<StaticTables*> (lua_touserdata(L, lua_upvalueindex(1)));
+    pTables->markDirty(lua_touserdata(L, lua_upvalueindex(2)));
+    return 0;
+}
+
+/**
+ * Checks, whether the metatable at the given index of the stack is the one of
+ * the barrier.
+ */
+bool StaticTables::isBarrier(lua_State* L, int metatable)
+{
+    metatable = lua_absindex(L, metatable);
+    lua_pushliteral(L, "__newindex");
+    lua_rawget(L, metatable);
+    const bool isNewIndex = lua_tocfunction(L, -1) == newIndex;
+    lua_pop(L, 1);
+    return isNewIndex;
+}
+
+/**
+ * Checks, whether the table at the given index of the stack is behind a
+ * barrier of its own (and not a copy sharing the storage of the original).
+ */
+bool StaticTables::ownsBarrier(lua_State* L, int index)
+{
+    index = lua_absindex(L, index);
+    if (!lua_istable(L, index) || !lua_getmetatable(L, index))
+    {
+        return false;
+    }
+    bool isOwner = false;
+    if (isBarrier(L, -1))
+    {
+        lua_pushliteral(L, "__newindex");
+        lua_rawget(L, -2);
+        lua_getupvalue(L, -1, 2);
+        isOwner = lua_touserdata(L, -1) == lua_topointer(L, index);
+        lua_pop(L, 2);
+    }
+    lua_pop(L, 1);
+    return isOwner;
+}
+
+/**
+ * Pushes a watched table of the ECU table at the given index of the stack, or
+ * nil if there is no such table.
+ */
+void StaticTables::pushWatchedTable(lua_State* L, int ecu, WatchedTable table)
+{
+    switch (table)
+    {
+    case RAW:
+        pushField(L, ecu, RAW_TABLE);
+        break;
+    case DIDS:
+        pushField(L, ecu, READ_DATA_BY_IDENTIFIER_TABLE);
+        break;
+    case PROGRAMMING_DIDS:
+    case EXTENDED_DIDS:
+        pushField(L, ecu, (table == PROGRAMMING_DIDS) ? PROGRAMMING_SESSION_TABLE : EXTENDED_SESSION_TABLE);
+        pushField(L, -1, READ_DATA_BY_IDENTIFIER_TABLE);
+        lua_remove(L, -2);
+        break;
+    case PGNS:
+        pushField(L, ecu, J1939_PGN_TABLE);
+        break;
+    default:
+        lua_pushnil(L);
+        break;
+    }
+}
+
+/**
+ * Gets the identity of the value at the given index of the stack, which is
+ * empty for anything but a table.
+ */
+StaticTables::Identity StaticTables::identityOf(lua_State* L, int index)
+{
+    Identity identity;
+    if (lua_istable(L, index))
+    {
+        identity.pTable = lua_topointer(L, index);
+        if (lua_getmetatable(L, index))
+        {
+            identity.pMetatable = lua_topointer(L, -1);
+            lua_pop(L, 1);
+        }
+    }
+    return identity;
+}
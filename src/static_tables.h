@@ -0,0 +1,120 @@
+/**
+ * @file static_tables.h
+ *
+ */
+
+#ifndef STATIC_TABLES_H
+#define STATIC_TABLES_H
+
+#include "static_entries.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+struct lua_State;
+
+/**
+ * The Lua tables of a shared Lua state, which the `StaticEntries` of its ECUs
+ * are compiled from: the `Raw`-, the `ReadDataByIdentifier`- (also of the
+ * `Programming` and `Extended` session) and the `PGNs`-table of every ECU
+ * table. The entries of these tables are moved behind a write barrier: the
+ * table itself stays empty and reads through its metatable from a storage
+ * table, so every assignment of an entry passes the barrier, which withdraws
+ * the compiled entries and marks the table for compilation. Checking for
+ * changes when the Lua state is unlocked therefore only compares the
+ * identities of the tables (a table may be replaced as a whole) and the
+ * change counter of the watched `Bytes` entries, and recompiles the marked
+ * tables. Entries written by `rawset()` bypass the barrier, they are noticed
+ * when the Lua state is unlocked by checking the table for entries of its
+ * own. `next()` and `rawget()` only see the empty table. Tables used by
+ * several ECUs are compiled once.
+ *
+ * All methods besides `get()` have to be called with the Lua state locked.
+ */
+class StaticTables
+{
+public:
+    StaticTables() = default;
+    StaticTables(const StaticTables& orig) = delete;
+    StaticTables& operator =(const StaticTables& orig) = delete;
+    StaticTables(StaticTables&& orig) = delete;
+    StaticTables& operator =(StaticTables&& orig) = delete;
+    virtual ~StaticTables() = default;
+
+    void addInstance(unsigned int index, const std::string& ecuIdent);
+    std::shared_ptr<const StaticEntries> get(unsigned int index) const noexcept;
+    void invalidate() noexcept;
+    void refresh(lua_State* L) noexcept;
+
+    static void pushStorage(lua_State* L, int index);
+    static void registerIterators(lua_State* L);
+
+private:
+    enum WatchedTable { RAW, DIDS, PROGRAMMING_DIDS, EXTENDED_DIDS, PGNS, NUM_WATCHED_TABLES };
+
+    /// Identity of a watched table: the table and its metatable (the barrier)
+    struct Identity
+    {
+        const void* pTable = nullptr;
+        const void* pMetatable = nullptr;
+
+        bool operator ==(const Identity& other) const noexcept
+        {
+            return pTable == other.pTable && pMetatable == other.pMetatable;
+        }
+    };
+
+    /// `Bytes` entry, which can be changed in place without passing the barrier
+    struct WatchedBytes
+    {
+        const std::uint64_t* pVersion; ///< see `LuaBytes::watch()`
+        std::uint64_t version; ///< when compiled
+    };
+
+    template <typename Table>
+    using Compiled = std::unordered_map<const void*, std::shared_ptr<const Table>>;
+
+    /// Compiled tables by the address of the Lua table
+    struct Compilation
+    {
+        Compiled<StaticEntries::RawTable> rawTables;
+        Compiled<StaticEntries::DataTable> dataTables;
+        Compiled<StaticEntries::PgnTable> pgnTables;
+        std::unordered_map<const void*, std::vector<WatchedBytes>> bytes; ///< by table
+        std::unordered_map<const void*, std::vector<const void*>> entryTables; ///< of the `PGNs`-tables
+    };
+
+    using Identities = std::array<Identity, NUM_WATCHED_TABLES>;
+    using Entries = std::vector<std::shared_ptr<const StaticEntries>>; ///< by fleet index
+
+    std::shared_ptr<const Entries> pEntries_; ///< published with `std::atomic_store()`
+    std::vector<std::string> ecuIdents_; ///< by fleet index, empty if there is no such ECU
+    std::vector<Identities> identities_; ///< of the compiled tables, by fleet index
+    bool isDirty_ = true;
+    std::uint64_t watchedChanges_ = 0; ///< `LuaBytes::watchedChanges()` when compiled
+    std::unordered_set<const void*> dirtyTables_; ///< written since the last compilation
+    Compilation compilation_;
+    int anchorRef_ = 0; ///< registry reference keeping the compiled tables alive
+    bool isAnchored_ = false;
+
+    bool isOutdated(lua_State* L);
+    void compile(lua_State* L);
+    bool isModified(const Compilation& compilation, const void* pTable) const;
+    void markDirty(const void* pTable) noexcept;
+    bool makeBarrier(lua_State* L, int index);
+    std::shared_ptr<const StaticEntries::PgnTable> compilePgns(lua_State* L, int table, std::vector<const void*>& entryTables);
+
+    static std::shared_ptr<const StaticEntries::RawTable> compileRaw(lua_State* L, int table, std::vector<WatchedBytes>& bytes);
+    static std::shared_ptr<const StaticEntries::DataTable> compileData(lua_State* L, int table, std::vector<WatchedBytes>& bytes);
+    static int newIndex(lua_State* L);
+    static bool isBarrier(lua_State* L, int metatable);
+    static bool ownsBarrier(lua_State* L, int index);
+    static void pushWatchedTable(lua_State* L, int ecu, WatchedTable table);
+    static Identity identityOf(lua_State* L, int index);
+};
+
+#endif /* STATIC_TABLES_H */
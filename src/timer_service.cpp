@@ -0,0 +1,139 @@
+/**
+ * @file timer_service.cpp
+ *
+ * This file contains the central timer service, which runs all timers of the
+ * simulator on a single thread.
+ */
+
+#include "timer_service.h"
+
+using namespace std;
+
+/**
+ * Constructor. Starts the timer thread.
+ */
+TimerService::TimerService()
+: thread_(&TimerService::run, this)
+{
+}
+
+/**
+ * Destructor. Stops the timer thread, pending timers are dropped.
+ */
+TimerService::~TimerService()
+{
+    {
+        const lock_guard<mutex> lock(mutex_);
+        isOnExit_ = true;
+    }
+    cond_.notify_one();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+/**
+ * Returns the process wide timer service, which is started on the first call.
+ */
+TimerService& TimerService::instance()
+{
+    static TimerService service;
+    return service;
+}
+
+/**
+ * Arms a new timer.
+ *
+ * @param delay: time until the first expiry
+ * @param callback: the function to call on the timer thread
+ * @param period: the interval of further expiries or 0 for a one-shot timer
+ * @return the ID of the timer, which is never 0
+ * @see TimerService::cancel()
+ */
+TimerService::TimerId TimerService::schedule(chrono::milliseconds delay,
+                                             Callback callback,
+                                             chrono::milliseconds period)
+{
+    const Clock::time_point due = Clock::now() + delay;
+    bool isEarliest;
+    TimerId id;
+    {
+        const lock_guard<mutex> lock(mutex_);
+        id = nextId_++;
+        entries_.emplace(id, Entry{move(callback), period});
+        isEarliest = queue_.empty() || due < queue_.top().first;
+        queue_.emplace(due, id);
+    }
+    if (isEarliest)
+    {
+        cond_.notify_one();
+    }
+    return id;
+}
+
+/**
+ * Disarms a timer. A callback which is just being executed is not
+ * interrupted, so callbacks must not rely on being cancelled synchronously.
+ *
+ * @param id: the ID returned by `schedule()`
+ * @return true if the timer was armed, otherwise false
+ */
+bool TimerService::cancel(TimerId id) noexcept
+{
+    const lock_guard<mutex> lock(mutex_);
+    // the queue entry is skipped lazily once it is due
+    return entries_.erase(id) != 0;
+}
+
+/**
+ * Returns the number of armed timers.
+ */
+size_t TimerService::size() const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void TimerService::run()
+{
+    unique_lock<mutex> lock(mutex_);
+    while (!isOnExit_)
+    {
+        if (queue_.empty())
+        {
+            cond_.wait(lock);
+            continue;
+        }
+
+        const Deadline next = queue_.top();
+        auto it = entries_.find(next.second);
+        if (it == entries_.end())
+        {
+            queue_.pop(); // cancelled
+            continue;
+        }
+        if (next.first > Clock::now())
+        {
+            cond_.wait_until(lock, next.first);
+            continue;
+        }
+
+        queue_.pop();
+        Callback callback;
+        if (it->second.period.count() > 0)
+        {
+            callback = it->second.callback;
+            queue_.emplace(next.first + it->second.period, next.second);
+        }
+        else
+        {
+            callback = move(it->second.callback);
+            entries_.erase(it);
+        }
+
+        lock.unlock();
+        callback();
+        lock.lock();
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file timer_service.h
+ *
+ */
+
+#ifndef TIMER_SERVICE_H
+#define TIMER_SERVICE_H
+
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/**
+ * Central timer service. All timers share a single thread which sleeps until
+ * the next deadline of a priority queue, so arming a timer costs a heap
+ * insertion instead of a new thread. Callbacks are executed on the timer
+ * thread and therefore have to be short and must not block.
+ */
+class TimerService
+{
+public:
+    using TimerId = std::uint64_t;
+    using Callback = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    TimerService();
+    TimerService(const TimerService& orig) = delete;
+    TimerService& operator =(const TimerService& orig) = delete;
+    TimerService(TimerService&& orig) = delete;
+    TimerService& operator =(TimerService&& orig) = delete;
+    virtual ~TimerService();
+
+    static TimerService& instance();
+
+    TimerId schedule(std::chrono::milliseconds delay,
+                     Callback callback,
+                     std::chrono::milliseconds period = std::chrono::milliseconds(0));
+    bool cancel(TimerId id) noexcept;
+    std::size_t size() const;
+
+private:
+    struct Entry
+    {
+        Callback callback;
+        std::chrono::milliseconds period;
+    };
+    using Deadline = std::pair<Clock::time_point, TimerId>;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> queue_;
+    std::unordered_map<TimerId, Entry> entries_;
+    TimerId nextId_ = 1;
+    bool isOnExit_ = false;
+    std::thread thread_;
+
+    void run();
+};
+
+#endif /* TIMER_SERVICE_H */
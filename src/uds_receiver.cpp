@@ -7,16 +7,152 @@
 
 #include "uds_receiver.h"
 #include "service_identifier.h"
+#include "metrics.h"
+#include "utilities.h"
+#include "request_arena.h"
 #include <vector>
 #include <array>
 #include <iostream>
-#include <random>
-#include <limits>
+#include <chrono>
 #include <cassert>
 
 using namespace std;
+using std::chrono::milliseconds;
 
-static random_device RANDOM_DEVICE; ///< necessary for `generateSeed()`
+constexpr size_t MAX_UDS_RESPONSE_SIZE = 4096; ///< max. 4096 bytes per UDS message
+
+constexpr milliseconds P2_SERVER_MAX(50); ///< max. time until the (first) response
+constexpr milliseconds P2_STAR_SERVER_MAX(5000); ///< max. time after a `ResponsePending`
+constexpr milliseconds P2_MARGIN(10); ///< bus and scheduling latency to stay within P2
+
+/// Collects the responses instead of sending them, see `UdsReceiver::evaluate()`.
+static thread_local vector<vector<uint8_t>>* pCapturedResponses = nullptr;
+
+/// Set while a request with the suppressPosRspMsgIndicationBit is handled.
+static thread_local bool isPosRspSuppressed = false;
+
+/// Version of the Lua script, which the request in progress is handled with.
+static thread_local EcuLuaScript* pActiveScript = nullptr;
+
+/// Set while a functionally addressed request is handled, see `UdsReceiver::evaluate()`.
+static thread_local bool isFunctionalRequest = false;
+
+/// State of the `ResponsePending` watchdog of a request.
+struct PendingResponse
+{
+    std::mutex mutex;
+    bool isActive = false;
+    uint8_t sid = 0x00;
+    unsigned numSent = 0;
+    TimerService::TimerId timerId = 0;
+};
+
+/// Watchdog of the request in progress. Every request gets its own one, since
+/// a receiver may handle a functional and a physical request at the same time.
+static thread_local PendingResponse* pPendingResponse = nullptr;
+
+/**
+ * Starts the P2 watchdog of a request. The first `ResponsePending` is sent
+ * shortly before P2 expires and repeated shortly before every P2* expiry.
+ *
+ * @param pPending: the watchdog state of the request
+ * @param sid: the service identifier of the request
+ * @param pSender: the sender of the `ResponsePending` messages
+ */
+static void armResponsePending(const shared_ptr<PendingResponse>& pPending, uint8_t sid, IsoTpSender* pSender)
+{
+    static metrics::Counter& deadlineHits = metrics::counter("uds.p2_deadline_hits");
+    static metrics::Counter& pendingSent = metrics::counter("uds.response_pending_sent");
+
+    const lock_guard<mutex> lock(pPending->mutex);
+    pPending->isActive = true;
+    pPending->sid = sid;
+    pPending->numSent = 0;
+
+    // the state is shared with the timer, since the callback may still run
+    // after the request has been finished
+    shared_ptr<PendingResponse> pState = pPending;
+    pPending->timerId = TimerService::instance().schedule(
+        P2_SERVER_MAX - P2_MARGIN,
+        [pState, pSender]()
+        {
+            const lock_guard<mutex> lock(pState->mutex);
+            if (!pState->isActive)
+            {
+                return;
+            }
+            if (pState->numSent++ == 0)
+            {
+                deadlineHits.increment();
+            }
+            pendingSent.increment();
+            const array<uint8_t, 3> resp = {ERROR, pState->sid, REQUEST_CORRECTLY_RECEIVED_RESPONSE_PENDING};
+            pSender->sendData(resp.data(), resp.size());
+        },
+        P2_STAR_SERVER_MAX - P2_MARGIN);
+}
+
+/**
+ * Stops the P2 watchdog of a request.
+ *
+ * @param pPending: the watchdog state of the request, may be `nullptr`
+ * @return true if a `ResponsePending` has been sent for the request
+ */
+static bool disarmResponsePending(PendingResponse* pPending) noexcept
+{
+    if (pPending == nullptr)
+    {
+        return false;
+    }
+
+    TimerService::TimerId timerId;
+    bool wasPending;
+    {
+        const lock_guard<mutex> lock(pPending->mutex);
+        wasPending = pPending->numSent > 0;
+        if (!pPending->isActive)
+        {
+            return wasPending;
+        }
+        pPending->isActive = false;
+        timerId = pPending->timerId;
+    }
+    TimerService::instance().cancel(timerId);
+    return wasPending;
+}
+
+/**
+ * Checks if a negative response has to be dropped, since it answers a
+ * functional request: ISO 14229-1 suppresses the NRCs 0x11, 0x12, 0x31, 0x7E
+ * and 0x7F on functional requests, unless a `ResponsePending` has been sent.
+ *
+ * @param buffer: the response message
+ * @param size: the length of the response in bytes
+ * @param wasPending: true if a `ResponsePending` has been sent for the request
+ * @return true if the response is dropped
+ */
+static bool isFunctionalNrcSuppressed(const void* buffer, size_t size, bool wasPending) noexcept
+{
+    static metrics::Counter& numSuppressed = metrics::counter("uds.functional_nrcs_suppressed");
+
+    const uint8_t* bytes = static_cast<const uint8_t*> (buffer);
+    if (!isFunctionalRequest || wasPending || size < 3 || bytes[0] != ERROR)
+    {
+        return false;
+    }
+    switch (bytes[2])
+    {
+        case SERVICE_NOT_SUPPORTED:
+        case SUBFUNCTION_NOT_SUPPORTED:
+        case REQUEST_OUT_OF_RANGE:
+        case SUBFUNCTION_NOT_SUPPORTED_IN_ACTIVE_SESSION:
+        case SERVICE_NOT_SUPPORTED_IN_ACTIVE_SESSION:
+            numSuppressed.increment();
+            return true;
+        default:
+            return false;
+    }
+}
 
 /**
  * Constructor.
@@ -34,15 +170,45 @@ UdsReceiver::UdsReceiver(canid_t source,
                          EcuLuaScript *pEcuScript,
                          IsoTpSender* pSender,
                          SessionController* pSesCtrl)
+: UdsReceiver(source, dest, device, ScriptSlot::borrow(pEcuScript), pSender, pSesCtrl)
+{
+}
+
+/**
+ * Constructor for an ECU, whose Lua script can be reloaded at run-time.
+ *
+ * @param source
+ * @param dest
+ * @param device
+ * @param pScriptSlot: the slot holding the current script
+ * @param pSender
+ * @param pSesCtrl
+ */
+UdsReceiver::UdsReceiver(canid_t source,
+                         canid_t dest,
+                         const string& device,
+                         shared_ptr<ScriptSlot> pScriptSlot,
+                         IsoTpSender* pSender,
+                         SessionController* pSesCtrl)
 : IsoTpReceiver(source, dest, device)
-, pEcuScript_(pEcuScript)
+, pScriptSlot_(move(pScriptSlot))
 , pIsoTpSender_(pSender)
 , pSessionCtrl_(pSesCtrl)
 {
+    assert(pScriptSlot_ != nullptr);
     assert(pIsoTpSender_ != nullptr);
     assert(pSessionCtrl_ != nullptr);
-    pEcuScript_->registerIsoTpSender(pSender);
-    pEcuScript_->registerSessionController(pSesCtrl);
+    const shared_ptr<EcuLuaScript> pScript = pScriptSlot_->load();
+    pScript->registerIsoTpSender(pSender);
+    pScript->registerSessionController(pSesCtrl);
+
+    // the communication state is handed over to every reloaded script, so it
+    // lives as long as the slot
+    pCommCtrl_ = &pScript->getCommunicationControl();
+
+    // the default session enables all communication again
+    CommunicationControl* pCommCtrl = pCommCtrl_;
+    pSessionCtrl_->setTimeoutHandler([pCommCtrl]() { pCommCtrl->reset(); });
 }
 
 /**
@@ -52,10 +218,10 @@ UdsReceiver::UdsReceiver(canid_t source,
  */
 UdsReceiver::UdsReceiver(UdsReceiver&& orig) noexcept
 : IsoTpReceiver(move(orig))
-, pEcuScript_(move(orig.pEcuScript_))
+, pScriptSlot_(move(orig.pScriptSlot_))
+, pCommCtrl_(orig.pCommCtrl_)
 , pIsoTpSender_(orig.pIsoTpSender_)
 , pSessionCtrl_(orig.pSessionCtrl_)
-, securityAccessType_(orig.securityAccessType_)
 {
     orig.pIsoTpSender_ = nullptr;
     orig.pSessionCtrl_ = nullptr;
@@ -70,18 +236,49 @@ UdsReceiver::UdsReceiver(UdsReceiver&& orig) noexcept
 UdsReceiver& UdsReceiver::operator=(UdsReceiver&& orig) noexcept
 {
     assert(this != &orig);
-    pEcuScript_ = move(orig.pEcuScript_);
+    pScriptSlot_ = move(orig.pScriptSlot_);
+    pCommCtrl_ = orig.pCommCtrl_;
     pIsoTpSender_ = orig.pIsoTpSender_;
     pSessionCtrl_ = orig.pSessionCtrl_;
-    securityAccessType_ = orig.securityAccessType_;
     orig.pIsoTpSender_ = nullptr;
     orig.pSessionCtrl_ = nullptr;
     return *this;
 }
 
+/**
+ * Builds the dispatch table of the natively handled services. All other SIDs
+ * are only answered from the `Raw`-table of the Lua script.
+ *
+ * @return the handlers indexed by the SID
+ */
+constexpr array<UdsReceiver::Service, 256> UdsReceiver::makeServiceTable() noexcept
+{
+    array<Service, 256> services{};
+    services[READ_DATA_BY_IDENTIFIER_REQ] = {&UdsReceiver::readDataByIdentifier, true};
+    services[WRITE_DATA_BY_IDENTIFIER_REQ] = {&UdsReceiver::writeDataByIdentifier, true};
+    services[DIAGNOSTIC_SESSION_CONTROL_REQ] = {&UdsReceiver::diagnosticSessionControl, false};
+    services[ECU_RESET_REQ] = {&UdsReceiver::ecuReset, false};
+    services[SECURITY_ACCESS_REQ] = {&UdsReceiver::securityAccess, true};
+    services[READ_DTC_INFORMATION_REQ] = {&UdsReceiver::readDtcInformation, true};
+    services[CLEAR_DIAGNOSTIC_INFORMATION_REQ] = {&UdsReceiver::clearDiagnosticInformation, true};
+    services[ROUTINE_CONTROL_REQ] = {&UdsReceiver::routineControl, true};
+    services[COMMUNICATION_CONTROL_REQ] = {&UdsReceiver::communicationControl, true};
+    services[CONTROL_DTC_SETTINGS_REQ] = {&UdsReceiver::controlDtcSetting, true};
+    services[TESTER_PRESENT_REQ] = {&UdsReceiver::testerPresent, false};
+    return services;
+}
+
 /**
  * Handles the received UDS messages and sends back the response like defined in
- * the according Lua script.
+ * the according Lua script. If the handler does not respond within P2, e.g.
+ * because a Lua function calls `sleep()`, `7F <SID> 78` (ResponsePending) is
+ * sent until the final response is ready.
+ *
+ * The native handler is picked from a table indexed by the SID. The literal
+ * hex string of the request is only built for services, which have entries in
+ * the `Raw`-table or no native handler at all. `TesterPresent` is answered
+ * right away, unless the script has `Raw` entries for it, which take
+ * precedence like for all other services.
  *
  * @param buffer: the buffer containing the received data
  * @param num_bytes: the number of received bytes.
@@ -91,88 +288,208 @@ UdsReceiver& UdsReceiver::operator=(UdsReceiver&& orig) noexcept
  */
 void UdsReceiver::proceedReceivedData(const uint8_t* buffer, const size_t num_bytes) noexcept
 {
+    static constexpr array<Service, 256> SERVICES = makeServiceTable();
+
+    if (num_bytes == 0 || pCommCtrl_->isSuspended())
+    {
+        return; // rebooting after an `ECUReset`
+    }
+
+    const UdsRequest request(buffer, num_bytes);
+    const uint8_t udsServiceIdentifier = request.sid();
+    if (udsServiceIdentifier == TESTER_PRESENT_REQ && !pScriptSlot_->hasRawTesterPresent())
+    {
+        // fast path: no logging, no Lua, no locks
+        testerPresent(request);
+        return;
+    }
+
     IsoTpReceiver::proceedReceivedData(buffer, num_bytes);
 
-    const uint8_t udsServiceIdentifier = buffer[0];
-    const string identifier = intToHexString(buffer, num_bytes);
-    const bool isRaw = pEcuScript_->hasRaw(identifier);
+    static metrics::Histogram& handlerTime = metrics::histogram("uds.handler_time_us");
+    static metrics::Histogram& gcTime = metrics::histogram("uds.gc_time_us");
+    const auto start = chrono::steady_clock::now();
+    const RequestArena::Scope arenaScope;
+
+    // the request completes with this version of the script, even if a
+    // reloaded one gets published meanwhile
+    const shared_ptr<EcuLuaScript> pScript = pScriptSlot_->load();
+    EcuLuaScript* const pOuterScript = pActiveScript;
+    pActiveScript = pScript.get();
+
+    // the handlers (and the Lua tables) only see the plain sub-function, the
+    // positive response is dropped in `sendResponse()`
+    isPosRspSuppressed = request.isPosRspSuppressed();
+
+    const shared_ptr<PendingResponse> pPending = make_shared<PendingResponse>();
+    PendingResponse* const pOuterPending = pPendingResponse;
+    pPendingResponse = pPending.get();
+    armResponsePending(pPending, udsServiceIdentifier, pIsoTpSender_);
+
+    const Service& service = SERVICES[udsServiceIdentifier];
+    bool isRaw = false;
+    if (service.handler == nullptr || pScript->hasRawService(udsServiceIdentifier))
+    {
+        const string identifier = request.toHexString();
+        isRaw = pScript->getRaw(identifier, request, [this](const uint8_t* data, size_t size)
+        {
+            cout << "UDS sending: " << dec << size << " bytes." << endl;
+            sendResponse(data, size);
+        });
+    }
 
-    if (isRaw)
+    if (!isRaw)
+    {
+        if (service.handler != nullptr)
+        {
+            (this->*service.handler)(request);
+        }
+        else
+        {
+            sendNegativeResponse(udsServiceIdentifier, SERVICE_NOT_SUPPORTED);
+        }
+    }
+    if (isRaw || service.isSessionRefresh)
     {
-        vector<unsigned char> raw = pEcuScript_->literalHexStrToBytes(pEcuScript_->getRaw(identifier));
-        cout << "UDS sending: " << dec << raw.size() << " bytes." << endl;
-        pIsoTpSender_->sendData(raw.data(), raw.size());
         pSessionCtrl_->reset();
     }
-    else
+
+    disarmResponsePending(pPending.get());
+    pPendingResponse = pOuterPending;
+    isPosRspSuppressed = false;
+    pActiveScript = pOuterScript;
+    handlerTime.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+
+    // part of the handler time spent in garbage collector steps
+    const int64_t gcTimeUs = LuaCollector::takeThreadTime();
+    if (gcTimeUs >= 0)
     {
-        switch (udsServiceIdentifier)
+        gcTime.record(uint64_t(gcTimeUs));
+    }
+}
+
+/**
+ * Handles the UDS `TesterPresent` request. Only the session timestamp is
+ * refreshed, which is a single atomic store, so this keeps up with testers
+ * polling at a high rate.
+ *
+ * @param request: the UDS request
+ */
+void UdsReceiver::testerPresent(const UdsRequest& request) noexcept
+{
+    assert(pSessionCtrl_ != nullptr);
+
+    if (pCommCtrl_->isSuspended())
+    {
+        return;
+    }
+    if (request.size() < 2)
+    {
+        const array<uint8_t, 3> resp = {ERROR, TESTER_PRESENT_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT};
+        transmit(resp.data(), resp.size());
+        return;
+    }
+    if ((request[1] & ~SUPPRESS_POS_RSP_MSG_INDICATION_BIT) != TESTER_PRESENT_ZERO_SUB_FUNCTION)
+    {
+        const array<uint8_t, 3> resp = {ERROR, TESTER_PRESENT_REQ, SUBFUNCTION_NOT_SUPPORTED};
+        if (!isFunctionalNrcSuppressed(resp.data(), resp.size(), false))
         {
-            case READ_DATA_BY_IDENTIFIER_REQ:
-            {
-                readDataByIdentifier(buffer, num_bytes);
-                pSessionCtrl_->reset();
-                break;
-            }
-            case DIAGNOSTIC_SESSION_CONTROL_REQ:
-                diagnosticSessionControl(buffer, num_bytes);
-                break;
-            case SECURITY_ACCESS_REQ:
-                //                securityAccess(buffer, num_bytes);
-                break;
-                // TODO: implement all other requests ...
-        default:
-            constexpr array<uint8_t, 2> resp = {
-                ERROR,
-                SUBFUNCTION_NOT_SUPPORTED
-            };
-            pIsoTpSender_->sendData(resp.data(), resp.size());
+            transmit(resp.data(), resp.size());
         }
+        return;
+    }
+
+    pSessionCtrl_->reset();
+    if (!request.isPosRspSuppressed())
+    {
+        constexpr array<uint8_t, 2> resp = {TESTER_PRESENT_RES, TESTER_PRESENT_ZERO_SUB_FUNCTION};
+        transmit(resp.data(), resp.size());
     }
 }
 
+/**
+ * Handles a received UDS message like `proceedReceivedData()`, but returns the
+ * responses instead of sending them. `ResponsePending` messages are still
+ * sent immediately. The negative responses, which ISO 14229-1 suppresses on
+ * functional requests, are dropped if the request was received functionally.
+ *
+ * @param buffer: the buffer containing the received data
+ * @param num_bytes: the number of received bytes
+ * @param isFunctional: true if the request was functionally addressed
+ * @return the response messages
+ * @see BroadcastReceiver::fanOut()
+ */
+vector<vector<uint8_t>> UdsReceiver::evaluate(const uint8_t* buffer,
+                                              const size_t num_bytes,
+                                              bool isFunctional) noexcept
+{
+    vector<vector<uint8_t>> responses;
+    pCapturedResponses = &responses;
+    isFunctionalRequest = isFunctional;
+    proceedReceivedData(buffer, num_bytes);
+    isFunctionalRequest = false;
+    pCapturedResponses = nullptr;
+    return responses;
+}
+
 /**
  * Handles the UDS `readDataByIdentifier` request. The ISO-TP layer already
  * ensures the min. length of 3 bytes by filling up the request with zero bytes
- * if necessary.
+ * if necessary. Identifiers of the DID store are answered natively, all others
+ * are looked up in the Lua script.
  *
- * @param buffer: the buffer containing the UDS message
- * @param num_bytes: the length of the message in bytes (min. 3 bytes)
+ * @param request: the UDS request (min. 3 bytes)
  */
-void UdsReceiver::readDataByIdentifier(const uint8_t* buffer, const size_t num_bytes) noexcept
+void UdsReceiver::readDataByIdentifier(const UdsRequest& request) noexcept
 {
     assert(pSessionCtrl_ != nullptr);
     assert(pIsoTpSender_ != nullptr);
 
-    const uint16_t dataIdentifier = (buffer[1] << 8) + buffer[2];
-    string data;
+    const uint16_t dataIdentifier = (request[1] << 8) + request[2];
+
+    DidStore* pDidStore = script().getDidStore();
+    if (pDidStore != nullptr)
+    {
+        ArenaBytes resp({
+            READ_DATA_BY_IDENTIFIER_RES,
+            request[1],
+            request[2]
+        }, RequestArena::resource());
+        if (pDidStore->read(dataIdentifier, resp))
+        {
+            sendResponse(resp.data(), resp.size());
+            return;
+        }
+    }
 
+    string data;
     if (pSessionCtrl_->getCurrentUdsSession() == UdsSession::PROGRAMMING)
     {
-        data = pEcuScript_->getDataByIdentifier(EcuLuaScript::toByteResponse(dataIdentifier, sizeof(dataIdentifier)), "Programming");
+        data = script().getDataByIdentifier(EcuLuaScript::toByteResponse(dataIdentifier, sizeof(dataIdentifier)), PROGRAMMING_SESSION_TABLE);
     }
     else if (pSessionCtrl_->getCurrentUdsSession() == UdsSession::EXTENDED)
     {
-        data = pEcuScript_->getDataByIdentifier(EcuLuaScript::toByteResponse(dataIdentifier, sizeof(dataIdentifier)), "Extended");
+        data = script().getDataByIdentifier(EcuLuaScript::toByteResponse(dataIdentifier, sizeof(dataIdentifier)), EXTENDED_SESSION_TABLE);
     }
     else // default session
     {
         const string resp = EcuLuaScript::toByteResponse(dataIdentifier, sizeof(dataIdentifier));
-        data = pEcuScript_->getDataByIdentifier(resp);
+        data = script().getDataByIdentifier(resp);
     }
 
 
     if (!data.empty())
     {
         // send positive response
-        vector<uint8_t> resp(data.length() + 3); // data + UDS header
-        resp = {
+        ArenaBytes resp(RequestArena::resource());
+        resp.reserve(data.length() + 3); // data + UDS header
+        resp.insert(resp.cend(), {
             READ_DATA_BY_IDENTIFIER_RES,
-            buffer[1],
-            buffer[2]
-        };
+            request[1],
+            request[2]
+        });
         resp.insert(resp.cend(), data.cbegin(), data.cend()); // insert payload
-        pIsoTpSender_->sendData(resp.data(), resp.size());
+        sendResponse(resp.data(), resp.size());
     }
     else // send out of range
     {
@@ -180,25 +497,70 @@ void UdsReceiver::readDataByIdentifier(const uint8_t* buffer, const size_t num_b
             ERROR,
             REQUEST_OUT_OF_RANGE
         };
-        pIsoTpSender_->sendData(nrc.data(), nrc.size());
+        sendResponse(nrc.data(), nrc.size());
+    }
+}
+
+/**
+ * Handles the UDS `WriteDataByIdentifier` request. Only identifiers defined in
+ * the `DIDStore`-table of the Lua script are writable. A value, which cannot
+ * be journaled, is answered with generalProgrammingFailure.
+ *
+ * @param request: the UDS request (min. 4 bytes)
+ */
+void UdsReceiver::writeDataByIdentifier(const UdsRequest& request) noexcept
+{
+    assert(pIsoTpSender_ != nullptr);
+
+    if (request.size() < 4)
+    {
+        sendNegativeResponse(WRITE_DATA_BY_IDENTIFIER_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+
+    DidStore* pDidStore = script().getDidStore();
+    if (pDidStore == nullptr)
+    {
+        sendNegativeResponse(WRITE_DATA_BY_IDENTIFIER_REQ, REQUEST_OUT_OF_RANGE);
+        return;
+    }
+
+    const uint16_t dataIdentifier = (request[1] << 8) + request[2];
+    switch (pDidStore->write(dataIdentifier, request.data() + 3, request.size() - 3))
+    {
+        case DidWriteResult::OK:
+        {
+            const array<uint8_t, 3> resp = {WRITE_DATA_BY_IDENTIFIER_RES, request[1], request[2]};
+            sendResponse(resp.data(), resp.size());
+            break;
+        }
+        case DidWriteResult::INVALID_LENGTH:
+            sendNegativeResponse(WRITE_DATA_BY_IDENTIFIER_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+            break;
+        case DidWriteResult::JOURNAL_FAILED:
+            sendNegativeResponse(WRITE_DATA_BY_IDENTIFIER_REQ, GENERAL_PROGRAMMING_FAILURE);
+            break;
+        default: // unknown identifier or invalid value
+            sendNegativeResponse(WRITE_DATA_BY_IDENTIFIER_REQ, REQUEST_OUT_OF_RANGE);
+            break;
     }
 }
 
 /**
  * Starts a session and sends back the corresponding response message.
  *
- * @param buffer: the buffer containing the UDS message
- * @param num_bytes: the length of the message in bytes
+ * @param request: the UDS request
  */
-void UdsReceiver::diagnosticSessionControl(const uint8_t* buffer, const size_t num_bytes)
+void UdsReceiver::diagnosticSessionControl(const UdsRequest& request)
 {
     assert(pSessionCtrl_ != nullptr);
 
-    const uint8_t sessionId = buffer[1];
+    const uint8_t sessionId = request[1];
     switch (sessionId)
     {
         case 0x01: // UdsSession::DEFAULT
             pSessionCtrl_->setCurrentUdsSession(UdsSession::DEFAULT);
+            pCommCtrl_->reset();
             break;
         case 0x02: // UdsSession::PROGRAMMING
             pSessionCtrl_->setCurrentUdsSession(UdsSession::PROGRAMMING);
@@ -213,105 +575,442 @@ void UdsReceiver::diagnosticSessionControl(const uint8_t* buffer, const size_t n
             break;
     }
 
+    // every session change locks the ECU
+    SecurityManager* pSecurity = script().getSecurityManager();
+    if (pSecurity != nullptr)
+    {
+        pSecurity->lock();
+    }
+
     const array<uint8_t, 2> resp = {
         DIAGNOSTIC_SESSION_CONTROL_RES,
         sessionId
     };
-    pIsoTpSender_->sendData(resp.data(), resp.size());
+    sendResponse(resp.data(), resp.size());
 }
 
 /**
+ * Handles the UDS `SecurityAccess` request natively. Odd sub-functions request
+ * a seed, even sub-functions send the key of the previous seed.
  *
- * @param buffer: the buffer containing the UDS message
- * @param num_bytes: the length of the message in bytes
+ * @param request: the UDS request
+ * @see SecurityManager
  */
-void UdsReceiver::securityAccess(const uint8_t* buffer, const size_t num_bytes) noexcept
+void UdsReceiver::securityAccess(const UdsRequest& request) noexcept
 {
-    const uint8_t seedId = buffer[1];
-    const string seed = pEcuScript_->getSeed(seedId);
-    if (!seed.empty())
-    {
-        // send seed
-        vector<uint8_t> resp(seed.length() + 2); // data + UDS header
-        resp = {
-            SECURITY_ACCESS_REQ,
-            seedId
-        };
-        resp.insert(resp.cend(), seed.cbegin(), seed.cend() - 1); // insert payload - nullbyte
-        pIsoTpSender_->sendData(resp.data(), resp.size());
-        securityAccessType_ = seedId + 0x01;
+    SecurityManager* pSecurity = script().getSecurityManager();
+    if (pSecurity == nullptr)
+    {
+        sendNegativeResponse(SECURITY_ACCESS_REQ, SERVICE_NOT_SUPPORTED);
+        return;
     }
-    else
+    if (request.size() < 2)
     {
-        if (securityAccessType_ == seedId)
-        {
-            // second request
-            constexpr array<uint8_t, 1> resp = {SECURITY_ACCESS_RES};
-            // Lua seed function
-            pIsoTpSender_->sendData(resp.data(), resp.size());
-            securityAccessType_ = 0x00;
-        }
-        else
-        {
-            constexpr array<uint8_t, 2> resp = {
-                ERROR,
-                SUBFUNCTION_NOT_SUPPORTED
-            };
-            pIsoTpSender_->sendData(resp.data(), resp.size());
-        }
+        sendNegativeResponse(SECURITY_ACCESS_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+
+    const uint8_t level = request[1];
+    vector<uint8_t> resp = {SECURITY_ACCESS_RES, level};
+    SecurityResult result;
+    if (level % 2 != 0) // requestSeed
+    {
+        vector<uint8_t> seed;
+        result = pSecurity->requestSeed(level, seed);
+        resp.insert(resp.end(), seed.cbegin(), seed.cend());
+    }
+    else // sendKey
+    {
+        result = pSecurity->sendKey(level, request.data() + 2, (request.size() > 2) ? request.size() - 2 : 0);
+    }
+
+    switch (result)
+    {
+        case SecurityResult::OK:
+            sendResponse(resp.data(), resp.size());
+            break;
+        case SecurityResult::INVALID_LEVEL:
+            sendNegativeResponse(SECURITY_ACCESS_REQ, SUBFUNCTION_NOT_SUPPORTED);
+            break;
+        case SecurityResult::SEQUENCE_ERROR:
+            sendNegativeResponse(SECURITY_ACCESS_REQ, REQUEST_SEQUENCE_ERROR);
+            break;
+        case SecurityResult::INVALID_KEY:
+            sendNegativeResponse(SECURITY_ACCESS_REQ, INVALID_KEY);
+            break;
+        case SecurityResult::EXCEEDED_ATTEMPTS:
+            sendNegativeResponse(SECURITY_ACCESS_REQ, EXCEEDED_NUMBER_OF_ATTEMPTS);
+            break;
+        case SecurityResult::DELAY_NOT_EXPIRED:
+            sendNegativeResponse(SECURITY_ACCESS_REQ, REQUIRED_TIME_DELAY_NOT_EXPIRED);
+            break;
     }
 }
 
-string UdsReceiver::intToHexString(const uint8_t* buffer, const size_t num_bytes)
+/**
+ * Handles the UDS `ReadDTCInformation` request natively from the DTC store of
+ * the ECU script. Supported sub-functions are `reportNumberOfDTCByStatusMask`,
+ * `reportDTCByStatusMask`, `reportDTCSnapshotRecordByDTCNumber`,
+ * `reportDTCExtDataRecordByDTCNumber` and `reportSupportedDTC`.
+ *
+ * @param request: the UDS request
+ */
+void UdsReceiver::readDtcInformation(const UdsRequest& request) noexcept
 {
-    string a = "";
+    assert(pIsoTpSender_ != nullptr);
 
-    for (unsigned int i = 0; i < num_bytes; i++)
+    if (request.size() < 2)
     {
-        if ((buffer[i] / 16) > 9)
-        {
-            if ((buffer[i] / 16) == 0x0a)
-                a.append("A");
-            else if ((buffer[i] / 16) == 0x0b)
-                a.append("B");
-            else if ((buffer[i] / 16) == 0x0c)
-                a.append("C");
-            else if ((buffer[i] / 16) == 0x0d)
-                a.append("D");
-            else if ((buffer[i] / 16) == 0x0e)
-                a.append("E");
-            else if ((buffer[i] / 16) == 0x0f)
-                a.append("F");
-        }
-        else
+        sendNegativeResponse(READ_DTC_INFORMATION_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+
+    const DtcStore& dtcs = script().getDtcStore();
+    const uint8_t subFunction = request[1];
+    const uint8_t availabilityMask = dtcs.getStatusAvailabilityMask();
+    vector<uint8_t> resp = {READ_DTC_INFORMATION_RES, subFunction};
+
+    switch (subFunction)
+    {
+        case REPORT_NUMBER_OF_DTC_BY_STATUS_MASK:
+        case REPORT_DTC_BY_STATUS_MASK:
         {
-            a.append(to_string(buffer[i] / 16));
+            if (request.size() != 3)
+            {
+                sendNegativeResponse(READ_DTC_INFORMATION_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+                return;
+            }
+            const uint8_t mask = request[2] & availabilityMask;
+            resp.push_back(availabilityMask);
+            if (subFunction == REPORT_NUMBER_OF_DTC_BY_STATUS_MASK)
+            {
+                const size_t count = dtcs.countByStatusMask(mask);
+                resp.push_back(DTC_FORMAT_ISO_14229_1);
+                resp.push_back(uint8_t(count >> 8));
+                resp.push_back(uint8_t(count));
+            }
+            else
+            {
+                dtcs.appendByStatusMask(mask, resp);
+            }
+            break;
         }
-        if ((buffer[i] % 16) > 9)
+        case REPORT_SUPPORTED_DTC:
+            resp.push_back(availabilityMask);
+            dtcs.appendAll(resp);
+            break;
+        case REPORT_DTC_SNAPSHOT_RECORD_BY_DTC_NUMBER:
+        case REPORT_DTC_EXT_DATA_RECORD_BY_DTC_NUMBER:
         {
-            if ((buffer[i] % 16) == 0x0a)
-                a.append("A");
-            else if ((buffer[i] % 16) == 0x0b)
-                a.append("B");
-            else if ((buffer[i] % 16) == 0x0c)
-                a.append("C");
-            else if ((buffer[i] % 16) == 0x0d)
-                a.append("D");
-            else if ((buffer[i] % 16) == 0x0e)
-                a.append("E");
-            else if ((buffer[i] % 16) == 0x0f)
-                a.append("F");
+            if (request.size() != 6)
+            {
+                sendNegativeResponse(READ_DTC_INFORMATION_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+                return;
+            }
+            const uint32_t dtc = (request[2] << 16) | (request[3] << 8) | request[4];
+            const bool found = (subFunction == REPORT_DTC_SNAPSHOT_RECORD_BY_DTC_NUMBER)
+                ? dtcs.appendSnapshotRecords(dtc, request[5], resp)
+                : dtcs.appendExtendedDataRecords(dtc, request[5], resp);
+            if (!found)
+            {
+                sendNegativeResponse(READ_DTC_INFORMATION_REQ, REQUEST_OUT_OF_RANGE);
+                return;
+            }
+            break;
         }
-        else
+        default:
+            sendNegativeResponse(READ_DTC_INFORMATION_REQ, SUBFUNCTION_NOT_SUPPORTED);
+            return;
+    }
+
+    if (resp.size() > MAX_UDS_RESPONSE_SIZE)
+    {
+        sendNegativeResponse(READ_DTC_INFORMATION_REQ, RESPONSE_TOO_LONG);
+        return;
+    }
+
+    cout << "UDS sending: " << dec << resp.size() << " bytes." << endl;
+    sendResponse(resp.data(), resp.size());
+}
+
+/**
+ * Handles the UDS `ClearDiagnosticInformation` request. The group of DTC is
+ * either a single DTC or `FF FF FF` for all DTCs.
+ *
+ * @param request: the UDS request
+ */
+void UdsReceiver::clearDiagnosticInformation(const UdsRequest& request) noexcept
+{
+    assert(pIsoTpSender_ != nullptr);
+
+    if (request.size() != 4)
+    {
+        sendNegativeResponse(CLEAR_DIAGNOSTIC_INFORMATION_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+
+    const uint32_t groupOfDtc = (request[1] << 16) | (request[2] << 8) | request[3];
+    if (!script().getDtcStore().clear(groupOfDtc))
+    {
+        sendNegativeResponse(CLEAR_DIAGNOSTIC_INFORMATION_REQ, REQUEST_OUT_OF_RANGE);
+        return;
+    }
+
+    constexpr array<uint8_t, 1> resp = {CLEAR_DIAGNOSTIC_INFORMATION_RES};
+    sendResponse(resp.data(), resp.size());
+}
+
+/**
+ * Handles the UDS `RoutineControl` request. Started routines run on the worker
+ * pool, so the request is answered immediately. `requestRoutineResults`
+ * reports the `routineInfo` (running, completed, stopped or failed) followed
+ * by the progress in percent while running or the result once completed.
+ *
+ * @param request: the UDS request (min. 4 bytes)
+ */
+void UdsReceiver::routineControl(const UdsRequest& request) noexcept
+{
+    if (request.size() < 4)
+    {
+        sendNegativeResponse(ROUTINE_CONTROL_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+
+    RoutineController& routines = script().getRoutineController();
+    const uint8_t subFunction = request[1];
+    const uint16_t rid = (request[2] << 8) | request[3];
+    vector<uint8_t> resp = {ROUTINE_CONTROL_RES, subFunction, request[2], request[3]};
+    RoutineResult result;
+
+    switch (subFunction)
+    {
+        case START_ROUTINE:
         {
-            a.append(to_string(buffer[i] % 16));
+            vector<uint8_t> statusRecord;
+            result = routines.start(rid, vector<uint8_t>(request.data() + 4, request.data() + request.size()), statusRecord);
+            resp.insert(resp.end(), statusRecord.cbegin(), statusRecord.cend());
+            break;
         }
-        if (!(i == num_bytes - 1))
+        case STOP_ROUTINE:
+            result = routines.stop(rid);
+            break;
+        case REQUEST_ROUTINE_RESULTS:
         {
-            a.append(" ");
+            RoutineState state = RoutineState::IDLE;
+            uint8_t progress = 0;
+            vector<uint8_t> routineResult;
+            result = routines.getStatus(rid, state, progress, routineResult);
+            resp.push_back(uint8_t(state));
+            if (state == RoutineState::RUNNING)
+            {
+                resp.push_back(progress);
+            }
+            else if (state == RoutineState::COMPLETED)
+            {
+                resp.insert(resp.end(), routineResult.cbegin(), routineResult.cend());
+            }
+            break;
         }
+        default:
+            sendNegativeResponse(ROUTINE_CONTROL_REQ, SUBFUNCTION_NOT_SUPPORTED);
+            return;
+    }
+
+    switch (result)
+    {
+        case RoutineResult::OK:
+            sendResponse(resp.data(), resp.size());
+            break;
+        case RoutineResult::UNKNOWN_ROUTINE:
+            sendNegativeResponse(ROUTINE_CONTROL_REQ, REQUEST_OUT_OF_RANGE);
+            break;
+        default: // started twice, or stopped / polled before being started
+            sendNegativeResponse(ROUTINE_CONTROL_REQ, REQUEST_SEQUENCE_ERROR);
+            break;
     }
-    return a;
+}
+
+/**
+ * Handles the UDS `ECUReset` request. The positive response is sent first,
+ * then the ECU returns to the default session and resets its volatile state
+ * without reloading the Lua script. The ECU is silent for the configured
+ * `RebootTime` afterwards. All supported reset types behave the same.
+ *
+ * @param request: the UDS request (2 bytes)
+ * @see EcuLuaScript::reset()
+ */
+void UdsReceiver::ecuReset(const UdsRequest& request) noexcept
+{
+    assert(pSessionCtrl_ != nullptr);
+
+    static metrics::Histogram& resetTime = metrics::histogram("uds.ecu_reset_time_us");
+
+    if (request.size() != 2)
+    {
+        sendNegativeResponse(ECU_RESET_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+
+    const uint8_t resetType = request[1];
+    if (resetType != HARD_RESET && resetType != KEY_OFF_ON_RESET && resetType != SOFT_RESET)
+    {
+        sendNegativeResponse(ECU_RESET_REQ, SUBFUNCTION_NOT_SUPPORTED);
+        return;
+    }
+
+    const array<uint8_t, 2> resp = {ECU_RESET_RES, resetType};
+    sendResponse(resp.data(), resp.size());
+
+    const auto start = chrono::steady_clock::now();
+    pSessionCtrl_->setCurrentUdsSession(UdsSession::DEFAULT);
+    script().reset();
+    resetTime.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * Handles the UDS `CommunicationControl` request. Disabling the transmission
+ * of normal messages silences the cyclic J1939 messages of the ECU, e.g.
+ * during a flash sequence (`28 03 01`). The diagnostic communication is not
+ * affected. Only available in a non-default session.
+ *
+ * @param request: the UDS request (min. 3 bytes)
+ */
+void UdsReceiver::communicationControl(const UdsRequest& request) noexcept
+{
+    assert(pSessionCtrl_ != nullptr);
+
+    if (request.size() < 3)
+    {
+        sendNegativeResponse(COMMUNICATION_CONTROL_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+    if (pSessionCtrl_->getCurrentUdsSession() == UdsSession::DEFAULT)
+    {
+        sendNegativeResponse(COMMUNICATION_CONTROL_REQ, SERVICE_NOT_SUPPORTED_IN_ACTIVE_SESSION);
+        return;
+    }
+
+    const uint8_t controlType = request[1];
+    if (controlType > DISABLE_RX_AND_TX)
+    {
+        sendNegativeResponse(COMMUNICATION_CONTROL_REQ, SUBFUNCTION_NOT_SUPPORTED);
+        return;
+    }
+    if (!pCommCtrl_->control(controlType, request[2]))
+    {
+        sendNegativeResponse(COMMUNICATION_CONTROL_REQ, REQUEST_OUT_OF_RANGE);
+        return;
+    }
+
+    const array<uint8_t, 2> resp = {COMMUNICATION_CONTROL_RES, controlType};
+    sendResponse(resp.data(), resp.size());
+}
+
+/**
+ * Handles the UDS `ControlDTCSetting` request. While the DTC setting is off,
+ * the Lua function `setDTCStatus()` has no effect. An optional
+ * `DTCSettingControlOptionRecord` is ignored. Only available in a non-default
+ * session.
+ *
+ * @param request: the UDS request (min. 2 bytes)
+ */
+void UdsReceiver::controlDtcSetting(const UdsRequest& request) noexcept
+{
+    assert(pSessionCtrl_ != nullptr);
+
+    if (request.size() < 2)
+    {
+        sendNegativeResponse(CONTROL_DTC_SETTINGS_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT);
+        return;
+    }
+    if (pSessionCtrl_->getCurrentUdsSession() == UdsSession::DEFAULT)
+    {
+        sendNegativeResponse(CONTROL_DTC_SETTINGS_REQ, SERVICE_NOT_SUPPORTED_IN_ACTIVE_SESSION);
+        return;
+    }
+
+    const uint8_t settingType = request[1];
+    if (settingType != DTC_SETTING_ON && settingType != DTC_SETTING_OFF)
+    {
+        sendNegativeResponse(CONTROL_DTC_SETTINGS_REQ, SUBFUNCTION_NOT_SUPPORTED);
+        return;
+    }
+    pCommCtrl_->setDtcSettingEnabled(settingType == DTC_SETTING_ON);
+
+    const array<uint8_t, 2> resp = {CONTROL_DTC_SETTINGS_RES, settingType};
+    sendResponse(resp.data(), resp.size());
+}
+
+/**
+ * Sends a negative response message (`7F <SID> <NRC>`).
+ *
+ * @param sid: the service identifier of the rejected request
+ * @param nrc: the negative response code (e.g. `REQUEST_OUT_OF_RANGE`)
+ */
+void UdsReceiver::sendNegativeResponse(uint8_t sid, uint8_t nrc) const noexcept
+{
+    const array<uint8_t, 3> resp = {ERROR, sid, nrc};
+    sendResponse(resp.data(), resp.size());
+}
+
+/**
+ * Sends the final response of the request in progress. The `ResponsePending`
+ * watchdog is stopped before, so no `7F <SID> 78` can follow the response.
+ * Positive responses to requests with the suppressPosRspMsgIndicationBit and
+ * the suppressed negative responses to functional requests are dropped, unless
+ * a `ResponsePending` has already been sent.
+ *
+ * @param buffer: the response message
+ * @param size: the length of the response in bytes
+ */
+void UdsReceiver::sendResponse(const void* buffer, size_t size) const noexcept
+{
+    static metrics::Counter& numSuppressed = metrics::counter("uds.positive_responses_suppressed");
+
+    const bool wasPending = disarmResponsePending(pPendingResponse);
+    if (isPosRspSuppressed
+        && !wasPending
+        && size > 0
+        && static_cast<const uint8_t*> (buffer)[0] != ERROR)
+    {
+        numSuppressed.increment();
+        return;
+    }
+    if (isFunctionalNrcSuppressed(buffer, size, wasPending))
+    {
+        return;
+    }
+    transmit(buffer, size);
+}
+
+/**
+ * Hands a response over to the ISO-TP sender, or to the capture buffer of
+ * `evaluate()`.
+ *
+ * @param buffer: the response message
+ * @param size: the length of the response in bytes
+ */
+void UdsReceiver::transmit(const void* buffer, size_t size) const noexcept
+{
+    if (pCapturedResponses != nullptr)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*> (buffer);
+        pCapturedResponses->emplace_back(bytes, bytes + size);
+        return;
+    }
+    pIsoTpSender_->sendData(buffer, size);
+}
+
+/**
+ * Gets the version of the Lua script, which the request in progress is
+ * handled with. Only valid within `proceedReceivedData()`.
+ *
+ * @return the script of the request in progress
+ */
+EcuLuaScript& UdsReceiver::script() const noexcept
+{
+    assert(pActiveScript != nullptr);
+    return *pActiveScript;
 }
 
 /**
@@ -321,7 +1020,5 @@ string UdsReceiver::intToHexString(const uint8_t* buffer, const size_t num_bytes
  */
 uint16_t UdsReceiver::generateSeed()
 {
-    default_random_engine gen(RANDOM_DEVICE());
-    uniform_int_distribution<uint16_t> dist(0, numeric_limits<uint16_t>::max());
-    return dist(gen);
+    return uint16_t(utils::fastRandom());
 }
\ No newline at end of file
@@ -9,8 +9,14 @@
 #include "isotp_receiver.h"
 #include "isotp_sender.h"
 #include "ecu_lua_script.h"
+#include "script_slot.h"
 #include "session_controller.h"
+#include "timer_service.h"
+#include "uds_request.h"
 #include <memory>
+#include <array>
+#include <mutex>
+#include <vector>
 
 class UdsReceiver : public IsoTpReceiver
 {
@@ -24,6 +30,12 @@ public:
                 EcuLuaScript *pEcuScript,
                 IsoTpSender* pSender,
                 SessionController* pSesCtrl);
+    UdsReceiver(canid_t source,
+                canid_t dest,
+                const std::string& device,
+                std::shared_ptr<ScriptSlot> pScriptSlot,
+                IsoTpSender* pSender,
+                SessionController* pSesCtrl);
     UdsReceiver(const UdsReceiver& orig) = default;
     UdsReceiver& operator =(const UdsReceiver& orig) = default;
     UdsReceiver(UdsReceiver&& orig) noexcept;
@@ -32,18 +44,40 @@ public:
 
     static std::uint16_t generateSeed();
     virtual void proceedReceivedData(const uint8_t* buffer, const size_t num_bytes) noexcept override;
+    std::vector<std::vector<std::uint8_t>> evaluate(const std::uint8_t* buffer,
+                                                    const std::size_t num_bytes,
+                                                    bool isFunctional = false) noexcept;
 
 private:
-    EcuLuaScript *pEcuScript_;
+    std::shared_ptr<ScriptSlot> pScriptSlot_;
+    CommunicationControl* pCommCtrl_ = nullptr;
     IsoTpSender* pIsoTpSender_ = nullptr;
     SessionController* pSessionCtrl_ = nullptr;
-    std::uint8_t securityAccessType_ = 0x00;
 
-    void readDataByIdentifier(const std::uint8_t* buffer, const std::size_t num_bytes) noexcept;
-    void diagnosticSessionControl(const std::uint8_t* buffer, const std::size_t num_bytes);
-    void securityAccess(const std::uint8_t* buffer, const std::size_t num_bytes) noexcept;
+    /// Native handler of a service, indexed by the SID.
+    struct Service
+    {
+        void (UdsReceiver::*handler)(const UdsRequest& request) = nullptr;
+        bool isSessionRefresh = true; ///< the request keeps a non-default session alive
+    };
+
+    static constexpr std::array<Service, 256> makeServiceTable() noexcept;
 
-    std::string intToHexString(const uint8_t* buffer, const std::size_t num_bytes);
+    EcuLuaScript& script() const noexcept;
+    void readDataByIdentifier(const UdsRequest& request) noexcept;
+    void writeDataByIdentifier(const UdsRequest& request) noexcept;
+    void diagnosticSessionControl(const UdsRequest& request);
+    void ecuReset(const UdsRequest& request) noexcept;
+    void securityAccess(const UdsRequest& request) noexcept;
+    void readDtcInformation(const UdsRequest& request) noexcept;
+    void clearDiagnosticInformation(const UdsRequest& request) noexcept;
+    void routineControl(const UdsRequest& request) noexcept;
+    void communicationControl(const UdsRequest& request) noexcept;
+    void controlDtcSetting(const UdsRequest& request) noexcept;
+    void sendNegativeResponse(std::uint8_t sid, std::uint8_t nrc) const noexcept;
+    void testerPresent(const UdsRequest& request) noexcept;
+    void sendResponse(const void* buffer, std::size_t size) const noexcept;
+    void transmit(const void* buffer, std::size_t size) const noexcept;
 };
 
 #endif /* UDS_RECEIVER_H */
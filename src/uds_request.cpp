@@ -0,0 +1,36 @@
+/**
+ * @file uds_request.cpp
+ *
+ * This file contains the view of a received UDS request.
+ */
+
+#include "uds_request.h"
+
+using namespace std;
+
+/**
+ * Returns the request as literal hex string (e.g. "22 F1 90"), which is the
+ * format of the keys in the `Raw` table. The SPRMIB is masked out of the
+ * sub-function.
+ *
+ * @return the upper case hex bytes separated by blanks
+ */
+string UdsRequest::toHexString() const
+{
+    static constexpr char DIGITS[] = "0123456789ABCDEF";
+
+    string hex;
+    if (size_ == 0)
+    {
+        return hex;
+    }
+
+    hex.resize(size_ * 3 - 1, ' ');
+    for (size_t i = 0; i < size_; ++i)
+    {
+        const uint8_t byte = (*this)[i];
+        hex[i * 3] = DIGITS[byte >> 4];
+        hex[i * 3 + 1] = DIGITS[byte & 0x0F];
+    }
+    return hex;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file uds_request.h
+ *
+ */
+
+#ifndef UDS_REQUEST_H
+#define UDS_REQUEST_H
+
+#include "service_identifier.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * Non-owning view of a received UDS request. The suppressPosRspMsgIndicationBit
+ * is masked out of the sub-function byte on access, so the handlers work on
+ * the receive buffer directly instead of a copy. The literal hex string, which
+ * is needed for the Lua tables only, is built on demand.
+ */
+class UdsRequest
+{
+public:
+    UdsRequest() = delete;
+    constexpr UdsRequest(const std::uint8_t* buffer, std::size_t num_bytes) noexcept
+    : buffer_(buffer)
+    , size_(num_bytes)
+    {
+    }
+    UdsRequest(const UdsRequest& orig) = default;
+    UdsRequest& operator =(const UdsRequest& orig) = default;
+    ~UdsRequest() = default;
+
+    /// the service identifier
+    constexpr std::uint8_t sid() const noexcept { return buffer_[0]; };
+    /// the number of bytes including the SID
+    constexpr std::size_t size() const noexcept { return size_; };
+    /// the unmodified request bytes
+    constexpr const std::uint8_t* data() const noexcept { return buffer_; };
+    /// the bytes behind the SID
+    constexpr const std::uint8_t* payload() const noexcept { return buffer_ + 1; };
+    constexpr std::size_t payloadSize() const noexcept { return (size_ > 0) ? size_ - 1 : 0; };
+
+    /// true if the sub-function carries the suppressPosRspMsgIndicationBit
+    constexpr bool isPosRspSuppressed() const noexcept
+    {
+        return size_ >= 2
+            && hasSuppressPosRspBit(buffer_[0])
+            && (buffer_[1] & SUPPRESS_POS_RSP_MSG_INDICATION_BIT);
+    };
+
+    /// the sub-function without the SPRMIB (requires at least 2 bytes)
+    constexpr std::uint8_t subFunction() const noexcept
+    {
+        return isPosRspSuppressed() ? (buffer_[1] & ~SUPPRESS_POS_RSP_MSG_INDICATION_BIT) : buffer_[1];
+    };
+
+    /// the byte at `pos`, with the SPRMIB masked out of the sub-function
+    constexpr std::uint8_t operator[](std::size_t pos) const noexcept
+    {
+        return (pos == 1) ? subFunction() : buffer_[pos];
+    };
+
+    std::string toHexString() const;
+
+private:
+    const std::uint8_t* buffer_;
+    std::size_t size_;
+};
+
+#endif /* UDS_REQUEST_H */
@@ -7,9 +7,17 @@
 
 #include "utilities.h"
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <dirent.h>
+#include <unistd.h>
 #include <iostream>
+#include <fstream>
 #include <cstring>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdio>
+#include <random>
 
 using namespace std;
 
@@ -98,3 +106,105 @@ vector<string> utils::getConfigFilenames(const string &config_dir) noexcept
 
     return filenames;
 }
+
+/**
+ * Returns a pseudo random number of a per-thread xorshift64* generator. Only
+ * the first call of each thread reads from `std::random_device` to seed the
+ * generator, so this is cheap enough for every seed of `SecurityAccess`. The
+ * numbers are not suitable for cryptographic purposes.
+ *
+ * @return a pseudo random 64 bit number
+ */
+uint64_t utils::fastRandom() noexcept
+{
+    thread_local uint64_t state = []()
+    {
+        random_device rd;
+        const uint64_t seed = (uint64_t(rd()) << 32) | rd();
+        return (seed != 0) ? seed : 0x9E3779B97F4A7C15ull;
+    }();
+
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Writes a file, which either appears with its complete content or not at
+ * all. The content is written to a temporary file, which is renamed
+ * afterwards, so a process polling for the file never reads it partially.
+ *
+ * @param path: the path to the file
+ * @param content: the content of the file
+ * @return true on success, otherwise false
+ */
+bool utils::writeFileAtomically(const string& path, const string& content) noexcept
+{
+    const string tmpPath = path + ".tmp";
+    {
+        ofstream file(tmpPath, ios::trunc);
+        file << content;
+        if (!file.flush())
+        {
+            cerr << __func__ << "() cannot write " << tmpPath << endl;
+            return false;
+        }
+    }
+    if (rename(tmpPath.c_str(), path.c_str()) < 0)
+    {
+        cerr << __func__ << "() rename " << tmpPath << ": " << strerror(errno) << endl;
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Sends a state notification (e.g. "READY=1") to the service manager, if the
+ * simulator has been started by one. The protocol is the one of systemd's
+ * `sd_notify()`: a datagram to the unix socket given by `NOTIFY_SOCKET`, a
+ * leading '@' denotes the abstract namespace.
+ *
+ * @param state: the newline separated state assignments
+ * @return true if the notification has been sent, otherwise false
+ */
+bool utils::notifyServiceManager(const string& state) noexcept
+{
+    const char* socketPath = getenv("NOTIFY_SOCKET");
+    if (socketPath == nullptr || socketPath[0] == '\0')
+    {
+        return false;
+    }
+
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    const size_t len = strlen(socketPath);
+    if (len >= sizeof(addr.sun_path))
+    {
+        cerr << __func__ << "() NOTIFY_SOCKET is too long" << endl;
+        return false;
+    }
+    memcpy(addr.sun_path, socketPath, len);
+    if (addr.sun_path[0] == '@')
+    {
+        addr.sun_path[0] = '\0';
+    }
+
+    const int skt = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (skt < 0)
+    {
+        cerr << __func__ << "() socket: " << strerror(errno) << endl;
+        return false;
+    }
+    const ssize_t sent = sendto(skt, state.data(), state.size(), MSG_NOSIGNAL,
+                                reinterpret_cast<const struct sockaddr*> (&addr),
+                                socklen_t(offsetof(struct sockaddr_un, sun_path) + len));
+    close(skt);
+    if (sent != ssize_t(state.size()))
+    {
+        cerr << __func__ << "() sendto: " << strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
@@ -8,12 +8,16 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 namespace utils {
   bool existsFile(const std::string& filepath) noexcept;
   bool existsDirectory(const std::string& dirpath) noexcept;
   bool endsWith(const std::string &s, const std::string &end) noexcept;
   std::vector<std::string> getConfigFilenames(const std::string &config_dir) noexcept;
+  std::uint64_t fastRandom() noexcept;
+  bool writeFileAtomically(const std::string& path, const std::string& content) noexcept;
+  bool notifyServiceManager(const std::string& state) noexcept;
 }
 
 #endif /* UTILITIES_H */
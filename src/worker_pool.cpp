@@ -0,0 +1,118 @@
+/**
+ * @file worker_pool.cpp
+ *
+ * This file contains the pool of worker threads for long running jobs.
+ */
+
+#include "worker_pool.h"
+#include <iostream>
+#include <exception>
+#include <algorithm>
+
+using namespace std;
+
+/// Min. number of workers of the process wide pool.
+static constexpr size_t MIN_NUM_WORKERS = 4;
+
+/**
+ * Constructor. Starts the worker threads.
+ *
+ * @param numThreads: the number of worker threads
+ * @param maxThreads: the number of worker threads the pool grows to, if a job
+ * is submitted while all workers are busy, 0 for a fixed size pool
+ */
+WorkerPool::WorkerPool(size_t numThreads, size_t maxThreads)
+: maxThreads_(max(numThreads, maxThreads))
+{
+    workers_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        workers_.emplace_back(&WorkerPool::run, this);
+    }
+}
+
+/**
+ * Destructor. Runs the queued jobs and waits for them, since the callers rely
+ * on the side effects of their jobs (e.g. a job counter or a caller waiting
+ * for the result).
+ */
+WorkerPool::~WorkerPool()
+{
+    {
+        const lock_guard<mutex> lock(mutex_);
+        isOnExit_ = true;
+    }
+    cond_.notify_all();
+    for (thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * Returns the process wide worker pool, which is started on the first call.
+ * It has one worker per CPU core, but at least `MIN_NUM_WORKERS`. Jobs, which
+ * block for a long time (e.g. routines), belong into their own pool.
+ */
+WorkerPool& WorkerPool::instance()
+{
+    static WorkerPool pool(max(size_t(thread::hardware_concurrency()), MIN_NUM_WORKERS));
+    return pool;
+}
+
+/**
+ * Queues a job for the next idle worker. A growing pool starts another worker,
+ * if all workers are busy.
+ *
+ * @param job: the function to execute
+ */
+void WorkerPool::submit(Job job)
+{
+    {
+        const lock_guard<mutex> lock(mutex_);
+        jobs_.push_back(move(job));
+        if (jobs_.size() > numIdle_ && workers_.size() < maxThreads_ && !isOnExit_)
+        {
+            workers_.emplace_back(&WorkerPool::run, this);
+        }
+    }
+    cond_.notify_one();
+}
+
+/**
+ * Returns the number of worker threads.
+ */
+size_t WorkerPool::numThreads() const
+{
+    const lock_guard<mutex> lock(mutex_);
+    return workers_.size();
+}
+
+void WorkerPool::run()
+{
+    while (true)
+    {
+        Job job;
+        {
+            unique_lock<mutex> lock(mutex_);
+            ++numIdle_;
+            cond_.wait(lock, [this] { return isOnExit_ || !jobs_.empty(); });
+            --numIdle_;
+            if (jobs_.empty())
+            {
+                return; // on exit, after the queue has been drained
+            }
+            job = move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        try
+        {
+            job();
+        }
+        catch (const exception& e)
+        {
+            cerr << __func__ << "() job failed: " << e.what() << '\n';
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * @file worker_pool.h
+ *
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/**
+ * Pool of worker threads for jobs, which must not block the receiver thread
+ * of an ECU. The pool either has a fixed size, or grows up to `maxThreads`
+ * while all workers are busy, so long running jobs (e.g. routines of
+ * `RoutineControl`) do not wait in the queue.
+ */
+class WorkerPool
+{
+public:
+    using Job = std::function<void()>;
+
+    WorkerPool() = delete;
+    explicit WorkerPool(std::size_t numThreads, std::size_t maxThreads = 0);
+    WorkerPool(const WorkerPool& orig) = delete;
+    WorkerPool& operator =(const WorkerPool& orig) = delete;
+    WorkerPool(WorkerPool&& orig) = delete;
+    WorkerPool& operator =(WorkerPool&& orig) = delete;
+    virtual ~WorkerPool();
+
+    static WorkerPool& instance();
+
+    void submit(Job job);
+    std::size_t numThreads() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<Job> jobs_;
+    bool isOnExit_ = false;
+    std::size_t maxThreads_;
+    std::size_t numIdle_ = 0;
+    std::vector<std::thread> workers_;
+
+    void run();
+};
+
+#endif /* WORKER_POOL_H */
@@ -0,0 +1,114 @@
+/**
+ * @file communication_control_test.cpp
+ *
+ * Unit test for the communication state of `CommunicationControl` and
+ * `ControlDTCSetting`.
+ */
+
+#include "communication_control_test.h"
+#include "communication_control.h"
+#include <unistd.h>
+
+using namespace std;
+using std::chrono::milliseconds;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CommunicationControlTest);
+
+void CommunicationControlTest::setUp() { }
+
+void CommunicationControlTest::tearDown() { }
+
+void CommunicationControlTest::testControl()
+{
+    CommunicationControl commCtrl;
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled());
+    CPPUNIT_ASSERT(commCtrl.isRxEnabled());
+
+    // `28 03 01` as sent before a download
+    CPPUNIT_ASSERT(commCtrl.control(DISABLE_RX_AND_TX, NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(!commCtrl.isTxEnabled());
+    CPPUNIT_ASSERT(!commCtrl.isRxEnabled());
+
+    CPPUNIT_ASSERT(commCtrl.control(DISABLE_RX_AND_ENABLE_TX, NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled());
+    CPPUNIT_ASSERT(!commCtrl.isRxEnabled());
+
+    CPPUNIT_ASSERT(commCtrl.control(ENABLE_RX_AND_DISABLE_TX, NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(!commCtrl.isTxEnabled());
+    CPPUNIT_ASSERT(commCtrl.isRxEnabled());
+
+    CPPUNIT_ASSERT(commCtrl.control(ENABLE_RX_AND_TX, NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled());
+    CPPUNIT_ASSERT(commCtrl.isRxEnabled());
+
+    // enhanced address information is not supported
+    CPPUNIT_ASSERT(!commCtrl.control(0x04, NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled());
+}
+
+void CommunicationControlTest::testCommunicationTypes()
+{
+    CommunicationControl commCtrl;
+    CPPUNIT_ASSERT(!commCtrl.control(DISABLE_RX_AND_TX, 0x00));
+    CPPUNIT_ASSERT(!commCtrl.control(DISABLE_RX_AND_TX, 0xF0));
+
+    CPPUNIT_ASSERT(commCtrl.control(DISABLE_RX_AND_TX, NETWORK_MANAGEMENT_COMMUNICATION));
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled(NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(!commCtrl.isTxEnabled(NETWORK_MANAGEMENT_COMMUNICATION));
+
+    // both types, the subnet number is ignored
+    CPPUNIT_ASSERT(commCtrl.control(ENABLE_RX_AND_DISABLE_TX, 0xF3));
+    CPPUNIT_ASSERT(!commCtrl.isTxEnabled(NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(!commCtrl.isTxEnabled(NETWORK_MANAGEMENT_COMMUNICATION));
+    CPPUNIT_ASSERT(commCtrl.isRxEnabled(NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(commCtrl.isRxEnabled(NETWORK_MANAGEMENT_COMMUNICATION));
+
+    commCtrl.reset();
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled(NORMAL_COMMUNICATION | NETWORK_MANAGEMENT_COMMUNICATION));
+    CPPUNIT_ASSERT(commCtrl.isRxEnabled(NORMAL_COMMUNICATION | NETWORK_MANAGEMENT_COMMUNICATION));
+}
+
+void CommunicationControlTest::testDtcSetting()
+{
+    CommunicationControl commCtrl;
+    CPPUNIT_ASSERT(commCtrl.isDtcSettingEnabled());
+
+    commCtrl.setDtcSettingEnabled(false);
+    CPPUNIT_ASSERT(!commCtrl.isDtcSettingEnabled());
+
+    // independent of the communication flags
+    CPPUNIT_ASSERT(commCtrl.control(ENABLE_RX_AND_TX, NORMAL_COMMUNICATION));
+    CPPUNIT_ASSERT(!commCtrl.isDtcSettingEnabled());
+    CPPUNIT_ASSERT(commCtrl.control(DISABLE_RX_AND_TX, NORMAL_COMMUNICATION));
+    commCtrl.setDtcSettingEnabled(true);
+    CPPUNIT_ASSERT(commCtrl.isDtcSettingEnabled());
+    CPPUNIT_ASSERT(!commCtrl.isTxEnabled());
+
+    commCtrl.setDtcSettingEnabled(false);
+    commCtrl.reset();
+    CPPUNIT_ASSERT(commCtrl.isDtcSettingEnabled());
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled());
+}
+
+void CommunicationControlTest::testSuspend()
+{
+    CommunicationControl commCtrl;
+    CPPUNIT_ASSERT(!commCtrl.isSuspended());
+
+    commCtrl.suspend(milliseconds(50));
+    CPPUNIT_ASSERT(commCtrl.isSuspended());
+    CPPUNIT_ASSERT(!commCtrl.isTxEnabled());
+    CPPUNIT_ASSERT(!commCtrl.isRxEnabled());
+
+    // a reset of the communication state does not end the reboot
+    commCtrl.reset();
+    CPPUNIT_ASSERT(commCtrl.isSuspended());
+
+    usleep(60000);
+    CPPUNIT_ASSERT(!commCtrl.isSuspended());
+    CPPUNIT_ASSERT(commCtrl.isTxEnabled());
+    CPPUNIT_ASSERT(commCtrl.isRxEnabled());
+
+    commCtrl.suspend(milliseconds(0));
+    CPPUNIT_ASSERT(!commCtrl.isSuspended());
+}
@@ -0,0 +1,36 @@
+/**
+ * @file communication_control_test.h
+ *
+ */
+
+#ifndef COMMUNICATION_CONTROL_TEST_H
+#define COMMUNICATION_CONTROL_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CommunicationControlTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(CommunicationControlTest);
+
+    CPPUNIT_TEST(testControl);
+    CPPUNIT_TEST(testCommunicationTypes);
+    CPPUNIT_TEST(testDtcSetting);
+    CPPUNIT_TEST(testSuspend);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    CommunicationControlTest() = default;
+    virtual ~CommunicationControlTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testControl();
+    void testCommunicationTypes();
+    void testDtcSetting();
+    void testSuspend();
+
+};
+
+#endif /* COMMUNICATION_CONTROL_TEST_H */
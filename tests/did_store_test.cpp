@@ -0,0 +1,166 @@
+/**
+ * @file did_store_test.cpp
+ *
+ * Unit test for the persistent DID store.
+ */
+
+#include "did_store_test.h"
+#include "did_store.h"
+#include "metrics.h"
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <csignal>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DidStoreTest);
+
+static const vector<uint8_t> VIN = {'W', 'V', 'W', 'Z', 'Z', 'Z', '1', 'K', 'Z', 'A', 'W', '0', '0', '0', '0', '0', '1'};
+
+static void defineDids(DidStore& store)
+{
+    store.define(0xF190, DidType::ASCII, VIN.size(), VIN);
+    store.define(0x0102, DidType::UINT, 2, {0x12, 0x34});
+    store.define(0x0103, DidType::BYTES, 0, {0x00, 0x11, 0x22});
+}
+
+void DidStoreTest::setUp()
+{
+    journal_ = "/tmp/did_store_test_" + to_string(getpid()) + ".dids";
+    unlink(journal_.c_str());
+}
+
+void DidStoreTest::tearDown()
+{
+    unlink(journal_.c_str());
+}
+
+void DidStoreTest::testReadDefaults()
+{
+    DidStore store;
+    defineDids(store);
+
+    vector<uint8_t> out = {0x62, 0xF1, 0x90};
+    CPPUNIT_ASSERT(store.read(0xF190, out));
+    CPPUNIT_ASSERT_EQUAL(VIN.size() + 3, out.size());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x62), out[0]);
+    CPPUNIT_ASSERT_EQUAL(uint8_t('W'), out[3]);
+
+    out.clear();
+    CPPUNIT_ASSERT(!store.read(0x4711, out));
+    CPPUNIT_ASSERT(out.empty());
+    CPPUNIT_ASSERT(store.has(0x0103));
+    CPPUNIT_ASSERT(!store.has(0x4711));
+}
+
+void DidStoreTest::testWriteValidation()
+{
+    DidStore store;
+    defineDids(store);
+
+    const uint8_t shortVin[] = {'A', 'B', 'C'};
+    CPPUNIT_ASSERT(store.write(0xF190, shortVin, sizeof(shortVin)) == DidWriteResult::INVALID_LENGTH);
+
+    vector<uint8_t> badVin = VIN;
+    badVin[4] = 0x07;
+    CPPUNIT_ASSERT(store.write(0xF190, badVin.data(), badVin.size()) == DidWriteResult::INVALID_VALUE);
+    CPPUNIT_ASSERT(store.write(0x4711, shortVin, sizeof(shortVin)) == DidWriteResult::UNKNOWN_IDENTIFIER);
+
+    // variable length
+    const uint8_t bytes[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x00};
+    CPPUNIT_ASSERT(store.write(0x0103, bytes, sizeof(bytes)) == DidWriteResult::OK);
+    vector<uint8_t> out;
+    CPPUNIT_ASSERT(store.read(0x0103, out));
+    CPPUNIT_ASSERT(out == vector<uint8_t>(bytes, bytes + sizeof(bytes)));
+}
+
+void DidStoreTest::testReplay()
+{
+    const uint8_t number[] = {0xAB, 0xCD};
+    const uint8_t bytes[] = {0x01};
+    {
+        DidStore store;
+        defineDids(store);
+        CPPUNIT_ASSERT_EQUAL(0, store.open(journal_));
+        CPPUNIT_ASSERT(store.write(0x0102, number, sizeof(number)) == DidWriteResult::OK);
+        CPPUNIT_ASSERT(store.write(0x0103, bytes, sizeof(bytes)) == DidWriteResult::OK);
+    }
+
+    DidStore store;
+    defineDids(store);
+    CPPUNIT_ASSERT_EQUAL(0, store.open(journal_));
+
+    vector<uint8_t> out;
+    CPPUNIT_ASSERT(store.read(0x0102, out));
+    CPPUNIT_ASSERT(out == vector<uint8_t>(number, number + sizeof(number)));
+    out.clear();
+    CPPUNIT_ASSERT(store.read(0x0103, out));
+    CPPUNIT_ASSERT(out == vector<uint8_t>(bytes, bytes + sizeof(bytes)));
+    out.clear();
+    CPPUNIT_ASSERT(store.read(0xF190, out));
+    CPPUNIT_ASSERT(out == VIN);
+}
+
+void DidStoreTest::testCompaction()
+{
+    struct stat sb;
+    uint8_t number[2];
+    {
+        DidStore store;
+        defineDids(store);
+        CPPUNIT_ASSERT_EQUAL(0, store.open(journal_));
+        for (unsigned i = 0; i < 50000; ++i)
+        {
+            number[0] = uint8_t(i >> 8);
+            number[1] = uint8_t(i);
+            CPPUNIT_ASSERT(store.write(0x0102, number, sizeof(number)) == DidWriteResult::OK);
+        }
+        store.compact();
+        CPPUNIT_ASSERT_EQUAL(0, stat(journal_.c_str(), &sb));
+        CPPUNIT_ASSERT(sb.st_size <= 64 * 1024);
+    }
+
+    DidStore store;
+    defineDids(store);
+    CPPUNIT_ASSERT_EQUAL(0, store.open(journal_));
+    vector<uint8_t> out;
+    CPPUNIT_ASSERT(store.read(0x0102, out));
+    CPPUNIT_ASSERT(out == vector<uint8_t>(number, number + sizeof(number)));
+}
+
+/**
+ * A value, which does not fit into the journal, is rejected and leaves the
+ * stored value unchanged. The journal is kept from growing by the file size
+ * limit of the process.
+ */
+void DidStoreTest::testJournalFailure()
+{
+    static metrics::Counter& numFailures = metrics::counter("did.journal_failures");
+    DidStore store;
+    defineDids(store);
+    CPPUNIT_ASSERT_EQUAL(0, store.open(journal_));
+
+    struct rlimit limit;
+    CPPUNIT_ASSERT_EQUAL(0, getrlimit(RLIMIT_FSIZE, &limit));
+    const struct rlimit small = {64 * 1024, limit.rlim_max};
+    const auto prevHandler = signal(SIGXFSZ, SIG_IGN);
+    CPPUNIT_ASSERT_EQUAL(0, setrlimit(RLIMIT_FSIZE, &small));
+
+    const uint64_t failuresBefore = numFailures.value();
+    const vector<uint8_t> large(0xFFFF, 0x55);
+    const DidWriteResult result = store.write(0x0103, large.data(), large.size());
+
+    setrlimit(RLIMIT_FSIZE, &limit);
+    signal(SIGXFSZ, prevHandler);
+
+    CPPUNIT_ASSERT(result == DidWriteResult::JOURNAL_FAILED);
+    CPPUNIT_ASSERT_EQUAL(failuresBefore + 1, numFailures.value());
+    vector<uint8_t> out;
+    CPPUNIT_ASSERT(store.read(0x0103, out));
+    CPPUNIT_ASSERT((out == vector<uint8_t>{0x00, 0x11, 0x22}));
+
+    // the journal keeps working once it can grow again
+    CPPUNIT_ASSERT(store.write(0x0103, large.data(), large.size()) == DidWriteResult::OK);
+}
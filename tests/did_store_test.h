@@ -0,0 +1,41 @@
+/**
+ * @file did_store_test.h
+ *
+ */
+
+#ifndef DID_STORE_TEST_H
+#define DID_STORE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+class DidStoreTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(DidStoreTest);
+
+    CPPUNIT_TEST(testReadDefaults);
+    CPPUNIT_TEST(testWriteValidation);
+    CPPUNIT_TEST(testReplay);
+    CPPUNIT_TEST(testCompaction);
+    CPPUNIT_TEST(testJournalFailure);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    DidStoreTest() = default;
+    virtual ~DidStoreTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    std::string journal_;
+
+    void testReadDefaults();
+    void testWriteValidation();
+    void testReplay();
+    void testCompaction();
+    void testJournalFailure();
+
+};
+
+#endif /* DID_STORE_TEST_H */
@@ -0,0 +1,165 @@
+/**
+ * @file dtc_store_test.cpp
+ *
+ * Unit test for the native DTC store.
+ */
+
+#include "dtc_store_test.h"
+#include "dtc_store.h"
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DtcStoreTest);
+
+void DtcStoreTest::setUp() { }
+
+void DtcStoreTest::tearDown() { }
+
+void DtcStoreTest::testAddAndGetStatus()
+{
+    DtcStore store;
+    store.add(0xC01234, 0x2F);
+    store.add(0xD10000, 0x08);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), store.size());
+    CPPUNIT_ASSERT_EQUAL(0x2F, store.getStatus(0xC01234));
+    CPPUNIT_ASSERT_EQUAL(0x08, store.getStatus(0xD10000));
+    CPPUNIT_ASSERT_EQUAL(-1, store.getStatus(0x123456));
+
+    // update of a known DTC must not add a new entry
+    store.setStatus(0xC01234, 0x01);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), store.size());
+    CPPUNIT_ASSERT_EQUAL(0x01, store.getStatus(0xC01234));
+
+    // unknown DTCs are added
+    store.setStatus(0x123456, 0x09);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), store.size());
+    CPPUNIT_ASSERT_EQUAL(true, store.contains(0x123456));
+}
+
+void DtcStoreTest::testCountByStatusMask()
+{
+    DtcStore store;
+    CPPUNIT_ASSERT_EQUAL(size_t(0), store.countByStatusMask(0xFF));
+
+    // more than one machine word of status bytes
+    for (uint32_t i = 0; i < 21; ++i)
+    {
+        store.add(0x100000 + i, (i % 3 == 0) ? 0x08 : 0x80);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(7), store.countByStatusMask(0x08));
+    CPPUNIT_ASSERT_EQUAL(size_t(14), store.countByStatusMask(0x80));
+    CPPUNIT_ASSERT_EQUAL(size_t(21), store.countByStatusMask(0x88));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), store.countByStatusMask(0x01));
+}
+
+void DtcStoreTest::testAppendByStatusMask()
+{
+    DtcStore store;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        store.add(0xA00000 + i, (i == 1 || i == 9) ? 0x2F : 0x00);
+    }
+
+    std::vector<uint8_t> resp;
+    store.appendByStatusMask(0x01, resp);
+    const std::vector<uint8_t> expected = {
+        0xA0, 0x00, 0x01, 0x2F,
+        0xA0, 0x00, 0x09, 0x2F
+    };
+    CPPUNIT_ASSERT(expected == resp);
+
+    resp.clear();
+    store.appendByStatusMask(0xFF, resp);
+    CPPUNIT_ASSERT_EQUAL(size_t(8), resp.size());
+    CPPUNIT_ASSERT_EQUAL(store.countByStatusMask(0xFF) * 4, resp.size());
+
+    // reportSupportedDTC lists the DTCs without any status bit as well
+    resp.clear();
+    store.appendAll(resp);
+    CPPUNIT_ASSERT_EQUAL(size_t(40), resp.size());
+}
+
+void DtcStoreTest::testAvailabilityMask()
+{
+    DtcStore store;
+    store.add(0xA00001, 0x2F);
+    store.setSnapshotRecord(0xA00001, 0x01, {0x12});
+    store.setStatusAvailabilityMask(0x09);
+
+    // unsupported status bits are never reported ...
+    std::vector<uint8_t> resp;
+    store.appendByStatusMask(0x01, resp);
+    CPPUNIT_ASSERT((resp == std::vector<uint8_t>{0xA0, 0x00, 0x01, 0x09}));
+
+    resp.clear();
+    store.appendAll(resp);
+    CPPUNIT_ASSERT((resp == std::vector<uint8_t>{0xA0, 0x00, 0x01, 0x09}));
+
+    resp.clear();
+    CPPUNIT_ASSERT(store.appendSnapshotRecords(0xA00001, 0x01, resp));
+    CPPUNIT_ASSERT((resp == std::vector<uint8_t>{0xA0, 0x00, 0x01, 0x09, 0x01, 0x12}));
+
+    // ... but kept in the store
+    CPPUNIT_ASSERT_EQUAL(0x2F, store.getStatus(0xA00001));
+}
+
+void DtcStoreTest::testRecords()
+{
+    DtcStore store;
+    store.add(0xC01234, 0x2F);
+    store.setSnapshotRecord(0xC01234, 0x01, {0x11, 0x22});
+    store.setSnapshotRecord(0xC01234, 0x02, {0x33});
+    store.setExtendedDataRecord(0xC01234, 0x01, {0x05});
+
+    std::vector<uint8_t> resp;
+    CPPUNIT_ASSERT_EQUAL(true, store.appendSnapshotRecords(0xC01234, 0x02, resp));
+    std::vector<uint8_t> expected = {0xC0, 0x12, 0x34, 0x2F, 0x02, 0x33};
+    CPPUNIT_ASSERT(expected == resp);
+
+    resp.clear();
+    CPPUNIT_ASSERT_EQUAL(true, store.appendSnapshotRecords(0xC01234, DTC_RECORD_ALL, resp));
+    expected = {0xC0, 0x12, 0x34, 0x2F, 0x01, 0x11, 0x22, 0x02, 0x33};
+    CPPUNIT_ASSERT(expected == resp);
+
+    resp.clear();
+    CPPUNIT_ASSERT_EQUAL(true, store.appendExtendedDataRecords(0xC01234, 0x01, resp));
+    expected = {0xC0, 0x12, 0x34, 0x2F, 0x01, 0x05};
+    CPPUNIT_ASSERT(expected == resp);
+
+    // these checks are supposed to fail
+    CPPUNIT_ASSERT_EQUAL(false, store.appendSnapshotRecords(0xC01234, 0x03, resp));
+    CPPUNIT_ASSERT_EQUAL(false, store.appendExtendedDataRecords(0x999999, 0x01, resp));
+}
+
+void DtcStoreTest::testClear()
+{
+    DtcStore store;
+    store.add(0xC01234, 0x2F);
+    store.add(0xD10000, 0x08);
+    store.setSnapshotRecord(0xC01234, 0x01, {0x11});
+
+    CPPUNIT_ASSERT_EQUAL(true, store.clear(0xD10000));
+    CPPUNIT_ASSERT_EQUAL(int(DTC_STATUS_AFTER_CLEAR), store.getStatus(0xD10000));
+    CPPUNIT_ASSERT_EQUAL(0x2F, store.getStatus(0xC01234));
+
+    CPPUNIT_ASSERT_EQUAL(true, store.clear(DTC_GROUP_ALL));
+    CPPUNIT_ASSERT_EQUAL(int(DTC_STATUS_AFTER_CLEAR), store.getStatus(0xC01234));
+    std::vector<uint8_t> resp;
+    CPPUNIT_ASSERT_EQUAL(false, store.appendSnapshotRecords(0xC01234, 0x01, resp));
+
+    // unknown DTC
+    CPPUNIT_ASSERT_EQUAL(false, store.clear(0x123456));
+}
+
+void DtcStoreTest::testOperationCycle()
+{
+    DtcStore store;
+    store.add(0xC01234, 0x2F);
+    store.add(0xD10000, 0x08);
+    store.setSnapshotRecord(0xC01234, 0x01, {0x11});
+
+    store.startOperationCycle();
+    CPPUNIT_ASSERT_EQUAL(0x6D, store.getStatus(0xC01234));
+    CPPUNIT_ASSERT_EQUAL(0x48, store.getStatus(0xD10000));
+    std::vector<uint8_t> resp;
+    CPPUNIT_ASSERT_EQUAL(true, store.appendSnapshotRecords(0xC01234, 0x01, resp));
+}
@@ -0,0 +1,42 @@
+/**
+ * @file dtc_store_test.h
+ *
+ */
+
+#ifndef DTC_STORE_TEST_H
+#define DTC_STORE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class DtcStoreTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(DtcStoreTest);
+
+    CPPUNIT_TEST(testAddAndGetStatus);
+    CPPUNIT_TEST(testCountByStatusMask);
+    CPPUNIT_TEST(testAppendByStatusMask);
+    CPPUNIT_TEST(testAvailabilityMask);
+    CPPUNIT_TEST(testRecords);
+    CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST(testOperationCycle);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    DtcStoreTest() = default;
+    virtual ~DtcStoreTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testAddAndGetStatus();
+    void testCountByStatusMask();
+    void testAppendByStatusMask();
+    void testAvailabilityMask();
+    void testRecords();
+    void testClear();
+    void testOperationCycle();
+
+};
+
+#endif /* DTC_STORE_TEST_H */
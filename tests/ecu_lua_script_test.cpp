@@ -6,6 +6,7 @@
 
 #include "ecu_lua_script_test.h"
 #include "ecu_lua_script.h"
+#include <vector>
 
 const std::string ECU_IDENT = "PCM";
 const std::string LUA_SCRIPT = "tests/test_config_dir/testscript05.lua";
@@ -344,3 +345,175 @@ void EcuLuaScriptTest::testGetRaw()
         CPPUNIT_ASSERT_EQUAL(expect.at(i), result.at(i));
     }
 }
+
+void EcuLuaScriptTest::testReset()
+{
+    EcuLuaScript ecuLuaScript(ECU_IDENT, "tests/test_config_dir/testscript07.lua");
+    CPPUNIT_ASSERT(ecuLuaScript.getRebootTime() == std::chrono::milliseconds(20));
+
+    // the script changes its global state on every call
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 01"), ecuLuaScript.getRaw("22 00 01"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 02"), ecuLuaScript.getRaw("22 00 01"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 02 02"), ecuLuaScript.getRaw("22 00 02"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 03 01"), ecuLuaScript.getRaw("22 00 03"));
+
+    ecuLuaScript.reset();
+    CPPUNIT_ASSERT(ecuLuaScript.getCommunicationControl().isSuspended());
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 03 00"), ecuLuaScript.getRaw("22 00 03"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 02 01"), ecuLuaScript.getRaw("22 00 02"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 01"), ecuLuaScript.getRaw("22 00 01"));
+
+    // the snapshot survives further resets
+    ecuLuaScript.reset();
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 01"), ecuLuaScript.getRaw("22 00 01"));
+}
+
+/**
+ * Evaluates a `Raw` entry and returns the response bytes.
+ */
+static std::vector<std::uint8_t> rawResponse(EcuLuaScript& ecuLuaScript, const std::vector<std::uint8_t>& request)
+{
+    const RequestArena::Scope arenaScope;
+    const UdsRequest udsRequest(request.data(), request.size());
+    std::vector<std::uint8_t> response;
+    ecuLuaScript.getRaw(udsRequest.toHexString(), udsRequest, [&response](const std::uint8_t* data, std::size_t size)
+    {
+        response.assign(data, data + size);
+    });
+    return response;
+}
+
+void EcuLuaScriptTest::testBytes()
+{
+    EcuLuaScript ecuLuaScript(ECU_IDENT, "tests/test_config_dir/testscript08.lua");
+
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x01})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x01, 0x01, 0x12, 0x34, 0xDE, 0xAD, 0xBE, 0xEF}));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x31, 0x81, 0x02, 0x03})
+                    == std::vector<std::uint8_t>{0x71, 0x01, 0x02, 0x03}));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x02})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x02, 0xAB, 0xCD}));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x03})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x03, 0x01}));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x04})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x04, 'O', 'K'}));
+    CPPUNIT_ASSERT(rawResponse(ecuLuaScript, {0x22, 0x00, 0x05}).empty());
+
+    // the legacy string interface sees the literal hex string
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 04 4F 4B"), ecuLuaScript.getRaw("22 00 04"));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("SALGA2EV9HA298784"), ecuLuaScript.getDataByIdentifier("F1 90"));
+    CPPUNIT_ASSERT_EQUAL(std::string("HPLA-12345-AB"), ecuLuaScript.getDataByIdentifier("F1 91"));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), ecuLuaScript.getDataByIdentifier("F1 92"));
+}
+
+void EcuLuaScriptTest::testFleet()
+{
+    const auto fleet = EcuLuaScript::loadFleet(ECU_IDENT, "tests/test_config_dir/testscript09.lua");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), fleet.size());
+
+    // the addresses are stepped per instance, explicit overrides win
+    CPPUNIT_ASSERT_EQUAL(std::string("PCM#1"), fleet[0]->getIdent());
+    CPPUNIT_ASSERT_EQUAL(std::uint32_t(0x700), fleet[0]->getRequestId());
+    CPPUNIT_ASSERT_EQUAL(std::uint32_t(0x780), fleet[0]->getResponseId());
+    CPPUNIT_ASSERT_EQUAL(std::uint32_t(0x701), fleet[1]->getRequestId());
+    CPPUNIT_ASSERT_EQUAL(std::uint32_t(0x782), fleet[1]->getResponseId());
+    CPPUNIT_ASSERT_EQUAL(std::uint32_t(0x7F0), fleet[2]->getResponseId());
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(0x12), fleet[2]->getJ1939SourceAddress());
+
+    // overridden tables are merged with the shared template
+    CPPUNIT_ASSERT_EQUAL(std::string("VIN0000000000000"), fleet[0]->getDataByIdentifier("F1 90"));
+    CPPUNIT_ASSERT_EQUAL(std::string("VIN0000000000002"), fleet[1]->getDataByIdentifier("F1 90"));
+    CPPUNIT_ASSERT_EQUAL(std::string("11"), fleet[1]->getDataByIdentifier("F1 91"));
+    CPPUNIT_ASSERT_EQUAL(std::string("12"), fleet[2]->getDataByIdentifier("F1 91"));
+
+    // `ECU` refers to the private table of the calling instance
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 01"), fleet[0]->getRaw("22 00 01"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 02"), fleet[0]->getRaw("22 00 01"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 01"), fleet[1]->getRaw("22 00 01"));
+    fleet[0]->reset();
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 01"), fleet[0]->getRaw("22 00 01"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 01 02"), fleet[1]->getRaw("22 00 01"));
+
+    CPPUNIT_ASSERT(fleet[0]->getPrivateMemory() > 0);
+    CPPUNIT_ASSERT(fleet[0]->getPrivateMemory() < fleet[0]->getLuaMemory());
+}
+
+void EcuLuaScriptTest::testExecutionBudget()
+{
+    EcuLuaScript ecuLuaScript(ECU_IDENT, "tests/test_config_dir/testscript10.lua");
+
+    // endless loops are aborted and answered with the configured NRC
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x01})
+                    == std::vector<std::uint8_t>{0x7F, 0x22, 0x22}));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x02})
+                    == std::vector<std::uint8_t>{0x7F, 0x22, 0x22}));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), ecuLuaScript.getDataByIdentifier("F1 90"));
+
+    // the ECU keeps responding afterwards
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x03})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x03, 0x01}));
+}
+
+void EcuLuaScriptTest::testPreparedCalls()
+{
+    const auto fleet = EcuLuaScript::loadFleet(ECU_IDENT, "tests/test_config_dir/testscript09.lua");
+
+    // the function of the shared template is prepared per instance and
+    // still sees the private table of the calling instance
+    for (int i = 0; i < 3; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(std::string("11"), fleet[1]->getDataByIdentifier("F1 91"));
+        CPPUNIT_ASSERT_EQUAL(std::string("12"), fleet[2]->getDataByIdentifier("F1 91"));
+        CPPUNIT_ASSERT_EQUAL(std::string("VIN0000000000002"), fleet[1]->getDataByIdentifier("F1 90"));
+    }
+    fleet[1]->reset();
+    CPPUNIT_ASSERT_EQUAL(std::string("11"), fleet[1]->getDataByIdentifier("F1 91"));
+    CPPUNIT_ASSERT_EQUAL(std::string("12"), fleet[2]->getDataByIdentifier("F1 91"));
+
+    // failing functions stay prepared and fail again
+    EcuLuaScript ecuLuaScript(ECU_IDENT, "tests/test_config_dir/testscript10.lua");
+    CPPUNIT_ASSERT_EQUAL(std::string(""), ecuLuaScript.getDataByIdentifier("F1 90"));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), ecuLuaScript.getDataByIdentifier("F1 90"));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x03})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x03, 0x01}));
+
+    // entries replaced at runtime take effect with the next read
+    EcuLuaScript changingScript(ECU_IDENT, "tests/test_config_dir/testscript07.lua");
+    CPPUNIT_ASSERT_EQUAL(std::string("first"), changingScript.getDataByIdentifier("F1 90"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 04 01"), changingScript.getRaw("22 00 04"));
+    CPPUNIT_ASSERT_EQUAL(std::string("second"), changingScript.getDataByIdentifier("F1 90"));
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 05 01"), changingScript.getRaw("22 00 05"));
+    CPPUNIT_ASSERT_EQUAL(std::string("third"), changingScript.getDataByIdentifier("F1 90"));
+    changingScript.reset();
+    CPPUNIT_ASSERT_EQUAL(std::string("first"), changingScript.getDataByIdentifier("F1 90"));
+}
+
+void EcuLuaScriptTest::testStaticEntries()
+{
+    EcuLuaScript ecuLuaScript(ECU_IDENT, "tests/test_config_dir/testscript07.lua");
+
+    // static entries are served without the lock, but follow the changes of
+    // the Lua code
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x02})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x02, 0x01}));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x01})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x01, 0x01}));
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x02})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x02, 0x02}));
+    ecuLuaScript.reset();
+    CPPUNIT_ASSERT((rawResponse(ecuLuaScript, {0x22, 0x00, 0x02})
+                    == std::vector<std::uint8_t>{0x62, 0x00, 0x02, 0x01}));
+
+    // the entries of the compiled tables are still seen by Lua and the simulator
+    CPPUNIT_ASSERT_EQUAL(std::string("62 00 06 06"), ecuLuaScript.getRaw("22 00 06"));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(6), ecuLuaScript.getRawRequests().size());
+
+    // the instances of a fleet have their own static entries
+    const auto fleet = EcuLuaScript::loadFleet(ECU_IDENT, "tests/test_config_dir/testscript09.lua");
+    for (int i = 0; i < 2; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(std::string("VIN0000000000000"), fleet[0]->getDataByIdentifier("F1 90"));
+        CPPUNIT_ASSERT_EQUAL(std::string("VIN0000000000002"), fleet[1]->getDataByIdentifier("F1 90"));
+    }
+}
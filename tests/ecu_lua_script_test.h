@@ -21,6 +21,12 @@ class EcuLuaScriptTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST(testAscii);
     CPPUNIT_TEST(testToByteResponse);
     CPPUNIT_TEST(testGetRaw);
+    CPPUNIT_TEST(testReset);
+    CPPUNIT_TEST(testBytes);
+    CPPUNIT_TEST(testFleet);
+    CPPUNIT_TEST(testExecutionBudget);
+    CPPUNIT_TEST(testPreparedCalls);
+    CPPUNIT_TEST(testStaticEntries);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -40,6 +46,12 @@ private:
     void testAscii();
     void testToByteResponse();
     void testGetRaw();
+    void testReset();
+    void testBytes();
+    void testFleet();
+    void testExecutionBudget();
+    void testPreparedCalls();
+    void testStaticEntries();
 
 };
 
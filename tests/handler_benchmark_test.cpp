@@ -0,0 +1,236 @@
+/**
+ * @file handler_benchmark_test.cpp
+ *
+ * Throughput of the `Raw` handlers of the shipped configs and of the helpers
+ * injected into the Lua scripts. Build the tests with `make LUA_PKG=lua5.2`
+ * and `make LUA_PKG=luajit` to compare the Lua backends, the calls per
+ * second are printed.
+ */
+
+#include "handler_benchmark_test.h"
+#include "ecu_lua_script.h"
+#include "request_arena.h"
+#include "uds_request.h"
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HandlerBenchmarkTest);
+
+/// Config and the global name of its ECU.
+struct BenchmarkConfig
+{
+    const char* ident;
+    const char* path;
+};
+
+static const BenchmarkConfig CONFIGS[] =
+{
+    {"PCM_1", "tests/test_config_dir/PCM.lua"},
+    {"PCM", "tests/test_config_dir/testscript08.lua"},
+    {"PCM", "tests/test_config_dir/testscript11.lua"},
+};
+
+/// Number of times every `Raw` entry is requested.
+static constexpr int ROUNDS = 200;
+
+/// Number of calls of every helper.
+static constexpr int HELPER_CALLS = 200000;
+
+/// Number of reads of a nested table entry.
+static constexpr int SELECTOR_READS = 200000;
+
+/// Number of calls of a Lua function.
+static constexpr int FUNCTION_CALLS = 200000;
+
+#ifdef SELENE_LUAJIT
+static constexpr char BACKEND[] = LUAJIT_VERSION;
+#else
+static constexpr char BACKEND[] = LUA_RELEASE;
+#endif
+
+void HandlerBenchmarkTest::setUp() { }
+
+void HandlerBenchmarkTest::tearDown() { }
+
+void HandlerBenchmarkTest::testRawThroughput()
+{
+    for (const BenchmarkConfig& config : CONFIGS)
+    {
+        EcuLuaScript script(config.ident, config.path);
+        CPPUNIT_ASSERT(script.isLoaded());
+
+        // wildcard entries (e.g. "31 01 *") are requested with a zero byte
+        vector<vector<uint8_t>> requests;
+        for (string key : script.getRawRequests())
+        {
+            const size_t wildcard = key.find(" *");
+            if (wildcard != string::npos)
+            {
+                key.replace(wildcard, 2, " 00");
+            }
+            requests.push_back(EcuLuaScript::literalHexStrToBytes(key));
+        }
+        CPPUNIT_ASSERT(!requests.empty());
+
+        size_t numResponses = 0;
+        const auto start = chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            for (const vector<uint8_t>& request : requests)
+            {
+                const RequestArena::Scope arenaScope;
+                const UdsRequest udsRequest(request.data(), request.size());
+                script.getRaw(udsRequest.toHexString(), udsRequest, [&numResponses](const uint8_t*, size_t)
+                {
+                    ++numResponses;
+                });
+            }
+        }
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        const size_t numCalls = ROUNDS * requests.size();
+        CPPUNIT_ASSERT_EQUAL(numCalls, numResponses);
+        cout << '\n' << BACKEND << ' ' << config.path << ": " << requests.size() << " handlers, "
+             << size_t(numCalls / elapsed.count()) << " calls/s";
+    }
+    cout << endl;
+}
+
+/// Context of the bound helper, like the `LuaContext` of a script.
+struct HelperContext
+{
+    uint32_t session = 0x01;
+};
+
+static uint32_t boundGetSession(HelperContext* pContext)
+{
+    return pContext->session;
+}
+
+/**
+ * Calls a helper from a Lua loop and returns the calls per second.
+ */
+static double helperCallsPerSecond(sel::State& state, const string& call)
+{
+    const string chunk = "for i = 1, " + to_string(HELPER_CALLS) + " do " + call + " end";
+    const auto start = chrono::steady_clock::now();
+    CPPUNIT_ASSERT(state(chunk.c_str()));
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return HELPER_CALLS / elapsed.count();
+}
+
+/**
+ * Compares the helpers registered as Selene lambdas (`std::function`) with
+ * the same helpers registered as trampolines.
+ */
+void HandlerBenchmarkTest::testHelperCalls()
+{
+    HelperContext context;
+    sel::State lambdas;
+    lambdas["ascii"] = [](const string& utf8_str) -> string { return EcuLuaScript::ascii(utf8_str); };
+    lambdas["toByteResponse"] = [](uint32_t value, uint32_t len) -> string { return EcuLuaScript::toByteResponse(value, len); };
+    HelperContext* pContext = &context;
+    lambdas["getCurrentSession"] = [pContext]() -> uint32_t { return boundGetSession(pContext); };
+
+    sel::State trampolines;
+    trampolines["ascii"] = sel::trampoline<&EcuLuaScript::ascii>;
+    trampolines["toByteResponse"] = sel::trampoline<&EcuLuaScript::toByteResponse>;
+    trampolines["getCurrentSession"].SetClosure(sel::bound_trampoline<&boundGetSession>, &context);
+
+    CPPUNIT_ASSERT(trampolines("result = toByteResponse(13248, 2) .. ascii('OK') .. getCurrentSession()"));
+    CPPUNIT_ASSERT_EQUAL(string("33 C0 4F 4B 1"), string(trampolines["result"]));
+
+    const char* const CALLS[] = {
+        "ascii('SALGA2EV9HA298784')",
+        "toByteResponse(i, 2)",
+        "getCurrentSession()",
+    };
+    for (const char* call : CALLS)
+    {
+        const double before = helperCallsPerSecond(lambdas, call);
+        const double after = helperCallsPerSecond(trampolines, call);
+        cout << '\n' << BACKEND << ' ' << call << ": " << size_t(before) << " calls/s (std::function), "
+             << size_t(after) << " calls/s (trampoline)";
+    }
+    cout << endl;
+}
+
+/**
+ * Reads a nested table entry like the handlers of `EcuLuaScript` do, as
+ * copied string and as view into the Lua string.
+ */
+void HandlerBenchmarkTest::testSelectorReads()
+{
+    sel::State state;
+    CPPUNIT_ASSERT(state("PCM = { Routines = { ['FF 00'] = { result = '71 01 FF 00 00' } } }"));
+    const string rid = "FF 00";
+
+    size_t numBytes = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < SELECTOR_READS; ++i)
+    {
+        const string value = state["PCM"]["Routines"][rid]["result"];
+        numBytes += value.size();
+    }
+    const chrono::duration<double> copied = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < SELECTOR_READS; ++i)
+    {
+        const string_view value = state["PCM"]["Routines"][rid]["result"];
+        numBytes -= value.size();
+    }
+    const chrono::duration<double> viewed = chrono::steady_clock::now() - start;
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), numBytes);
+    const string_view value = state["PCM"]["Routines"][rid]["result"];
+    CPPUNIT_ASSERT(value == "71 01 FF 00 00");
+    cout << '\n' << BACKEND << " nested read: " << size_t(SELECTOR_READS / copied.count()) << " reads/s (std::string), "
+         << size_t(SELECTOR_READS / viewed.count()) << " reads/s (std::string_view)" << endl;
+}
+
+/**
+ * Calls a function entry of the `ReadDataByIdentifier`-table through a
+ * selector, which looks it up for every call, and as prepared call. The
+ * function DIDs of `EcuLuaScript` are prepared at their first read.
+ */
+void HandlerBenchmarkTest::testPreparedCalls()
+{
+    EcuLuaScript script("PCM", "tests/test_config_dir/testscript08.lua");
+    CPPUNIT_ASSERT(script.isLoaded());
+    const string did = "F1 90";
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < FUNCTION_CALLS; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(size_t(17), script.getDataByIdentifier(did).size());
+    }
+    const chrono::duration<double> prepared = chrono::steady_clock::now() - start;
+
+    sel::State state;
+    CPPUNIT_ASSERT(state("PCM = { ReadDataByIdentifier = { ['F1 90'] = function (identifier) return identifier end } }"));
+    auto entry = state["PCM"]["ReadDataByIdentifier"][did];
+    const sel::PreparedCall call = entry.Prepare();
+    CPPUNIT_ASSERT(call);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < FUNCTION_CALLS; ++i)
+    {
+        const string data = entry(did);
+        CPPUNIT_ASSERT(data == did);
+    }
+    const chrono::duration<double> selected = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < FUNCTION_CALLS; ++i)
+    {
+        CPPUNIT_ASSERT(call.Call<string>(did) == did);
+    }
+    const chrono::duration<double> called = chrono::steady_clock::now() - start;
+
+    cout << '\n' << BACKEND << " getDataByIdentifier(\"F1 90\"): " << size_t(FUNCTION_CALLS / prepared.count()) << " calls/s"
+         << '\n' << BACKEND << " DID function: " << size_t(FUNCTION_CALLS / selected.count()) << " calls/s (selector), "
+         << size_t(FUNCTION_CALLS / called.count()) << " calls/s (prepared)" << endl;
+}
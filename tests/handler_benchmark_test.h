@@ -0,0 +1,36 @@
+/**
+ * @file handler_benchmark_test.h
+ *
+ */
+
+#ifndef HANDLER_BENCHMARK_TEST_H
+#define HANDLER_BENCHMARK_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class HandlerBenchmarkTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(HandlerBenchmarkTest);
+
+    CPPUNIT_TEST(testRawThroughput);
+    CPPUNIT_TEST(testHelperCalls);
+    CPPUNIT_TEST(testSelectorReads);
+    CPPUNIT_TEST(testPreparedCalls);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    HandlerBenchmarkTest() = default;
+    virtual ~HandlerBenchmarkTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testRawThroughput();
+    void testHelperCalls();
+    void testSelectorReads();
+    void testPreparedCalls();
+
+};
+
+#endif /* HANDLER_BENCHMARK_TEST_H */
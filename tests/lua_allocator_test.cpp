@@ -0,0 +1,113 @@
+/**
+ * @file lua_allocator_test.cpp
+ *
+ * Unit test for the memory allocator of the Lua states.
+ */
+
+#include "lua_allocator_test.h"
+#include "lua_allocator.h"
+#include "metrics.h"
+#include <cstring>
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LuaAllocatorTest);
+
+/// Type tag passed by Lua for new tables, ignored by the allocator.
+static constexpr size_t NEW_TABLE = 5;
+
+void LuaAllocatorTest::setUp() { }
+
+void LuaAllocatorTest::tearDown() { }
+
+void LuaAllocatorTest::testAccounting()
+{
+    metrics::Gauge& bytes = metrics::gauge("lua.memory.accounting.bytes");
+    metrics::Gauge& blocks = metrics::gauge("lua.memory.accounting.blocks");
+    {
+        LuaAllocator allocator("accounting");
+        void* pSmall = LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 40);
+        void* pLarge = LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 4000);
+        CPPUNIT_ASSERT(pSmall != nullptr && pLarge != nullptr);
+        CPPUNIT_ASSERT_EQUAL(size_t(4040), allocator.getBytes());
+        CPPUNIT_ASSERT_EQUAL(size_t(2), allocator.getBlocks());
+        CPPUNIT_ASSERT_EQUAL(int64_t(4040), bytes.value());
+        CPPUNIT_ASSERT_EQUAL(int64_t(2), blocks.value());
+
+        CPPUNIT_ASSERT(LuaAllocator::allocate(&allocator, pSmall, 40, 0) == nullptr);
+        CPPUNIT_ASSERT_EQUAL(size_t(4000), allocator.getBytes());
+        CPPUNIT_ASSERT_EQUAL(size_t(1), allocator.getBlocks());
+        LuaAllocator::allocate(&allocator, pLarge, 4000, 0);
+
+        // pooled blocks left behind are taken off the gauges with the allocator
+        LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 24);
+        CPPUNIT_ASSERT_EQUAL(int64_t(24), bytes.value());
+    }
+    CPPUNIT_ASSERT_EQUAL(int64_t(0), bytes.value());
+    CPPUNIT_ASSERT_EQUAL(int64_t(0), blocks.value());
+}
+
+void LuaAllocatorTest::testResize()
+{
+    LuaAllocator allocator("resize");
+    char* p = static_cast<char*>(LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 20));
+    memcpy(p, "0123456789abcdefghi", 20);
+
+    // the size class of 17..32 bytes keeps the block in place
+    CPPUNIT_ASSERT(LuaAllocator::allocate(&allocator, p, 20, 32) == p);
+
+    // growing beyond the pools keeps the content
+    p = static_cast<char*>(LuaAllocator::allocate(&allocator, p, 32, 1000));
+    CPPUNIT_ASSERT(p != nullptr);
+    CPPUNIT_ASSERT_EQUAL(string("0123456789abcdefghi"), string(p));
+    p = static_cast<char*>(LuaAllocator::allocate(&allocator, p, 1000, 3000));
+    CPPUNIT_ASSERT_EQUAL(string("0123456789abcdefghi"), string(p));
+    p = static_cast<char*>(LuaAllocator::allocate(&allocator, p, 3000, 20));
+    CPPUNIT_ASSERT_EQUAL(string("0123456789abcdefghi"), string(p));
+    CPPUNIT_ASSERT_EQUAL(size_t(20), allocator.getBytes());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), allocator.getBlocks());
+    LuaAllocator::allocate(&allocator, p, 20, 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), allocator.getBytes());
+}
+
+void LuaAllocatorTest::testReuse()
+{
+    LuaAllocator allocator("reuse");
+    void* p1 = LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 64);
+    void* p2 = LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 64);
+    CPPUNIT_ASSERT(p1 != p2);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), reinterpret_cast<uintptr_t>(p1) % LuaAllocator::GRANULARITY);
+
+    // freed blocks are handed out again for the same size class
+    LuaAllocator::allocate(&allocator, p1, 64, 0);
+    CPPUNIT_ASSERT(LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 50) == p1);
+
+    // more blocks than fit into a single chunk
+    for (size_t i = 0; i < 2 * LuaAllocator::CHUNK_SIZE / LuaAllocator::MAX_POOLED_SIZE; ++i)
+    {
+        void* p = LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, LuaAllocator::MAX_POOLED_SIZE);
+        CPPUNIT_ASSERT(p != nullptr);
+        memset(p, 0xA5, LuaAllocator::MAX_POOLED_SIZE);
+    }
+}
+
+void LuaAllocatorTest::testLimit()
+{
+    metrics::Counter& limitHits = metrics::counter("lua.memory.limit.limit_hits");
+    LuaAllocator allocator("limit");
+    allocator.setLimit(1000);
+
+    void* p = LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 600);
+    CPPUNIT_ASSERT(p != nullptr);
+    CPPUNIT_ASSERT(LuaAllocator::allocate(&allocator, nullptr, NEW_TABLE, 600) == nullptr);
+    CPPUNIT_ASSERT(LuaAllocator::allocate(&allocator, p, 600, 1200) == nullptr);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2), limitHits.value());
+    CPPUNIT_ASSERT_EQUAL(size_t(600), allocator.getBytes());
+
+    // shrinking always works, even above the limit
+    allocator.setLimit(100);
+    p = LuaAllocator::allocate(&allocator, p, 600, 300);
+    CPPUNIT_ASSERT(p != nullptr);
+    CPPUNIT_ASSERT_EQUAL(size_t(300), allocator.getBytes());
+    LuaAllocator::allocate(&allocator, p, 300, 0);
+}
@@ -0,0 +1,36 @@
+/**
+ * @file lua_allocator_test.h
+ *
+ */
+
+#ifndef LUA_ALLOCATOR_TEST_H
+#define LUA_ALLOCATOR_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LuaAllocatorTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(LuaAllocatorTest);
+
+    CPPUNIT_TEST(testAccounting);
+    CPPUNIT_TEST(testResize);
+    CPPUNIT_TEST(testReuse);
+    CPPUNIT_TEST(testLimit);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    LuaAllocatorTest() = default;
+    virtual ~LuaAllocatorTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testAccounting();
+    void testResize();
+    void testReuse();
+    void testLimit();
+
+};
+
+#endif /* LUA_ALLOCATOR_TEST_H */
@@ -0,0 +1,138 @@
+/**
+ * @file lua_budget_test.cpp
+ *
+ * Unit test for the execution budget of the Lua handlers.
+ */
+
+#include "lua_budget_test.h"
+#include "lua_budget.h"
+#include "metrics.h"
+
+#include "selene/compat.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LuaBudgetTest);
+
+void LuaBudgetTest::setUp() { }
+
+void LuaBudgetTest::tearDown() { }
+
+void LuaBudgetTest::testUnlimited()
+{
+    static metrics::Histogram& callInstructions = metrics::histogram("lua.call_instructions");
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaBudget budget;
+    budget.install(L);
+
+    const uint64_t numCalls = callInstructions.count();
+    budget.start();
+    CPPUNIT_ASSERT_EQUAL(LUA_OK, luaL_dostring(L, "local n = 0 for i = 1, 100000 do n = n + i end"));
+    budget.stop();
+    CPPUNIT_ASSERT(!budget.isExceeded());
+    CPPUNIT_ASSERT(budget.getInstructions() >= 100000);
+    CPPUNIT_ASSERT_EQUAL(numCalls + 1, callInstructions.count());
+
+    // outside of a call nothing is counted
+    CPPUNIT_ASSERT_EQUAL(LUA_OK, luaL_dostring(L, "for i = 1, 100000 do end"));
+    budget.stop();
+    CPPUNIT_ASSERT_EQUAL(numCalls + 1, callInstructions.count());
+    lua_close(L);
+}
+
+void LuaBudgetTest::testInstructionLimit()
+{
+    static metrics::Counter& numExceeded = metrics::counter("lua.budget_exceeded");
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaBudget budget;
+    budget.install(L);
+    budget.setLimits(50000, chrono::milliseconds(0));
+
+    const uint64_t exceededBefore = numExceeded.value();
+    budget.start();
+    CPPUNIT_ASSERT(luaL_dostring(L, "while true do end") != LUA_OK);
+    lua_pop(L, 1);
+    CPPUNIT_ASSERT(budget.isExceeded());
+    CPPUNIT_ASSERT(budget.getInstructions() > 50000);
+    CPPUNIT_ASSERT(budget.getInstructions() <= 50000 + LuaBudget::HOOK_INTERVAL);
+    budget.stop();
+    CPPUNIT_ASSERT_EQUAL(exceededBefore + 1, numExceeded.value());
+
+    // the next call starts with a fresh budget
+    budget.start();
+    CPPUNIT_ASSERT_EQUAL(LUA_OK, luaL_dostring(L, "for i = 1, 1000 do end"));
+    CPPUNIT_ASSERT(!budget.isExceeded());
+    budget.stop();
+    lua_close(L);
+}
+
+void LuaBudgetTest::testCaughtError()
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaBudget budget;
+    budget.install(L);
+    budget.setLimits(50000, chrono::milliseconds(0));
+
+    budget.start();
+    CPPUNIT_ASSERT(luaL_dostring(L, "while true do pcall(function() while true do end end) end") != LUA_OK);
+    lua_pop(L, 1);
+    CPPUNIT_ASSERT(budget.isExceeded());
+    budget.stop();
+    lua_close(L);
+}
+
+void LuaBudgetTest::testTimeLimit()
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaBudget budget;
+    budget.install(L);
+    budget.setLimits(0, chrono::milliseconds(20));
+
+    const auto start = chrono::steady_clock::now();
+    budget.start();
+    CPPUNIT_ASSERT(luaL_dostring(L, "while true do end") != LUA_OK);
+    lua_pop(L, 1);
+    CPPUNIT_ASSERT(budget.isExceeded());
+    budget.stop();
+    CPPUNIT_ASSERT(chrono::steady_clock::now() - start >= chrono::milliseconds(20));
+    lua_close(L);
+}
+
+/**
+ * A loop hot enough to be compiled by LuaJIT is aborted as well, build the
+ * test with `make LUA_PKG=luajit` to cover the JIT.
+ */
+void LuaBudgetTest::testHotLoop()
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaBudget budget;
+    budget.install(L);
+    budget.setLimits(1000000, chrono::milliseconds(0));
+#ifdef SELENE_LUAJIT
+    CPPUNIT_ASSERT_EQUAL(LUA_OK, luaL_dostring(L, "isJitOn = jit.status()"));
+    lua_getglobal(L, "isJitOn");
+    CPPUNIT_ASSERT(!lua_toboolean(L, -1));
+    lua_pop(L, 1);
+#endif
+
+    budget.start();
+    CPPUNIT_ASSERT(luaL_dostring(L, "local n = 0 while true do n = n + 1 end") != LUA_OK);
+    lua_pop(L, 1);
+    CPPUNIT_ASSERT(budget.isExceeded());
+    budget.stop();
+
+#ifdef SELENE_LUAJIT
+    // without limits the JIT compiles again
+    budget.setLimits(0, chrono::milliseconds(0));
+    CPPUNIT_ASSERT_EQUAL(LUA_OK, luaL_dostring(L, "isJitOn = jit.status()"));
+    lua_getglobal(L, "isJitOn");
+    CPPUNIT_ASSERT(lua_toboolean(L, -1));
+    lua_pop(L, 1);
+#endif
+    lua_close(L);
+}
@@ -0,0 +1,38 @@
+/**
+ * @file lua_budget_test.h
+ *
+ */
+
+#ifndef LUA_BUDGET_TEST_H
+#define LUA_BUDGET_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LuaBudgetTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(LuaBudgetTest);
+
+    CPPUNIT_TEST(testUnlimited);
+    CPPUNIT_TEST(testInstructionLimit);
+    CPPUNIT_TEST(testCaughtError);
+    CPPUNIT_TEST(testTimeLimit);
+    CPPUNIT_TEST(testHotLoop);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    LuaBudgetTest() = default;
+    virtual ~LuaBudgetTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testUnlimited();
+    void testInstructionLimit();
+    void testCaughtError();
+    void testTimeLimit();
+    void testHotLoop();
+
+};
+
+#endif /* LUA_BUDGET_TEST_H */
@@ -0,0 +1,106 @@
+/**
+ * @file lua_chunk_cache_test.cpp
+ *
+ * Unit test for the cache of precompiled Lua scripts.
+ */
+
+#include "lua_chunk_cache_test.h"
+#include "lua_chunk_cache.h"
+#include "metrics.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+#include "selene/compat.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LuaChunkCacheTest);
+
+static const string SCRIPT_V1 = "PCM = { RequestId = 0x100, Name = 'V1' }\n";
+static const string SCRIPT_V2 = "PCM = { RequestId = 0x100, Name = 'V2' }\n";
+
+/**
+ * Loads and runs the script in a fresh Lua state and returns `PCM.Name`.
+ */
+static string runScript(const string& path)
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    string name;
+    if (LuaChunkCache::load(L, path) == LUA_OK && lua_pcall(L, 0, 0, 0) == LUA_OK)
+    {
+        lua_getglobal(L, "PCM");
+        lua_getfield(L, -1, "Name");
+        name = lua_tostring(L, -1);
+    }
+    lua_close(L);
+    return name;
+}
+
+void LuaChunkCacheTest::setUp()
+{
+    directory_ = "/tmp/lua_chunk_cache_test_" + to_string(getpid());
+    script_ = directory_ + "/PCM.lua";
+    filesystem::remove_all(directory_);
+    filesystem::create_directory(directory_);
+}
+
+void LuaChunkCacheTest::tearDown()
+{
+    filesystem::remove_all(directory_);
+}
+
+void LuaChunkCacheTest::writeScript(const string& content) const
+{
+    ofstream file(script_, ios::trunc);
+    file << content;
+}
+
+void LuaChunkCacheTest::testEntryPath()
+{
+    CPPUNIT_ASSERT_EQUAL(string("lua_config/.luacache/0123456789ABCDEF.luac"),
+                         LuaChunkCache::entryPath("lua_config/PCM.lua", 0x0123456789ABCDEFull));
+    CPPUNIT_ASSERT_EQUAL(string(".luacache/0000000000000001.luac"),
+                         LuaChunkCache::entryPath("PCM.lua", 1));
+    // FNV-1a test vectors
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0xCBF29CE484222325ull), LuaChunkCache::hash("", 0));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0xAF63DC4C8601EC8Cull), LuaChunkCache::hash("a", 1));
+}
+
+void LuaChunkCacheTest::testHit()
+{
+    metrics::Counter& numHits = metrics::counter("lua.chunk_cache_hits");
+    writeScript(SCRIPT_V1);
+    const string entry = LuaChunkCache::entryPath(script_, LuaChunkCache::hash(SCRIPT_V1.data(), SCRIPT_V1.size()));
+
+    CPPUNIT_ASSERT_EQUAL(string("V1"), runScript(script_));
+    CPPUNIT_ASSERT(filesystem::exists(entry));
+
+    const uint64_t hits = numHits.value();
+    CPPUNIT_ASSERT_EQUAL(string("V1"), runScript(script_));
+    CPPUNIT_ASSERT_EQUAL(hits + 1, numHits.value());
+}
+
+void LuaChunkCacheTest::testChangedSource()
+{
+    writeScript(SCRIPT_V1);
+    CPPUNIT_ASSERT_EQUAL(string("V1"), runScript(script_));
+    writeScript(SCRIPT_V2);
+    CPPUNIT_ASSERT_EQUAL(string("V2"), runScript(script_));
+    CPPUNIT_ASSERT(filesystem::exists(LuaChunkCache::entryPath(script_, LuaChunkCache::hash(SCRIPT_V2.data(), SCRIPT_V2.size()))));
+}
+
+void LuaChunkCacheTest::testDamagedEntry()
+{
+    metrics::Counter& numMisses = metrics::counter("lua.chunk_cache_misses");
+    writeScript(SCRIPT_V1);
+    CPPUNIT_ASSERT_EQUAL(string("V1"), runScript(script_));
+
+    // cut the bytecode, the source is compiled again
+    const string entry = LuaChunkCache::entryPath(script_, LuaChunkCache::hash(SCRIPT_V1.data(), SCRIPT_V1.size()));
+    filesystem::resize_file(entry, filesystem::file_size(entry) - 8);
+    const uint64_t misses = numMisses.value();
+    CPPUNIT_ASSERT_EQUAL(string("V1"), runScript(script_));
+    CPPUNIT_ASSERT_EQUAL(misses + 1, numMisses.value());
+}
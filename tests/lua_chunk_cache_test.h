@@ -0,0 +1,41 @@
+/**
+ * @file lua_chunk_cache_test.h
+ *
+ */
+
+#ifndef LUA_CHUNK_CACHE_TEST_H
+#define LUA_CHUNK_CACHE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+class LuaChunkCacheTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(LuaChunkCacheTest);
+
+    CPPUNIT_TEST(testEntryPath);
+    CPPUNIT_TEST(testHit);
+    CPPUNIT_TEST(testChangedSource);
+    CPPUNIT_TEST(testDamagedEntry);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    LuaChunkCacheTest() = default;
+    virtual ~LuaChunkCacheTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    std::string directory_;
+    std::string script_;
+
+    void writeScript(const std::string& content) const;
+    void testEntryPath();
+    void testHit();
+    void testChangedSource();
+    void testDamagedEntry();
+
+};
+
+#endif /* LUA_CHUNK_CACHE_TEST_H */
@@ -0,0 +1,117 @@
+/**
+ * @file lua_collector_test.cpp
+ *
+ * Unit test for the control of the Lua garbage collector.
+ */
+
+#include "lua_collector_test.h"
+#include "lua_collector.h"
+#include "metrics.h"
+
+#include "selene/compat.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LuaCollectorTest);
+
+/**
+ * Creates almost 2 MiB of garbage, like a busy request.
+ */
+static void createGarbage(lua_State* L)
+{
+    (void)luaL_dostring(L, "for i = 1, 10000 do local t = { i, tostring(i), {} } end");
+}
+
+void LuaCollectorTest::setUp()
+{
+    LuaCollector::takeThreadTime();
+}
+
+void LuaCollectorTest::tearDown() { }
+
+void LuaCollectorTest::testAutoSteps()
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaCollector collector;
+    collector.configure(L, LuaGcSettings());
+    CPPUNIT_ASSERT(lua_gc(L, LUA_GCISRUNNING, 0) != 0);
+
+    createGarbage(L);
+    collector.afterCall(L);
+    CPPUNIT_ASSERT_EQUAL(int64_t(-1), LuaCollector::takeThreadTime());
+    lua_close(L);
+}
+
+void LuaCollectorTest::testRequestSteps()
+{
+    static metrics::Histogram& stepTime = metrics::histogram("lua.gc_step_us");
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaCollector collector;
+    LuaGcSettings settings;
+    settings.steps = LuaGcSteps::REQUEST;
+    settings.pause = 100;
+    collector.configure(L, settings);
+    CPPUNIT_ASSERT(lua_gc(L, LUA_GCISRUNNING, 0) == 0);
+
+    // nothing allocated, nothing to do
+    collector.afterCall(L);
+    CPPUNIT_ASSERT_EQUAL(int64_t(-1), LuaCollector::takeThreadTime());
+
+    const uint64_t numSteps = stepTime.count();
+    const int kbBefore = lua_gc(L, LUA_GCCOUNT, 0);
+    for (int i = 0; i < 20; ++i)
+    {
+        createGarbage(L);
+        collector.afterCall(L);
+    }
+    CPPUNIT_ASSERT(LuaCollector::takeThreadTime() >= 0);
+    CPPUNIT_ASSERT_EQUAL(int64_t(-1), LuaCollector::takeThreadTime());
+    CPPUNIT_ASSERT_EQUAL(numSteps + 20, stepTime.count());
+
+    // the steps keep up with the garbage of the requests
+    CPPUNIT_ASSERT(lua_gc(L, LUA_GCCOUNT, 0) < kbBefore + 16384);
+    lua_close(L);
+}
+
+void LuaCollectorTest::testIdleSteps()
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    LuaCollector collector;
+    LuaGcSettings settings;
+    settings.steps = LuaGcSteps::IDLE;
+    collector.configure(L, settings);
+    CPPUNIT_ASSERT(lua_gc(L, LUA_GCISRUNNING, 0) == 0);
+
+    // a short request leaves the garbage to the idle steps
+    (void)luaL_dostring(L, "local t = {}");
+    collector.afterCall(L);
+    CPPUNIT_ASSERT_EQUAL(int64_t(-1), LuaCollector::takeThreadTime());
+
+    createGarbage(L);
+    const int kbBusy = lua_gc(L, LUA_GCCOUNT, 0);
+    for (int i = 0; i < 1000; ++i)
+    {
+        collector.idleStep(L);
+    }
+    CPPUNIT_ASSERT(lua_gc(L, LUA_GCCOUNT, 0) < kbBusy);
+
+    // a request, which outgrew the pause, steps in
+    for (int i = 0; i < 20; ++i)
+    {
+        createGarbage(L);
+        collector.afterCall(L);
+    }
+    LuaCollector::takeThreadTime();
+    lua_close(L);
+}
+
+void LuaCollectorTest::testStepsFromString()
+{
+    CPPUNIT_ASSERT(LuaCollector::stepsFromString("auto") == LuaGcSteps::AUTO);
+    CPPUNIT_ASSERT(LuaCollector::stepsFromString("request") == LuaGcSteps::REQUEST);
+    CPPUNIT_ASSERT(LuaCollector::stepsFromString("idle") == LuaGcSteps::IDLE);
+    CPPUNIT_ASSERT(LuaCollector::stepsFromString("whenever") == LuaGcSteps::AUTO);
+}
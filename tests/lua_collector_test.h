@@ -0,0 +1,36 @@
+/**
+ * @file lua_collector_test.h
+ *
+ */
+
+#ifndef LUA_COLLECTOR_TEST_H
+#define LUA_COLLECTOR_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LuaCollectorTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(LuaCollectorTest);
+
+    CPPUNIT_TEST(testAutoSteps);
+    CPPUNIT_TEST(testRequestSteps);
+    CPPUNIT_TEST(testIdleSteps);
+    CPPUNIT_TEST(testStepsFromString);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    LuaCollectorTest() = default;
+    virtual ~LuaCollectorTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testAutoSteps();
+    void testRequestSteps();
+    void testIdleSteps();
+    void testStepsFromString();
+
+};
+
+#endif /* LUA_COLLECTOR_TEST_H */
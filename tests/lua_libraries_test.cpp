@@ -0,0 +1,119 @@
+/**
+ * @file lua_libraries_test.cpp
+ *
+ * Unit test for the minimal and lazily opened Lua standard libraries.
+ */
+
+#include "lua_libraries_test.h"
+#include "lua_libraries.h"
+#include "lua_allocator.h"
+#include <string>
+#include <vector>
+
+#include "selene/compat.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LuaLibrariesTest);
+
+/// Number of states, like the ECUs of a large simulation.
+static constexpr int NUM_STATES = 500;
+
+/**
+ * Checks if the global is set, without opening a lazy library.
+ */
+static bool hasRawGlobal(lua_State* L, const char* name)
+{
+    lua_pushglobaltable(L);
+    lua_pushstring(L, name);
+    lua_rawget(L, -2);
+    const bool isSet = !lua_isnil(L, -1);
+    lua_pop(L, 2);
+    return isSet;
+}
+
+/**
+ * Runs a chunk, which returns a string.
+ */
+static string run(lua_State* L, const char* chunk)
+{
+    string result;
+    if (luaL_loadstring(L, chunk) == LUA_OK && lua_pcall(L, 0, 1, 0) == LUA_OK && lua_isstring(L, -1))
+    {
+        result = lua_tostring(L, -1);
+    }
+    lua_pop(L, 1);
+    return result;
+}
+
+void LuaLibrariesTest::setUp() { }
+
+void LuaLibrariesTest::tearDown() { }
+
+void LuaLibrariesTest::testLazyLoading()
+{
+    lua_State* L = luaL_newstate();
+    LuaLibraries::open(L);
+    CPPUNIT_ASSERT(hasRawGlobal(L, "string"));
+    CPPUNIT_ASSERT(hasRawGlobal(L, "math"));
+    CPPUNIT_ASSERT(!hasRawGlobal(L, "os"));
+    CPPUNIT_ASSERT(!hasRawGlobal(L, "io"));
+
+    CPPUNIT_ASSERT_EQUAL(string("number"), run(L, "return type(os.time())"));
+    CPPUNIT_ASSERT(hasRawGlobal(L, "os"));
+    CPPUNIT_ASSERT(!hasRawGlobal(L, "io"));
+
+    // the package library comes with `require`
+    CPPUNIT_ASSERT_EQUAL(string("table"), run(L, "return type(require('string'))"));
+    CPPUNIT_ASSERT(hasRawGlobal(L, "package"));
+    CPPUNIT_ASSERT_EQUAL(string("nil"), run(L, "return type(undefinedGlobal)"));
+    lua_close(L);
+}
+
+void LuaLibrariesTest::testProfiles()
+{
+    lua_State* L = luaL_newstate();
+    LuaLibraries::open(L);
+    CPPUNIT_ASSERT_EQUAL(string("table"), run(L, "return type(os)"));
+    LuaLibraries::setProfile(L, LuaLibraryProfile::MINIMAL);
+    CPPUNIT_ASSERT_EQUAL(string("nil"), run(L, "return type(io)"));
+    CPPUNIT_ASSERT_EQUAL(string("table"), run(L, "return type(os)")); // stays open
+    lua_close(L);
+
+    L = luaL_newstate();
+    LuaLibraries::open(L);
+    LuaLibraries::setProfile(L, LuaLibraryProfile::FULL);
+    CPPUNIT_ASSERT(hasRawGlobal(L, "io"));
+    CPPUNIT_ASSERT(hasRawGlobal(L, "debug"));
+    CPPUNIT_ASSERT(hasRawGlobal(L, "require"));
+    lua_close(L);
+
+    CPPUNIT_ASSERT(LuaLibraries::profileFromString("minimal") == LuaLibraryProfile::MINIMAL);
+    CPPUNIT_ASSERT(LuaLibraries::profileFromString("full") == LuaLibraryProfile::FULL);
+    CPPUNIT_ASSERT(LuaLibraries::profileFromString("lazy") == LuaLibraryProfile::LAZY);
+}
+
+void LuaLibrariesTest::testMemory()
+{
+    LuaAllocator minimal("libraries_test.minimal");
+    LuaAllocator full("libraries_test.full");
+    vector<lua_State*> states;
+    for (int i = 0; i < NUM_STATES; ++i)
+    {
+        lua_State* L = lua_newstate(&LuaAllocator::allocate, &minimal);
+        LuaLibraries::open(L);
+        states.push_back(L);
+        L = lua_newstate(&LuaAllocator::allocate, &full);
+        luaL_openlibs(L);
+        states.push_back(L);
+    }
+
+    CPPUNIT_ASSERT(minimal.getBytes() < full.getBytes());
+
+    for (lua_State* L : states)
+    {
+        lua_close(L);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(0), minimal.getBytes());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), full.getBytes());
+}
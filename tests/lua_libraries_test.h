@@ -0,0 +1,34 @@
+/**
+ * @file lua_libraries_test.h
+ *
+ */
+
+#ifndef LUA_LIBRARIES_TEST_H
+#define LUA_LIBRARIES_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LuaLibrariesTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(LuaLibrariesTest);
+
+    CPPUNIT_TEST(testLazyLoading);
+    CPPUNIT_TEST(testProfiles);
+    CPPUNIT_TEST(testMemory);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    LuaLibrariesTest() = default;
+    virtual ~LuaLibrariesTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testLazyLoading();
+    void testProfiles();
+    void testMemory();
+
+};
+
+#endif /* LUA_LIBRARIES_TEST_H */
@@ -0,0 +1,116 @@
+/**
+ * @file request_arena_test.cpp
+ *
+ * Unit test for the per-request arena. The global allocation functions of
+ * this test binary count all heap allocations while `isCounting` is set.
+ */
+
+#include "request_arena_test.h"
+#include "request_arena.h"
+#include "did_store.h"
+#include "ecu_lua_script.h"
+#include "metrics.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static atomic<bool> isCounting{false};
+static atomic<size_t> numAllocations{0};
+
+void* operator new(size_t size)
+{
+    if (isCounting.load(memory_order_relaxed))
+    {
+        numAllocations.fetch_add(1, memory_order_relaxed);
+    }
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RequestArenaTest);
+
+void RequestArenaTest::setUp()
+{
+    RequestArena::release();
+}
+
+void RequestArenaTest::tearDown()
+{
+    isCounting = false;
+    RequestArena::release();
+}
+
+void RequestArenaTest::testRelease()
+{
+    void* first;
+    {
+        const RequestArena::Scope scope;
+        first = RequestArena::resource()->allocate(100);
+        void* second = RequestArena::resource()->allocate(100);
+        CPPUNIT_ASSERT(first != second);
+    }
+
+    // the next request starts at the beginning of the buffer again
+    const RequestArena::Scope scope;
+    CPPUNIT_ASSERT(RequestArena::resource()->allocate(100) == first);
+}
+
+void RequestArenaTest::testOverflow()
+{
+    metrics::Counter& overflows = metrics::counter("uds.arena_overflows");
+    const uint64_t before = overflows.value();
+
+    const RequestArena::Scope scope;
+    ArenaBytes huge(RequestArena::BUFFER_SIZE * 2, 0xAA, RequestArena::resource());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0xAA), huge.back());
+    CPPUNIT_ASSERT(overflows.value() > before);
+}
+
+void RequestArenaTest::testStaticResponseAllocations()
+{
+    const vector<uint8_t> vin = {'W', 'V', 'W', 'Z', 'Z', 'Z', '1', 'K', 'Z', 'A', 'W', '0', '0', '0', '0', '0', '1'};
+    DidStore store;
+    store.define(0xF190, DidType::ASCII, vin.size(), vin);
+    const string rawResponse = "62 F1 91 53 41 4C 47 41 32 45 56 39 48 41 32 39 38 37 38 34";
+
+    // like `readDataByIdentifier()` and a static `Raw` entry
+    auto handleRequest = [&]()
+    {
+        const RequestArena::Scope scope;
+        ArenaBytes resp({0x62, 0xF1, 0x90}, RequestArena::resource());
+        CPPUNIT_ASSERT(store.read(0xF190, resp));
+        CPPUNIT_ASSERT_EQUAL(size_t(3 + vin.size()), resp.size());
+
+        ArenaBytes raw(RequestArena::resource());
+        EcuLuaScript::appendLiteralHexStr(rawResponse, raw);
+        CPPUNIT_ASSERT_EQUAL(size_t(20), raw.size());
+        CPPUNIT_ASSERT_EQUAL(uint8_t(0x34), raw.back());
+    };
+
+    handleRequest(); // warm up (metrics, thread local arena)
+
+    numAllocations = 0;
+    isCounting = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        handleRequest();
+    }
+    isCounting = false;
+    CPPUNIT_ASSERT_EQUAL(size_t(0), numAllocations.load());
+}
@@ -0,0 +1,34 @@
+/**
+ * @file request_arena_test.h
+ *
+ */
+
+#ifndef REQUEST_ARENA_TEST_H
+#define REQUEST_ARENA_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class RequestArenaTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(RequestArenaTest);
+
+    CPPUNIT_TEST(testRelease);
+    CPPUNIT_TEST(testOverflow);
+    CPPUNIT_TEST(testStaticResponseAllocations);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    RequestArenaTest() = default;
+    virtual ~RequestArenaTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testRelease();
+    void testOverflow();
+    void testStaticResponseAllocations();
+
+};
+
+#endif /* REQUEST_ARENA_TEST_H */
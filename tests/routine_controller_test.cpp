@@ -0,0 +1,148 @@
+/**
+ * @file routine_controller_test.cpp
+ *
+ * Unit test for the asynchronous routines of `RoutineControl`.
+ */
+
+#include "routine_controller_test.h"
+#include "routine_controller.h"
+#include "worker_pool.h"
+#include <atomic>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace std;
+using std::chrono::milliseconds;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RoutineControllerTest);
+
+void RoutineControllerTest::setUp() { }
+
+void RoutineControllerTest::tearDown() { }
+
+void RoutineControllerTest::testUnknownRoutine()
+{
+    RoutineController routines;
+    vector<uint8_t> record;
+    RoutineState state;
+    uint8_t progress;
+    CPPUNIT_ASSERT(routines.start(0xFF00, {}, record) == RoutineResult::UNKNOWN_ROUTINE);
+    CPPUNIT_ASSERT(routines.stop(0xFF00) == RoutineResult::UNKNOWN_ROUTINE);
+    CPPUNIT_ASSERT(routines.getStatus(0xFF00, state, progress, record) == RoutineResult::UNKNOWN_ROUTINE);
+
+    routines.define(0xFF00, [](RoutineRun&) { });
+    CPPUNIT_ASSERT(routines.has(0xFF00));
+    CPPUNIT_ASSERT(routines.stop(0xFF00) == RoutineResult::NOT_STARTED);
+    CPPUNIT_ASSERT(routines.getStatus(0xFF00, state, progress, record) == RoutineResult::NOT_STARTED);
+}
+
+void RoutineControllerTest::testStartAndResults()
+{
+    RoutineController routines;
+    routines.define(0x0203,
+        [](RoutineRun& run)
+        {
+            run.setProgress(50);
+            run.sleepFor(milliseconds(50));
+            run.setResult(run.getOptions());
+        },
+        []() { return vector<uint8_t>{0xAA}; });
+
+    vector<uint8_t> record;
+    CPPUNIT_ASSERT(routines.start(0x0203, {0x12, 0x34}, record) == RoutineResult::OK);
+    CPPUNIT_ASSERT(record == vector<uint8_t>{0xAA});
+    // the start request returns immediately
+    CPPUNIT_ASSERT(routines.start(0x0203, {}, record) == RoutineResult::ALREADY_RUNNING);
+
+    RoutineState state;
+    uint8_t progress;
+    vector<uint8_t> result;
+    usleep(20000);
+    CPPUNIT_ASSERT(routines.getStatus(0x0203, state, progress, result) == RoutineResult::OK);
+    CPPUNIT_ASSERT(state == RoutineState::RUNNING);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(50), progress);
+
+    usleep(80000);
+    CPPUNIT_ASSERT(routines.getStatus(0x0203, state, progress, result) == RoutineResult::OK);
+    CPPUNIT_ASSERT(state == RoutineState::COMPLETED);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(100), progress);
+    CPPUNIT_ASSERT(result == vector<uint8_t>({0x12, 0x34}));
+
+    // a completed routine can be started again
+    CPPUNIT_ASSERT(routines.start(0x0203, {}, record) == RoutineResult::OK);
+}
+
+void RoutineControllerTest::testStop()
+{
+    RoutineController routines;
+    routines.define(0xFF00, [](RoutineRun& run)
+    {
+        if (run.sleepFor(milliseconds(30000)))
+        {
+            run.setResult({0x01});
+        }
+    });
+
+    vector<uint8_t> record;
+    CPPUNIT_ASSERT(routines.start(0xFF00, {}, record) == RoutineResult::OK);
+    CPPUNIT_ASSERT(routines.stop(0xFF00) == RoutineResult::OK);
+
+    RoutineState state;
+    uint8_t progress;
+    vector<uint8_t> result;
+    usleep(20000);
+    CPPUNIT_ASSERT(routines.getStatus(0xFF00, state, progress, result) == RoutineResult::OK);
+    CPPUNIT_ASSERT(state == RoutineState::STOPPED);
+    CPPUNIT_ASSERT(result.empty());
+    CPPUNIT_ASSERT(routines.stop(0xFF00) == RoutineResult::NOT_STARTED);
+}
+
+void RoutineControllerTest::testFailure()
+{
+    RoutineController routines;
+    routines.define(0x0001, [](RoutineRun&) { throw runtime_error("test"); });
+
+    vector<uint8_t> record;
+    CPPUNIT_ASSERT(routines.start(0x0001, {}, record) == RoutineResult::OK);
+    usleep(20000);
+
+    RoutineState state;
+    uint8_t progress;
+    CPPUNIT_ASSERT(routines.getStatus(0x0001, state, progress, record) == RoutineResult::OK);
+    CPPUNIT_ASSERT(state == RoutineState::FAILED);
+}
+
+void RoutineControllerTest::testParallelRoutines()
+{
+    // more long running routines than the shared pool has workers
+    const unsigned numRoutines = WorkerPool::instance().numThreads() + 4;
+    atomic<unsigned> numStarted{0};
+    RoutineController routines;
+    vector<uint8_t> record;
+    for (unsigned i = 0; i < numRoutines; ++i)
+    {
+        routines.define(uint16_t(i), [&numStarted](RoutineRun& run)
+        {
+            ++numStarted;
+            run.sleepFor(milliseconds(2000));
+        });
+        CPPUNIT_ASSERT(routines.start(uint16_t(i), {}, record) == RoutineResult::OK);
+    }
+
+    // all bodies run at once and the shared pool stays available
+    atomic<bool> isJobDone{false};
+    WorkerPool::instance().submit([&isJobDone]() { isJobDone = true; });
+    for (int i = 0; i < 100 && (numStarted < numRoutines || !isJobDone); ++i)
+    {
+        usleep(10000);
+    }
+    CPPUNIT_ASSERT_EQUAL(numRoutines, unsigned(numStarted));
+    CPPUNIT_ASSERT(isJobDone);
+
+    routines.stopAll();
+    for (int i = 0; i < 100 && routines.isBusy(); ++i)
+    {
+        usleep(10000);
+    }
+    CPPUNIT_ASSERT(!routines.isBusy());
+}
@@ -0,0 +1,38 @@
+/**
+ * @file routine_controller_test.h
+ *
+ */
+
+#ifndef ROUTINE_CONTROLLER_TEST_H
+#define ROUTINE_CONTROLLER_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class RoutineControllerTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(RoutineControllerTest);
+
+    CPPUNIT_TEST(testUnknownRoutine);
+    CPPUNIT_TEST(testStartAndResults);
+    CPPUNIT_TEST(testStop);
+    CPPUNIT_TEST(testFailure);
+    CPPUNIT_TEST(testParallelRoutines);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    RoutineControllerTest() = default;
+    virtual ~RoutineControllerTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testUnknownRoutine();
+    void testStartAndResults();
+    void testStop();
+    void testFailure();
+    void testParallelRoutines();
+
+};
+
+#endif /* ROUTINE_CONTROLLER_TEST_H */
@@ -0,0 +1,126 @@
+/**
+ * @file script_slot_test.cpp
+ *
+ * Unit test for the hot reload of the Lua configs.
+ */
+
+#include "script_slot_test.h"
+#include "script_slot.h"
+#include "config_watcher.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ScriptSlotTest);
+
+static const string ECU_IDENT = "PCM";
+static const string CONFIG_FILE = "PCM.lua";
+
+static const string CONFIG_V1 =
+    "PCM = {\n"
+    "    RequestId = 0x100,\n"
+    "    ResponseId = 0x200,\n"
+    "    ReadDataByIdentifier = { [\"F1 91\"] = \"V1\" },\n"
+    "    DIDStore = { [\"F1 90\"] = { type = \"ascii\", length = 4, default = \"NONE\" } },\n"
+    "}\n";
+
+static const string CONFIG_V2 =
+    "PCM = {\n"
+    "    RequestId = 0x100,\n"
+    "    ResponseId = 0x200,\n"
+    "    ReadDataByIdentifier = { [\"F1 91\"] = \"V2\" },\n"
+    "    DIDStore = { [\"F1 90\"] = { type = \"ascii\", length = 4, default = \"NONE\" } },\n"
+    "}\n";
+
+void ScriptSlotTest::setUp()
+{
+    directory_ = "/tmp/script_slot_test_" + to_string(getpid());
+    filesystem::remove_all(directory_);
+    filesystem::create_directory(directory_);
+}
+
+void ScriptSlotTest::tearDown()
+{
+    filesystem::remove_all(directory_);
+}
+
+void ScriptSlotTest::writeConfig(const string& content) const
+{
+    ofstream file(directory_ + '/' + CONFIG_FILE, ios::trunc);
+    file << content;
+}
+
+void ScriptSlotTest::testPublish()
+{
+    writeConfig(CONFIG_V1);
+    const string path = directory_ + '/' + CONFIG_FILE;
+    auto pFirst = make_shared<EcuLuaScript>(ECU_IDENT, path);
+    ScriptSlot slot(pFirst);
+    CPPUNIT_ASSERT_EQUAL(0u, slot.getVersion());
+
+    // a request in progress keeps its version
+    const shared_ptr<EcuLuaScript> pPinned = slot.load();
+    writeConfig(CONFIG_V2);
+    auto pSecond = make_shared<EcuLuaScript>(ECU_IDENT, path, *pFirst);
+    CPPUNIT_ASSERT(slot.publish(pSecond) == pFirst);
+    CPPUNIT_ASSERT_EQUAL(1u, slot.getVersion());
+    CPPUNIT_ASSERT(slot.load() == pSecond);
+    CPPUNIT_ASSERT_EQUAL(string("V1"), pPinned->getDataByIdentifier("F1 91"));
+    CPPUNIT_ASSERT_EQUAL(string("V2"), slot.load()->getDataByIdentifier("F1 91"));
+
+    // the state surviving the reload is shared
+    CPPUNIT_ASSERT(&pFirst->getCommunicationControl() == &pSecond->getCommunicationControl());
+    CPPUNIT_ASSERT(pFirst->getDidStore() == pSecond->getDidStore());
+}
+
+void ScriptSlotTest::testReload()
+{
+    writeConfig(CONFIG_V1);
+    auto slot = make_shared<ScriptSlot>(make_shared<EcuLuaScript>(ECU_IDENT, directory_ + '/' + CONFIG_FILE));
+    const uint8_t vin[] = {'W', 'V', 'W', '1'};
+    CPPUNIT_ASSERT(slot->load()->getDidStore()->write(0xF190, vin, sizeof(vin)) == DidWriteResult::OK);
+    slot->load()->getCommunicationControl().control(DISABLE_RX_AND_TX, NORMAL_COMMUNICATION);
+
+    ConfigWatcher watcher(directory_);
+    watcher.watch(CONFIG_FILE, ECU_IDENT, slot);
+    CPPUNIT_ASSERT(!watcher.reload("unknown.lua"));
+
+    shared_ptr<EcuLuaScript> pPinned = slot->load();
+    writeConfig(CONFIG_V2);
+    CPPUNIT_ASSERT(watcher.reload(CONFIG_FILE));
+    CPPUNIT_ASSERT_EQUAL(string("V2"), slot->load()->getDataByIdentifier("F1 91"));
+
+    // written DIDs and the communication state are kept
+    vector<uint8_t> out;
+    CPPUNIT_ASSERT(slot->load()->getDidStore()->read(0xF190, out));
+    CPPUNIT_ASSERT(out == vector<uint8_t>(vin, vin + sizeof(vin)));
+    CPPUNIT_ASSERT(!slot->load()->getCommunicationControl().isTxEnabled());
+
+    // the replaced version is freed once it is not used anymore
+    CPPUNIT_ASSERT_EQUAL(size_t(1), watcher.collectRetired());
+    const weak_ptr<EcuLuaScript> pReplaced = pPinned;
+    pPinned.reset();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), watcher.collectRetired());
+    CPPUNIT_ASSERT(pReplaced.expired());
+}
+
+void ScriptSlotTest::testRejectedReload()
+{
+    writeConfig(CONFIG_V1);
+    auto slot = make_shared<ScriptSlot>(make_shared<EcuLuaScript>(ECU_IDENT, directory_ + '/' + CONFIG_FILE));
+    ConfigWatcher watcher(directory_);
+    watcher.watch(CONFIG_FILE, ECU_IDENT, slot);
+
+    // syntax error
+    writeConfig("PCM = {\n    RequestId = 0x100,\n");
+    CPPUNIT_ASSERT(!watcher.reload(CONFIG_FILE));
+
+    // the CAN IDs need a restart
+    writeConfig("PCM = {\n    RequestId = 0x101,\n    ResponseId = 0x200,\n}\n");
+    CPPUNIT_ASSERT(!watcher.reload(CONFIG_FILE));
+
+    CPPUNIT_ASSERT_EQUAL(0u, slot->getVersion());
+    CPPUNIT_ASSERT_EQUAL(string("V1"), slot->load()->getDataByIdentifier("F1 91"));
+}
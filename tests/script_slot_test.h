@@ -0,0 +1,38 @@
+/**
+ * @file script_slot_test.h
+ *
+ */
+
+#ifndef SCRIPT_SLOT_TEST_H
+#define SCRIPT_SLOT_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+class ScriptSlotTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ScriptSlotTest);
+
+    CPPUNIT_TEST(testPublish);
+    CPPUNIT_TEST(testReload);
+    CPPUNIT_TEST(testRejectedReload);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    ScriptSlotTest() = default;
+    virtual ~ScriptSlotTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    std::string directory_;
+
+    void writeConfig(const std::string& content) const;
+    void testPublish();
+    void testReload();
+    void testRejectedReload();
+
+};
+
+#endif /* SCRIPT_SLOT_TEST_H */
@@ -0,0 +1,90 @@
+/**
+ * @file security_manager_test.cpp
+ *
+ * Unit test for the native `SecurityAccess` handling.
+ */
+
+#include "security_manager_test.h"
+#include "security_manager.h"
+#include <unistd.h>
+
+using namespace std;
+using std::chrono::milliseconds;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SecurityManagerTest);
+
+static const uint32_t CONSTANT = 0x11223344;
+
+void SecurityManagerTest::setUp() { }
+
+void SecurityManagerTest::tearDown() { }
+
+void SecurityManagerTest::testAlgorithms()
+{
+    auto pXor = SecurityAlgorithm::create("xor", CONSTANT);
+    CPPUNIT_ASSERT(pXor != nullptr);
+    CPPUNIT_ASSERT(pXor->computeKey(0x01, {0x11, 0x22, 0x33, 0x44, 0x55}) == vector<uint8_t>({0x00, 0x00, 0x00, 0x00, 0x44}));
+
+    auto pAdd = SecurityAlgorithm::create("add", 0xFF);
+    CPPUNIT_ASSERT(pAdd != nullptr);
+    CPPUNIT_ASSERT(pAdd->computeKey(0x01, {0x12, 0x00}) == vector<uint8_t>({0x13, 0x00}));
+    CPPUNIT_ASSERT(pAdd->computeKey(0x01, {0xFF, 0xFF}) == vector<uint8_t>({0x00, 0xFF}));
+
+    CPPUNIT_ASSERT(SecurityAlgorithm::create("unknown", CONSTANT) == nullptr);
+    CPPUNIT_ASSERT(SecurityAlgorithm::create("/nonexistent/plugin.so", CONSTANT) == nullptr);
+}
+
+void SecurityManagerTest::testUnlock()
+{
+    SecurityManager security(SecurityAlgorithm::create("xor", CONSTANT), 4, 3, milliseconds(1000));
+    auto pAlgorithm = SecurityAlgorithm::create("xor", CONSTANT);
+
+    vector<uint8_t> seed;
+    CPPUNIT_ASSERT(security.requestSeed(0x01, seed) == SecurityResult::OK);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), seed.size());
+    CPPUNIT_ASSERT(seed != vector<uint8_t>(4, 0x00));
+
+    const vector<uint8_t> key = pAlgorithm->computeKey(0x01, seed);
+    CPPUNIT_ASSERT(security.sendKey(0x02, key.data(), key.size()) == SecurityResult::OK);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x01), security.getUnlockedLevel());
+
+    // an unlocked level is answered with a zero seed
+    CPPUNIT_ASSERT(security.requestSeed(0x01, seed) == SecurityResult::OK);
+    CPPUNIT_ASSERT(seed == vector<uint8_t>(4, 0x00));
+
+    security.lock();
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x00), security.getUnlockedLevel());
+}
+
+void SecurityManagerTest::testSequence()
+{
+    SecurityManager security(SecurityAlgorithm::create("xor", CONSTANT), 2, 3, milliseconds(1000));
+
+    const uint8_t key[] = {0x00, 0x00};
+    CPPUNIT_ASSERT(security.sendKey(0x02, key, sizeof(key)) == SecurityResult::SEQUENCE_ERROR);
+    vector<uint8_t> seed;
+    CPPUNIT_ASSERT(security.requestSeed(0x43, seed) == SecurityResult::INVALID_LEVEL);
+
+    CPPUNIT_ASSERT(security.requestSeed(0x03, seed) == SecurityResult::OK);
+    // key of another level
+    CPPUNIT_ASSERT(security.sendKey(0x02, key, sizeof(key)) == SecurityResult::SEQUENCE_ERROR);
+}
+
+void SecurityManagerTest::testDelay()
+{
+    SecurityManager security(SecurityAlgorithm::create("xor", CONSTANT), 4, 2, milliseconds(30));
+
+    vector<uint8_t> seed;
+    const uint8_t key[] = {0x00};
+    CPPUNIT_ASSERT(security.requestSeed(0x01, seed) == SecurityResult::OK);
+    CPPUNIT_ASSERT(security.sendKey(0x02, key, sizeof(key)) == SecurityResult::INVALID_KEY);
+    // every seed allows a single attempt only
+    CPPUNIT_ASSERT(security.sendKey(0x02, key, sizeof(key)) == SecurityResult::SEQUENCE_ERROR);
+
+    CPPUNIT_ASSERT(security.requestSeed(0x01, seed) == SecurityResult::OK);
+    CPPUNIT_ASSERT(security.sendKey(0x02, key, sizeof(key)) == SecurityResult::EXCEEDED_ATTEMPTS);
+    CPPUNIT_ASSERT(security.requestSeed(0x01, seed) == SecurityResult::DELAY_NOT_EXPIRED);
+
+    usleep(60000);
+    CPPUNIT_ASSERT(security.requestSeed(0x01, seed) == SecurityResult::OK);
+}
@@ -0,0 +1,36 @@
+/**
+ * @file security_manager_test.h
+ *
+ */
+
+#ifndef SECURITY_MANAGER_TEST_H
+#define SECURITY_MANAGER_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SecurityManagerTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(SecurityManagerTest);
+
+    CPPUNIT_TEST(testAlgorithms);
+    CPPUNIT_TEST(testUnlock);
+    CPPUNIT_TEST(testSequence);
+    CPPUNIT_TEST(testDelay);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    SecurityManagerTest() = default;
+    virtual ~SecurityManagerTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testAlgorithms();
+    void testUnlock();
+    void testSequence();
+    void testDelay();
+
+};
+
+#endif /* SECURITY_MANAGER_TEST_H */
@@ -0,0 +1,185 @@
+/**
+ * @file static_entries_test.cpp
+ *
+ * Unit test for the static entries of the Lua tables.
+ */
+
+#include "static_entries_test.h"
+#include "static_entries.h"
+#include "static_tables.h"
+#include "lua_bytes.h"
+#include "selene.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StaticEntriesTest);
+
+void StaticEntriesTest::setUp()
+{
+}
+
+void StaticEntriesTest::tearDown()
+{
+}
+
+void StaticEntriesTest::testFindRaw()
+{
+    StaticEntries entries;
+    entries.setRaw(make_shared<StaticEntries::RawTable>(StaticEntries::RawTable{
+        {"22 F1 90", {true, {0x62, 0xF1, 0x90, 0x01}}},
+        {"31 *", {true, {0x7F, 0x31, 0x31}}},
+        {"31 01 *", {false, {}}}}));
+
+    const StaticEntries::RawEntry* pEntry = entries.findRaw("22 F1 90");
+    CPPUNIT_ASSERT(pEntry != nullptr);
+    CPPUNIT_ASSERT(pEntry->isStatic);
+    CPPUNIT_ASSERT((pEntry->response == vector<uint8_t>{0x62, 0xF1, 0x90, 0x01}));
+
+    // the shortest wildcard wins, like in the lookup of the Lua table
+    pEntry = entries.findRaw("31 01 FF 00");
+    CPPUNIT_ASSERT(pEntry != nullptr);
+    CPPUNIT_ASSERT((pEntry->response == vector<uint8_t>{0x7F, 0x31, 0x31}));
+
+    CPPUNIT_ASSERT(entries.findRaw("22 F1 91") == nullptr);
+    CPPUNIT_ASSERT(entries.findRaw("") == nullptr);
+}
+
+void StaticEntriesTest::testFindDataByIdentifier()
+{
+    StaticEntries entries;
+    entries.setDataByIdentifier("", make_shared<StaticEntries::DataTable>(StaticEntries::DataTable{
+        {"F1 90", "VIN0000000000000"}}));
+    entries.setDataByIdentifier("Programming", make_shared<StaticEntries::DataTable>(StaticEntries::DataTable{
+        {"F1 90", "VIN0000000000001"}}));
+
+    const string* pData = entries.findDataByIdentifier("", "F1 90");
+    CPPUNIT_ASSERT(pData != nullptr);
+    CPPUNIT_ASSERT_EQUAL(string("VIN0000000000000"), *pData);
+    pData = entries.findDataByIdentifier("Programming", "F1 90");
+    CPPUNIT_ASSERT(pData != nullptr);
+    CPPUNIT_ASSERT_EQUAL(string("VIN0000000000001"), *pData);
+
+    CPPUNIT_ASSERT(entries.findDataByIdentifier("Extended", "F1 90") == nullptr);
+    CPPUNIT_ASSERT(entries.findDataByIdentifier("", "F1 91") == nullptr);
+}
+
+void StaticEntriesTest::testFindPgn()
+{
+    StaticEntries entries;
+    entries.setPgns(make_shared<StaticEntries::PgnTable>(StaticEntries::PgnTable{{"FEF1", {100, "01 02 03"}}}));
+
+    const J1939PGNData* pData = entries.findPgn("FEF1");
+    CPPUNIT_ASSERT(pData != nullptr);
+    CPPUNIT_ASSERT_EQUAL(100u, pData->cycleTime);
+    CPPUNIT_ASSERT_EQUAL(string("01 02 03"), pData->payload);
+    CPPUNIT_ASSERT(entries.findPgn("FEF2") == nullptr);
+}
+
+/**
+ * Compiles the tables of a Lua state and checks, that only written or
+ * replaced tables give new entries.
+ */
+void StaticEntriesTest::testStaticTables()
+{
+    sel::State state{true};
+    lua_State* L = state.GetLuaState();
+    LuaBytes::registerType(L);
+    CPPUNIT_ASSERT(state("PCM = { Raw = { ['22 F1 90'] = '62 F1 90 01', ['22 F1 91'] = Bytes.new('62 F1 91') },"
+                         "  ReadDataByIdentifier = { ['F1 90'] = 'VIN' },"
+                         "  PGNs = { FEF1 = { payload = '01 02', cycleTime = 100 } } }"));
+
+    StaticTables tables;
+    tables.addInstance(0, "PCM");
+    CPPUNIT_ASSERT(tables.get(0) == nullptr);
+    tables.refresh(L);
+    const auto pEntries = tables.get(0);
+    CPPUNIT_ASSERT(pEntries != nullptr);
+    CPPUNIT_ASSERT(pEntries->findRaw("22 F1 90") != nullptr);
+    CPPUNIT_ASSERT_EQUAL(string("VIN"), *pEntries->findDataByIdentifier("", "F1 90"));
+    CPPUNIT_ASSERT_EQUAL(100u, pEntries->findPgn("FEF1")->cycleTime);
+
+    // reads and iteration pass the barrier, unchanged tables are not compiled again
+    CPPUNIT_ASSERT(state("n = 0; for k, v in pairs(PCM.Raw) do n = n + 1 end; vin = PCM.ReadDataByIdentifier['F1 90']"));
+    CPPUNIT_ASSERT_EQUAL(2, int(state["n"]));
+    CPPUNIT_ASSERT_EQUAL(string("VIN"), string(state["vin"]));
+    tables.refresh(L);
+    CPPUNIT_ASSERT(tables.get(0) == pEntries);
+
+    // a written entry withdraws the entries at once, only its table is compiled again
+    CPPUNIT_ASSERT(state("PCM.Raw['22 F1 90'] = '62 F1 90 02'"));
+    CPPUNIT_ASSERT(tables.get(0) == nullptr);
+    tables.refresh(L);
+    auto pChanged = tables.get(0);
+    CPPUNIT_ASSERT(pChanged != nullptr);
+    CPPUNIT_ASSERT((pChanged->findRaw("22 F1 90")->response == vector<uint8_t>{0x62, 0xF1, 0x90, 0x02}));
+    CPPUNIT_ASSERT(pChanged->findPgn("FEF1") == pEntries->findPgn("FEF1"));
+
+    // entry tables of the PGNs and Bytes changed in place
+    CPPUNIT_ASSERT(state("PCM.PGNs.FEF1.cycleTime = 200; PCM.Raw['22 F1 91']:u8(0x01)"));
+    tables.refresh(L);
+    pChanged = tables.get(0);
+    CPPUNIT_ASSERT_EQUAL(200u, pChanged->findPgn("FEF1")->cycleTime);
+    CPPUNIT_ASSERT((pChanged->findRaw("22 F1 91")->response == vector<uint8_t>{0x62, 0xF1, 0x91, 0x01}));
+
+    // Bytes, which are not compiled, do not concern the entries
+    CPPUNIT_ASSERT(state("local b = Bytes.new('62'):u8(0x01):resize(4)"));
+    tables.refresh(L);
+    CPPUNIT_ASSERT(tables.get(0) == pChanged);
+
+    // a replaced table
+    CPPUNIT_ASSERT(state("PCM.ReadDataByIdentifier = { ['F1 90'] = 'NEW' }"));
+    tables.refresh(L);
+    CPPUNIT_ASSERT_EQUAL(string("NEW"), *tables.get(0)->findDataByIdentifier("", "F1 90"));
+
+    // an instance falling back to the tables of the template shares their entries
+    CPPUNIT_ASSERT(state("PCM1 = setmetatable({}, { __index = PCM })"));
+    tables.addInstance(1, "PCM1");
+    tables.refresh(L);
+    CPPUNIT_ASSERT(tables.get(1) != nullptr);
+    CPPUNIT_ASSERT(tables.get(1)->findRaw("22 F1 90") == tables.get(0)->findRaw("22 F1 90"));
+}
+
+/**
+ * Lua functions on the tables behind the barrier, run with every backend the
+ * tests are built with (e.g. `make LUA_PKG=luajit`).
+ */
+void StaticEntriesTest::testBarrier()
+{
+    sel::State state{true};
+    lua_State* L = state.GetLuaState();
+    LuaBytes::registerType(L);
+    StaticTables::registerIterators(L);
+    CPPUNIT_ASSERT(state("PCM = { Raw = { ['22 F1 90'] = '62 F1 90 01', 'first', 'second' } }"));
+
+    StaticTables tables;
+    tables.addInstance(0, "PCM");
+    tables.refresh(L);
+    const auto pEntries = tables.get(0);
+    CPPUNIT_ASSERT(pEntries != nullptr);
+
+    // `pairs()` and `ipairs()` see the entries under all backends
+    CPPUNIT_ASSERT(state("n = 0; for k, v in pairs(PCM.Raw) do n = n + 1 end;"
+                         "i = 0; for k, v in ipairs(PCM.Raw) do i = i + 1 end"));
+    CPPUNIT_ASSERT_EQUAL(3, int(state["n"]));
+    CPPUNIT_ASSERT_EQUAL(2, int(state["i"]));
+#if LUA_VERSION_NUM >= 502
+    CPPUNIT_ASSERT(state("len = #PCM.Raw"));
+    CPPUNIT_ASSERT_EQUAL(2, int(state["len"]));
+#endif
+
+    // `next()` and `rawget()` only see the empty table
+    CPPUNIT_ASSERT(state("isEmpty = next(PCM.Raw) == nil and rawget(PCM.Raw, '22 F1 90') == nil"));
+    CPPUNIT_ASSERT(bool(state["isEmpty"]));
+
+    // `rawset()` bypasses the barrier, the entry is noticed on the unlock
+    CPPUNIT_ASSERT(state("rawset(PCM.Raw, '22 F1 90', '62 F1 90 02')"));
+    tables.refresh(L);
+    const auto pChanged = tables.get(0);
+    CPPUNIT_ASSERT(pChanged != nullptr && pChanged != pEntries);
+    CPPUNIT_ASSERT((pChanged->findRaw("22 F1 90")->response == vector<uint8_t>{0x62, 0xF1, 0x90, 0x02}));
+    CPPUNIT_ASSERT(state("isEmpty = next(PCM.Raw) == nil; v = PCM.Raw['22 F1 90']"));
+    CPPUNIT_ASSERT(bool(state["isEmpty"]));
+    CPPUNIT_ASSERT_EQUAL(string("62 F1 90 02"), string(state["v"]));
+    tables.refresh(L);
+    CPPUNIT_ASSERT(tables.get(0) == pChanged);
+}
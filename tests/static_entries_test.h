@@ -0,0 +1,38 @@
+/**
+ * @file static_entries_test.h
+ *
+ */
+
+#ifndef STATIC_ENTRIES_TEST_H
+#define STATIC_ENTRIES_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class StaticEntriesTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(StaticEntriesTest);
+
+    CPPUNIT_TEST(testFindRaw);
+    CPPUNIT_TEST(testFindDataByIdentifier);
+    CPPUNIT_TEST(testFindPgn);
+    CPPUNIT_TEST(testStaticTables);
+    CPPUNIT_TEST(testBarrier);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    StaticEntriesTest() = default;
+    virtual ~StaticEntriesTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testFindRaw();
+    void testFindDataByIdentifier();
+    void testFindPgn();
+    void testStaticTables();
+    void testBarrier();
+
+};
+
+#endif /* STATIC_ENTRIES_TEST_H */
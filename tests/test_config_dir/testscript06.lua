@@ -40,6 +40,12 @@ PCM = {
             sendRaw("7F 19 78")
             sleep(5000)
             return "59 02 FF E3 00 54 2F"
+        end,
+
+        -- a slow handler, which misses P2
+        ["22 00 10"] = function (request)
+            sleep(200)
+            return "62 00 10 01"
         end
     },
 
@@ -49,3 +55,12 @@ PCM = {
     }
 }
 
+-- overrides the native TesterPresent
+TCM = {
+    RequestId = 0x101,
+    ResponseId = 0x201,
+
+    Raw = {
+        ["3E 00"] = "7E 00 AA"
+    }
+}
@@ -0,0 +1,46 @@
+counter = 0
+
+PCM = {
+    RequestId = 0x100,
+    ResponseId = 0x200,
+    RebootTime = 20,
+
+    ReadDataByIdentifier = {
+        ["F1 90"] = function (identifier)
+            return "first"
+        end,
+    },
+
+    Raw = {
+        ["22 00 01"] = function (request)
+            counter = counter + 1
+            PCM.Raw["22 00 02"] = "62 00 02 02"
+            createdLater = true
+            return "62 00 01 0" .. counter
+        end,
+        ["22 00 02"] = "62 00 02 01",
+        ["22 00 03"] = function (request)
+            if createdLater then
+                return "62 00 03 01"
+            end
+            return "62 00 03 00"
+        end,
+        ["22 00 04"] = function (request)
+            PCM.ReadDataByIdentifier["F1 90"] = function (identifier)
+                return "second"
+            end
+            return "62 00 04 01"
+        end,
+        ["22 00 05"] = function (request)
+            PCM.ReadDataByIdentifier["F1 90"] = "third"
+            return "62 00 05 01"
+        end,
+        ["22 00 06"] = function (request)
+            local n = 0
+            for _ in pairs(PCM.Raw) do
+                n = n + 1
+            end
+            return "62 00 06 0" .. n
+        end,
+    }
+}
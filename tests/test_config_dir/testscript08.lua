@@ -0,0 +1,31 @@
+PCM = {
+    RequestId = 0x100,
+    ResponseId = 0x200,
+
+    ReadDataByIdentifier = {
+        ["F1 90"] = function (identifier)
+            return Bytes.new():ascii("SALGA2EV9HA298784")
+        end,
+        ["F1 91"] = "HPLA-12345-AB",
+    },
+
+    Raw = {
+        -- built as binary buffer
+        ["22 00 01"] = function (request, bytes)
+            return Bytes.new("62"):append(bytes:slice(2)):u8(0x01):u16be(0x1234):u32be(0xDEADBEEF)
+        end,
+        -- sub-function without the suppressPosRspMsgIndicationBit
+        ["31 01 *"] = function (request, bytes)
+            return Bytes.new():u8(0x71):u8(bytes:at(2)):append(bytes:slice(3, 4))
+        end,
+        -- a buffer concatenated with strings gives a literal hex string
+        ["22 00 02"] = function (request, bytes)
+            return "62 00 02 " .. Bytes.new():u16be(0xABCD)
+        end,
+        -- hex strings keep working
+        ["22 00 03"] = "62 00 03 01",
+        ["22 00 04"] = function (request)
+            return tostring(Bytes.new("62 00 04"):ascii("OK"))
+        end,
+    }
+}
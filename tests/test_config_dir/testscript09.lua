@@ -0,0 +1,32 @@
+PCM = {
+    RequestId = 0x700,
+    ResponseId = 0x780,
+    J1939SourceAddress = 0x10,
+
+    Fleet = {
+        count = 3,
+        ResponseIdStep = 2,
+        [2] = {
+            ReadDataByIdentifier = {
+                ["F1 90"] = "VIN0000000000002",
+            },
+        },
+        [3] = {
+            ResponseId = 0x7F0,
+        },
+    },
+
+    ReadDataByIdentifier = {
+        ["F1 90"] = "VIN0000000000000",
+        ["F1 91"] = function ()
+            return string.format("%02X", ECU.J1939SourceAddress)
+        end,
+    },
+
+    Raw = {
+        ["22 00 01"] = function (request)
+            ECU.counter = (ECU.counter or 0) + 1
+            return "62 00 01 0" .. ECU.counter
+        end,
+    },
+}
@@ -0,0 +1,30 @@
+PCM = {
+    RequestId = 0x100,
+    ResponseId = 0x200,
+
+    ExecutionBudget = {
+        instructions = 100000,
+        nrc = 0x22,
+    },
+
+    ReadDataByIdentifier = {
+        ["F1 90"] = function (identifier)
+            while true do end
+        end,
+    },
+
+    Raw = {
+        ["22 00 01"] = function (request)
+            while true do end
+        end,
+        -- catching the error does not help
+        ["22 00 02"] = function (request)
+            while true do pcall(function () while true do end end) end
+        end,
+        ["22 00 03"] = function (request)
+            local n = 0
+            for i = 1, 1000 do n = n + i end
+            return "62 00 03 01"
+        end,
+    }
+}
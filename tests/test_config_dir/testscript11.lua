@@ -0,0 +1,53 @@
+-- DIDs computed by signal models and checksums, the typical load of the JIT
+PCM = {
+    RequestId = 0x100,
+    ResponseId = 0x200,
+
+    Raw = {
+        -- engine speed: low-pass filtered model of the crankshaft signal
+        ["22 F4 0C"] = function (request)
+            local rpm = 0
+            for t = 1, 2000 do
+                local raw = 800 + 400 * math.sin(t * 0.01) + 50 * math.sin(t * 0.37)
+                rpm = rpm + (raw - rpm) * 0.05
+            end
+            return Bytes.new("62 F4 0C"):u16be(math.floor(rpm * 4))
+        end,
+        -- Fletcher-16 checksum of a calibration block
+        ["22 F1 A0"] = function (request)
+            local block = Bytes.new()
+            for i = 0, 1023 do
+                block:u8((i * 31 + 7) % 256)
+            end
+            local sum1, sum2 = 0, 0
+            for i = 1, #block do
+                sum1 = (sum1 + block:at(i)) % 255
+                sum2 = (sum2 + sum1) % 255
+            end
+            return Bytes.new("62 F1 A0"):u16be(sum2 * 256 + sum1)
+        end,
+        -- the same checksum through the FFI, if the backend is LuaJIT
+        ["22 F1 A1"] = function (request)
+            local block = Bytes.new():resize(1024)
+            local sum1, sum2 = 0, 0
+            if jit then
+                local ffi = require("ffi")
+                local p = ffi.cast("uint8_t*", block:ptr())
+                for i = 0, 1023 do
+                    p[i] = (i * 31 + 7) % 256
+                end
+                for i = 0, 1023 do
+                    sum1 = (sum1 + p[i]) % 255
+                    sum2 = (sum2 + sum1) % 255
+                end
+            else
+                for i = 0, 1023 do
+                    local byte = (i * 31 + 7) % 256
+                    sum1 = (sum1 + byte) % 255
+                    sum2 = (sum2 + sum1) % 255
+                end
+            end
+            return Bytes.new("62 F1 A1"):u16be(sum2 * 256 + sum1)
+        end,
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * @file timer_service_test.cpp
+ *
+ * Unit test for the central timer service.
+ */
+
+#include "timer_service_test.h"
+#include "timer_service.h"
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <unistd.h>
+
+using namespace std;
+using std::chrono::milliseconds;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimerServiceTest);
+
+void TimerServiceTest::setUp() { }
+
+void TimerServiceTest::tearDown() { }
+
+void TimerServiceTest::testOneShot()
+{
+    TimerService timers;
+    atomic<int> calls{0};
+    const auto id = timers.schedule(milliseconds(10), [&calls]() { ++calls; });
+    CPPUNIT_ASSERT(id != 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), timers.size());
+
+    usleep(50000);
+    CPPUNIT_ASSERT_EQUAL(1, calls.load());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), timers.size());
+    CPPUNIT_ASSERT(!timers.cancel(id));
+}
+
+void TimerServiceTest::testOrder()
+{
+    TimerService timers;
+    mutex orderMutex;
+    vector<int> order;
+    auto push = [&orderMutex, &order](int n)
+    {
+        const lock_guard<mutex> lock(orderMutex);
+        order.push_back(n);
+    };
+    // a later scheduled, but earlier due timer has to wake up the thread
+    timers.schedule(milliseconds(40), [&push]() { push(3); });
+    timers.schedule(milliseconds(20), [&push]() { push(2); });
+    timers.schedule(milliseconds(5), [&push]() { push(1); });
+
+    usleep(80000);
+    const lock_guard<mutex> lock(orderMutex);
+    CPPUNIT_ASSERT(order == vector<int>({1, 2, 3}));
+}
+
+void TimerServiceTest::testPeriodic()
+{
+    TimerService timers;
+    atomic<int> calls{0};
+    const auto id = timers.schedule(milliseconds(5), [&calls]() { ++calls; }, milliseconds(10));
+
+    usleep(60000);
+    CPPUNIT_ASSERT(timers.cancel(id));
+    const int n = calls.load();
+    CPPUNIT_ASSERT(n >= 3);
+
+    usleep(30000);
+    CPPUNIT_ASSERT_EQUAL(n, calls.load());
+}
+
+void TimerServiceTest::testCancel()
+{
+    TimerService timers;
+    atomic<int> calls{0};
+    const auto id = timers.schedule(milliseconds(20), [&calls]() { ++calls; });
+    timers.schedule(milliseconds(30), [&calls]() { calls += 10; });
+    CPPUNIT_ASSERT(timers.cancel(id));
+    CPPUNIT_ASSERT(!timers.cancel(id));
+
+    usleep(60000);
+    CPPUNIT_ASSERT_EQUAL(10, calls.load());
+}
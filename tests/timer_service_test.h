@@ -0,0 +1,36 @@
+/**
+ * @file timer_service_test.h
+ *
+ */
+
+#ifndef TIMER_SERVICE_TEST_H
+#define TIMER_SERVICE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TimerServiceTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(TimerServiceTest);
+
+    CPPUNIT_TEST(testOneShot);
+    CPPUNIT_TEST(testOrder);
+    CPPUNIT_TEST(testPeriodic);
+    CPPUNIT_TEST(testCancel);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TimerServiceTest() = default;
+    virtual ~TimerServiceTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testOneShot();
+    void testOrder();
+    void testPeriodic();
+    void testCancel();
+
+};
+
+#endif /* TIMER_SERVICE_TEST_H */
@@ -11,6 +11,7 @@
 #include "uds_receiver_test.h"
 #include "uds_receiver.h"
 #include "service_identifier.h"
+#include "metrics.h"
 #include <thread>
 #include <unistd.h>
 #include <cstring>
@@ -46,7 +47,7 @@ void UdsReceiverTest::testUdsReceiver()
     IsoTpSender sender(respId, requId, DEVICE);
     SessionController sesCtrl;
     UdsReceiver* udsReceiver;
-    CPPUNIT_ASSERT_NO_THROW(udsReceiver = new UdsReceiver(requId, respId, DEVICE, std::move(ecuScript), &sender, &sesCtrl));
+    CPPUNIT_ASSERT_NO_THROW(udsReceiver = new UdsReceiver(requId, respId, DEVICE, ecuScript.get(), &sender, &sesCtrl));
     delete udsReceiver;
 }
 
@@ -59,7 +60,7 @@ void UdsReceiverTest::testProceedReceivedData()
     const uint16_t requId = ecuScript->getRequestId();
     IsoTpSender sender(respId, requId, DEVICE);
     SessionController sesCtrl;
-    UdsReceiver udsReceiver(requId, respId, DEVICE, std::move(ecuScript), &sender, &sesCtrl);
+    UdsReceiver udsReceiver(requId, respId, DEVICE, ecuScript.get(), &sender, &sesCtrl);
     TestReceiver testReceiver(requId, respId, DEVICE);
     std::thread testThread(&IsoTpReceiver::readData, &testReceiver); // run async in thread
     usleep(4000); // wait some time to ensure the thread is set up and running
@@ -220,6 +221,166 @@ void UdsReceiverTest::testGenerateSeed()
     }
 }
 
+void UdsReceiverTest::testSuppressPosRsp()
+{
+    auto ecuScript = std::make_unique<EcuLuaScript>(ECU_IDENT, LUA_SCRIPT);
+    const uint16_t respId = ecuScript->getResponseId();
+    const uint16_t requId = ecuScript->getRequestId();
+    IsoTpSender sender(respId, requId, DEVICE);
+    SessionController sesCtrl;
+    UdsReceiver udsReceiver(requId, respId, DEVICE, ecuScript.get(), &sender, &sesCtrl);
+
+    // TesterPresent with and without the suppressPosRspMsgIndicationBit
+    constexpr std::array<uint8_t, 2> testerPresent = {TESTER_PRESENT_REQ, 0x00};
+    auto responses = udsReceiver.evaluate(testerPresent.data(), testerPresent.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{TESTER_PRESENT_RES, 0x00}));
+
+    constexpr std::array<uint8_t, 2> testerPresentSuppressed = {TESTER_PRESENT_REQ, 0x80};
+    CPPUNIT_ASSERT(udsReceiver.evaluate(testerPresentSuppressed.data(), testerPresentSuppressed.size()).empty());
+
+    // negative responses are never suppressed
+    constexpr std::array<uint8_t, 2> testerPresentInvalid = {TESTER_PRESENT_REQ, 0x81};
+    responses = udsReceiver.evaluate(testerPresentInvalid.data(), testerPresentInvalid.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{ERROR, TESTER_PRESENT_REQ, SUBFUNCTION_NOT_SUPPORTED}));
+
+    // the service is executed, only the positive response is dropped
+    constexpr std::array<uint8_t, 2> extendedSession = {DIAGNOSTIC_SESSION_CONTROL_REQ, 0x83};
+    CPPUNIT_ASSERT(udsReceiver.evaluate(extendedSession.data(), extendedSession.size()).empty());
+    CPPUNIT_ASSERT_EQUAL(UdsSession::EXTENDED, sesCtrl.getCurrentUdsSession());
+
+    // the bit has no meaning for services without it
+    constexpr std::array<uint8_t, 3> readDataById = {READ_DATA_BY_IDENTIFIER_REQ, 0xf1, 0x90};
+    CPPUNIT_ASSERT_EQUAL(size_t(1), udsReceiver.evaluate(readDataById.data(), readDataById.size()).size());
+
+    constexpr std::array<uint8_t, 2> defaultSession = {DIAGNOSTIC_SESSION_CONTROL_REQ, 0x01};
+    responses = udsReceiver.evaluate(defaultSession.data(), defaultSession.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{DIAGNOSTIC_SESSION_CONTROL_RES, 0x01}));
+}
+
+void UdsReceiverTest::testUnsupportedService()
+{
+    auto ecuScript = std::make_unique<EcuLuaScript>(ECU_IDENT, LUA_SCRIPT);
+    const uint16_t respId = ecuScript->getResponseId();
+    const uint16_t requId = ecuScript->getRequestId();
+    IsoTpSender sender(respId, requId, DEVICE);
+    SessionController sesCtrl;
+    UdsReceiver udsReceiver(requId, respId, DEVICE, ecuScript.get(), &sender, &sesCtrl);
+
+    // neither a native handler nor a `Raw` entry (WriteMemoryByAddress)
+    constexpr std::array<uint8_t, 2> writeMemory = {0x3D, 0x12};
+    auto responses = udsReceiver.evaluate(writeMemory.data(), writeMemory.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{ERROR, 0x3D, SERVICE_NOT_SUPPORTED}));
+
+    // the last entry of the service table
+    constexpr std::array<uint8_t, 1> lastSid = {0xFF};
+    responses = udsReceiver.evaluate(lastSid.data(), lastSid.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{ERROR, 0xFF, SERVICE_NOT_SUPPORTED}));
+
+    // a service with `Raw` entries falls back to its native handler
+    constexpr std::array<uint8_t, 3> readDataById = {READ_DATA_BY_IDENTIFIER_REQ, 0xf1, 0x24};
+    responses = udsReceiver.evaluate(readDataById.data(), readDataById.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{
+        READ_DATA_BY_IDENTIFIER_RES, 0xf1, 0x24,
+        'H', 'P', 'L', 'A', '-', '1', '2', '3', '4', '5', '-', 'A', 'B'
+    }));
+
+    // `Raw` entries take precedence over the native handlers
+    constexpr std::array<uint8_t, 2> programmingSession = {DIAGNOSTIC_SESSION_CONTROL_REQ, 0x02};
+    responses = udsReceiver.evaluate(programmingSession.data(), programmingSession.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{0x50, 0x02, 0x00, 0x19, 0x01, 0xF4}));
+}
+
+void UdsReceiverTest::testConcurrentRequests()
+{
+    auto ecuScript = std::make_unique<EcuLuaScript>(ECU_IDENT, LUA_SCRIPT);
+    const uint16_t respId = ecuScript->getResponseId();
+    const uint16_t requId = ecuScript->getRequestId();
+    IsoTpSender sender(respId, requId, DEVICE);
+    SessionController sesCtrl;
+    UdsReceiver udsReceiver(requId, respId, DEVICE, ecuScript.get(), &sender, &sesCtrl);
+    metrics::Counter& deadlineHits = metrics::counter("uds.p2_deadline_hits");
+    const uint64_t numHits = deadlineHits.value();
+
+    // a slow request (e.g. a functional one handled by a worker) ...
+    std::vector<std::vector<uint8_t>> slowResponses;
+    std::thread slowThread([&udsReceiver, &slowResponses]()
+    {
+        constexpr std::array<uint8_t, 3> slowRequest = {READ_DATA_BY_IDENTIFIER_REQ, 0x00, 0x10};
+        slowResponses = udsReceiver.evaluate(slowRequest.data(), slowRequest.size());
+    });
+    usleep(10000);
+
+    // ... must not lose its `ResponsePending` to a request answered meanwhile
+    constexpr std::array<uint8_t, 3> fastRequest = {READ_DATA_BY_IDENTIFIER_REQ, 0xfa, 0xbc};
+    const auto responses = udsReceiver.evaluate(fastRequest.data(), fastRequest.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{0x10, 0x33, 0x11}));
+
+    slowThread.join();
+    CPPUNIT_ASSERT_EQUAL(size_t(1), slowResponses.size());
+    CPPUNIT_ASSERT((slowResponses[0] == std::vector<uint8_t>{READ_DATA_BY_IDENTIFIER_RES, 0x00, 0x10, 0x01}));
+    CPPUNIT_ASSERT_EQUAL(numHits + 1, deadlineHits.value());
+}
+
+void UdsReceiverTest::testFunctionalNrcSuppression()
+{
+    auto ecuScript = std::make_unique<EcuLuaScript>(ECU_IDENT, LUA_SCRIPT);
+    const uint16_t respId = ecuScript->getResponseId();
+    const uint16_t requId = ecuScript->getRequestId();
+    IsoTpSender sender(respId, requId, DEVICE);
+    SessionController sesCtrl;
+    UdsReceiver udsReceiver(requId, respId, DEVICE, ecuScript.get(), &sender, &sesCtrl);
+
+    // unsupported services and sub-functions stay unanswered on functional requests
+    constexpr std::array<uint8_t, 2> writeMemory = {0x3D, 0x12};
+    CPPUNIT_ASSERT(udsReceiver.evaluate(writeMemory.data(), writeMemory.size(), true).empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), udsReceiver.evaluate(writeMemory.data(), writeMemory.size()).size());
+
+    constexpr std::array<uint8_t, 2> testerPresentInvalid = {TESTER_PRESENT_REQ, 0x05};
+    CPPUNIT_ASSERT(udsReceiver.evaluate(testerPresentInvalid.data(), testerPresentInvalid.size(), true).empty());
+
+    // other negative and all positive responses are still sent
+    constexpr std::array<uint8_t, 1> testerPresentShort = {TESTER_PRESENT_REQ};
+    auto responses = udsReceiver.evaluate(testerPresentShort.data(), testerPresentShort.size(), true);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{ERROR, TESTER_PRESENT_REQ, INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT}));
+
+    constexpr std::array<uint8_t, 3> readDataById = {READ_DATA_BY_IDENTIFIER_REQ, 0xf1, 0x90};
+    CPPUNIT_ASSERT_EQUAL(size_t(1), udsReceiver.evaluate(readDataById.data(), readDataById.size(), true).size());
+}
+
+void UdsReceiverTest::testRawTesterPresent()
+{
+    auto ecuScript = std::make_unique<EcuLuaScript>("TCM", LUA_SCRIPT);
+    const uint16_t respId = ecuScript->getResponseId();
+    const uint16_t requId = ecuScript->getRequestId();
+    IsoTpSender sender(respId, requId, DEVICE);
+    SessionController sesCtrl;
+    UdsReceiver udsReceiver(requId, respId, DEVICE, ecuScript.get(), &sender, &sesCtrl);
+
+    // the `Raw` entry takes precedence over the native handler ...
+    constexpr std::array<uint8_t, 2> testerPresent = {TESTER_PRESENT_REQ, 0x00};
+    auto responses = udsReceiver.evaluate(testerPresent.data(), testerPresent.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{TESTER_PRESENT_RES, 0x00, 0xaa}));
+
+    constexpr std::array<uint8_t, 2> testerPresentSuppressed = {TESTER_PRESENT_REQ, 0x80};
+    CPPUNIT_ASSERT(udsReceiver.evaluate(testerPresentSuppressed.data(), testerPresentSuppressed.size()).empty());
+
+    // ... which still answers the requests without an entry
+    constexpr std::array<uint8_t, 2> testerPresentInvalid = {TESTER_PRESENT_REQ, 0x05};
+    responses = udsReceiver.evaluate(testerPresentInvalid.data(), testerPresentInvalid.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), responses.size());
+    CPPUNIT_ASSERT((responses[0] == std::vector<uint8_t>{ERROR, TESTER_PRESENT_REQ, SUBFUNCTION_NOT_SUPPORTED}));
+}
+
 /**
  * Compares the incoming response data from the corresponding `UdsReceiver` with
  * the expected internal data set. This is done by the 
@@ -46,6 +46,11 @@ class UdsReceiverTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST(testUdsReceiver);
     CPPUNIT_TEST(testProceedReceivedData);
     CPPUNIT_TEST(testGenerateSeed);
+    CPPUNIT_TEST(testSuppressPosRsp);
+    CPPUNIT_TEST(testUnsupportedService);
+    CPPUNIT_TEST(testConcurrentRequests);
+    CPPUNIT_TEST(testFunctionalNrcSuppression);
+    CPPUNIT_TEST(testRawTesterPresent);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -60,6 +65,11 @@ private:
     void testProceedReceivedData();
     void testSetSessionController();
     void testGenerateSeed();
+    void testSuppressPosRsp();
+    void testUnsupportedService();
+    void testConcurrentRequests();
+    void testFunctionalNrcSuppression();
+    void testRawTesterPresent();
 
 };
 
@@ -0,0 +1,61 @@
+/**
+ * @file uds_request_test.cpp
+ *
+ * Unit test for the view of a received UDS request.
+ */
+
+#include "uds_request_test.h"
+#include "uds_request.h"
+#include <cstdint>
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UdsRequestTest);
+
+void UdsRequestTest::setUp() { }
+
+void UdsRequestTest::tearDown() { }
+
+void UdsRequestTest::testAccess()
+{
+    static constexpr uint8_t RDBI[] = {0x22, 0xF1, 0x90};
+    constexpr UdsRequest request(RDBI, sizeof(RDBI));
+    static_assert(request.sid() == 0x22, "SID is the first byte");
+    static_assert(request.payloadSize() == 2, "payload excludes the SID");
+
+    CPPUNIT_ASSERT_EQUAL(size_t(3), request.size());
+    CPPUNIT_ASSERT(request.data() == RDBI);
+    CPPUNIT_ASSERT(request.payload() == RDBI + 1);
+    // `ReadDataByIdentifier` has no sub-function, so bit 7 is kept
+    CPPUNIT_ASSERT(!request.isPosRspSuppressed());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0xF1), request[1]);
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x90), request[2]);
+}
+
+void UdsRequestTest::testSuppressPosRsp()
+{
+    const uint8_t dsc[] = {0x10, 0x83};
+    const UdsRequest request(dsc, sizeof(dsc));
+    CPPUNIT_ASSERT(request.isPosRspSuppressed());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x03), request.subFunction());
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x03), request[1]);
+    // the receive buffer itself stays untouched
+    CPPUNIT_ASSERT_EQUAL(uint8_t(0x83), request.data()[1]);
+
+    const uint8_t plain[] = {0x10, 0x03};
+    CPPUNIT_ASSERT(!UdsRequest(plain, sizeof(plain)).isPosRspSuppressed());
+
+    const uint8_t shortRequest[] = {0x10};
+    CPPUNIT_ASSERT(!UdsRequest(shortRequest, sizeof(shortRequest)).isPosRspSuppressed());
+}
+
+void UdsRequestTest::testToHexString()
+{
+    const uint8_t rdbi[] = {0x22, 0xF1, 0x90};
+    CPPUNIT_ASSERT_EQUAL(string("22 F1 90"), UdsRequest(rdbi, sizeof(rdbi)).toHexString());
+
+    const uint8_t routine[] = {0x31, 0x81, 0x0A, 0x0B};
+    CPPUNIT_ASSERT_EQUAL(string("31 01 0A 0B"), UdsRequest(routine, sizeof(routine)).toHexString());
+
+    CPPUNIT_ASSERT_EQUAL(string(""), UdsRequest(rdbi, 0).toHexString());
+}
@@ -0,0 +1,34 @@
+/**
+ * @file uds_request_test.h
+ *
+ */
+
+#ifndef UDS_REQUEST_TEST_H
+#define UDS_REQUEST_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class UdsRequestTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(UdsRequestTest);
+
+    CPPUNIT_TEST(testAccess);
+    CPPUNIT_TEST(testSuppressPosRsp);
+    CPPUNIT_TEST(testToHexString);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    UdsRequestTest() = default;
+    virtual ~UdsRequestTest() = default;
+    void setUp();
+    void tearDown();
+
+private:
+    void testAccess();
+    void testSuppressPosRsp();
+    void testToHexString();
+
+};
+
+#endif /* UDS_REQUEST_TEST_H */
@@ -6,7 +6,14 @@
 
 #include "utils_test.h"
 #include "utilities.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <vector>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UtilsTest);
@@ -84,6 +91,11 @@ void UtilsTest::testGetConfigFilenames()
         "testscript04.lua",
         "testscript05.lua",
         "testscript06.lua",
+        "testscript07.lua",
+        "testscript08.lua",
+        "testscript09.lua",
+        "testscript10.lua",
+        "testscript11.lua",
         "invalid_testscript01.lua"
     };
     std::sort(expected.begin(), expected.end());
@@ -110,3 +122,43 @@ void UtilsTest::testGetConfigFilenames()
     result = (expected == filenames);
     CPPUNIT_ASSERT_EQUAL(false, result);
 }
+
+void UtilsTest::testWriteFileAtomically()
+{
+    const std::string path = "/tmp/utils_test_" + std::to_string(getpid()) + ".ready";
+    CPPUNIT_ASSERT(utils::writeFileAtomically(path, "3 of 3 configs ready\n"));
+    CPPUNIT_ASSERT(!utils::existsFile(path + ".tmp"));
+
+    std::ifstream file(path);
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CPPUNIT_ASSERT_EQUAL(std::string("3 of 3 configs ready\n"), content);
+    unlink(path.c_str());
+
+    CPPUNIT_ASSERT(!utils::writeFileAtomically("tests/not_a_dir/ready", ""));
+}
+
+void UtilsTest::testNotifyServiceManager()
+{
+    unsetenv("NOTIFY_SOCKET");
+    CPPUNIT_ASSERT(!utils::notifyServiceManager("READY=1\n"));
+
+    // plays the service manager
+    const std::string socketPath = "/tmp/utils_test_" + std::to_string(getpid()) + ".sock";
+    unlink(socketPath.c_str());
+    const int skt = socket(AF_UNIX, SOCK_DGRAM, 0);
+    CPPUNIT_ASSERT(skt >= 0);
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    CPPUNIT_ASSERT_EQUAL(0, bind(skt, reinterpret_cast<struct sockaddr*> (&addr), sizeof(addr)));
+
+    setenv("NOTIFY_SOCKET", socketPath.c_str(), 1);
+    CPPUNIT_ASSERT(utils::notifyServiceManager("READY=1\n"));
+    char buffer[64] = {};
+    CPPUNIT_ASSERT_EQUAL(ssize_t(8), recv(skt, buffer, sizeof(buffer), MSG_DONTWAIT));
+    CPPUNIT_ASSERT_EQUAL(std::string("READY=1\n"), std::string(buffer));
+
+    unsetenv("NOTIFY_SOCKET");
+    close(skt);
+    unlink(socketPath.c_str());
+}
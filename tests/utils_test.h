@@ -16,6 +16,8 @@ class UtilsTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST(testExistsDirectory);
     CPPUNIT_TEST(testEndsWith);
     CPPUNIT_TEST(testGetConfigFilenames);
+    CPPUNIT_TEST(testWriteFileAtomically);
+    CPPUNIT_TEST(testNotifyServiceManager);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -30,6 +32,8 @@ private:
     void testExistsDirectory();
     void testEndsWith();
     void testGetConfigFilenames();
+    void testWriteFileAtomically();
+    void testNotifyServiceManager();
 
 };
 